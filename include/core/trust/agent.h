@@ -24,6 +24,8 @@
 #include <core/trust/visibility.h>
 
 #include <cstdint>
+#include <map>
+#include <set>
 
 namespace core
 {
@@ -80,15 +82,51 @@ public:
         std::string description;
     };
 
+    /** @brief Summarizes all parameters for processing a trust request covering multiple features. */
+    struct BatchRequestParameters
+    {
+        /** @brief All application-specific parameters go here. */
+        struct
+        {
+            /** @brief The user id under which the requesting application runs. */
+            core::trust::Uid uid;
+            /** @brief The process id of the requesting application. */
+            core::trust::Pid pid;
+            /** @brief The id of the requesting application. */
+            std::string id;
+        } application;
+        /** @brief The set of service-specific feature identifiers. */
+        std::set<Feature> features;
+        /** @brief An extended description that should be presented to the user on prompting. */
+        std::string description;
+    };
+
+    /** @brief Maps features of a batch request to the user's answer. */
+    typedef std::map<Feature, Request::Answer> BatchAnswer;
+
     /**
      * @brief Authenticates the given request and returns the user's answer.
      * @param parameters [in] Describe the request.
      */
     virtual Request::Answer authenticate_request_with_parameters(const RequestParameters& parameters) = 0;
+
+    /**
+     * @brief Authenticates the given batch request and returns the user's answer per feature.
+     *
+     * The default implementation authenticates every feature individually. Implementations
+     * should override it to resolve all features with a single prompt, given that the prompt
+     * presents every feature it covers to the user.
+     *
+     * @param parameters [in] Describe the request.
+     */
+    virtual BatchAnswer authenticate_batch_request_with_parameters(const BatchRequestParameters& parameters);
 };
 
 /** @brief Returns true iff lhs and rhs are equal. */
 CORE_TRUST_DLL_PUBLIC bool operator==(const Agent::RequestParameters& lhs, const Agent::RequestParameters& rhs);
+
+/** @brief Returns true iff lhs and rhs are equal. */
+CORE_TRUST_DLL_PUBLIC bool operator==(const Agent::BatchRequestParameters& lhs, const Agent::BatchRequestParameters& rhs);
 }
 }
 
@@ -0,0 +1,122 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_ASYNC_STORE_H_
+#define CORE_TRUST_ASYNC_STORE_H_
+
+#include <core/trust/request.h>
+#include <core/trust/store.h>
+#include <core/trust/visibility.h>
+
+#include <exception>
+#include <functional>
+#include <memory>
+
+namespace core
+{
+namespace trust
+{
+/**
+ * @brief Models non-blocking read/write/query access to persisted trust requests.
+ *
+ * All operations return immediately and report their outcome to a handler, allowing
+ * for many operations to be in flight at the same time. Handlers receive a null
+ * std::exception_ptr on success, and the error describing the failure otherwise.
+ *
+ * Handlers are invoked on the thread dispatching messages for the underlying connection
+ * and must not block, nor call into the synchronous core::trust::Store interface.
+ */
+class CORE_TRUST_DLL_PUBLIC AsyncStore
+{
+public:
+    /** @brief Invoked with the outcome of an operation. */
+    typedef std::function<void(const std::exception_ptr&)> Handler;
+
+    /**
+     * @brief The Query class encapsulates non-blocking queries against a trust store instance.
+     */
+    class Query
+    {
+    public:
+        /** @brief Invoked with the outcome of an operation and the subsequent status of the query. */
+        typedef std::function<void(const std::exception_ptr&, Store::Query::Status)> StatusHandler;
+
+        /** @brief Invoked with the outcome of an operation and the request the query points to. */
+        typedef std::function<void(const std::exception_ptr&, const Request&)> RequestHandler;
+
+        Query(const Query&) = delete;
+        virtual ~Query() = default;
+
+        /** @brief Access the status of the query. */
+        virtual void status_async(const StatusHandler& handler) = 0;
+
+        /** @brief Limit the query to a specific application Id. */
+        virtual void for_application_id_async(const std::string& id, const Handler& handler) = 0;
+
+        /** @brief Limit the query to a service-specific feature. */
+        virtual void for_feature_async(Feature feature, const Handler& handler) = 0;
+
+        /** @brief Limit the query to the specified time interval. */
+        virtual void for_interval_async(const Request::Timestamp& begin, const Request::Timestamp& end, const Handler& handler) = 0;
+
+        /** @brief Limit the query for a specific answer. */
+        virtual void for_answer_async(Request::Answer answer, const Handler& handler) = 0;
+
+        /** @brief Query all stored requests. */
+        virtual void all_async(const Handler& handler) = 0;
+
+        /** @brief Execute the query against the store, reporting the status of the query after execution. */
+        virtual void execute_async(const StatusHandler& handler) = 0;
+
+        /** @brief After successful execution, advance to the next request and report the new status. */
+        virtual void next_async(const StatusHandler& handler) = 0;
+
+        /** @brief After successful execution, erase the current element, advance to the next request and report the new status. */
+        virtual void erase_async(const StatusHandler& handler) = 0;
+
+        /**
+         * @brief Access the request the query currently points to.
+         *
+         * Reports Store::Query::Errors::NoCurrentResult if the query does not point to a request.
+         */
+        virtual void current_async(const RequestHandler& handler) = 0;
+
+    protected:
+        Query() = default;
+    };
+
+    /** @brief Invoked with the outcome of creating a query and the query itself on success. */
+    typedef std::function<void(const std::exception_ptr&, const std::shared_ptr<Query>&)> QueryHandler;
+
+    AsyncStore(const AsyncStore&) = delete;
+    virtual ~AsyncStore() = default;
+
+    AsyncStore& operator=(const AsyncStore&) = delete;
+    bool operator==(const AsyncStore&) const = delete;
+
+    /** @brief Add the provided request to the store. */
+    virtual void add_async(const Request& request, const Handler& handler) = 0;
+
+    /** @brief Create a query for this store. */
+    virtual void query_async(const QueryHandler& handler) = 0;
+
+protected:
+    AsyncStore() = default;
+};
+}
+}
+
+#endif // CORE_TRUST_ASYNC_STORE_H_
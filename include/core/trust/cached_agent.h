@@ -21,6 +21,12 @@
 
 #include <core/trust/agent.h>
 
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace core
 {
 namespace trust
@@ -47,6 +53,44 @@ public:
         virtual void report_user_prompted_for_trust(const core::trust::Agent::RequestParameters&, const core::trust::Request::Answer&);
     };
 
+    /** @brief Controls when answers obtained from the agent are persisted to the store. */
+    struct Persistence
+    {
+        /** @brief The available persistence modes. */
+        enum class Mode
+        {
+            /** @brief Answers are persisted before they are returned. */
+            synchronous,
+            /**
+             * @brief Answers are returned right away and served from memory until a
+             * background writer persists them, grouping answers into a single store
+             * transaction. Modifications applied to the store while answers are still
+             * pending must be announced via CachedAgent::discard or CachedAgent::flush,
+             * and are overridden by pending answers otherwise.
+             */
+            write_behind
+        };
+
+        /** @brief Persists answers before returning them. */
+        static Persistence synchronous();
+
+        /** @brief Persists answers in the background, flushing on shutdown. */
+        static Persistence write_behind(std::chrono::milliseconds max_delay = std::chrono::milliseconds{5},
+                                        std::size_t max_batch_size = 64);
+
+        /** @brief The persistence mode. */
+        Mode mode;
+        /** @brief Pending answers are persisted no later than max_delay after they have been queued. */
+        std::chrono::milliseconds max_delay;
+        /** @brief Pending answers are persisted as soon as max_batch_size have been queued. */
+        std::size_t max_batch_size;
+        /**
+         * @brief Whether answers still pending when the agent is destroyed are persisted,
+         * or dropped.
+         */
+        bool flush_on_shutdown;
+    };
+
     /** @brief Creation time parameters. */
     struct Configuration
     {
@@ -56,24 +100,65 @@ public:
         std::shared_ptr<Store> store;
         /** @brief The reporter implementation. */
         std::shared_ptr<Reporter> reporter;
+        /** @brief When answers are persisted to the store. */
+        Persistence persistence;
     };
 
     /**
      * @brief CachedAgent creates a new agent instance.
      * @param configuration Specifies the actual agent and the store.
-     * @throws std::logic_error if either the agent or the store are null.
+     * @throws std::logic_error if either the agent or the store are null, or if
+     * write-behind persistence is requested with a batch size of 0.
      */
     CachedAgent(const Configuration& configuration);
     /** @cond */
-    virtual ~CachedAgent() = default;
+    virtual ~CachedAgent();
     /** @endcond */
 
+    /**
+     * @brief Blocks until all answers obtained so far have been handed to the store.
+     *
+     * Returns immediately for synchronous persistence. Answers that the store fails
+     * to persist are dropped, and the user will be prompted again.
+     */
+    void flush();
+
+    /**
+     * @brief Drops all answers not yet persisted that match filter.
+     *
+     * Blocks until the store received answers that are being persisted right
+     * now, such that a subsequent removal of requests from the store is neither
+     * overridden by pending answers nor undone by the background writer. Returns
+     * immediately for synchronous persistence.
+     */
+    void discard(const std::function<bool(const Request&)>& filter);
+
+    /** @brief Drops all answers not yet persisted, see discard. */
+    void discard_all();
+
     /** @brief From core::trust::Agent. */
     Request::Answer authenticate_request_with_parameters(const core::trust::Agent::RequestParameters& parameters) override;
 
+    /**
+     * @brief From core::trust::Agent.
+     *
+     * Resolves all features with a single store query and hands all features
+     * that lack a cached answer to the agent in a single batch request.
+     */
+    BatchAnswer authenticate_batch_request_with_parameters(const core::trust::Agent::BatchRequestParameters& parameters) override;
+
 private:
+    /** @cond */
+    struct WriteBehind;
+    /** @endcond */
+
+    /** @brief Hands requests to the store, or queues them for the background writer. */
+    void persist(const std::vector<Request>& requests);
+
     /** @brief We just store a copy of the configuration parameters */
     Configuration configuration;
+    /** @brief Pending answers and the background writer, null for synchronous persistence. */
+    std::unique_ptr<WriteBehind> write_behind;
 };
 }
 }
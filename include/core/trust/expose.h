@@ -21,6 +21,7 @@
 
 #include <core/trust/visibility.h>
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -49,8 +50,14 @@ protected:
     Token() = default;
 };
 
+/** @brief The number of worker threads handling method calls on an exposed store by default. */
+constexpr const std::size_t default_store_worker_count{4};
+
 /**
  * @brief Exposes an existing store instance on the given bus.
+ *
+ * Method calls are handled by default_store_worker_count worker threads.
+ *
  * @throw Error::ServiceNameMustNotBeEmpty.
  * @param store The instance to be exposed.
  * @param bus The bus connection.
@@ -62,6 +69,27 @@ CORE_TRUST_DLL_PUBLIC std::unique_ptr<Token> expose_store_to_bus_with_name(
         const std::shared_ptr<core::dbus::Bus>& bus,
         const std::string& name);
 
+/**
+ * @brief Exposes an existing store instance on the given bus, handling method calls on a pool of worker threads.
+ *
+ * Calls modifying the store are handled one after the other, in the order they arrived.
+ * Calls on different query objects are handled in parallel, while calls on the same
+ * query object are handled in the order they arrived.
+ *
+ * @throw Error::ServiceNameMustNotBeEmpty.
+ * @throw std::invalid_argument if worker_count is 0.
+ * @param store The instance to be exposed. Has to tolerate queries being used concurrently.
+ * @param bus The bus connection.
+ * @param name The name under which the service can be found within the session.
+ * @param worker_count The number of worker threads handling method calls.
+ * @return A token that limits the lifetime of the exposure.
+ */
+CORE_TRUST_DLL_PUBLIC std::unique_ptr<Token> expose_store_to_bus_with_name(
+        const std::shared_ptr<Store>& store,
+        const std::shared_ptr<core::dbus::Bus>& bus,
+        const std::string& name,
+        std::size_t worker_count);
+
 /**
  * @brief Exposes an existing store instance with the current user session.
  * @throw Error::ServiceNameMustNotBeEmpty.
@@ -21,6 +21,7 @@
 
 #include <core/trust/visibility.h>
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -33,6 +34,7 @@ class Bus;
 namespace trust
 {
 // Forward declarations
+class AsyncStore;
 class Store;
 
 /**
@@ -54,6 +56,59 @@ CORE_TRUST_DLL_PUBLIC std::shared_ptr<Store> resolve_store_on_bus_with_name(
  */
 CORE_TRUST_DLL_PUBLIC std::shared_ptr<Store> resolve_store_in_session_with_name(
         const std::string& name);
+
+/** @brief The default number of query results remembered by caching stores. */
+constexpr const std::size_t default_store_cache_capacity{64};
+
+/**
+ * @brief Resolves an existing store instance, serving query results from a local cache.
+ *
+ * The cache is invalidated precisely by the change notifications emitted by the store,
+ * such that repeated queries do not cause any bus traffic unless the store changes.
+ *
+ * @throw Error::ServiceNameMustNotBeEmpty.
+ * @throw std::invalid_argument if capacity is 0.
+ * @param bus The bus connection.
+ * @param name The name under which the service can be found on the bus.
+ * @param capacity The maximum number of query results remembered.
+ * @return A Store instance caching query results.
+ */
+CORE_TRUST_DLL_PUBLIC std::shared_ptr<Store> resolve_caching_store_on_bus_with_name(
+        const std::shared_ptr<core::dbus::Bus>& bus,
+        const std::string& name,
+        std::size_t capacity = default_store_cache_capacity);
+
+/**
+ * @brief Resolves an existing store instance within the current user session, serving query results from a local cache.
+ * @throw Error::ServiceNameMustNotBeEmpty.
+ * @throw std::invalid_argument if capacity is 0.
+ * @param name The name under which the service can be found within the session.
+ * @param capacity The maximum number of query results remembered.
+ * @return A Store instance caching query results.
+ */
+CORE_TRUST_DLL_PUBLIC std::shared_ptr<Store> resolve_caching_store_in_session_with_name(
+        const std::string& name,
+        std::size_t capacity = default_store_cache_capacity);
+
+/**
+ * @brief Resolves an existing store instance for non-blocking access.
+ * @throw Error::ServiceNameMustNotBeEmpty.
+ * @param bus The bus connection.
+ * @param name The name under which the service can be found on the bus.
+ * @return An AsyncStore instance issuing all calls without blocking the caller.
+ */
+CORE_TRUST_DLL_PUBLIC std::shared_ptr<AsyncStore> resolve_async_store_on_bus_with_name(
+        const std::shared_ptr<core::dbus::Bus>& bus,
+        const std::string& name);
+
+/**
+ * @brief Resolves an existing store instance within the current user session for non-blocking access.
+ * @throw Error::ServiceNameMustNotBeEmpty.
+ * @param name The name under which the service can be found within the session.
+ * @return An AsyncStore instance issuing all calls without blocking the caller.
+ */
+CORE_TRUST_DLL_PUBLIC std::shared_ptr<AsyncStore> resolve_async_store_in_session_with_name(
+        const std::string& name);
 }
 }
 
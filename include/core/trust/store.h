@@ -23,9 +23,12 @@
 #include <core/trust/tagged_integer.h>
 #include <core/trust/visibility.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <stdexcept>
+#include <vector>
 
 namespace core
 {
@@ -78,6 +81,57 @@ public:
             }
         };
 
+        /**
+         * @brief Thrown if a store implementation could not export its requests.
+         */
+        struct ErrorExportingStore : public std::runtime_error
+        {
+            ErrorExportingStore(const char* implementation_specific)
+                : std::runtime_error(implementation_specific)
+            {
+            }
+        };
+
+        /**
+         * @brief Thrown if a store implementation could not import requests, e.g., from a corrupted stream.
+         */
+        struct ErrorImportingStore : public std::runtime_error
+        {
+            ErrorImportingStore(const char* implementation_specific)
+                : std::runtime_error(implementation_specific)
+            {
+            }
+        };
+
+        /**
+         * @brief Thrown when trying to modify a read-only store.
+         */
+        struct StoreIsReadOnly : public std::runtime_error
+        {
+            StoreIsReadOnly() : std::runtime_error("Store is read-only and cannot be modified.")
+            {
+            }
+        };
+
+    };
+
+    /**
+     * @brief Aggregates all requests recorded for an application and a feature.
+     */
+    struct Statistics
+    {
+        /** @brief The application that issued the requests. */
+        std::string application_id;
+        /** @brief The feature that the requests referred to. */
+        Feature feature;
+        /** @brief The number of requests that have been granted. */
+        std::uint64_t granted;
+        /** @brief The number of requests that have been denied. */
+        std::uint64_t denied;
+        /** @brief The timestamp of the oldest request. */
+        Request::Timestamp first;
+        /** @brief The timestamp of the most recent request. */
+        Request::Timestamp last;
     };
 
     /**
@@ -140,6 +194,15 @@ public:
         /** @brief Limit the query for a specific answer. */
         virtual void for_answer(Request::Answer answer) = 0;
 
+        /**
+         * @brief Limit the query to the given number of most recent results.
+         *
+         * Implementations stop producing results once count of them have been visited. The
+         * default implementation ignores the limit, and callers must thus not rely on queries
+         * yielding no more than count results.
+         */
+        virtual void limit(std::size_t count);
+
         /** @brief Query all stored requests. */
         virtual void all() = 0;
 
@@ -152,9 +215,36 @@ public:
         /** @brief After successful execution, erase the current element and advance to the next request. */
         virtual void erase() = 0;
 
+        /**
+         * @brief Erase all requests matching the limits of the query, leaving the query in state eor.
+         *
+         * The query does not need to be executed before. Implementations erase all requests
+         * with a single statement if possible. The default implementation executes the query
+         * and erases the results one by one.
+         */
+        virtual void erase_all();
+
         /** @brief Access the request the query currently points to. */
         virtual Request current() = 0;
 
+        /**
+         * @brief Returns the number of results of the query, without visiting them.
+         *
+         * The query does not need to be executed before. Implementations count the results
+         * without moving the cursor of the query if possible. The default implementation
+         * executes the query and visits all results.
+         */
+        virtual std::size_t count();
+
+        /**
+         * @brief Returns true if the query has at least one result.
+         *
+         * The query does not need to be executed before. Implementations check for results
+         * without moving the cursor of the query if possible. The default implementation
+         * executes the query.
+         */
+        virtual bool exists();
+
     protected:
         Query() = default;
     };
@@ -175,16 +265,87 @@ public:
       */
     virtual void add(const Request& request) = 0;
 
+    /**
+     * @brief Add all provided requests to the store, in order.
+     *
+     * Implementations persist the requests as a group if possible, e.g., with a single
+     * transaction. The default implementation adds the requests one by one.
+     */
+    virtual void add_all(const std::vector<Request>& requests);
+
+    /**
+     * @brief Reads the next request into request, returning false once all requests have been read.
+     */
+    typedef std::function<bool(Request& request)> RequestSource;
+
+    /**
+     * @brief Add all requests read from source to the store, in order, and return their number.
+     *
+     * Implementations stream the requests into the store as a whole if possible, e.g., with
+     * chunked inserts inside a single transaction. If defer_indices is true, implementations
+     * rebuild their indices once all requests have been read instead of maintaining them for
+     * every single request, which pays off for large numbers of requests. The default
+     * implementation adds the requests in groups via add_all.
+     */
+    virtual std::size_t load(const RequestSource& source, bool defer_indices);
+
     /**
      * @brief Remove all requests issued by the given application.
      */
     virtual void remove_application(const std::string& id) = 0;
 
+    /**
+     * @brief Remove all requests for the given feature, issued by any application.
+     *
+     * The default implementation erases all results of a query limited to the feature.
+     */
+    virtual void remove_feature(Feature feature);
+
+    /**
+     * @brief Remove all requests issued before the given point in time.
+     *
+     * The default implementation erases all results of a query limited to the interval
+     * preceding timestamp.
+     */
+    virtual void remove_older_than(const Request::Timestamp& timestamp);
+
     /**
      * @brief Create a query for this store.
      */
     virtual std::shared_ptr<Query> query() = 0;
 
+    /**
+     * @brief Returns statistics for every application and feature with recorded requests,
+     * ordered by application id and feature.
+     *
+     * Implementations maintain the statistics incrementally if possible. The default
+     * implementation aggregates the results of a query for all requests.
+     */
+    virtual std::vector<Statistics> statistics();
+
+    /**
+     * @brief Write all requests in the store to fd and return their number.
+     *
+     * Requests are streamed in a versioned binary format made up of length-prefixed
+     * and checksummed records, with app ids being dictionary encoded. fd stays owned
+     * by the caller. The default implementation encodes the results of a query for
+     * all requests.
+     *
+     * @throws Errors::ErrorExportingStore if the requests could not be written.
+     */
+    virtual std::size_t export_to(int fd);
+
+    /**
+     * @brief Add all requests read from fd, as written by export_to, to the store and return their number.
+     *
+     * fd stays owned by the caller. See load for the meaning of defer_indices. The default
+     * implementation decodes requests while loading them.
+     *
+     * @throws Errors::ErrorImportingStore if the stream is truncated, corrupted, or of an
+     * unsupported version, or if the requests could not be added.
+     */
+    virtual std::size_t import_from(int fd, bool defer_indices);
+
 protected:
     Store() = default;
 };
@@ -210,11 +371,45 @@ struct Errors
 
 /**
   * @brief Creates an instance for the default store implementation.
+  *
+  * The implementation is selected by the environment variable CORE_TRUST_STORE_BACKEND,
+  * naming one of the backends known to create_store_for_backend. Defaults to "sqlite".
+  *
   * @throw Error::ServiceNameMustNotBeEmpty.
+  * @throw std::invalid_argument if CORE_TRUST_STORE_BACKEND names an unknown backend.
   * @param service_name [in] The service name, must not be empty.
   * @return An instance of trust::Store.
   */
 CORE_TRUST_DLL_PUBLIC std::shared_ptr<Store> create_default_store(const std::string& service_name);
+
+/**
+  * @brief Creates an instance of the store implementation known as backend.
+  *
+  * Known backends are:
+  *   - "sqlite": Persists requests in an sqlite3 database.
+  *   - "log_structured": Persists requests in an append-only log, indexed in memory.
+  *
+  * @throw Error::ServiceNameMustNotBeEmpty.
+  * @throw std::invalid_argument if backend is unknown.
+  * @param backend [in] The name of the store implementation.
+  * @param service_name [in] The service name, must not be empty.
+  * @return An instance of trust::Store.
+  */
+CORE_TRUST_DLL_PUBLIC std::shared_ptr<Store> create_store_for_backend(const std::string& backend, const std::string& service_name);
+
+/**
+  * @brief Opens the store of a service for reading within the calling process.
+  *
+  * The store accesses the trust database of the service directly, without any
+  * IPC. The database has to exist already, and the calling process needs permission
+  * to read it. All modifications throw Store::Errors::StoreIsReadOnly.
+  *
+  * @throw Error::ServiceNameMustNotBeEmpty.
+  * @throw Store::Errors::ErrorOpeningStore if the database cannot be opened.
+  * @param service_name [in] The service name, must not be empty.
+  * @return An instance of trust::Store.
+  */
+CORE_TRUST_DLL_PUBLIC std::shared_ptr<Store> create_read_only_store(const std::string& service_name);
 }
 }
 
@@ -23,3 +23,29 @@ bool core::trust::operator==(const core::trust::Agent::RequestParameters& lhs, c
     return std::tie(lhs.application.id, lhs.application.pid, lhs.application.uid, lhs.description, lhs.feature) ==
            std::tie(rhs.application.id, rhs.application.pid, rhs.application.uid, rhs.description, rhs.feature);
 }
+
+bool core::trust::operator==(const core::trust::Agent::BatchRequestParameters& lhs, const core::trust::Agent::BatchRequestParameters& rhs)
+{
+    return std::tie(lhs.application.id, lhs.application.pid, lhs.application.uid, lhs.description, lhs.features) ==
+           std::tie(rhs.application.id, rhs.application.pid, rhs.application.uid, rhs.description, rhs.features);
+}
+
+core::trust::Agent::BatchAnswer core::trust::Agent::authenticate_batch_request_with_parameters(
+        const core::trust::Agent::BatchRequestParameters& parameters)
+{
+    core::trust::Agent::BatchAnswer answers;
+
+    for (const auto& feature : parameters.features)
+    {
+        answers[feature] = authenticate_request_with_parameters(core::trust::Agent::RequestParameters
+        {
+            parameters.application.uid,
+            parameters.application.pid,
+            parameters.application.id,
+            feature,
+            parameters.description
+        });
+    }
+
+    return answers;
+}
@@ -29,13 +29,12 @@ core::trust::AppIdFormattingTrustAgent::AppIdFormattingTrustAgent(const std::sha
     };
 }
 
-// From core::trust::Agent
-core::trust::Request::Answer core::trust::AppIdFormattingTrustAgent::authenticate_request_with_parameters(const core::trust::Agent::RequestParameters& incoming_params)
+namespace
+{
+// We post-process the application id and try to extract the unversioned package name.
+// Please see https://wiki.ubuntu.com/AppStore/Interfaces/ApplicationId.
+std::string format_app_id(const std::string& app_id)
 {
-    auto params = incoming_params;
-
-    // We post-process the application id and try to extract the unversioned package name.
-    // Please see https://wiki.ubuntu.com/AppStore/Interfaces/ApplicationId.
     static const std::regex regex{"(.*)_(.*)_(.*)"};
     static constexpr std::size_t index_package{1};
     static constexpr std::size_t index_app{2};
@@ -45,10 +44,27 @@ core::trust::Request::Answer core::trust::AppIdFormattingTrustAgent::authenticat
 
     // See if the application id matches the pattern described in
     // https://wiki.ubuntu.com/AppStore/Interfaces/ApplicationId
-    if (std::regex_match(params.application.id, match, regex))
-    {
-        params.application.id = std::string{match[index_package]} + "_" + std::string{match[index_app]};
-    }
+    if (std::regex_match(app_id, match, regex))
+        return std::string{match[index_package]} + "_" + std::string{match[index_app]};
+
+    return app_id;
+}
+}
+
+// From core::trust::Agent
+core::trust::Request::Answer core::trust::AppIdFormattingTrustAgent::authenticate_request_with_parameters(const core::trust::Agent::RequestParameters& incoming_params)
+{
+    auto params = incoming_params;
+    params.application.id = format_app_id(params.application.id);
 
     return impl->authenticate_request_with_parameters(params);
 }
+
+// From core::trust::Agent
+core::trust::Agent::BatchAnswer core::trust::AppIdFormattingTrustAgent::authenticate_batch_request_with_parameters(const core::trust::Agent::BatchRequestParameters& incoming_params)
+{
+    auto params = incoming_params;
+    params.application.id = format_app_id(params.application.id);
+
+    return impl->authenticate_batch_request_with_parameters(params);
+}
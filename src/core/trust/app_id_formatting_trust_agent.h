@@ -35,6 +35,7 @@ public:
 
     // From core::trust::Agent
     Request::Answer authenticate_request_with_parameters(const RequestParameters& parameters) override;
+    BatchAnswer authenticate_batch_request_with_parameters(const BatchRequestParameters& parameters) override;
 
 private:
     std::shared_ptr<Agent> impl;
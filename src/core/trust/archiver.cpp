@@ -0,0 +1,179 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/archiver.h>
+
+#include <core/trust/resolve.h>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace Options = boost::program_options;
+
+namespace
+{
+// Parses the options shared by both executables, in addition to options, into vm.
+void parse(int argc, const char** argv, Options::options_description& options, Options::variables_map& vm)
+{
+    options.add_options()
+            (core::trust::Archiver::Parameters::ForService::name, Options::value<std::string>()->required(), core::trust::Archiver::Parameters::ForService::description)
+            (core::trust::Archiver::Parameters::Remote::name, Options::bool_switch()->default_value(false), core::trust::Archiver::Parameters::Remote::description);
+
+    Options::command_line_parser parser
+    {
+        argc,
+        argv
+    };
+
+    auto parsed_options = parser.options(options).allow_unregistered().run();
+    Options::store(parsed_options, vm);
+    Options::notify(vm);
+}
+
+// Returns the store selected by vm.
+std::shared_ptr<core::trust::Store> store_for(const Options::variables_map& vm)
+{
+    auto service_name = vm[core::trust::Archiver::Parameters::ForService::name].as<std::string>();
+
+    if (vm[core::trust::Archiver::Parameters::Remote::name].as<bool>())
+        return core::trust::resolve_store_in_session_with_name(service_name);
+
+    return core::trust::create_default_store(service_name);
+}
+
+// Opens path with flags, or returns fallback for '-'. Throws std::system_error on failure.
+int open_or_throw(const std::string& path, int flags, int fallback)
+{
+    if (path == "-")
+        return fallback;
+
+    // Exports reveal the trust decisions of the user, and we keep them private.
+    auto fd = ::open(path.c_str(), flags | O_CLOEXEC, S_IRUSR | S_IWUSR);
+
+    if (fd == -1)
+        throw std::system_error(errno, std::system_category(), "Could not open " + path);
+
+    return fd;
+}
+
+// Reports the number of requests transferred within the time elapsed since start.
+void report(const std::string& what, std::size_t count, std::chrono::steady_clock::time_point start)
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    // Guard against dividing by zero for small stores.
+    auto rate = count * 1000 / std::max<std::chrono::milliseconds::rep>(elapsed.count(), 1);
+
+    // Exports might go to stdout, and we thus report on stderr.
+    std::cerr << what << " " << count << " requests in " << elapsed.count() << " ms (" << rate << " requests/s)" << std::endl;
+}
+}
+
+core::trust::Archiver::Export::Configuration core::trust::Archiver::Export::Configuration::parse_from_command_line(int argc, const char** argv)
+{
+    Options::variables_map vm;
+
+    Options::options_description options{"Known options"};
+    options.add_options()
+            (Parameters::Output::name, Options::value<std::string>()->default_value("-"), Parameters::Output::description);
+
+    parse(argc, argv, options, vm);
+
+    return core::trust::Archiver::Export::Configuration
+    {
+        store_for(vm),
+        vm[Parameters::Output::name].as<std::string>()
+    };
+}
+
+core::posix::exit::Status core::trust::Archiver::Export::main(const core::trust::Archiver::Export::Configuration& configuration)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    int fd{-1};
+
+    try
+    {
+        fd = open_or_throw(configuration.output, O_WRONLY | O_CREAT | O_TRUNC, STDOUT_FILENO);
+        auto count = configuration.store->export_to(fd);
+
+        if (fd != STDOUT_FILENO && ::close(fd) == -1)
+            throw std::system_error(errno, std::system_category(), "Could not close " + configuration.output);
+
+        report("Exported", count, start);
+    } catch(const std::runtime_error& e)
+    {
+        if (fd != -1 && fd != STDOUT_FILENO)
+            ::close(fd);
+
+        std::cerr << "Could not export trust store: " << e.what() << std::endl;
+        return core::posix::exit::Status::failure;
+    }
+
+    return core::posix::exit::Status::success;
+}
+
+core::trust::Archiver::Import::Configuration core::trust::Archiver::Import::Configuration::parse_from_command_line(int argc, const char** argv)
+{
+    Options::variables_map vm;
+
+    Options::options_description options{"Known options"};
+    options.add_options()
+            (Parameters::Input::name, Options::value<std::string>()->default_value("-"), Parameters::Input::description)
+            (Parameters::BulkLoad::name, Options::bool_switch()->default_value(false), Parameters::BulkLoad::description);
+
+    parse(argc, argv, options, vm);
+
+    return core::trust::Archiver::Import::Configuration
+    {
+        store_for(vm),
+        vm[Parameters::Input::name].as<std::string>(),
+        vm[Parameters::BulkLoad::name].as<bool>()
+    };
+}
+
+core::posix::exit::Status core::trust::Archiver::Import::main(const core::trust::Archiver::Import::Configuration& configuration)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    int fd{-1};
+
+    try
+    {
+        fd = open_or_throw(configuration.input, O_RDONLY, STDIN_FILENO);
+        auto count = configuration.store->import_from(fd, configuration.bulk_load);
+
+        if (fd != STDIN_FILENO)
+            ::close(fd);
+
+        report("Imported", count, start);
+    } catch(const std::runtime_error& e)
+    {
+        if (fd != -1 && fd != STDIN_FILENO)
+            ::close(fd);
+
+        std::cerr << "Could not import into trust store: " << e.what() << std::endl;
+        return core::posix::exit::Status::failure;
+    }
+
+    return core::posix::exit::Status::success;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_ARCHIVER_H_
+#define CORE_TRUST_ARCHIVER_H_
+
+#include <core/trust/store.h>
+
+#include <core/posix/exit.h>
+
+#include <memory>
+#include <string>
+
+namespace core
+{
+namespace trust
+{
+// Helper executables for backing up, migrating and cloning service specific trust stores.
+// Invoke them with:
+//   trust-store-export --for-service MyFunkyServiceName --output backup.bin
+//   trust-store-import --for-service MyFunkyServiceName --input backup.bin
+// Please see core::trust::Store::export_to for a description of the stream format. Both
+// executables read from stdin or write to stdout for '-', and access the store directly
+// unless --remote is given, in which case they go through the trust-stored instance
+// exposing the store in the current session.
+struct Archiver
+{
+    // Command-line parameters, their name and their description
+    struct Parameters
+    {
+        Parameters() = delete;
+
+        struct ForService
+        {
+            static constexpr const char* name{"for-service"};
+            static constexpr const char* description{"The name of the service to handle trust for."};
+        };
+
+        struct Remote
+        {
+            static constexpr const char* name{"remote"};
+            static constexpr const char* description{"Access the store via the trust-stored instance exposing it in the session."};
+        };
+
+        struct Output
+        {
+            static constexpr const char* name{"output"};
+            static constexpr const char* description{"The file requests should be exported to, or '-' for stdout."};
+        };
+
+        struct Input
+        {
+            static constexpr const char* name{"input"};
+            static constexpr const char* description{"The file requests should be imported from, or '-' for stdin."};
+        };
+
+        struct BulkLoad
+        {
+            static constexpr const char* name{"bulk-load"};
+            static constexpr const char* description{"Defer building indices until all requests have been imported, for large inputs."};
+        };
+    };
+
+    // Exports all requests of a store.
+    struct Export
+    {
+        // Parameters for execution of the export executable.
+        struct Configuration
+        {
+            // Parses command line args and produces a configuration
+            static Configuration parse_from_command_line(int argc, const char** argv);
+            // The store that requests should be exported from.
+            std::shared_ptr<Store> store;
+            // The file requests should be exported to, or '-' for stdout.
+            std::string output;
+        };
+
+        static core::posix::exit::Status main(const Configuration& configuration);
+    };
+
+    // Imports requests into a store.
+    struct Import
+    {
+        // Parameters for execution of the import executable.
+        struct Configuration
+        {
+            // Parses command line args and produces a configuration
+            static Configuration parse_from_command_line(int argc, const char** argv);
+            // The store that requests should be imported into.
+            std::shared_ptr<Store> store;
+            // The file requests should be imported from, or '-' for stdin.
+            std::string input;
+            // True if the store should defer building indices until all requests have been imported.
+            bool bulk_load;
+        };
+
+        static core::posix::exit::Status main(const Configuration& configuration);
+    };
+};
+}
+}
+
+#endif // CORE_TRUST_ARCHIVER_H_
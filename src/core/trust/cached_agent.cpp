@@ -20,6 +20,212 @@
 
 #include <core/trust/store.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+// Queues answers for a background writer persisting them in groups, and serves
+// queued answers until they made it to the store.
+struct core::trust::CachedAgent::WriteBehind
+{
+    WriteBehind(const std::shared_ptr<core::trust::Store>& store, const core::trust::CachedAgent::Persistence& persistence)
+        : store{store},
+          persistence(persistence),
+          writer{[this]() { run(); }}
+    {
+    }
+
+    ~WriteBehind()
+    {
+        {
+            std::lock_guard<std::mutex> lg(guard);
+            stopping = true;
+        }
+
+        wakeup.notify_all();
+
+        if (writer.joinable())
+            writer.join();
+    }
+
+    // Returns true and the most recent pending request for app_id and feature in request, if any.
+    bool lookup(const std::string& app_id, core::trust::Feature feature, core::trust::Request& request)
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        auto it = pending.find(std::make_pair(app_id, feature.value));
+        if (it == pending.end())
+            return false;
+
+        request = it->second;
+        return true;
+    }
+
+    // Queues requests for the writer.
+    void enqueue(const std::vector<core::trust::Request>& requests)
+    {
+        {
+            std::lock_guard<std::mutex> lg(guard);
+
+            for (const auto& request : requests)
+            {
+                queue.push_back(std::make_pair(++enqueued, request));
+                pending[std::make_pair(request.from, request.feature.value)] = request;
+            }
+        }
+
+        wakeup.notify_all();
+    }
+
+    // Blocks until the writer handled all requests queued so far.
+    void flush()
+    {
+        std::unique_lock<std::mutex> ul(guard);
+
+        auto target = enqueued;
+        flush_requested = true;
+        wakeup.notify_all();
+
+        persisted.wait(ul, [this, target]() { return handled(target); });
+    }
+
+    // Drops all queued requests matching filter, and blocks until the writer
+    // handed the group it might be persisting right now to the store.
+    void discard(const std::function<bool(const core::trust::Request&)>& filter)
+    {
+        std::unique_lock<std::mutex> ul(guard);
+
+        queue.erase(std::remove_if(queue.begin(), queue.end(), [&filter](const std::pair<std::uint64_t, core::trust::Request>& queued)
+        {
+            return filter(queued.second);
+        }), queue.end());
+
+        for (auto it = pending.begin(); it != pending.end();)
+        {
+            if (filter(it->second))
+                it = pending.erase(it);
+            else
+                ++it;
+        }
+
+        // Callers flushing might have been waiting for discarded requests.
+        persisted.notify_all();
+
+        if (not in_flight.empty())
+        {
+            auto target = in_flight.back();
+            persisted.wait(ul, [this, target]() { return handled(target); });
+        }
+    }
+
+    // Returns true if no request with a sequence number up to target is queued or
+    // being persisted. Requests are handed to the writer in order, i.e., the group
+    // being persisted precedes all queued requests.
+    bool handled(std::uint64_t target) const
+    {
+        if (not in_flight.empty())
+            return in_flight.front() > target;
+
+        return queue.empty() || queue.front().first > target;
+    }
+
+    // The writer waits for the first request of a group, and persists the group after
+    // max_delay, after max_batch_size requests have been queued or if asked to flush.
+    void run()
+    {
+        std::unique_lock<std::mutex> ul(guard);
+
+        while (true)
+        {
+            wakeup.wait(ul, [this]() { return stopping || not queue.empty(); });
+
+            if (queue.empty() || (stopping && not persistence.flush_on_shutdown))
+                break;
+
+            wakeup.wait_for(ul, persistence.max_delay, [this]()
+            {
+                return stopping || flush_requested || queue.size() >= persistence.max_batch_size;
+            });
+
+            // Requests might have been discarded while waiting.
+            if (queue.empty())
+                continue;
+
+            std::vector<core::trust::Request> group;
+            for (const auto& queued : queue)
+            {
+                in_flight.push_back(queued.first);
+                group.push_back(queued.second);
+            }
+            queue.clear();
+            flush_requested = false;
+
+            ul.unlock();
+
+            try
+            {
+                store->add_all(group);
+            } catch(const std::exception& e)
+            {
+                std::cerr << "Failed to persist " << group.size() << " answers: " << e.what() << std::endl;
+            } catch(...)
+            {
+                std::cerr << "Failed to persist " << group.size() << " answers." << std::endl;
+            }
+
+            ul.lock();
+
+            // Persisted requests are answered from the store from now on, unless
+            // more recent answers have been queued in the meantime.
+            for (const auto& request : group)
+            {
+                auto it = pending.find(std::make_pair(request.from, request.feature.value));
+                if (it != pending.end() && it->second.when == request.when)
+                    pending.erase(it);
+            }
+
+            in_flight.clear();
+            persisted.notify_all();
+        }
+    }
+
+    std::shared_ptr<core::trust::Store> store;
+    core::trust::CachedAgent::Persistence persistence;
+
+    std::mutex guard;
+    // Wakes up the writer.
+    std::condition_variable wakeup;
+    // Signals that the writer handled a group of requests.
+    std::condition_variable persisted;
+    // Requests to be handed to the store, in order and by sequence number.
+    std::vector<std::pair<std::uint64_t, core::trust::Request>> queue;
+    // The sequence numbers of the requests being persisted right now, in order.
+    std::vector<std::uint64_t> in_flight;
+    // The most recent request queued or being persisted, by application id and feature.
+    std::map<std::pair<std::string, std::uint64_t>, core::trust::Request> pending;
+    // The sequence number of the request queued most recently.
+    std::uint64_t enqueued{0};
+    bool flush_requested{false};
+    bool stopping{false};
+
+    // Declared last, the writer accesses all of the above.
+    std::thread writer;
+};
+
+core::trust::CachedAgent::Persistence core::trust::CachedAgent::Persistence::synchronous()
+{
+    return Persistence{Mode::synchronous, std::chrono::milliseconds{0}, 1, false};
+}
+
+core::trust::CachedAgent::Persistence core::trust::CachedAgent::Persistence::write_behind(std::chrono::milliseconds max_delay, std::size_t max_batch_size)
+{
+    return Persistence{Mode::write_behind, max_delay, max_batch_size, true};
+}
+
 void core::trust::CachedAgent::Reporter::report_cached_answer_found(const core::trust::Agent::RequestParameters&, const core::trust::Request&)
 {
 }
@@ -41,18 +247,69 @@ core::trust::CachedAgent::CachedAgent(const core::trust::CachedAgent::Configurat
     {
         "Cannot operate without a store implementation."
     };
+
+    if (configuration.persistence.mode == Persistence::Mode::write_behind)
+    {
+        if (configuration.persistence.max_batch_size == 0) throw std::logic_error
+        {
+            "Cannot persist answers in batches of size 0."
+        };
+
+        write_behind.reset(new WriteBehind{configuration.store, configuration.persistence});
+    }
+}
+
+core::trust::CachedAgent::~CachedAgent()
+{
+}
+
+void core::trust::CachedAgent::flush()
+{
+    if (write_behind)
+        write_behind->flush();
+}
+
+void core::trust::CachedAgent::discard(const std::function<bool(const core::trust::Request&)>& filter)
+{
+    if (write_behind)
+        write_behind->discard(filter);
+}
+
+void core::trust::CachedAgent::discard_all()
+{
+    discard([](const core::trust::Request&) { return true; });
+}
+
+void core::trust::CachedAgent::persist(const std::vector<core::trust::Request>& requests)
+{
+    if (write_behind)
+        write_behind->enqueue(requests);
+    else if (requests.size() == 1)
+        configuration.store->add(requests.front());
+    else
+        configuration.store->add_all(requests);
 }
 
 // From core::trust::Agent
 core::trust::Request::Answer core::trust::CachedAgent::authenticate_request_with_parameters(
         const core::trust::Agent::RequestParameters& params)
 {
+    // Answers not yet persisted are the most recent ones.
+    core::trust::Request pending;
+    if (write_behind && write_behind->lookup(params.application.id, params.feature, pending))
+    {
+        configuration.reporter->report_cached_answer_found(params, pending);
+        return pending.answer;
+    }
+
     // Let's see if the store has an answer for app-id and feature.
     auto query = configuration.store->query();
 
     // Narrow it down to the specific app and the specific feature
     query->for_application_id(params.application.id);
     query->for_feature(params.feature);
+    // Only the most recent answer is of interest.
+    query->limit(1);
 
     query->execute();
 
@@ -79,13 +336,121 @@ core::trust::Request::Answer core::trust::CachedAgent::authenticate_request_with
     // Tell the reporter that the user was successfully prompted for an answer.
     configuration.reporter->report_user_prompted_for_trust(params, answer);
 
-    configuration.store->add(core::trust::Request
+    persist(
     {
-        params.application.id,
-        params.feature,
-        std::chrono::system_clock::now(),
-        answer
+        core::trust::Request
+        {
+            params.application.id,
+            params.feature,
+            std::chrono::system_clock::now(),
+            answer
+        }
     });
 
     return answer;
 }
+
+// From core::trust::Agent
+core::trust::Agent::BatchAnswer core::trust::CachedAgent::authenticate_batch_request_with_parameters(
+        const core::trust::Agent::BatchRequestParameters& params)
+{
+    // Assembles the single-feature parameters handed to the reporter.
+    auto params_for_feature = [&params](const core::trust::Feature& feature)
+    {
+        return core::trust::Agent::RequestParameters
+        {
+            params.application.uid,
+            params.application.pid,
+            params.application.id,
+            feature,
+            params.description
+        };
+    };
+
+    core::trust::Agent::BatchAnswer answers;
+
+    // Answers not yet persisted are the most recent ones.
+    core::trust::Request pending;
+    for (const auto& feature : params.features)
+    {
+        if (write_behind && write_behind->lookup(params.application.id, feature, pending))
+        {
+            configuration.reporter->report_cached_answer_found(params_for_feature(feature), pending);
+            answers[feature] = pending.answer;
+        }
+    }
+
+    // We run a single query for the app id and pick the answers for all requested
+    // features from the result set. Results are ordered by descending timestamp, and
+    // the first hit for a feature thus is the most recent one.
+    auto query = configuration.store->query();
+    query->for_application_id(params.application.id);
+    query->execute();
+
+    while (query->status() == core::trust::Store::Query::Status::has_more_results &&
+           answers.size() < params.features.size())
+    {
+        auto request = query->current();
+
+        if (params.features.count(request.feature) > 0 && answers.count(request.feature) == 0)
+        {
+            // Tell the reporter that we found a cached answer.
+            configuration.reporter->report_cached_answer_found(params_for_feature(request.feature), request);
+            answers[request.feature] = request.answer;
+        }
+
+        query->next();
+    }
+
+    core::trust::Agent::BatchRequestParameters misses
+    {
+        {
+            params.application.uid,
+            params.application.pid,
+            params.application.id
+        },
+        {},
+        params.description
+    };
+
+    for (const auto& feature : params.features)
+        if (answers.count(feature) == 0)
+            misses.features.insert(feature);
+
+    // Everything has been resolved from the cache, returning early.
+    if (misses.features.empty())
+        return answers;
+
+    // We ask the agent once for all features lacking an answer.
+    auto prompted = configuration.agent->authenticate_batch_request_with_parameters(misses);
+
+    std::vector<core::trust::Request> requests;
+
+    for (const auto& feature : misses.features)
+    {
+        auto it = prompted.find(feature);
+
+        if (it == prompted.end()) throw std::logic_error
+        {
+            "Agent implementation did not answer for all requested features."
+        };
+
+        // Tell the reporter that the user was successfully prompted for an answer.
+        configuration.reporter->report_user_prompted_for_trust(params_for_feature(feature), it->second);
+
+        requests.push_back(core::trust::Request
+        {
+            params.application.id,
+            feature,
+            std::chrono::system_clock::now(),
+            it->second
+        });
+
+        answers[feature] = it->second;
+    }
+
+    // All answers are persisted together.
+    persist(requests);
+
+    return answers;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_COPY_ON_WRITE_MAP_H_
+#define CORE_TRUST_COPY_ON_WRITE_MAP_H_
+
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace core
+{
+namespace trust
+{
+// A CopyOnWriteMap is tailored to read-mostly workloads: Readers atomically
+// load an immutable snapshot of the map and never contend on a mutex. Writers
+// are serialized, copy the current snapshot, modify the copy and atomically
+// publish it. Snapshots stay valid for as long as readers hold on to them.
+template<typename Key, typename Value>
+class CopyOnWriteMap
+{
+public:
+    // The immutable map handed out to readers.
+    typedef std::map<Key, Value> Map;
+    // A snapshot of the map at a given point in time.
+    typedef std::shared_ptr<const Map> Snapshot;
+
+    CopyOnWriteMap() : snapshot_{std::make_shared<const Map>()}
+    {
+    }
+
+    CopyOnWriteMap(const CopyOnWriteMap&) = delete;
+    CopyOnWriteMap& operator=(const CopyOnWriteMap&) = delete;
+
+    // Returns the current snapshot of the map.
+    Snapshot snapshot() const
+    {
+        return std::atomic_load(&snapshot_);
+    }
+
+    // Returns the value known for key or an empty optional.
+    boost::optional<Value> try_resolve(const Key& key) const
+    {
+        auto s = snapshot();
+        auto it = s->find(key);
+
+        if (it == s->end())
+            return boost::optional<Value>{};
+
+        return it->second;
+    }
+
+    // Returns true iff the map contains a value for key.
+    bool contains(const Key& key) const
+    {
+        return snapshot()->count(key) > 0;
+    }
+
+    // Inserts value for key, replacing any previous value.
+    void insert_or_assign(const Key& key, const Value& value)
+    {
+        update([&key, &value](Map& map) { map[key] = value; });
+    }
+
+    // Removes the value known for key, if any.
+    void erase(const Key& key)
+    {
+        update([&key](Map& map) { map.erase(key); });
+    }
+
+    // Applies f to a copy of the current map and publishes the result.
+    // f must not call back into this instance.
+    template<typename F>
+    void update(F f)
+    {
+        std::lock_guard<std::mutex> lg(writer_guard);
+
+        std::shared_ptr<Map> copy{std::make_shared<Map>(*std::atomic_load(&snapshot_))};
+        f(*copy);
+
+        std::atomic_store(&snapshot_, Snapshot{copy});
+    }
+
+private:
+    // Serializes writers.
+    std::mutex writer_guard;
+    // The current, immutable snapshot.
+    Snapshot snapshot_;
+};
+}
+}
+
+#endif // CORE_TRUST_COPY_ON_WRITE_MAP_H_
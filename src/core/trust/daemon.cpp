@@ -20,11 +20,16 @@
 
 #include <core/trust/app_id_formatting_trust_agent.h>
 #include <core/trust/cached_agent.h>
+#include <core/trust/discarding_store.h>
 #include <core/trust/expose.h>
 #include <core/trust/i18n.h>
+#include <core/trust/notifying_store.h>
 #include <core/trust/privilege_escalation_prevention_agent.h>
+#include <core/trust/publishing_store.h>
+#include <core/trust/revoking_store.h>
 #include <core/trust/runtime.h>
 #include <core/trust/store.h>
+#include <core/trust/policy_snapshot.h>
 #include <core/trust/white_listing_agent.h>
 
 #include <core/trust/mir_agent.h>
@@ -46,6 +51,7 @@
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/program_options.hpp>
 
+#include <map>
 #include <thread>
 #include <chrono>
 
@@ -80,6 +86,57 @@ namespace
         return dict;
     }
 
+    // Maps the optional io-backend entry of dict to a backend for unix socket remote agents.
+    core::trust::remote::posix::IoBackend io_backend_from_dictionary(const core::trust::Daemon::Dictionary& dict)
+    {
+        if (dict.count("io-backend") == 0 || dict.at("io-backend") == "asio")
+            return core::trust::remote::posix::IoBackend::asio;
+
+        if (dict.at("io-backend") == "io_uring")
+            return core::trust::remote::posix::IoBackend::io_uring;
+
+        throw std::runtime_error
+        {
+            "Unknown io backend, please choose from {asio, io_uring}."
+        };
+    }
+
+    // Once a restarted trusted helper accepts connections again, skeletons reconnect within a quarter of a second.
+    const core::trust::remote::posix::ReconnectBackoff default_reconnect_backoff
+    {
+        std::chrono::milliseconds{10},
+        std::chrono::milliseconds{250}
+    };
+
+    // Trusted helpers hold back requests while skeletons are about to reconnect.
+    const std::chrono::milliseconds default_reconnect_grace_period{1000};
+
+    // Maps the optional decision-cache-ttl entry of dict (in milliseconds) to a cache
+    // for the sending end of remote agents, returning an empty pointer if not given.
+    core::trust::remote::DecisionCache::Ptr decision_cache_from_dictionary(const core::trust::Daemon::Dictionary& dict)
+    {
+        if (dict.count("decision-cache-ttl") == 0)
+            return core::trust::remote::DecisionCache::Ptr{};
+
+        return std::make_shared<core::trust::remote::DecisionCache>(
+                    core::trust::remote::DecisionCache::Configuration
+                    {
+                        std::chrono::milliseconds{boost::lexical_cast<std::chrono::milliseconds::rep>(dict.at("decision-cache-ttl"))},
+                        1024
+                    });
+    }
+
+    // Maps the optional decision-table-slots entry of dict to a table for publishing
+    // decisions to trusted helpers, returning an empty pointer if not given.
+    core::trust::remote::posix::DecisionTable::Ptr decision_table_from_dictionary(const core::trust::Daemon::Dictionary& dict)
+    {
+        if (dict.count("decision-table-slots") == 0)
+            return core::trust::remote::posix::DecisionTable::Ptr{};
+
+        return core::trust::remote::posix::DecisionTable::create(
+                    boost::lexical_cast<std::uint32_t>(dict.at("decision-table-slots")));
+    }
+
     struct DummyAgent : public core::trust::Agent
     {
         DummyAgent(core::trust::Request::Answer canned_answer)
@@ -161,7 +218,7 @@ const std::map<std::string, core::trust::Daemon::Skeleton::RemoteAgentFactory>&
     {
         {
             std::string{Daemon::RemoteAgents::UnixDomainSocketRemoteAgent::name},
-            [](const std::string& service_name, const std::shared_ptr<Agent>& agent, const core::trust::dbus::BusFactory::Ptr&, const Dictionary& dict)
+            [](const std::string& service_name, const std::shared_ptr<Agent>& agent, const core::trust::dbus::BusFactory::Ptr&, const core::trust::remote::posix::DecisionTable::Ptr& decision_table, const Dictionary& dict)
             {
                 if (dict.count("endpoint") == 0) throw std::runtime_error
                 {
@@ -178,7 +235,12 @@ const std::map<std::string, core::trust::Daemon::Skeleton::RemoteAgentFactory>&
                     dict.count("description-pattern") > 0 ?
                             dict.at("description-pattern") :
                             core::trust::i18n::tr("is trying to access") + " " + service_name + ".",
-                    dict.count("verify-process-timestamp") > 0
+                    dict.count("verify-process-timestamp") > 0,
+                    core::trust::remote::helpers::pidfd_process_identity_resolver(
+                        core::trust::remote::helpers::proc_stat_start_time_resolver()),
+                    io_backend_from_dictionary(dict),
+                    default_reconnect_backoff,
+                    decision_table
                 };
 
                 return core::trust::remote::posix::Skeleton::create_skeleton_for_configuration(config);
@@ -186,7 +248,7 @@ const std::map<std::string, core::trust::Daemon::Skeleton::RemoteAgentFactory>&
         },
         {
             std::string{Daemon::RemoteAgents::SystemServiceDBusRemoteAgent::name},
-            [](const std::string& service_name, const std::shared_ptr<Agent>& agent, const core::trust::dbus::BusFactory::Ptr& bf, const Dictionary& dict)
+            [](const std::string& service_name, const std::shared_ptr<Agent>& agent, const core::trust::dbus::BusFactory::Ptr& bf, const core::trust::remote::posix::DecisionTable::Ptr&, const Dictionary& dict)
             {
                 if (dict.count("bus") == 0) throw std::runtime_error
                 {
@@ -221,7 +283,7 @@ const std::map<std::string, core::trust::Daemon::Skeleton::RemoteAgentFactory>&
         },
         {
             std::string{Daemon::RemoteAgents::SessionServiceDBusRemoteAgent::name},
-            [](const std::string& service_name, const std::shared_ptr<Agent>& agent, const core::trust::dbus::BusFactory::Ptr& bf, const Dictionary& dict)
+            [](const std::string& service_name, const std::shared_ptr<Agent>& agent, const core::trust::dbus::BusFactory::Ptr& bf, const core::trust::remote::posix::DecisionTable::Ptr&, const Dictionary& dict)
             {
                 if (dict.count("bus") == 0) throw std::runtime_error
                 {
@@ -241,6 +303,10 @@ const std::map<std::string, core::trust::Daemon::Skeleton::RemoteAgentFactory>&
                                 [agent](const core::trust::Agent::RequestParameters& params)
                                 {
                                     return agent->authenticate_request_with_parameters(params);
+                                },
+                                [agent](const core::trust::Agent::BatchRequestParameters& params)
+                                {
+                                    return agent->authenticate_batch_request_with_parameters(params);
                                 }
                             });
             }
@@ -260,6 +326,9 @@ core::trust::Daemon::Skeleton::Configuration core::trust::Daemon::Skeleton::Conf
             (Parameters::ForService::name, Options::value<std::string>()->required(), Parameters::ForService::description)
             (Parameters::WithTextDomain::name, Options::value<std::string>(), Parameters::WithTextDomain::description)
             (Parameters::StoreBus::name, Options::value<core::trust::dbus::BusFactory::Type>()->required(), Parameters::StoreBus::description)
+            (Parameters::StoreBackend::name, Options::value<std::string>(), Parameters::StoreBackend::description)
+            (Parameters::WithPolicySnapshot::name, Options::value<std::string>(), Parameters::WithPolicySnapshot::description)
+            (Parameters::WithWriteBehind::name, Options::value<std::uint32_t>(), Parameters::WithWriteBehind::description)
             (Parameters::LocalAgent::name, Options::value<std::string>()->required(), Parameters::LocalAgent::description)
             (Parameters::RemoteAgent::name, Options::value<std::string>()->required(), Parameters::RemoteAgent::description);
 
@@ -301,24 +370,62 @@ core::trust::Daemon::Skeleton::Configuration core::trust::Daemon::Skeleton::Conf
     auto remote_agent_factory = core::trust::Daemon::Skeleton::known_remote_agent_factories()
             .at(vm[Parameters::RemoteAgent::name].as<std::string>());
 
-    auto local_store = core::trust::create_default_store(service_name);
+    std::shared_ptr<core::trust::Store> local_store = vm.count(Parameters::StoreBackend::name) > 0 ?
+                core::trust::create_store_for_backend(vm[Parameters::StoreBackend::name].as<std::string>(), service_name) :
+                core::trust::create_default_store(service_name);
     auto local_agent = local_agent_factory(service_name, dict);
 
+    core::trust::WhiteListingAgent::WhiteListingPredicate is_whitelisted = [dict](const core::trust::Agent::RequestParameters& params) -> bool
+    {
+        static auto unconfined_predicate = core::trust::WhiteListingAgent::always_grant_for_unconfined();
+        const bool is_unconfined = unconfined_predicate(params);
+        return is_unconfined || ((not (dict.count("disable-whitelisting") > 0)) && params.application.id == "com.ubuntu.camera_camera");
+    };
+
+    core::trust::PolicySnapshot::Ptr policy_snapshot;
+    if (vm.count(Parameters::WithPolicySnapshot::name) > 0)
+        policy_snapshot = core::trust::PolicySnapshot::open(vm[Parameters::WithPolicySnapshot::name].as<std::string>());
+
+    // Decisions recorded in the store are published to trusted helpers if configured, unless
+    // overridden by the policy or the whitelist.
+    auto decision_table = decision_table_from_dictionary(dict);
+    if (decision_table)
+        local_store = std::make_shared<core::trust::PublishingStore>(local_store, decision_table, [is_whitelisted, policy_snapshot](const std::string& app_id, core::trust::Feature feature)
+        {
+            core::trust::Request::Answer answer;
+
+            if (policy_snapshot && policy_snapshot->lookup(app_id, feature, answer))
+                return false;
+
+            return not is_whitelisted(core::trust::Agent::RequestParameters{core::trust::Uid{::getuid()}, core::trust::Pid{0}, app_id, feature, std::string{}});
+        });
+
+    // Clients of the exposed store are notified about answers persisted by the cached agent, too.
+    auto notifying_store = std::make_shared<core::trust::NotifyingStore>(local_store);
+
+    auto persistence = vm.count(Parameters::WithWriteBehind::name) > 0 ?
+                core::trust::CachedAgent::Persistence::write_behind(std::chrono::milliseconds{vm[Parameters::WithWriteBehind::name].as<std::uint32_t>()}) :
+                core::trust::CachedAgent::Persistence::synchronous();
+
     auto cached_agent = std::make_shared<core::trust::CachedAgent>(
         core::trust::CachedAgent::Configuration
         {
             local_agent,
-            local_store,
+            notifying_store,
             std::make_shared<core::trust::CachedAgentGlogReporter>(
-                    core::trust::CachedAgentGlogReporter::Configuration{})
+                    core::trust::CachedAgentGlogReporter::Configuration{}),
+            persistence
         });
 
-    auto whitelisting_agent = std::make_shared<core::trust::WhiteListingAgent>([dict](const core::trust::Agent::RequestParameters& params) -> bool
-    {
-        static auto unconfined_predicate = core::trust::WhiteListingAgent::always_grant_for_unconfined();
-        const bool is_unconfined = unconfined_predicate(params);
-        return is_unconfined || ((not (dict.count("disable-whitelisting") > 0)) && params.application.id == "com.ubuntu.camera_camera");
-    }, cached_agent);
+    // Modifications applied via the bus must not be overridden by answers still pending.
+    auto exposed_store = std::make_shared<core::trust::DiscardingStore>(notifying_store, cached_agent);
+
+    // Answers covered by the image-wide policy take precedence over answers cached in the store.
+    std::shared_ptr<core::trust::Agent> policy_agent = cached_agent;
+    if (policy_snapshot)
+        policy_agent = std::make_shared<core::trust::PolicySnapshotAgent>(policy_snapshot, cached_agent);
+
+    auto whitelisting_agent = std::make_shared<core::trust::WhiteListingAgent>(is_whitelisted, policy_agent);
 
     auto formatting_agent = std::make_shared<core::trust::AppIdFormattingTrustAgent>(whitelisting_agent);
     
@@ -326,13 +433,13 @@ core::trust::Daemon::Skeleton::Configuration core::trust::Daemon::Skeleton::Conf
         core::trust::PrivilegeEscalationPreventionAgent::default_user_id_functor(),
         formatting_agent);
 
-    auto remote_agent = remote_agent_factory(service_name, formatting_agent, bf, dict);
+    auto remote_agent = remote_agent_factory(service_name, formatting_agent, bf, decision_table, dict);
 
     return core::trust::Daemon::Skeleton::Configuration
     {
         service_name,
         bf->bus_for_type(vm[Parameters::StoreBus::name].as<core::trust::dbus::BusFactory::Type>()),
-        {local_store, privilege_escalation_prevention_agent},
+        {exposed_store, privilege_escalation_prevention_agent, notifying_store, cached_agent},
         {remote_agent}
     };
 }
@@ -340,15 +447,31 @@ core::trust::Daemon::Skeleton::Configuration core::trust::Daemon::Skeleton::Conf
 // Executes the daemon with the given configuration.
 core::posix::exit::Status core::trust::Daemon::Skeleton::main(const core::trust::Daemon::Skeleton::Configuration& configuration)
 {
+    auto store = configuration.local.store;
+
+    // Modifications applied via the bus invalidate decisions cached by trusted helpers.
+    if (auto skeleton = std::dynamic_pointer_cast<core::trust::remote::Agent::Skeleton>(configuration.remote.agent))
+        store = std::make_shared<core::trust::RevokingStore>(store, skeleton);
+
     // Expose the local store to the bus, keeping it exposed for the
     // lifetime of the returned token.
-    auto token = core::trust::expose_store_to_bus_with_name(
-                configuration.local.store,
-                configuration.bus,
-                configuration.service_name);
+    auto token = configuration.local.notifications ?
+                core::trust::expose_store_to_bus_with_name(
+                    store,
+                    configuration.local.notifications,
+                    configuration.bus,
+                    configuration.service_name) :
+                core::trust::expose_store_to_bus_with_name(
+                    store,
+                    configuration.bus,
+                    configuration.service_name);
 
     core::trust::Runtime::instance().run();
 
+    // Answers still pending are persisted before the daemon exits.
+    if (configuration.local.cache)
+        configuration.local.cache->flush();
+
     return core::posix::exit::Status::success;
 }
 
@@ -371,7 +494,18 @@ const std::map<std::string, core::trust::Daemon::Stub::RemoteAgentFactory>& core
                     boost::asio::local::stream_protocol::endpoint{dict.at("endpoint")},
                     core::trust::remote::helpers::proc_stat_start_time_resolver(),
                     core::trust::remote::posix::Stub::get_sock_opt_credentials_resolver(),
-                    std::make_shared<core::trust::remote::posix::Stub::Session::Registry>()
+                    std::make_shared<core::trust::remote::posix::Stub::Session::Registry>(),
+                    dict.count("shared-memory-ring-capacity") > 0 ?
+                            boost::lexical_cast<std::uint32_t>(dict.at("shared-memory-ring-capacity")) :
+                            0,
+                    core::trust::remote::helpers::pidfd_process_identity_resolver(
+                        core::trust::remote::helpers::proc_stat_start_time_resolver()),
+                    io_backend_from_dictionary(dict),
+                    dict.count("reconnect-grace-period") > 0 ?
+                            std::chrono::milliseconds{boost::lexical_cast<std::chrono::milliseconds::rep>(dict.at("reconnect-grace-period"))} :
+                            default_reconnect_grace_period,
+                    decision_cache_from_dictionary(dict),
+                    dict.count("consult-decision-tables") > 0
                 };
 
                 return core::trust::remote::posix::Stub::create_stub_for_configuration(config);
@@ -395,7 +529,9 @@ const std::map<std::string, core::trust::Daemon::Stub::RemoteAgentFactory>& core
                 core::trust::remote::dbus::Agent::Stub::Configuration config
                 {
                     object,
-                    bus
+                    bus,
+                    core::trust::remote::helpers::proc_stat_start_time_resolver(),
+                    decision_cache_from_dictionary(dict)
                 };
 
                 return std::make_shared<core::trust::remote::dbus::Agent::Stub>(config);
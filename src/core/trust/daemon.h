@@ -24,6 +24,7 @@
 
 #include <core/trust/dbus/bus_factory.h>
 #include <core/trust/remote/agent.h>
+#include <core/trust/remote/decision_table.h>
 
 #include <core/dbus/bus.h>
 
@@ -37,6 +38,10 @@ namespace core
 {
 namespace trust
 {
+// Forward declarations
+class CachedAgent;
+class NotifyingStore;
+
 // Encapsulates an executable that allows services to run an out-of-process daemon for
 // managing trust to applications. The reason here is simple: Patching each and every
 // service in the system to use and link against the trust-store might not be feasible.
@@ -127,6 +132,7 @@ struct Daemon
                 const std::string&,             // The name of the service.
                 const std::shared_ptr<Agent>&,  // The local agent implementation.
                 const core::trust::dbus::BusFactory::Ptr&, // The bus bus factory.
+                const core::trust::remote::posix::DecisionTable::Ptr&, // Decisions published to trusted helpers, might be null.
                 const Dictionary&               // Dictionary containing Agent-specific configuration options.
                 )
         > RemoteAgentFactory;
@@ -148,6 +154,24 @@ struct Daemon
                 static constexpr const char* description{"The bus that the remote store should be exposed on"};
             };
 
+            struct StoreBackend
+            {
+                static constexpr const char* name{"store-backend"};
+                static constexpr const char* description{"The store implementation persisting requests, one of: sqlite, log_structured"};
+            };
+
+            struct WithPolicySnapshot
+            {
+                static constexpr const char* name{"with-policy-snapshot"};
+                static constexpr const char* description{"A compiled policy snapshot consulted before the store"};
+            };
+
+            struct WithWriteBehind
+            {
+                static constexpr const char* name{"with-write-behind"};
+                static constexpr const char* description{"Persist answers in the background, grouping answers given within the specified number of milliseconds"};
+            };
+
             struct ForService
             {
                 static constexpr const char* name{"for-service"};
@@ -192,6 +216,12 @@ struct Daemon
                 std::shared_ptr<Store> store;
                 // The agent used for prompting the user.
                 std::shared_ptr<Agent> agent;
+                // Notifies about all modifications of the store, including the ones
+                // applied by the agent. Might be null if the agent does not modify the store.
+                std::shared_ptr<NotifyingStore> notifications;
+                // Answers still pending with this agent are persisted before the daemon
+                // exits. Might be null if the agent does not cache answers.
+                std::shared_ptr<CachedAgent> cache;
             } local;
 
             // All remote implementations for exposing the services
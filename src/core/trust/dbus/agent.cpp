@@ -60,6 +60,22 @@ core::trust::Request::Answer core::trust::dbus::Agent::Stub::authenticate_reques
     return result.value();
 }
 
+core::trust::Agent::BatchAnswer core::trust::dbus::Agent::Stub::authenticate_batch_request_with_parameters(const core::trust::Agent::BatchRequestParameters& parameters)
+{
+    auto result = object->transact_method
+            <
+                Methods::AuthenticateBatchRequestWithParameters,
+                core::trust::Agent::BatchAnswer
+            >(parameters);
+
+    if (result.is_error()) throw std::runtime_error
+    {
+        result.error().print()
+    };
+
+    return result.value();
+}
+
 core::trust::dbus::Agent::Skeleton::Skeleton(const Configuration& config)
     : configuration(config)
 {
@@ -83,6 +99,23 @@ core::trust::dbus::Agent::Skeleton::Skeleton(const Configuration& config)
 
         configuration.bus->send(reply);
     });
+
+    configuration.object->install_method_handler<Methods::AuthenticateBatchRequestWithParameters>([this](const core::dbus::Message::Ptr& in)
+    {
+        core::trust::Agent::BatchRequestParameters params; in->reader() >> params;
+
+        core::dbus::Message::Ptr reply;
+        try
+        {
+            reply = core::dbus::Message::make_method_return(in);
+            reply->writer() << authenticate_batch_request_with_parameters(params);
+        } catch(...)
+        {
+            reply = core::dbus::Message::make_error(in, Errors::CouldNotDetermineConclusiveAnswer::name, "");
+        }
+
+        configuration.bus->send(reply);
+    });
 }
 
 core::trust::Request::Answer core::trust::dbus::Agent::Skeleton::authenticate_request_with_parameters(const core::trust::Agent::RequestParameters& request)
@@ -90,6 +123,14 @@ core::trust::Request::Answer core::trust::dbus::Agent::Skeleton::authenticate_re
     return configuration.agent(request);
 }
 
+core::trust::Agent::BatchAnswer core::trust::dbus::Agent::Skeleton::authenticate_batch_request_with_parameters(const core::trust::Agent::BatchRequestParameters& request)
+{
+    if (configuration.batch_agent)
+        return configuration.batch_agent(request);
+
+    return core::trust::Agent::authenticate_batch_request_with_parameters(request);
+}
+
 
 /**
  * @brief create_per_user_agent_for_bus_connection creates a trust::Agent implementation communicating with a remote agent
@@ -62,6 +62,7 @@ struct Agent
         // And thus not constructible
         Methods() = delete;
         DBUS_CPP_METHOD_WITH_TIMEOUT_DEF(AuthenticateRequestWithParameters, Agent, 120000)
+        DBUS_CPP_METHOD_WITH_TIMEOUT_DEF(AuthenticateBatchRequestWithParameters, Agent, 120000)
     };
 
     class CORE_TRUST_DLL_PUBLIC Stub : public core::trust::Agent
@@ -70,6 +71,7 @@ struct Agent
         Stub(const core::dbus::Object::Ptr& object);
 
         Request::Answer authenticate_request_with_parameters(const RequestParameters& parameters) override;
+        BatchAnswer authenticate_batch_request_with_parameters(const BatchRequestParameters& parameters) override;
 
     private:
         core::dbus::Object::Ptr object;
@@ -87,11 +89,15 @@ struct Agent
             core::dbus::Bus::Ptr bus;
             // The agent implementation
             std::function<core::trust::Request::Answer(const core::trust::Agent::RequestParameters&)> agent;
+            // The agent implementation for batch requests. If not set, batch requests
+            // are authenticated feature by feature via agent.
+            std::function<core::trust::Agent::BatchAnswer(const core::trust::Agent::BatchRequestParameters&)> batch_agent;
         };
 
         Skeleton(const Configuration& config);
 
         Request::Answer authenticate_request_with_parameters(const RequestParameters& request) override;
+        BatchAnswer authenticate_batch_request_with_parameters(const BatchRequestParameters& request) override;
 
     private:
         // We just store all creation time parameters.
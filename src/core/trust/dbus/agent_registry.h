@@ -19,6 +19,7 @@
 #ifndef CORE_TRUST_DBUS_AGENT_REGISTRY_H_
 #define CORE_TRUST_DBUS_AGENT_REGISTRY_H_
 
+#include <core/trust/copy_on_write_map.h>
 #include <core/trust/dbus/agent.h>
 #include <core/trust/dbus/codec.h>
 
@@ -29,20 +30,19 @@ namespace core
 {
 namespace trust
 {
-// A thread-safe AgentRegistry implementation.
+// A thread-safe AgentRegistry implementation. Registrations are rare and
+// lookups happen for every request, lookups thus never take a lock.
 class LockingAgentRegistry : public Agent::Registry
 {
 public:
     // From AgentRegistry
     void register_agent_for_user(const core::trust::Uid& uid, const std::shared_ptr<core::trust::Agent>& agent) override
     {
-        std::lock_guard<std::mutex> lg(guard);
-        registered_agents[uid] = agent;
+        registered_agents.insert_or_assign(uid, agent);
     }
 
     void unregister_agent_for_user(const core::trust::Uid& uid) override
     {
-        std::lock_guard<std::mutex> lg(guard);
         registered_agents.erase(uid);
     }
 
@@ -50,21 +50,25 @@ public:
     // Returns true iff the registry knows about an agent for the given uid.
     bool has_agent_for_user(const core::trust::Uid& uid) const
     {
-        std::lock_guard<std::mutex> lg(guard);
-        return registered_agents.count(uid) > 0;
+        return registered_agents.contains(uid);
     }
 
     // Returns the agent implementation for the given uid
     // or throws std::out_of_range if no agent is known for the uid.
     std::shared_ptr<Agent> agent_for_user(const core::trust::Uid& uid) const
     {
-        std::lock_guard<std::mutex> lg(guard);
-        return registered_agents.at(uid);
+        return registered_agents.snapshot()->at(uid);
+    }
+
+    // Returns the agent implementation for the given uid or an
+    // empty optional if no agent is known for the uid.
+    boost::optional<std::shared_ptr<Agent>> try_resolve_agent_for_user(const core::trust::Uid& uid) const
+    {
+        return registered_agents.try_resolve(uid);
     }
 
 private:
-    mutable std::mutex guard;
-    std::map<core::trust::Uid, std::shared_ptr<core::trust::Agent>> registered_agents;
+    CopyOnWriteMap<core::trust::Uid, std::shared_ptr<core::trust::Agent>> registered_agents;
 };
 
 namespace dbus
@@ -111,8 +115,14 @@ struct AgentRegistry
         DBUS_CPP_METHOD_DEF(RegisterAgentForUser, AgentRegistry)
         // Maps to unregister_agent_for_user
         DBUS_CPP_METHOD_DEF(UnregisterAgentForUser, AgentRegistry)
+        // Maps to revoke_decisions_for_user
+        DBUS_CPP_METHOD_DEF(RevokeDecisionsForUser, AgentRegistry)
     };
 
+    // Invoked for revoking cached decisions for the given user, either for all
+    // features or just for the given one.
+    typedef std::function<void(const core::trust::Uid&, bool, const core::trust::Feature&)> RevocationHandler;
+
     // A DBus stub implementation of core::trust::AgentRegistry.
     struct Stub : public core::trust::Agent::Registry
     {
@@ -162,7 +172,8 @@ struct AgentRegistry
                     {
                         configuration.service->add_object_for_path(path),
                         configuration.bus,
-                        std::bind(&core::trust::Agent::authenticate_request_with_parameters, impl, std::placeholders::_1)
+                        std::bind(&core::trust::Agent::authenticate_request_with_parameters, impl, std::placeholders::_1),
+                        std::bind(&core::trust::Agent::authenticate_batch_request_with_parameters, impl, std::placeholders::_1)
                     }
                 }
             };
@@ -194,7 +205,8 @@ struct AgentRegistry
                     {
                         configuration.service->add_object_for_path(path),
                         configuration.bus,
-                        std::bind(&core::trust::Agent::authenticate_request_with_parameters, impl, std::placeholders::_1)
+                        std::bind(&core::trust::Agent::authenticate_request_with_parameters, impl, std::placeholders::_1),
+                        std::bind(&core::trust::Agent::authenticate_batch_request_with_parameters, impl, std::placeholders::_1)
                     }
                 }
             };
@@ -233,6 +245,19 @@ struct AgentRegistry
             };
         }
 
+        // Asks the remote implementation to drop cached decisions for the given uid, either for
+        // all features or just for the given one. Does not wait for the remote end to reply.
+        void revoke_decisions_for_user_async(const core::trust::Uid& uid, bool all_features, const core::trust::Feature& feature)
+        {
+            configuration.object->invoke_method_asynchronously_with_callback<
+                Methods::RevokeDecisionsForUser, void
+            >([](const core::dbus::Result<void>& result)
+            {
+                if (result.is_error())
+                    std::cerr << "Failed to revoke decisions for user: " << result.error().print() << std::endl;
+            }, uid, all_features, feature);
+        }
+
         // We just store all creation-time arguments.
         Configuration configuration;
         // Our local registry of agents
@@ -252,11 +277,14 @@ struct AgentRegistry
             core::dbus::Bus::Ptr bus;
             // The actual implementation.
             core::trust::Agent::Registry& impl;
+            // Invoked for incoming revocations and whenever the agent for a user changes, if set.
+            RevocationHandler on_revocation;
         };
 
         // Setups up handlers for:
         //   Methods::RegisterAgentForUser
         //   Methods::UnregisterAgentForUser
+        //   Methods::RevokeDecisionsForUser
         Skeleton(const Configuration& config)
             : configuration(config)
         {
@@ -283,6 +311,8 @@ struct AgentRegistry
                 try
                 {
                     configuration.impl.register_agent_for_user(uid, agent);
+                    // Decisions of a previously registered agent do not carry over.
+                    revoke_decisions_for_user(uid, true, core::trust::Feature{});
                     reply = core::dbus::Message::make_method_return(in);
                 } catch(const std::exception&)
                 {
@@ -334,6 +364,18 @@ struct AgentRegistry
                     // stay silent for now.
                 }
 
+                revoke_decisions_for_user(uid, true, core::trust::Feature{});
+
+                configuration.bus->send(core::dbus::Message::make_method_return(in));
+            });
+
+            configuration.object->install_method_handler<Methods::RevokeDecisionsForUser>([this](const core::dbus::Message::Ptr& in)
+            {
+                core::trust::Uid uid; bool all_features; core::trust::Feature feature;
+                in->reader() >> uid >> all_features >> feature;
+
+                revoke_decisions_for_user(uid, all_features, feature);
+
                 configuration.bus->send(core::dbus::Message::make_method_return(in));
             });
         }
@@ -343,6 +385,7 @@ struct AgentRegistry
         {
             configuration.object->uninstall_method_handler<Methods::RegisterAgentForUser>();
             configuration.object->uninstall_method_handler<Methods::UnregisterAgentForUser>();
+            configuration.object->uninstall_method_handler<Methods::RevokeDecisionsForUser>();
         }
 
         // Registers an agent for the given uid,
@@ -359,6 +402,13 @@ struct AgentRegistry
             configuration.impl.unregister_agent_for_user(uid);
         }
 
+        // Dispatches to the revocation handler given at construction time, if any.
+        void revoke_decisions_for_user(const core::trust::Uid& uid, bool all_features, const core::trust::Feature& feature)
+        {
+            if (configuration.on_revocation)
+                configuration.on_revocation(uid, all_features, feature);
+        }
+
         // We just store all creation time parameters
         Configuration configuration;
     };
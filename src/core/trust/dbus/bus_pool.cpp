@@ -0,0 +1,120 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/dbus/bus_pool.h>
+
+#include <core/dbus/asio/executor.h>
+
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+// Runs ios until it is stopped, reporting but never propagating exceptions
+// thrown by handlers.
+void execute_and_never_throw(boost::asio::io_service& ios) noexcept(true)
+{
+    while (true)
+    {
+        try
+        {
+            ios.run();
+            break;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << __PRETTY_FUNCTION__ << ": " << e.what() << std::endl;
+        }
+        catch (...)
+        {
+            std::cerr << __PRETTY_FUNCTION__ << ": unknown exception" << std::endl;
+        }
+    }
+}
+}
+
+core::trust::dbus::BusPool& core::trust::dbus::BusPool::instance()
+{
+    static BusPool pool;
+    return pool;
+}
+
+core::trust::dbus::BusPool::BusPool()
+    : keep_alive{io_service},
+      worker{execute_and_never_throw, std::ref(io_service)}
+{
+}
+
+core::trust::dbus::BusPool::~BusPool()
+{
+    io_service.stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+core::dbus::Bus::Ptr core::trust::dbus::BusPool::bus_for_well_known_bus(core::dbus::WellKnownBus bus)
+{
+    return bus_for_key("well-known:" + std::to_string(static_cast<int>(bus)), [bus]()
+    {
+        return std::make_shared<core::dbus::Bus>(bus);
+    });
+}
+
+core::dbus::Bus::Ptr core::trust::dbus::BusPool::bus_for_address(const std::string& address)
+{
+    if (address.empty()) throw std::invalid_argument
+    {
+        "Bus address must not be empty."
+    };
+
+    return bus_for_key("address:" + address, [address]()
+    {
+        return std::make_shared<core::dbus::Bus>(address);
+    });
+}
+
+std::size_t core::trust::dbus::BusPool::size() const
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    std::size_t result{0};
+    for (const auto& pair : buses)
+        if (not pair.second.expired())
+            result++;
+
+    return result;
+}
+
+core::dbus::Bus::Ptr core::trust::dbus::BusPool::bus_for_key(
+        const std::string& key,
+        const std::function<core::dbus::Bus::Ptr()>& connect)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = buses.find(key);
+    if (it != buses.end())
+    {
+        if (auto bus = it->second.lock())
+            return bus;
+    }
+
+    auto bus = connect();
+    bus->install_executor(core::dbus::asio::make_executor(bus, io_service));
+
+    buses[key] = bus;
+    return bus;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_DBUS_BUS_POOL_H_
+#define CORE_TRUST_DBUS_BUS_POOL_H_
+
+#include <core/trust/visibility.h>
+
+#include <core/dbus/bus.h>
+
+#include <boost/asio.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace core
+{
+namespace trust
+{
+namespace dbus
+{
+// BusPool hands out bus connections shared by all users within a process.
+// Connections are keyed by bus type or address and are reference counted:
+// a connection is closed as soon as the last user releases it. All connections
+// are driven by one executor, i.e., a single worker thread dispatching messages.
+//
+// Users must neither run nor stop buses handed out by the pool.
+class CORE_TRUST_DLL_PUBLIC BusPool
+{
+public:
+    // instance returns the process-wide pool.
+    static BusPool& instance();
+
+    // @cond
+    BusPool(const BusPool&) = delete;
+    BusPool(BusPool&&) = delete;
+    ~BusPool();
+
+    BusPool& operator=(const BusPool&) = delete;
+    BusPool& operator=(BusPool&&) = delete;
+    // @endcond
+
+    // bus_for_well_known_bus returns the shared connection to bus, connecting on first use.
+    core::dbus::Bus::Ptr bus_for_well_known_bus(core::dbus::WellKnownBus bus);
+
+    // bus_for_address returns the shared connection to the bus at address, connecting on first use.
+    core::dbus::Bus::Ptr bus_for_address(const std::string& address);
+
+    // size returns the number of connections currently in use.
+    std::size_t size() const;
+
+private:
+    BusPool();
+
+    // bus_for_key returns the connection known for key, or creates,
+    // sets up and remembers a new one by invoking connect.
+    core::dbus::Bus::Ptr bus_for_key(const std::string& key, const std::function<core::dbus::Bus::Ptr()>& connect);
+
+    // The reactor shared by all connections.
+    boost::asio::io_service io_service;
+    // Keeps the io_service running in the absence of connections.
+    boost::asio::io_service::work keep_alive;
+    // Dispatches messages for all connections.
+    std::thread worker;
+
+    mutable std::mutex guard;
+    std::map<std::string, std::weak_ptr<core::dbus::Bus>> buses;
+};
+}
+}
+}
+
+#endif // CORE_TRUST_DBUS_BUS_POOL_H_
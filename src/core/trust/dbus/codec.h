@@ -23,6 +23,8 @@
 #include <core/trust/request.h>
 #include <core/trust/store.h>
 
+#include <core/trust/dbus/interface.h>
+
 #include <core/dbus/codec.h>
 #include <core/dbus/message_streaming_operators.h>
 #include <core/dbus/types/stl/string.h>
@@ -94,6 +96,70 @@ struct Codec<core::trust::Request>
     }
 };
 
+template<>
+struct Codec<core::trust::Store::Statistics>
+{
+    inline static void encode_argument(core::dbus::Message::Writer& writer, const core::trust::Store::Statistics& arg)
+    {
+        writer.push_stringn(arg.application_id.c_str(), arg.application_id.size());
+        writer.push_uint64(arg.feature.value);
+        writer.push_uint64(arg.granted);
+        writer.push_uint64(arg.denied);
+        writer.push_uint64(std::chrono::duration_cast<core::trust::Request::Duration>(arg.first.time_since_epoch()).count());
+        writer.push_uint64(std::chrono::duration_cast<core::trust::Request::Duration>(arg.last.time_since_epoch()).count());
+    }
+
+    inline static void decode_argument(core::dbus::Message::Reader& reader, core::trust::Store::Statistics& arg)
+    {
+        arg.application_id = reader.pop_string();
+        arg.feature.value = reader.pop_uint64();
+        arg.granted = reader.pop_uint64();
+        arg.denied = reader.pop_uint64();
+        arg.first = core::trust::Request::Timestamp{core::trust::Request::Duration{reader.pop_uint64()}};
+        arg.last = core::trust::Request::Timestamp{core::trust::Request::Duration{reader.pop_uint64()}};
+    }
+};
+
+template<>
+struct Codec<std::vector<core::trust::Store::Statistics>>
+{
+    inline static void encode_argument(core::dbus::Message::Writer& writer, const std::vector<core::trust::Store::Statistics>& arg)
+    {
+        // We flatten the vector, prefixing it with the number of elements.
+        writer.push_uint32(arg.size());
+        for (const auto& statistics : arg)
+            Codec<core::trust::Store::Statistics>::encode_argument(writer, statistics);
+    }
+
+    inline static void decode_argument(core::dbus::Message::Reader& reader, std::vector<core::trust::Store::Statistics>& arg)
+    {
+        arg.clear();
+        for (auto count = reader.pop_uint32(); count > 0; count--)
+        {
+            core::trust::Store::Statistics statistics; Codec<core::trust::Store::Statistics>::decode_argument(reader, statistics);
+            arg.push_back(statistics);
+        }
+    }
+};
+
+template<>
+struct Codec<core::trust::dbus::Store::Changed::Notification>
+{
+    inline static void encode_argument(core::dbus::Message::Writer& writer, const core::trust::dbus::Store::Changed::Notification& arg)
+    {
+        writer.push_uint64(arg.generation);
+        writer.push_byte(static_cast<std::int8_t>(arg.kind));
+        Codec<core::trust::Request>::encode_argument(writer, arg.request);
+    }
+
+    inline static void decode_argument(core::dbus::Message::Reader& reader, core::trust::dbus::Store::Changed::Notification& arg)
+    {
+        arg.generation = reader.pop_uint64();
+        arg.kind = static_cast<core::trust::dbus::Store::Changed::Kind>(reader.pop_byte());
+        Codec<core::trust::Request>::decode_argument(reader, arg.request);
+    }
+};
+
 template<>
 struct Codec<core::trust::Agent::RequestParameters>
 {
@@ -115,6 +181,62 @@ struct Codec<core::trust::Agent::RequestParameters>
         Codec<std::string>::decode_argument(reader, arg.description);
     }
 };
+
+template<>
+struct Codec<core::trust::Agent::BatchRequestParameters>
+{
+    inline static void encode_argument(core::dbus::Message::Writer& writer, const core::trust::Agent::BatchRequestParameters& arg)
+    {
+        Codec<core::trust::Uid>::encode_argument(writer, arg.application.uid);
+        Codec<core::trust::Pid>::encode_argument(writer, arg.application.pid);
+        Codec<std::string>::encode_argument(writer, arg.application.id);
+        // We flatten the set of features, prefixing it with the number of elements.
+        writer.push_uint32(arg.features.size());
+        for (const auto& feature : arg.features)
+            Codec<core::trust::Feature>::encode_argument(writer, feature);
+        Codec<std::string>::encode_argument(writer, arg.description);
+    }
+
+    inline static void decode_argument(core::dbus::Message::Reader& reader, core::trust::Agent::BatchRequestParameters& arg)
+    {
+        Codec<core::trust::Uid>::decode_argument(reader, arg.application.uid);
+        Codec<core::trust::Pid>::decode_argument(reader, arg.application.pid);
+        Codec<std::string>::decode_argument(reader, arg.application.id);
+        arg.features.clear();
+        for (auto count = reader.pop_uint32(); count > 0; count--)
+        {
+            core::trust::Feature feature; Codec<core::trust::Feature>::decode_argument(reader, feature);
+            arg.features.insert(feature);
+        }
+        Codec<std::string>::decode_argument(reader, arg.description);
+    }
+};
+
+template<>
+struct Codec<core::trust::Agent::BatchAnswer>
+{
+    inline static void encode_argument(core::dbus::Message::Writer& writer, const core::trust::Agent::BatchAnswer& arg)
+    {
+        // We flatten the map, prefixing it with the number of (feature, answer) pairs.
+        writer.push_uint32(arg.size());
+        for (const auto& pair : arg)
+        {
+            Codec<core::trust::Feature>::encode_argument(writer, pair.first);
+            Codec<core::trust::Request::Answer>::encode_argument(writer, pair.second);
+        }
+    }
+
+    inline static void decode_argument(core::dbus::Message::Reader& reader, core::trust::Agent::BatchAnswer& arg)
+    {
+        arg.clear();
+        for (auto count = reader.pop_uint32(); count > 0; count--)
+        {
+            core::trust::Feature feature; Codec<core::trust::Feature>::decode_argument(reader, feature);
+            core::trust::Request::Answer answer; Codec<core::trust::Request::Answer>::decode_argument(reader, answer);
+            arg[feature] = answer;
+        }
+    }
+};
 }
 }
 
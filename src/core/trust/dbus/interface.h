@@ -24,9 +24,13 @@
 
 #include <core/dbus/traits/service.h>
 #include <core/dbus/types/object_path.h>
+#include <core/dbus/types/unix_fd.h>
 
 #include <chrono>
+#include <cstdint>
 #include <string>
+#include <tuple>
+#include <vector>
 
 namespace core
 {
@@ -99,6 +103,34 @@ struct Store
             typedef core::trust::Store Interface;
         };
 
+        struct RemovingFeature
+        {
+            static const std::string& name()
+            {
+                static const std::string s
+                {
+                    "core.trust.store.error.RemovingFeature"
+                };
+
+                return s;
+            }
+            typedef core::trust::Store Interface;
+        };
+
+        struct RemovingOlderRequests
+        {
+            static const std::string& name()
+            {
+                static const std::string s
+                {
+                    "core.trust.store.error.RemovingOlderRequests"
+                };
+
+                return s;
+            }
+            typedef core::trust::Store Interface;
+        };
+
         struct ResettingStore
         {
             static const std::string& name()
@@ -126,6 +158,48 @@ struct Store
             }
             typedef core::trust::Store Interface;
         };
+
+        struct QueryingStatistics
+        {
+            static const std::string& name()
+            {
+                static const std::string s
+                {
+                    "core.trust.store.error.QueryingStatistics"
+                };
+
+                return s;
+            }
+            typedef core::trust::Store Interface;
+        };
+
+        struct ExportingStore
+        {
+            static const std::string& name()
+            {
+                static const std::string s
+                {
+                    "core.trust.store.error.ExportingStore"
+                };
+
+                return s;
+            }
+            typedef core::trust::Store Interface;
+        };
+
+        struct ImportingStore
+        {
+            static const std::string& name()
+            {
+                static const std::string s
+                {
+                    "core.trust.store.error.ImportingStore"
+                };
+
+                return s;
+            }
+            typedef core::trust::Store Interface;
+        };
     };
 
     struct Query
@@ -242,6 +316,63 @@ struct Store
                 return std::chrono::seconds{1};
             }
         };
+        struct Limit
+        {
+            inline static const std::string& name()
+            {
+                static const std::string& s
+                {
+                    "Limit"
+                };
+                return s;
+            }
+            typedef core::trust::Store::Query Interface;
+            typedef std::uint64_t ArgumentType;
+            typedef void ResultType;
+
+            inline static const std::chrono::milliseconds default_timeout()
+            {
+                return std::chrono::seconds{1};
+            }
+        };
+        struct Count
+        {
+            inline static const std::string& name()
+            {
+                static const std::string& s
+                {
+                    "Count"
+                };
+                return s;
+            }
+            typedef core::trust::Store::Query Interface;
+            typedef void ArgumentType;
+            typedef std::uint64_t ResultType;
+
+            inline static const std::chrono::milliseconds default_timeout()
+            {
+                return std::chrono::seconds{1};
+            }
+        };
+        struct Exists
+        {
+            inline static const std::string& name()
+            {
+                static const std::string& s
+                {
+                    "Exists"
+                };
+                return s;
+            }
+            typedef core::trust::Store::Query Interface;
+            typedef void ArgumentType;
+            typedef bool ResultType;
+
+            inline static const std::chrono::milliseconds default_timeout()
+            {
+                return std::chrono::seconds{1};
+            }
+        };
         struct All
         {
             inline static const std::string& name()
@@ -318,6 +449,25 @@ struct Store
                 return std::chrono::seconds{1};
             }
         };
+        struct EraseAll
+        {
+            inline static const std::string& name()
+            {
+                static const std::string& s
+                {
+                    "EraseAll"
+                };
+                return s;
+            }
+            typedef core::trust::Store::Query Interface;
+            typedef void ArgumentType;
+            typedef void ResultType;
+
+            inline static const std::chrono::milliseconds default_timeout()
+            {
+                return std::chrono::seconds{1};
+            }
+        };
         struct Current
         {
             inline static const std::string& name()
@@ -380,6 +530,48 @@ struct Store
         }
     };
 
+    // Removes all requests for a feature, issued by any application.
+    struct RemoveFeature
+    {
+        inline static const std::string& name()
+        {
+            static const std::string& s
+            {
+                "RemoveFeature"
+            };
+            return s;
+        }
+        typedef core::trust::Store Interface;
+        typedef std::uint64_t ArgumentType;
+        typedef void ResultType;
+
+        inline static const std::chrono::milliseconds default_timeout()
+        {
+            return std::chrono::seconds{1};
+        }
+    };
+
+    // Removes all requests issued before a point in time, given in ticks since the epoch.
+    struct RemoveOlderThan
+    {
+        inline static const std::string& name()
+        {
+            static const std::string& s
+            {
+                "RemoveOlderThan"
+            };
+            return s;
+        }
+        typedef core::trust::Store Interface;
+        typedef std::int64_t ArgumentType;
+        typedef void ResultType;
+
+        inline static const std::chrono::milliseconds default_timeout()
+        {
+            return std::chrono::seconds{1};
+        }
+    };
+
     struct Reset
     {
         inline static const std::string& name()
@@ -439,6 +631,138 @@ struct Store
             return std::chrono::seconds{1};
         }
     };
+
+    // Returns the current generation of the store, as announced by Changed.
+    struct Generation
+    {
+        inline static const std::string& name()
+        {
+            static const std::string& s
+            {
+                "Generation"
+            };
+            return s;
+        }
+        typedef core::trust::Store Interface;
+        typedef void ArgumentType;
+        typedef std::uint64_t ResultType;
+
+        inline static const std::chrono::milliseconds default_timeout()
+        {
+            return std::chrono::seconds{1};
+        }
+    };
+
+    // Returns the per-application statistics maintained by the store.
+    struct Statistics
+    {
+        inline static const std::string& name()
+        {
+            static const std::string& s
+            {
+                "Statistics"
+            };
+            return s;
+        }
+        typedef core::trust::Store Interface;
+        typedef void ArgumentType;
+        typedef std::vector<core::trust::Store::Statistics> ResultType;
+
+        inline static const std::chrono::milliseconds default_timeout()
+        {
+            return std::chrono::seconds{1};
+        }
+    };
+
+    // Returns the reading end of a socket that all requests are streamed to, as
+    // written by core::trust::Store::export_to. Requests are not marshalled, and
+    // exports that fail midway lack the end record of the stream format.
+    struct Export
+    {
+        inline static const std::string& name()
+        {
+            static const std::string& s
+            {
+                "Export"
+            };
+            return s;
+        }
+        typedef core::trust::Store Interface;
+        typedef void ArgumentType;
+        typedef core::dbus::types::UnixFd ResultType;
+
+        inline static const std::chrono::milliseconds default_timeout()
+        {
+            return std::chrono::seconds{1};
+        }
+    };
+
+    // Imports all requests read from the given file descriptor, as written by
+    // core::trust::Store::export_to, and returns their number. The boolean argument
+    // requests deferring index maintenance until all requests have been read.
+    struct Import
+    {
+        inline static const std::string& name()
+        {
+            static const std::string& s
+            {
+                "Import"
+            };
+            return s;
+        }
+        typedef core::trust::Store Interface;
+        typedef std::tuple<core::dbus::types::UnixFd, bool> ArgumentType;
+        typedef std::uint64_t ResultType;
+
+        // Imports might be large, and we wait for the store to read all of them.
+        inline static const std::chrono::milliseconds default_timeout()
+        {
+            return std::chrono::minutes{5};
+        }
+    };
+
+    // Emitted whenever the content of the store changes.
+    struct Changed
+    {
+        // Kind enumerates all modifications announced by Changed.
+        enum class Kind : std::uint8_t
+        {
+            added, // A request has been added.
+            erased, // A request has been erased by a query.
+            application_removed, // All requests of an application have been removed.
+            reset, // The store has been reset.
+            feature_removed, // All requests for a feature have been removed.
+            older_removed, // All requests issued before a point in time have been removed.
+            results_erased, // All results of a query have been erased.
+            imported // Requests have been imported from a stream.
+        };
+
+        // Notification describes a single modification of the store.
+        struct Notification
+        {
+            // The generation of the store after the modification. Every
+            // modification increases the generation of the store by one.
+            std::uint64_t generation;
+            // The kind of modification.
+            Kind kind;
+            // The affected request. Only the application id is meaningful for
+            // Kind::application_removed, only the feature for Kind::feature_removed,
+            // only the timestamp for Kind::older_removed, and nothing is for
+            // Kind::reset, Kind::results_erased and Kind::imported.
+            core::trust::Request request;
+        };
+
+        inline static const std::string& name()
+        {
+            static const std::string& s
+            {
+                "Changed"
+            };
+            return s;
+        }
+        typedef core::trust::Store Interface;
+        typedef Notification ArgumentType;
+    };
 };
 }
 }
@@ -0,0 +1,136 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <core/trust/discarding_store.h>
+
+#include <stdexcept>
+
+namespace
+{
+// Decorates queries, discarding answers matching the query whenever results are erased.
+class Query : public core::trust::ForwardingStore::Query
+{
+public:
+    Query(const std::shared_ptr<core::trust::Store::Query>& impl, const core::trust::CachedAgent::Ptr& agent)
+        : core::trust::ForwardingStore::Query{impl}, agent{agent}
+    {
+    }
+
+    void for_application_id(const std::string& id) override { impl->for_application_id(id); application_id = std::make_shared<std::string>(id); }
+    void for_feature(core::trust::Feature feature) override { impl->for_feature(feature); this->feature = std::make_shared<core::trust::Feature>(feature); }
+    void for_interval(const core::trust::Request::Timestamp& begin, const core::trust::Request::Timestamp& end) override
+    {
+        impl->for_interval(begin, end);
+        interval = std::make_shared<std::pair<core::trust::Request::Timestamp, core::trust::Request::Timestamp>>(begin, end);
+    }
+    void for_answer(core::trust::Request::Answer answer) override { impl->for_answer(answer); this->answer = std::make_shared<core::trust::Request::Answer>(answer); }
+    void all() override { impl->all(); application_id.reset(); feature.reset(); interval.reset(); answer.reset(); }
+    void erase() override
+    {
+        auto erased = impl->current();
+        agent->discard([erased](const core::trust::Request& request)
+        {
+            return request.from == erased.from && request.feature == erased.feature;
+        });
+        impl->erase();
+    }
+    void erase_all() override
+    {
+        // Limits are not taken into account, and we might discard more answers than necessary.
+        auto application_id = this->application_id;
+        auto feature = this->feature;
+        auto interval = this->interval;
+        auto answer = this->answer;
+
+        agent->discard([application_id, feature, interval, answer](const core::trust::Request& request)
+        {
+            return (not application_id || request.from == *application_id) &&
+                   (not feature || request.feature == *feature) &&
+                   (not interval || (interval->first <= request.when && request.when <= interval->second)) &&
+                   (not answer || request.answer == *answer);
+        });
+        impl->erase_all();
+    }
+
+private:
+    core::trust::CachedAgent::Ptr agent;
+    // The criteria of the query, null if not given.
+    std::shared_ptr<std::string> application_id;
+    std::shared_ptr<core::trust::Feature> feature;
+    std::shared_ptr<std::pair<core::trust::Request::Timestamp, core::trust::Request::Timestamp>> interval;
+    std::shared_ptr<core::trust::Request::Answer> answer;
+};
+}
+
+core::trust::DiscardingStore::DiscardingStore(const std::shared_ptr<core::trust::Store>& impl, const core::trust::CachedAgent::Ptr& agent)
+    : core::trust::ForwardingStore{impl},
+      agent{agent}
+{
+    if (not agent) throw std::runtime_error
+    {
+        "Missing agent for discarding answers."
+    };
+}
+
+void core::trust::DiscardingStore::reset()
+{
+    agent->discard_all();
+    impl->reset();
+}
+
+// Pending answers take precedence over the store, and we hand them to the store
+// prior to additions, leaving it to the store to tell the most recent answer.
+void core::trust::DiscardingStore::add(const core::trust::Request& request)
+{
+    agent->flush();
+    impl->add(request);
+}
+
+void core::trust::DiscardingStore::add_all(const std::vector<core::trust::Request>& requests)
+{
+    agent->flush();
+    impl->add_all(requests);
+}
+
+std::size_t core::trust::DiscardingStore::load(const core::trust::Store::RequestSource& source, bool defer_indices)
+{
+    agent->flush();
+    return impl->load(source, defer_indices);
+}
+
+void core::trust::DiscardingStore::remove_application(const std::string& id)
+{
+    agent->discard([id](const core::trust::Request& request) { return request.from == id; });
+    impl->remove_application(id);
+}
+
+void core::trust::DiscardingStore::remove_feature(core::trust::Feature feature)
+{
+    agent->discard([feature](const core::trust::Request& request) { return request.feature == feature; });
+    impl->remove_feature(feature);
+}
+
+void core::trust::DiscardingStore::remove_older_than(const core::trust::Request::Timestamp& timestamp)
+{
+    agent->discard([timestamp](const core::trust::Request& request) { return request.when < timestamp; });
+    impl->remove_older_than(timestamp);
+}
+
+std::shared_ptr<core::trust::Store::Query> core::trust::DiscardingStore::query()
+{
+    return std::make_shared<::Query>(impl->query(), agent);
+}
@@ -18,35 +18,42 @@
 
 #include <core/trust/expose.h>
 
+#include <core/trust/notifying_store.h>
 #include <core/trust/store.h>
 
+#include "dbus/bus_pool.h"
 #include "dbus/codec.h"
 #include "dbus/interface.h"
 
-#include <core/dbus/asio/executor.h>
 #include <core/dbus/codec.h>
 #include <core/dbus/object.h>
 #include <core/dbus/service.h>
 #include <core/dbus/skeleton.h>
 
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+#include <linux/memfd.h>
+
 namespace dbus = core::dbus;
 
 namespace
 {
 namespace detail
 {
-std::shared_ptr<dbus::Bus> session_bus()
-{
-    std::shared_ptr<dbus::Bus> bus
-    {
-        new dbus::Bus(dbus::WellKnownBus::session)
-    };
-
-    bus->install_executor(dbus::asio::make_executor(bus));
-
-    return bus;
-}
-
 template<typename Key, typename Value>
 class Store
 {
@@ -69,61 +76,262 @@ private:
     std::map<Key, Value> map;
 };
 
+// Bounds the time a client gets for handing over a stream to be imported.
+constexpr const std::chrono::seconds import_deadline{60};
+// Bounds the size of streams to be imported.
+constexpr const std::size_t max_import_size{64 * 1024 * 1024};
+
+// Reads the stream to be imported from fd into an anonymous in-memory file, and returns the
+// file rewound to its start. Clients that do not hand over the complete stream within the
+// deadline or exceed the size limit are rejected. Throws std::runtime_error on failure.
+int buffer_import_from(int fd)
+{
+    int memfd = ::syscall(SYS_memfd_create, "trust-store-import", MFD_CLOEXEC);
+    if (memfd == -1)
+        throw std::system_error(errno, std::system_category());
+
+    auto deadline = std::chrono::steady_clock::now() + import_deadline;
+
+    std::vector<char> chunk(64 * 1024);
+    std::size_t size{0};
+
+    try
+    {
+        while (true)
+        {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+
+            if (remaining.count() <= 0)
+                throw std::runtime_error{"Timed out reading the stream to be imported."};
+
+            // We never block in read, but wait for data to arrive up to the deadline.
+            pollfd pfd{fd, POLLIN, 0};
+            auto rc = ::poll(&pfd, 1, remaining.count());
+
+            if (rc == -1 && errno != EINTR)
+                throw std::system_error(errno, std::system_category());
+
+            if (rc <= 0)
+                continue;
+
+            auto n = ::read(fd, chunk.data(), chunk.size());
+
+            if (n == -1)
+            {
+                if (errno == EINTR || errno == EAGAIN)
+                    continue;
+                throw std::system_error(errno, std::system_category());
+            }
+
+            if (n == 0)
+                break;
+
+            size += n;
+
+            if (size > max_import_size)
+                throw std::runtime_error{"Stream to be imported exceeds " + std::to_string(max_import_size) + " bytes."};
+
+            for (ssize_t written = 0; written < n;)
+            {
+                auto w = ::write(memfd, chunk.data() + written, n - written);
+
+                if (w == -1 && errno != EINTR)
+                    throw std::system_error(errno, std::system_category());
+
+                if (w > 0)
+                    written += w;
+            }
+        }
+
+        if (::lseek(memfd, 0, SEEK_SET) == -1)
+            throw std::system_error(errno, std::system_category());
+    } catch(...)
+    {
+        ::close(memfd);
+        throw;
+    }
+
+    return memfd;
+}
+
+// Runs ios until it runs out of work, reporting but never propagating exceptions
+// thrown by handlers.
+void execute_and_never_throw(boost::asio::io_service& ios) noexcept(true)
+{
+    while (true)
+    {
+        try
+        {
+            ios.run();
+            break;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << __PRETTY_FUNCTION__ << ": " << e.what() << std::endl;
+        }
+        catch (...)
+        {
+            std::cerr << __PRETTY_FUNCTION__ << ": unknown exception" << std::endl;
+        }
+    }
+}
+
 struct Token : public core::trust::Token
 {
+    // Serializes the handling of method calls dispatched through it.
+    typedef std::shared_ptr<boost::asio::io_service::strand> Strand;
+
     Token(const std::string& service_name,
           const std::shared_ptr<dbus::Bus>& bus,
-          const std::shared_ptr<core::trust::Store>& store)
+          const std::shared_ptr<core::trust::Store>& store,
+          const core::trust::NotifyingStore::Ptr& notifications,
+          std::size_t worker_count,
+          bool drive_bus)
         : store(store),
+          notifications(notifications),
           bus(bus),
           service(dbus::Service::add_service(bus, service_name)),
-          object(service->add_object_for_path(dbus::types::ObjectPath::root()))
+          object(service->add_object_for_path(dbus::types::ObjectPath::root())),
+          keep_alive{new boost::asio::io_service::work{dispatcher}},
+          store_strand{std::make_shared<boost::asio::io_service::strand>(dispatcher)},
+          import_strand{std::make_shared<boost::asio::io_service::strand>(dispatcher)},
+          export_strand{std::make_shared<boost::asio::io_service::strand>(dispatcher)}
     {
-        object->install_method_handler<core::trust::dbus::Store::Add>([this](const core::dbus::Message::Ptr& msg)
+        // Calls modifying the store and managing queries are handled in order.
+        install_dispatching_method_handler<core::trust::dbus::Store::Add>(object, store_strand, [this](const core::dbus::Message::Ptr& msg)
         {
             handle_add(msg);
         });
 
-        object->install_method_handler<core::trust::dbus::Store::RemoveApplication>([this](const core::dbus::Message::Ptr& msg)
+        install_dispatching_method_handler<core::trust::dbus::Store::RemoveApplication>(object, store_strand, [this](const core::dbus::Message::Ptr& msg)
         {
             handle_remove_application(msg);
         });
 
-        object->install_method_handler<core::trust::dbus::Store::Reset>([this](const core::dbus::Message::Ptr& msg)
+        install_dispatching_method_handler<core::trust::dbus::Store::RemoveFeature>(object, store_strand, [this](const core::dbus::Message::Ptr& msg)
+        {
+            handle_remove_feature(msg);
+        });
+
+        install_dispatching_method_handler<core::trust::dbus::Store::RemoveOlderThan>(object, store_strand, [this](const core::dbus::Message::Ptr& msg)
+        {
+            handle_remove_older_than(msg);
+        });
+
+        install_dispatching_method_handler<core::trust::dbus::Store::Reset>(object, store_strand, [this](const core::dbus::Message::Ptr& msg)
         {
             handle_reset(msg);
         });
 
-        object->install_method_handler<core::trust::dbus::Store::AddQuery>([this](const core::dbus::Message::Ptr& msg)
+        install_dispatching_method_handler<core::trust::dbus::Store::AddQuery>(object, store_strand, [this](const core::dbus::Message::Ptr& msg)
         {
             handle_add_query(msg);
         });
 
-        object->install_method_handler<core::trust::dbus::Store::RemoveQuery>([this](const core::dbus::Message::Ptr& msg)
+        install_dispatching_method_handler<core::trust::dbus::Store::RemoveQuery>(object, store_strand, [this](const core::dbus::Message::Ptr& msg)
         {
             handle_remove_query(msg);
         });
 
-        worker = std::move(std::thread([this](){Token::bus->run();}));
+        install_dispatching_method_handler<core::trust::dbus::Store::Generation>(object, store_strand, [this](const core::dbus::Message::Ptr& msg)
+        {
+            handle_generation(msg);
+        });
+
+        install_dispatching_method_handler<core::trust::dbus::Store::Statistics>(object, store_strand, [this](const core::dbus::Message::Ptr& msg)
+        {
+            handle_statistics(msg);
+        });
+
+        // Imports are read from the client before they enter the store, keeping
+        // slow clients from delaying modifications.
+        install_dispatching_method_handler<core::trust::dbus::Store::Import>(object, import_strand, [this](const core::dbus::Message::Ptr& msg)
+        {
+            handle_import(msg);
+        });
+
+        // Exports only read from the store, and block a worker until the client
+        // has drained them. We thus keep them from delaying modifications.
+        install_dispatching_method_handler<core::trust::dbus::Store::Export>(object, export_strand, [this](const core::dbus::Message::Ptr& msg)
+        {
+            handle_export(msg);
+        });
+
+        // All modifications are announced, including the ones applied by writers
+        // within the process that do not go through the bus.
+        connection = notifications->connect([this](core::trust::dbus::Store::Changed::Kind kind, const core::trust::Request& request)
+        {
+            announce_change(kind, request);
+        });
+
+        for (std::size_t i = 0; i < worker_count; i++)
+            workers.emplace_back(execute_and_never_throw, std::ref(dispatcher));
+
+        // Buses handed out by the pool are driven by the pool.
+        if (drive_bus)
+            worker = std::move(std::thread([this](){Token::bus->run();}));
     }
 
     ~Token()
     {
+        notifications->disconnect(connection);
+
         object->uninstall_method_handler<core::trust::dbus::Store::Add>();
         object->uninstall_method_handler<core::trust::dbus::Store::RemoveApplication>();
+        object->uninstall_method_handler<core::trust::dbus::Store::RemoveFeature>();
+        object->uninstall_method_handler<core::trust::dbus::Store::RemoveOlderThan>();
         object->uninstall_method_handler<core::trust::dbus::Store::Reset>();
         object->uninstall_method_handler<core::trust::dbus::Store::AddQuery>();
         object->uninstall_method_handler<core::trust::dbus::Store::RemoveQuery>();
-
-        bus->stop();
+        object->uninstall_method_handler<core::trust::dbus::Store::Generation>();
+        object->uninstall_method_handler<core::trust::dbus::Store::Statistics>();
+        object->uninstall_method_handler<core::trust::dbus::Store::Import>();
+        object->uninstall_method_handler<core::trust::dbus::Store::Export>();
 
         if (worker.joinable())
+        {
+            bus->stop();
             worker.join();
+        }
+
+        // No more calls come in, and we finish handling the ones dispatched already.
+        keep_alive.reset();
+
+        for (auto& w : workers)
+            if (w.joinable())
+                w.join();
+    }
+
+    // Installs a handler for Method on object that hands incoming calls over
+    // to the worker threads, handling them in order on strand.
+    template<typename Method>
+    static void install_dispatching_method_handler(
+            const std::shared_ptr<dbus::Object>& object,
+            const Strand& strand,
+            const std::function<void(const core::dbus::Message::Ptr&)>& handler)
+    {
+        object->install_method_handler<Method>([strand, handler](const core::dbus::Message::Ptr& msg)
+        {
+            strand->post([handler, msg]()
+            {
+                handler(msg);
+            });
+        });
+    }
+
+    // Bumps the generation of the store and announces the modification to all clients.
+    void announce_change(core::trust::dbus::Store::Changed::Kind kind, const core::trust::Request& request)
+    {
+        // Guarantees that notifications go out in the order of generations.
+        std::lock_guard<std::mutex> lg(change_guard);
+
+        object->emit_signal<core::trust::dbus::Store::Changed, core::trust::dbus::Store::Changed::ArgumentType>(
+                    core::trust::dbus::Store::Changed::Notification{++generation, kind, request});
     }
 
     void handle_add(const core::dbus::Message::Ptr& msg)
     {
-        core::trust::Request request;
+        core::trust::Request request{};
         msg->reader() >> request;
 
         try
@@ -167,6 +375,52 @@ struct Token : public core::trust::Token
         bus->send(reply);
     }
 
+    void handle_remove_feature(const core::dbus::Message::Ptr& msg)
+    {
+        std::uint64_t feature;
+        msg->reader() >> feature;
+
+        try
+        {
+            store->remove_feature(core::trust::Feature{feature});
+        } catch(const std::runtime_error& e)
+        {
+            auto error = dbus::Message::make_error(
+                        msg,
+                        core::trust::dbus::Store::Error::RemovingFeature::name(),
+                        e.what());
+
+            bus->send(error);
+            return;
+        }
+
+        auto reply = dbus::Message::make_method_return(msg);
+        bus->send(reply);
+    }
+
+    void handle_remove_older_than(const core::dbus::Message::Ptr& msg)
+    {
+        std::int64_t ticks;
+        msg->reader() >> ticks;
+
+        try
+        {
+            store->remove_older_than(core::trust::Request::Timestamp{core::trust::Request::Duration{ticks}});
+        } catch(const std::runtime_error& e)
+        {
+            auto error = dbus::Message::make_error(
+                        msg,
+                        core::trust::dbus::Store::Error::RemovingOlderRequests::name(),
+                        e.what());
+
+            bus->send(error);
+            return;
+        }
+
+        auto reply = dbus::Message::make_method_return(msg);
+        bus->send(reply);
+    }
+
     void handle_reset(const core::dbus::Message::Ptr& msg)
     {
         try
@@ -188,7 +442,7 @@ struct Token : public core::trust::Token
 
     void handle_add_query(const core::dbus::Message::Ptr& msg)
     {
-        static std::uint64_t query_counter = 0;
+        static std::atomic<std::uint64_t> query_counter{0};
 
         try
         {
@@ -196,14 +450,18 @@ struct Token : public core::trust::Token
             auto query = store->query();
             auto object = service->add_object_for_path(path);
 
-            object->install_method_handler<core::trust::dbus::Store::Query::All>([this, query](const core::dbus::Message::Ptr& msg)
+            // Calls on different queries are handled in parallel, calls on
+            // this query are handled in order.
+            auto strand = std::make_shared<boost::asio::io_service::strand>(dispatcher);
+
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::All>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
             {
                 query->all();
 
                 auto reply = core::dbus::Message::make_method_return(msg);
                 bus->send(reply);
             });
-            object->install_method_handler<core::trust::dbus::Store::Query::Current>([this, query](const core::dbus::Message::Ptr& msg)
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::Current>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
             {
                 try
                 {
@@ -221,21 +479,28 @@ struct Token : public core::trust::Token
                     bus->send(error);
                 }
             });
-            object->install_method_handler<core::trust::dbus::Store::Query::Erase>([this, query](const core::dbus::Message::Ptr& msg)
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::Erase>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
             {
                 query->erase();
 
                 auto reply = core::dbus::Message::make_method_return(msg);
                 bus->send(reply);
             });
-            object->install_method_handler<core::trust::dbus::Store::Query::Execute>([this, query](const core::dbus::Message::Ptr& msg)
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::EraseAll>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
+            {
+                query->erase_all();
+
+                auto reply = core::dbus::Message::make_method_return(msg);
+                bus->send(reply);
+            });
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::Execute>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
             {
                 query->execute();
 
                 auto reply = core::dbus::Message::make_method_return(msg);
                 bus->send(reply);
             });
-            object->install_method_handler<core::trust::dbus::Store::Query::ForAnswer>([this, query](const core::dbus::Message::Ptr& msg)
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::ForAnswer>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
             {
                 core::trust::Request::Answer a; msg->reader() >> a;
                 query->for_answer(a);
@@ -243,7 +508,27 @@ struct Token : public core::trust::Token
                 auto reply = core::dbus::Message::make_method_return(msg);
                 bus->send(reply);
             });
-            object->install_method_handler<core::trust::dbus::Store::Query::ForApplicationId>([this, query](const core::dbus::Message::Ptr& msg)
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::Limit>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
+            {
+                std::uint64_t count; msg->reader() >> count;
+                query->limit(count);
+
+                auto reply = core::dbus::Message::make_method_return(msg);
+                bus->send(reply);
+            });
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::Count>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
+            {
+                auto reply = core::dbus::Message::make_method_return(msg);
+                reply->writer() << static_cast<std::uint64_t>(query->count());
+                bus->send(reply);
+            });
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::Exists>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
+            {
+                auto reply = core::dbus::Message::make_method_return(msg);
+                reply->writer() << query->exists();
+                bus->send(reply);
+            });
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::ForApplicationId>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
             {
                 std::string app_id; msg->reader() >> app_id;
                 query->for_application_id(app_id);
@@ -251,7 +536,7 @@ struct Token : public core::trust::Token
                 auto reply = core::dbus::Message::make_method_return(msg);
                 bus->send(reply);
             });
-            object->install_method_handler<core::trust::dbus::Store::Query::ForFeature>([this, query](const core::dbus::Message::Ptr& msg)
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::ForFeature>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
             {
                 core::trust::Feature feature; msg->reader() >> feature;
                 query->for_feature(feature);
@@ -259,7 +544,7 @@ struct Token : public core::trust::Token
                 auto reply = core::dbus::Message::make_method_return(msg);
                 bus->send(reply);
             });
-            object->install_method_handler<core::trust::dbus::Store::Query::ForInterval>([this, query](const core::dbus::Message::Ptr& msg)
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::ForInterval>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
             {
                 std::tuple<std::int64_t, std::int64_t> interval; msg->reader() >> interval;
 
@@ -271,14 +556,14 @@ struct Token : public core::trust::Token
                 auto reply = core::dbus::Message::make_method_return(msg);
                 bus->send(reply);
             });
-            object->install_method_handler<core::trust::dbus::Store::Query::Next>([this, query](const core::dbus::Message::Ptr& msg)
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::Next>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
             {
                 query->next();
 
                 auto reply = core::dbus::Message::make_method_return(msg);
                 bus->send(reply);
             });
-            object->install_method_handler<core::trust::dbus::Store::Query::Status>([this, query](const core::dbus::Message::Ptr& msg)
+            install_dispatching_method_handler<core::trust::dbus::Store::Query::Status>(object, strand, [this, query](const core::dbus::Message::Ptr& msg)
             {
                 auto reply = core::dbus::Message::make_method_return(msg);
                 reply->writer() << query->status();
@@ -301,6 +586,114 @@ struct Token : public core::trust::Token
         }
     }
 
+    void handle_generation(const core::dbus::Message::Ptr& msg)
+    {
+        std::lock_guard<std::mutex> lg(change_guard);
+
+        auto reply = dbus::Message::make_method_return(msg);
+        reply->writer() << generation;
+        bus->send(reply);
+    }
+
+    void handle_statistics(const core::dbus::Message::Ptr& msg)
+    {
+        try
+        {
+            auto reply = dbus::Message::make_method_return(msg);
+            reply->writer() << store->statistics();
+            bus->send(reply);
+        } catch(const std::runtime_error& e)
+        {
+            auto error = core::dbus::Message::make_error(
+                        msg,
+                        core::trust::dbus::Store::Error::QueryingStatistics::name(),
+                        e.what());
+
+            bus->send(error);
+        }
+    }
+
+    void handle_import(const core::dbus::Message::Ptr& msg)
+    {
+        core::dbus::types::UnixFd fd; bool defer_indices{false};
+        msg->reader() >> fd >> defer_indices;
+
+        try
+        {
+            auto buffer = buffer_import_from(fd.to_raw());
+
+            // The buffered stream is available without blocking, and the store is modified in order.
+            store_strand->post([this, msg, buffer, defer_indices]()
+            {
+                handle_buffered_import(msg, buffer, defer_indices);
+            });
+        } catch(const std::runtime_error& e)
+        {
+            auto error = core::dbus::Message::make_error(
+                        msg,
+                        core::trust::dbus::Store::Error::ImportingStore::name(),
+                        e.what());
+
+            bus->send(error);
+        }
+    }
+
+    // Imports the stream buffered in fd, closing fd afterwards.
+    void handle_buffered_import(const core::dbus::Message::Ptr& msg, int fd, bool defer_indices)
+    {
+        try
+        {
+            auto count = store->import_from(fd, defer_indices);
+
+            auto reply = dbus::Message::make_method_return(msg);
+            reply->writer() << static_cast<std::uint64_t>(count);
+            bus->send(reply);
+        } catch(const std::runtime_error& e)
+        {
+            auto error = core::dbus::Message::make_error(
+                        msg,
+                        core::trust::dbus::Store::Error::ImportingStore::name(),
+                        e.what());
+
+            bus->send(error);
+        }
+
+        ::close(fd);
+    }
+
+    void handle_export(const core::dbus::Message::Ptr& msg)
+    {
+        // Sockets, other than pipes, allow for writing without raising SIGPIPE
+        // if the client goes away midway.
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == -1)
+        {
+            auto error = core::dbus::Message::make_error(
+                        msg,
+                        core::trust::dbus::Store::Error::ExportingStore::name(),
+                        std::system_error(errno, std::system_category()).what());
+
+            bus->send(error);
+            return;
+        }
+
+        auto reply = dbus::Message::make_method_return(msg);
+        reply->writer() << core::dbus::types::UnixFd{fds[0]};
+        bus->send(reply);
+        ::close(fds[0]);
+
+        // The client tells failed exports from complete ones by the stream lacking its end record.
+        try
+        {
+            store->export_to(fds[1]);
+        } catch(const std::runtime_error& e)
+        {
+            std::cerr << __PRETTY_FUNCTION__ << ": " << e.what() << std::endl;
+        }
+
+        ::close(fds[1]);
+    }
+
     void handle_remove_query(const core::dbus::Message::Ptr& msg)
     {
         try
@@ -320,24 +713,50 @@ struct Token : public core::trust::Token
     }
 
     std::shared_ptr<core::trust::Store> store;
+    // Notifies about all modifications of store.
+    core::trust::NotifyingStore::Ptr notifications;
+    core::trust::NotifyingStore::Connection connection{0};
     std::shared_ptr<dbus::Bus> bus;
     std::shared_ptr<dbus::Service> service;
     std::shared_ptr<dbus::Object> object;
     std::thread worker;
 
+    // Method calls are dispatched to and handled by workers.
+    boost::asio::io_service dispatcher;
+    std::unique_ptr<boost::asio::io_service::work> keep_alive;
+    std::vector<std::thread> workers;
+    // Serializes calls modifying the store.
+    Strand store_strand;
+    // Serializes reading streams to be imported.
+    Strand import_strand;
+    // Serializes exports.
+    Strand export_strand;
+
+    // Guards generation and the emission of change notifications.
+    std::mutex change_guard;
+    // Increased by one with every modification of the store.
+    std::uint64_t generation{0};
+
     detail::Store<core::dbus::types::ObjectPath, std::shared_ptr<core::dbus::Object>> query_store;
 };
-}
-}
 
-std::unique_ptr<core::trust::Token>
-core::trust::expose_store_to_bus_with_name(
+// Exposes store on bus under the given name, announcing modifications notified by
+// notifications. If drive_bus is true, the returned token runs bus on a dedicated thread.
+std::unique_ptr<core::trust::Token> expose(
         const std::shared_ptr<core::trust::Store>& store,
+        const core::trust::NotifyingStore::Ptr& notifications,
         const std::shared_ptr<core::dbus::Bus>& bus,
-        const std::string& name)
+        const std::string& name,
+        std::size_t worker_count,
+        bool drive_bus)
 {
     if (name.empty())
-        throw Errors::ServiceNameMustNotBeEmpty{};
+        throw core::trust::Errors::ServiceNameMustNotBeEmpty{};
+
+    if (worker_count == 0) throw std::invalid_argument
+    {
+        "At least one worker is required for handling method calls."
+    };
 
     return std::move(std::unique_ptr<core::trust::Token>
     {
@@ -345,15 +764,57 @@ core::trust::expose_store_to_bus_with_name(
         {
             "com.ubuntu.trust.store." + name,
             bus,
-            store
+            store,
+            notifications,
+            worker_count,
+            drive_bus
         }
     });
 }
+}
+}
+
+std::unique_ptr<core::trust::Token>
+core::trust::expose_store_to_bus_with_name(
+        const std::shared_ptr<core::trust::Store>& store,
+        const std::shared_ptr<core::dbus::Bus>& bus,
+        const std::string& name)
+{
+    return std::move(core::trust::expose_store_to_bus_with_name(store, bus, name, core::trust::default_store_worker_count));
+}
+
+std::unique_ptr<core::trust::Token>
+core::trust::expose_store_to_bus_with_name(
+        const std::shared_ptr<core::trust::Store>& store,
+        const std::shared_ptr<core::dbus::Bus>& bus,
+        const std::string& name,
+        std::size_t worker_count)
+{
+    auto notifications = std::make_shared<core::trust::NotifyingStore>(store);
+    return std::move(detail::expose(notifications, notifications, bus, name, worker_count, true));
+}
+
+std::unique_ptr<core::trust::Token>
+core::trust::expose_store_to_bus_with_name(
+        const std::shared_ptr<core::trust::Store>& store,
+        const core::trust::NotifyingStore::Ptr& notifications,
+        const std::shared_ptr<core::dbus::Bus>& bus,
+        const std::string& name)
+{
+    return std::move(detail::expose(store, notifications, bus, name, core::trust::default_store_worker_count, true));
+}
 
 std::unique_ptr<core::trust::Token>
 core::trust::expose_store_to_session_with_name(
         const std::shared_ptr<core::trust::Store>& store,
         const std::string& name)
 {
-    return std::move(core::trust::expose_store_to_bus_with_name(store, detail::session_bus(), name));
+    auto notifications = std::make_shared<core::trust::NotifyingStore>(store);
+    return std::move(detail::expose(
+            notifications,
+            notifications,
+            core::trust::dbus::BusPool::instance().bus_for_well_known_bus(core::dbus::WellKnownBus::session),
+            name,
+            core::trust::default_store_worker_count,
+            false));
 }
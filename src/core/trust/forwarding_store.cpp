@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <core/trust/forwarding_store.h>
+
+#include <stdexcept>
+
+core::trust::ForwardingStore::Query::Query(const std::shared_ptr<core::trust::Store::Query>& impl)
+    : impl{impl}
+{
+}
+
+core::trust::Store::Query::Status core::trust::ForwardingStore::Query::status() const
+{
+    return impl->status();
+}
+
+void core::trust::ForwardingStore::Query::for_application_id(const std::string& id)
+{
+    impl->for_application_id(id);
+}
+
+void core::trust::ForwardingStore::Query::for_feature(core::trust::Feature feature)
+{
+    impl->for_feature(feature);
+}
+
+void core::trust::ForwardingStore::Query::for_interval(const core::trust::Request::Timestamp& begin, const core::trust::Request::Timestamp& end)
+{
+    impl->for_interval(begin, end);
+}
+
+void core::trust::ForwardingStore::Query::for_answer(core::trust::Request::Answer answer)
+{
+    impl->for_answer(answer);
+}
+
+void core::trust::ForwardingStore::Query::limit(std::size_t count)
+{
+    impl->limit(count);
+}
+
+void core::trust::ForwardingStore::Query::all()
+{
+    impl->all();
+}
+
+void core::trust::ForwardingStore::Query::execute()
+{
+    impl->execute();
+}
+
+void core::trust::ForwardingStore::Query::next()
+{
+    impl->next();
+}
+
+void core::trust::ForwardingStore::Query::erase()
+{
+    impl->erase();
+}
+
+void core::trust::ForwardingStore::Query::erase_all()
+{
+    impl->erase_all();
+}
+
+core::trust::Request core::trust::ForwardingStore::Query::current()
+{
+    return impl->current();
+}
+
+std::size_t core::trust::ForwardingStore::Query::count()
+{
+    return impl->count();
+}
+
+bool core::trust::ForwardingStore::Query::exists()
+{
+    return impl->exists();
+}
+
+core::trust::ForwardingStore::ForwardingStore(const std::shared_ptr<core::trust::Store>& impl)
+    : impl{impl}
+{
+    if (not impl) throw std::runtime_error
+    {
+        "Missing store implementation."
+    };
+}
+
+void core::trust::ForwardingStore::reset()
+{
+    impl->reset();
+}
+
+void core::trust::ForwardingStore::add(const core::trust::Request& request)
+{
+    impl->add(request);
+}
+
+void core::trust::ForwardingStore::add_all(const std::vector<core::trust::Request>& requests)
+{
+    impl->add_all(requests);
+}
+
+std::size_t core::trust::ForwardingStore::load(const core::trust::Store::RequestSource& source, bool defer_indices)
+{
+    return impl->load(source, defer_indices);
+}
+
+void core::trust::ForwardingStore::remove_application(const std::string& id)
+{
+    impl->remove_application(id);
+}
+
+void core::trust::ForwardingStore::remove_feature(core::trust::Feature feature)
+{
+    impl->remove_feature(feature);
+}
+
+void core::trust::ForwardingStore::remove_older_than(const core::trust::Request::Timestamp& timestamp)
+{
+    impl->remove_older_than(timestamp);
+}
+
+std::shared_ptr<core::trust::Store::Query> core::trust::ForwardingStore::query()
+{
+    return std::make_shared<Query>(impl->query());
+}
+
+std::vector<core::trust::Store::Statistics> core::trust::ForwardingStore::statistics()
+{
+    return impl->statistics();
+}
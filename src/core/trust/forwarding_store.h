@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_FORWARDING_STORE_H_
+#define CORE_TRUST_FORWARDING_STORE_H_
+
+#include <core/trust/store.h>
+#include <core/trust/visibility.h>
+
+#include <memory>
+
+namespace core
+{
+namespace trust
+{
+// Forwards all operations to an actual store implementation. Serves as the base of
+// decorators, which only override the operations they are interested in. export_to
+// and import_from are left to their default implementations, such that decorators
+// observe them as queries and loads, respectively.
+class CORE_TRUST_DLL_PUBLIC ForwardingStore : public core::trust::Store
+{
+public:
+    // Forwards all operations to an actual query implementation.
+    class CORE_TRUST_DLL_PUBLIC Query : public core::trust::Store::Query
+    {
+    public:
+        Query(const std::shared_ptr<core::trust::Store::Query>& impl);
+
+        // From core::trust::Store::Query
+        Status status() const override;
+        void for_application_id(const std::string& id) override;
+        void for_feature(Feature feature) override;
+        void for_interval(const Request::Timestamp& begin, const Request::Timestamp& end) override;
+        void for_answer(Request::Answer answer) override;
+        void limit(std::size_t count) override;
+        void all() override;
+        void execute() override;
+        void next() override;
+        void erase() override;
+        void erase_all() override;
+        Request current() override;
+        std::size_t count() override;
+        bool exists() override;
+
+    protected:
+        std::shared_ptr<core::trust::Store::Query> impl;
+    };
+
+    ForwardingStore(const std::shared_ptr<Store>& impl);
+
+    // From core::trust::Store
+    void reset() override;
+    void add(const Request& request) override;
+    void add_all(const std::vector<Request>& requests) override;
+    std::size_t load(const RequestSource& source, bool defer_indices) override;
+    void remove_application(const std::string& id) override;
+    void remove_feature(Feature feature) override;
+    void remove_older_than(const Request::Timestamp& timestamp) override;
+    std::shared_ptr<core::trust::Store::Query> query() override;
+    std::vector<Statistics> statistics() override;
+
+protected:
+    std::shared_ptr<Store> impl;
+};
+}
+}
+
+#endif // CORE_TRUST_FORWARDING_STORE_H_
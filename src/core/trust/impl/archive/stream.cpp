@@ -0,0 +1,380 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/impl/archive/stream.h>
+
+#include <boost/crc.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace archive = core::trust::impl::archive;
+
+namespace
+{
+constexpr const char magic[] = {'T', 'R', 'U', 'S', 'T', 'E', 'X', 'P'};
+constexpr const std::size_t header_size{sizeof(magic) + sizeof(archive::format_version)};
+
+// Every record is framed by the size of its payload and the crc32 of the payload.
+constexpr const std::size_t frame_size{2 * sizeof(std::uint32_t)};
+// Bounds the memory spent on a single record, protecting against corrupted sizes.
+constexpr const std::uint32_t max_payload_size{1024 * 1024};
+// The size of a single encoded request within a requests record.
+constexpr const std::size_t request_size{sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(std::int64_t) + sizeof(std::uint8_t)};
+// Output is written and input is read in chunks of this size.
+constexpr const std::size_t chunk_size{64 * 1024};
+
+template<typename Integer>
+void put(std::string& out, Integer value)
+{
+    for (std::size_t i = 0; i < sizeof(Integer); i++)
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+void put(std::string& out, const std::string& s)
+{
+    put<std::uint32_t>(out, s.size());
+    out.append(s);
+}
+
+// Decoder decodes values from a buffer, tracking whether the buffer has been exhausted.
+class Decoder
+{
+public:
+    Decoder(const char* begin, const char* end) : it(begin), end(end)
+    {
+    }
+
+    template<typename Integer>
+    Integer get()
+    {
+        Integer value{0};
+
+        if (static_cast<std::size_t>(end - it) < sizeof(Integer))
+        {
+            ok = false;
+            return value;
+        }
+
+        for (std::size_t i = 0; i < sizeof(Integer); i++)
+            value |= static_cast<Integer>(static_cast<std::uint8_t>(*it++)) << (8 * i);
+
+        return value;
+    }
+
+    std::string get_string()
+    {
+        auto size = get<std::uint32_t>();
+
+        if (not ok || static_cast<std::size_t>(end - it) < size)
+        {
+            ok = false;
+            return std::string{};
+        }
+
+        std::string s{it, it + size}; it += size;
+        return s;
+    }
+
+    // Returns the number of bytes consumed from begin.
+    std::size_t consumed(const char* begin) const
+    {
+        return it - begin;
+    }
+
+    // Returns true if all values could be decoded so far and nothing is left.
+    bool exhausted() const
+    {
+        return ok && it == end;
+    }
+
+    // Returns true if all values could be decoded so far.
+    bool good() const
+    {
+        return ok;
+    }
+
+private:
+    const char* it;
+    const char* end;
+    bool ok{true};
+};
+
+std::uint32_t crc32(const char* data, std::size_t size)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(data, size);
+    return crc.checksum();
+}
+
+// Returns true if fd refers to a socket.
+bool is_socket(int fd)
+{
+    struct stat st;
+    return ::fstat(fd, &st) == 0 && S_ISSOCK(st.st_mode);
+}
+
+// write_or_throw writes all of data to fd. Sockets are written to without raising
+// SIGPIPE if their reader went away.
+void write_or_throw(int fd, bool socket, const std::string& data)
+{
+    std::size_t written{0};
+
+    while (written < data.size())
+    {
+        auto rc = socket ?
+                    ::send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL) :
+                    ::write(fd, data.data() + written, data.size() - written);
+
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::system_category());
+        }
+
+        written += rc;
+    }
+}
+
+std::string header()
+{
+    std::string s{magic, sizeof(magic)};
+    put(s, archive::format_version);
+    return s;
+}
+}
+
+archive::Writer::Writer(int fd) : fd{fd}, socket{is_socket(fd)}, out{header()}
+{
+    flush();
+}
+
+void archive::Writer::write(const core::trust::Request& request)
+{
+    auto it = applications.find(request.from);
+
+    // App ids are announced prior to the first request referring to them.
+    if (it == applications.end())
+    {
+        std::string payload;
+        put(payload, static_cast<std::uint8_t>(RecordType::application));
+        put<std::uint32_t>(payload, applications.size());
+        put(payload, request.from);
+        append(payload);
+
+        it = applications.insert(std::make_pair(request.from, applications.size())).first;
+    }
+
+    put<std::uint32_t>(requests, it->second);
+    put<std::uint64_t>(requests, request.feature.value);
+    put(requests, static_cast<std::uint64_t>(request.when.time_since_epoch().count()));
+    put(requests, static_cast<std::uint8_t>(request.answer));
+
+    if (++pending == requests_per_record)
+        flush_requests();
+
+    if (out.size() >= chunk_size)
+        flush();
+}
+
+std::uint64_t archive::Writer::finish()
+{
+    flush_requests();
+
+    std::string payload;
+    put(payload, static_cast<std::uint8_t>(RecordType::end));
+    put(payload, count);
+    append(payload);
+
+    flush();
+
+    return count;
+}
+
+void archive::Writer::append(const std::string& payload)
+{
+    put<std::uint32_t>(out, payload.size());
+    put<std::uint32_t>(out, crc32(payload.data(), payload.size()));
+    out.append(payload);
+}
+
+void archive::Writer::flush_requests()
+{
+    if (pending == 0)
+        return;
+
+    std::string payload;
+    put(payload, static_cast<std::uint8_t>(RecordType::requests));
+    put(payload, pending);
+    payload.append(requests);
+    append(payload);
+
+    count += pending;
+    pending = 0;
+    requests.clear();
+}
+
+void archive::Writer::flush()
+{
+    write_or_throw(fd, socket, out);
+    out.clear();
+}
+
+archive::Reader::Reader(int fd) : fd{fd}
+{
+    std::string s(header_size, '\0');
+    read_exactly(&s[0], s.size());
+
+    if (s.compare(0, sizeof(magic), magic, sizeof(magic)) != 0)
+        throw std::runtime_error{"Stream does not hold exported requests."};
+
+    Decoder decoder{s.data() + sizeof(magic), s.data() + s.size()};
+    auto version = decoder.get<std::uint32_t>();
+
+    if (version != format_version)
+        throw std::runtime_error{"Stream has an unsupported format version: " + std::to_string(version)};
+}
+
+bool archive::Reader::read(core::trust::Request& request)
+{
+    while (remaining == 0)
+    {
+        if (done)
+            return false;
+
+        next_record();
+    }
+
+    Decoder decoder{payload.data() + offset, payload.data() + offset + request_size};
+    auto index = decoder.get<std::uint32_t>();
+    auto feature = decoder.get<std::uint64_t>();
+    auto ticks = static_cast<std::int64_t>(decoder.get<std::uint64_t>());
+    auto answer = decoder.get<std::uint8_t>();
+
+    if (index >= applications.size())
+        throw std::runtime_error{"Stream refers to an unknown application."};
+
+    if (answer != static_cast<std::uint8_t>(core::trust::Request::Answer::denied) &&
+            answer != static_cast<std::uint8_t>(core::trust::Request::Answer::granted))
+        throw std::runtime_error{"Stream holds an unknown answer."};
+
+    request.from = applications[index];
+    request.feature = core::trust::Feature{feature};
+    request.when = core::trust::Request::Timestamp{core::trust::Request::Duration{ticks}};
+    request.answer = static_cast<core::trust::Request::Answer>(answer);
+
+    offset += request_size;
+    remaining--;
+    count++;
+
+    return true;
+}
+
+void archive::Reader::next_record()
+{
+    char frame[frame_size];
+    read_exactly(frame, sizeof(frame));
+
+    Decoder decoder{frame, frame + sizeof(frame)};
+    auto size = decoder.get<std::uint32_t>();
+    auto checksum = decoder.get<std::uint32_t>();
+
+    if (size == 0 || size > max_payload_size)
+        throw std::runtime_error{"Stream holds a record of invalid size."};
+
+    payload.resize(size);
+    read_exactly(&payload[0], payload.size());
+
+    if (crc32(payload.data(), payload.size()) != checksum)
+        throw std::runtime_error{"Stream holds a record with a checksum mismatch."};
+
+    Decoder record{payload.data(), payload.data() + payload.size()};
+
+    switch (static_cast<RecordType>(record.get<std::uint8_t>()))
+    {
+    case RecordType::application:
+    {
+        auto index = record.get<std::uint32_t>();
+        auto application = record.get_string();
+
+        if (not record.exhausted() || index != applications.size())
+            throw std::runtime_error{"Stream holds an invalid application record."};
+
+        applications.push_back(application);
+        break;
+    }
+    case RecordType::requests:
+    {
+        auto n = record.get<std::uint32_t>();
+        offset = record.consumed(payload.data());
+
+        if (not record.good() || payload.size() - offset != n * request_size)
+            throw std::runtime_error{"Stream holds an invalid requests record."};
+
+        remaining = n;
+        break;
+    }
+    case RecordType::end:
+    {
+        auto n = record.get<std::uint64_t>();
+
+        if (not record.exhausted() || n != count)
+            throw std::runtime_error{"Stream holds an invalid end record."};
+
+        done = true;
+        break;
+    }
+    default:
+        throw std::runtime_error{"Stream holds a record of unknown type."};
+    }
+}
+
+void archive::Reader::read_exactly(char* buffer, std::size_t size)
+{
+    while (size > 0)
+    {
+        if (input_offset == input.size())
+        {
+            input.resize(chunk_size);
+            auto rc = ::read(fd, &input[0], input.size());
+
+            if (rc < 0)
+            {
+                input.clear(); input_offset = 0;
+
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::system_category());
+            }
+
+            if (rc == 0)
+                throw std::runtime_error{"Stream ended prematurely."};
+
+            input.resize(rc); input_offset = 0;
+        }
+
+        auto n = std::min(size, input.size() - input_offset);
+        input.copy(buffer, n, input_offset);
+
+        buffer += n; size -= n; input_offset += n;
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_TRUST_IMPL_ARCHIVE_STREAM_H_
+#define CORE_TRUST_IMPL_ARCHIVE_STREAM_H_
+
+#include <core/trust/request.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace core
+{
+namespace trust
+{
+namespace impl
+{
+namespace archive
+{
+// Requests are exported to and imported from a stream of the following shape:
+//
+// |-------------------------------------------------------------------------------|
+// | header   | Magic : "TRUSTEXP" | Version : u32                                  |
+// | record   | Size : u32 | Crc32 : u32 | Payload : Size bytes                     |
+// | ...      |                                                                     |
+// |-------------------------------------------------------------------------------|
+//
+// Every payload starts with its RecordType, followed by:
+//
+// |-------------------------------------------------------------------------------|
+// | application | Index : u32 | ApplicationId                                      |
+// | requests    | Count : u32 | Count x (Index : u32 | Feature : u64 |             |
+// |             |               Timestamp : i64 | Answer : u8)                     |
+// | end         | Count : u64                                                      |
+// |-------------------------------------------------------------------------------|
+//
+// App ids are dictionary encoded: an application record assigns the next index to an app
+// id prior to the first request referring to it. The end record carries the total number of
+// requests and tells complete streams from truncated ones. All integers are stored in
+// little-endian order, strings are prefixed by their size as u32.
+enum class RecordType : std::uint8_t
+{
+    application = 1,
+    requests = 2,
+    end = 3
+};
+
+// The version of the stream format written by Writer and understood by Reader.
+constexpr const std::uint32_t format_version{1};
+
+// Writer encodes requests to a file descriptor, buffering a bounded number of them.
+class Writer
+{
+public:
+    // The maximum number of requests encoded in a single record.
+    static constexpr const std::size_t requests_per_record{256};
+
+    // Writes the header to fd, which stays owned by the caller.
+    explicit Writer(int fd);
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // Encodes request, throwing std::runtime_error if writing to fd fails.
+    void write(const Request& request);
+
+    // Flushes all pending requests followed by the end record and returns the
+    // number of requests written. No requests must be written afterwards.
+    std::uint64_t finish();
+
+private:
+    // Frames payload and appends it to the output.
+    void append(const std::string& payload);
+    // Appends the pending requests as a single record.
+    void flush_requests();
+    // Writes out all buffered output.
+    void flush();
+
+    int fd;
+    bool socket;
+    std::unordered_map<std::string, std::uint32_t> applications;
+    std::string requests;
+    std::uint32_t pending{0};
+    std::uint64_t count{0};
+    std::string out;
+};
+
+// Reader decodes requests from a file descriptor, reading ahead a bounded amount of data.
+// Throws std::runtime_error for streams that are truncated, corrupted, or of an unknown format
+// version.
+class Reader
+{
+public:
+    // Reads and validates the header from fd, which stays owned by the caller.
+    explicit Reader(int fd);
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    // Decodes the next request into request, returning false once the end
+    // record has been read.
+    bool read(Request& request);
+
+private:
+    // Reads the next record into payload, validating its checksum.
+    void next_record();
+    // Reads exactly size bytes from fd into buffer, throwing on a premature end.
+    void read_exactly(char* buffer, std::size_t size);
+
+    int fd;
+    std::vector<std::string> applications;
+    std::string payload;
+    std::size_t offset{0};
+    std::uint32_t remaining{0};
+    std::uint64_t count{0};
+    bool done{false};
+    std::string input;
+    std::size_t input_offset{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_TRUST_IMPL_ARCHIVE_STREAM_H_
@@ -0,0 +1,885 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/store.h>
+#include <core/trust/impl/log_structured/store.h>
+
+#include <xdg.h>
+
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace fs = boost::filesystem;
+
+namespace core
+{
+namespace trust
+{
+namespace impl
+{
+namespace log_structured
+{
+namespace
+{
+// The log starts with a header made up of this magic, followed by the format version.
+constexpr const char magic[] = {'T', 'R', 'U', 'S', 'T', 'L', 'O', 'G'};
+constexpr const std::uint32_t format_version{1};
+constexpr const std::size_t header_size{sizeof(magic) + sizeof(format_version)};
+
+// Every record is framed by the size of its payload and the crc32 of the payload.
+constexpr const std::size_t frame_size{2 * sizeof(std::uint32_t)};
+
+// RecordType enumerates all kinds of records found in the log.
+//
+// |------------------------------------------------------------------------------------------------|
+// | add                | Id : u64 | Timestamp : i64 | Feature : u64 | Answer : u8 | ApplicationId |
+// | erase              | Id : u64 |                                                                |
+// | remove_application | ApplicationId                                                             |
+// |------------------------------------------------------------------------------------------------|
+//
+// All integers are stored in little-endian order, strings are prefixed by their size as u32.
+enum class RecordType : std::uint8_t
+{
+    add = 1,
+    erase = 2,
+    remove_application = 3
+};
+
+// ensure_dir_or_throw ensures that the directory p exists
+// with the correct permissions, i.e., 0700.
+fs::path ensure_dir_or_throw(const fs::path& p)
+{
+    static const mode_t owner_all = S_IRWXU;
+    if (::mkdir(p.string().c_str(), owner_all) != 0)
+    {
+        if (errno != EEXIST) throw std::system_error(errno, std::system_category());
+    }
+
+    return p;
+}
+
+template<typename Integer>
+void put(std::string& out, Integer value)
+{
+    for (std::size_t i = 0; i < sizeof(Integer); i++)
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+void put(std::string& out, const std::string& s)
+{
+    put<std::uint32_t>(out, s.size());
+    out.append(s);
+}
+
+// Reader decodes values from a buffer, tracking whether the buffer has been exhausted.
+class Reader
+{
+public:
+    Reader(const char* begin, const char* end) : it(begin), end(end)
+    {
+    }
+
+    template<typename Integer>
+    Integer get()
+    {
+        Integer value{0};
+
+        if (static_cast<std::size_t>(end - it) < sizeof(Integer))
+        {
+            ok = false;
+            return value;
+        }
+
+        for (std::size_t i = 0; i < sizeof(Integer); i++)
+            value |= static_cast<Integer>(static_cast<std::uint8_t>(*it++)) << (8 * i);
+
+        return value;
+    }
+
+    std::string get_string()
+    {
+        auto size = get<std::uint32_t>();
+
+        if (not ok || static_cast<std::size_t>(end - it) < size)
+        {
+            ok = false;
+            return std::string{};
+        }
+
+        std::string s{it, it + size}; it += size;
+        return s;
+    }
+
+    // Returns true if all values could be decoded so far.
+    bool good() const
+    {
+        return ok;
+    }
+
+private:
+    const char* it;
+    const char* end;
+    bool ok{true};
+};
+
+std::uint32_t crc32(const char* data, std::size_t size)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(data, size);
+    return crc.checksum();
+}
+
+// write_or_throw writes all of data to fd.
+void write_or_throw(int fd, const std::string& data)
+{
+    std::size_t written{0};
+
+    while (written < data.size())
+    {
+        auto rc = ::write(fd, data.data() + written, data.size() - written);
+
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::system_category());
+        }
+
+        written += rc;
+    }
+}
+
+// read_all_or_throw reads the entire content of the file referred to by fd.
+std::string read_all_or_throw(int fd)
+{
+    std::string content;
+    char buffer[64 * 1024];
+
+    while (true)
+    {
+        auto rc = ::pread(fd, buffer, sizeof(buffer), content.size());
+
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::system_category());
+        }
+
+        if (rc == 0)
+            break;
+
+        content.append(buffer, rc);
+    }
+
+    return content;
+}
+
+std::string header()
+{
+    std::string s{magic, sizeof(magic)};
+    put(s, format_version);
+    return s;
+}
+
+// Frames payload by its size and checksum.
+std::string frame(const std::string& payload)
+{
+    std::string s;
+    put<std::uint32_t>(s, payload.size());
+    put<std::uint32_t>(s, crc32(payload.data(), payload.size()));
+    s.append(payload);
+    return s;
+}
+
+std::string add_record(std::uint64_t id, const core::trust::Request& request)
+{
+    std::string s;
+    put(s, static_cast<std::uint8_t>(RecordType::add));
+    put(s, id);
+    put(s, static_cast<std::uint64_t>(request.when.time_since_epoch().count()));
+    put<std::uint64_t>(s, request.feature.value);
+    put(s, static_cast<std::uint8_t>(request.answer));
+    put(s, request.from);
+    return s;
+}
+
+// Filter captures the limits applied to a query.
+struct Filter
+{
+    // A limit is only applied if its first member is true.
+    std::pair<bool, std::string> application_id;
+    std::pair<bool, std::uint64_t> feature;
+    std::pair<bool, std::pair<std::int64_t, std::int64_t>> interval;
+    std::pair<bool, core::trust::Request::Answer> answer;
+    // The maximum number of most recent results.
+    std::pair<bool, std::size_t> count;
+
+    // Returns true if request satisfies all limits, apart from count.
+    bool matches(const core::trust::Request& request) const
+    {
+        auto when = request.when.time_since_epoch().count();
+
+        return (not application_id.first || application_id.second == request.from) &&
+               (not feature.first || feature.second == request.feature.value) &&
+               (not interval.first || (interval.second.first <= when && when <= interval.second.second)) &&
+               (not answer.first || answer.second == request.answer);
+    }
+};
+
+// Key identifies all requests for a feature issued by an application.
+struct Key
+{
+    bool operator==(const Key& rhs) const
+    {
+        return application_id == rhs.application_id && feature == rhs.feature;
+    }
+
+    std::string application_id;
+    std::uint64_t feature;
+};
+
+struct KeyHash
+{
+    std::size_t operator()(const Key& key) const
+    {
+        return std::hash<std::string>()(key.application_id) ^ (std::hash<std::uint64_t>()(key.feature) << 1);
+    }
+};
+
+// A store implementation persisting requests in an append-only log.
+class Store
+        : public core::trust::Store,
+          public std::enable_shared_from_this<Store>
+{
+public:
+    // A request known to the store, together with its id.
+    typedef std::pair<std::uint64_t, core::trust::Request> Entry;
+
+    // An implementation of the query interface for the log-structured store.
+    class Query : public core::trust::Store::Query
+    {
+    public:
+        // Constructs the query and associates it with its store.
+        // That is: As long as a query is alive, the store is kept alive, too.
+        Query(const std::shared_ptr<Store>& store) : store(store)
+        {
+        }
+
+        Status status() const
+        {
+            return current_status;
+        }
+
+        void for_application_id(const std::string& id)
+        {
+            filter.application_id = std::make_pair(true, id);
+        }
+
+        void for_feature(core::trust::Feature feature)
+        {
+            filter.feature = std::make_pair(true, feature.value);
+        }
+
+        void for_interval(const core::trust::Request::Timestamp& begin, const core::trust::Request::Timestamp& end)
+        {
+            filter.interval = std::make_pair(true, std::make_pair(begin.time_since_epoch().count(), end.time_since_epoch().count()));
+        }
+
+        void for_answer(core::trust::Request::Answer answer)
+        {
+            filter.answer = std::make_pair(true, answer);
+        }
+
+        void limit(std::size_t count)
+        {
+            filter.count = std::make_pair(true, count);
+        }
+
+        void all()
+        {
+            filter = Filter{};
+        }
+
+        void execute()
+        {
+            results = store->select(filter);
+            position = 0;
+            update_status();
+        }
+
+        void next()
+        {
+            position++;
+            update_status();
+        }
+
+        void erase()
+        {
+            if (Status::has_more_results != current_status)
+                throw std::runtime_error("Cannot delete request as query points beyond the result set.");
+
+            store->erase(results.at(position).first);
+            next();
+        }
+
+        std::size_t count()
+        {
+            return store->select(filter).size();
+        }
+
+        bool exists()
+        {
+            auto limited = filter;
+            limited.count = std::make_pair(true, std::min<std::size_t>(1, filter.count.first ? filter.count.second : 1));
+            return not store->select(limited).empty();
+        }
+
+        void erase_all()
+        {
+            store->erase_all(filter);
+
+            results.clear();
+            position = 0;
+            update_status();
+        }
+
+        core::trust::Request current()
+        {
+            if (Status::has_more_results != current_status)
+                throw Errors::NoCurrentResult{};
+
+            return results.at(position).second;
+        }
+
+    private:
+        void update_status()
+        {
+            current_status = position < results.size() ? Status::has_more_results : Status::eor;
+        }
+
+        std::shared_ptr<Store> store;
+        Filter filter;
+        Status current_status{Status::armed};
+        // The results of the last execution, ordered by timestamp, latest first.
+        std::vector<Entry> results;
+        std::size_t position{0};
+    };
+
+    // Opens the log at path, creating it if it does not exist yet.
+    Store(const fs::path& path, const Configuration& configuration);
+    ~Store();
+
+    // From core::trust::Store
+    void reset();
+    void add(const core::trust::Request& request);
+    void add_all(const std::vector<core::trust::Request>& requests);
+    void remove_application(const std::string& id);
+    std::shared_ptr<core::trust::Store::Query> query();
+
+    // Returns all requests matching filter, ordered by timestamp, latest first.
+    std::vector<Entry> select(const Filter& filter);
+
+    // Erases the request with the given id, if it is still known.
+    void erase(std::uint64_t id);
+
+    // Erases all requests matching filter, appending their records with a single write.
+    void erase_all(const Filter& filter);
+
+private:
+    // Returns all requests matching filter, ordered by timestamp, latest first. Has to be called with guard held.
+    std::vector<Entry> select_locked(const Filter& filter);
+
+    // Decodes payload and applies it to the index, returning false if payload is malformed.
+    bool apply(const std::string& payload);
+
+    // Indexes request under id.
+    void insert(std::uint64_t id, const core::trust::Request& request);
+
+    // Drops the request with the given id from the index.
+    void drop(std::uint64_t id);
+
+    // Appends payload to the log. Has to be called with guard held.
+    void append(const std::string& payload);
+
+    // Appends all payloads to the log with a single write, or none of them. Has to be called with guard held.
+    void append(const std::vector<std::string>& payloads);
+
+    // Rewrites the log to contain only live requests. Has to be called with guard held.
+    void compact();
+
+    // Compacts the log if enough records became obsolete. Has to be called with guard held.
+    void compact_if_required();
+
+    fs::path path;
+    Configuration configuration;
+
+    std::mutex guard;
+    int fd{-1};
+    // The id assigned to the next request added to the store.
+    std::uint64_t next_id{0};
+    // The number of records in the log.
+    std::size_t records{0};
+    // True if a failed append might have left a partial record behind.
+    bool failed{false};
+
+    std::map<std::uint64_t, core::trust::Request> requests;
+    std::unordered_map<std::string, std::set<std::uint64_t>> by_application_id;
+    std::unordered_map<Key, std::set<std::uint64_t>, KeyHash> by_key;
+};
+
+Store::Store(const fs::path& path, const Configuration& configuration)
+    : path(path),
+      configuration(configuration),
+      fd{::open(path.string().c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR)}
+{
+    if (fd == -1) throw core::trust::Store::Errors::ErrorOpeningStore
+    {
+        std::system_error(errno, std::system_category(), "Problem opening log file " + path.string()).what()
+    };
+
+    try
+    {
+        auto content = read_all_or_throw(fd);
+
+        if (content.empty())
+        {
+            write_or_throw(fd, header());
+            return;
+        }
+
+        if (content.size() < header_size || content.compare(0, header_size, header()) != 0)
+            throw core::trust::Store::Errors::ErrorOpeningStore{"Log file has an unknown format."};
+
+        // We replay all records, stopping at the first incomplete or corrupt one.
+        std::size_t offset{header_size};
+        while (content.size() - offset >= frame_size)
+        {
+            Reader reader{content.data() + offset, content.data() + offset + frame_size};
+            auto size = reader.get<std::uint32_t>();
+            auto checksum = reader.get<std::uint32_t>();
+
+            if (content.size() - offset - frame_size < size)
+                break;
+
+            std::string payload{content.data() + offset + frame_size, size};
+
+            if (crc32(payload.data(), payload.size()) != checksum || not apply(payload))
+                break;
+
+            offset += frame_size + size;
+            records++;
+        }
+
+        // A crash might have left a partially written record behind, which we drop.
+        if (offset < content.size() && ::ftruncate(fd, offset) != 0)
+            throw std::system_error(errno, std::system_category());
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+}
+
+Store::~Store()
+{
+    ::close(fd);
+}
+
+void Store::reset()
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    try
+    {
+        requests.clear();
+        by_application_id.clear();
+        by_key.clear();
+
+        compact();
+    } catch(const std::exception& e)
+    {
+        throw core::trust::Store::Errors::ErrorResettingStore{e.what()};
+    }
+}
+
+void Store::add(const core::trust::Request& request)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto id = next_id;
+    append(add_record(id, request));
+    insert(id, request);
+}
+
+void Store::add_all(const std::vector<core::trust::Request>& requests)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    std::vector<std::string> payloads;
+    for (std::size_t i = 0; i < requests.size(); i++)
+        payloads.push_back(add_record(next_id + i, requests[i]));
+
+    append(payloads);
+
+    for (const auto& request : requests)
+        insert(next_id, request);
+}
+
+void Store::remove_application(const std::string& id)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = by_application_id.find(id);
+    if (it == by_application_id.end())
+        return;
+
+    std::string payload;
+    put(payload, static_cast<std::uint8_t>(RecordType::remove_application));
+    put(payload, id);
+    append(payload);
+
+    auto ids = it->second;
+    for (auto i : ids)
+        drop(i);
+
+    compact_if_required();
+}
+
+std::shared_ptr<core::trust::Store::Query> Store::query()
+{
+    return std::make_shared<Store::Query>(shared_from_this());
+}
+
+std::vector<Store::Entry> Store::select(const Filter& filter)
+{
+    std::lock_guard<std::mutex> lg(guard);
+    return select_locked(filter);
+}
+
+std::vector<Store::Entry> Store::select_locked(const Filter& filter)
+{
+    std::vector<Entry> result;
+
+    auto collect = [this, &filter, &result](std::uint64_t id)
+    {
+        const auto& request = requests.at(id);
+        if (filter.matches(request))
+            result.push_back(std::make_pair(id, request));
+    };
+
+    // We narrow down the candidates with the help of our indices, if possible.
+    if (filter.application_id.first && filter.feature.first)
+    {
+        auto it = by_key.find(Key{filter.application_id.second, filter.feature.second});
+        if (it != by_key.end())
+            for (auto id : it->second)
+                collect(id);
+    }
+    else if (filter.application_id.first)
+    {
+        auto it = by_application_id.find(filter.application_id.second);
+        if (it != by_application_id.end())
+            for (auto id : it->second)
+                collect(id);
+    }
+    else
+    {
+        for (const auto& pair : requests)
+            collect(pair.first);
+    }
+
+    // Latest first, ties are reported in the order requests have been added,
+    // just like the sqlite implementation does.
+    auto latest_first = [](const Entry& lhs, const Entry& rhs)
+    {
+        if (lhs.second.when != rhs.second.when)
+            return lhs.second.when > rhs.second.when;
+        return lhs.first < rhs.first;
+    };
+
+    // We only order as many results as requested.
+    if (filter.count.first && filter.count.second < result.size())
+    {
+        std::partial_sort(result.begin(), result.begin() + filter.count.second, result.end(), latest_first);
+        result.resize(filter.count.second);
+    }
+    else
+    {
+        std::sort(result.begin(), result.end(), latest_first);
+    }
+
+    return result;
+}
+
+void Store::erase(std::uint64_t id)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (requests.count(id) == 0)
+        return;
+
+    std::string payload;
+    put(payload, static_cast<std::uint8_t>(RecordType::erase));
+    put(payload, id);
+    append(payload);
+
+    drop(id);
+
+    compact_if_required();
+}
+
+void Store::erase_all(const Filter& filter)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto entries = select_locked(filter);
+    if (entries.empty())
+        return;
+
+    std::vector<std::string> payloads;
+    for (const auto& entry : entries)
+    {
+        std::string payload;
+        put(payload, static_cast<std::uint8_t>(RecordType::erase));
+        put(payload, entry.first);
+        payloads.push_back(payload);
+    }
+
+    append(payloads);
+
+    for (const auto& entry : entries)
+        drop(entry.first);
+
+    compact_if_required();
+}
+
+bool Store::apply(const std::string& payload)
+{
+    Reader reader{payload.data(), payload.data() + payload.size()};
+
+    switch (static_cast<RecordType>(reader.get<std::uint8_t>()))
+    {
+    case RecordType::add:
+    {
+        core::trust::Request request;
+
+        auto id = reader.get<std::uint64_t>();
+        request.when = core::trust::Request::Timestamp{core::trust::Request::Duration{static_cast<std::int64_t>(reader.get<std::uint64_t>())}};
+        request.feature.value = reader.get<std::uint64_t>();
+        request.answer = static_cast<core::trust::Request::Answer>(reader.get<std::uint8_t>());
+        request.from = reader.get_string();
+
+        if (not reader.good())
+            return false;
+
+        insert(id, request);
+        return true;
+    }
+    case RecordType::erase:
+    {
+        auto id = reader.get<std::uint64_t>();
+
+        if (not reader.good())
+            return false;
+
+        drop(id);
+        return true;
+    }
+    case RecordType::remove_application:
+    {
+        auto app_id = reader.get_string();
+
+        if (not reader.good())
+            return false;
+
+        auto it = by_application_id.find(app_id);
+        if (it != by_application_id.end())
+        {
+            auto ids = it->second;
+            for (auto id : ids)
+                drop(id);
+        }
+        return true;
+    }
+    }
+
+    return false;
+}
+
+void Store::insert(std::uint64_t id, const core::trust::Request& request)
+{
+    requests[id] = request;
+    by_application_id[request.from].insert(id);
+    by_key[Key{request.from, request.feature.value}].insert(id);
+
+    next_id = std::max(next_id, id + 1);
+}
+
+void Store::drop(std::uint64_t id)
+{
+    auto it = requests.find(id);
+    if (it == requests.end())
+        return;
+
+    auto app = by_application_id.find(it->second.from);
+    app->second.erase(id);
+    if (app->second.empty())
+        by_application_id.erase(app);
+
+    auto key = by_key.find(Key{it->second.from, it->second.feature.value});
+    key->second.erase(id);
+    if (key->second.empty())
+        by_key.erase(key);
+
+    requests.erase(it);
+}
+
+void Store::append(const std::string& payload)
+{
+    append(std::vector<std::string>{payload});
+}
+
+void Store::append(const std::vector<std::string>& payloads)
+{
+    if (failed) throw std::runtime_error
+    {
+        "Log might end with a partially written record, refusing to append."
+    };
+
+    std::string frames;
+    for (const auto& payload : payloads)
+        frames += frame(payload);
+
+    auto offset = ::lseek(fd, 0, SEEK_END);
+    if (offset == -1)
+        throw std::system_error(errno, std::system_category());
+
+    try
+    {
+        write_or_throw(fd, frames);
+
+        if (configuration.sync_on_append && ::fdatasync(fd) != 0)
+            throw std::system_error(errno, std::system_category());
+    }
+    catch (...)
+    {
+        // Replaying the log stops at a partially written record, dropping all records
+        // appended after it. We thus cut it off, and stop appending if we cannot.
+        if (::ftruncate(fd, offset) != 0)
+            failed = true;
+        throw;
+    }
+
+    records += payloads.size();
+}
+
+void Store::compact()
+{
+    auto compacted_path = path.string() + ".compacting";
+
+    int compacted = ::open(compacted_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (compacted == -1)
+        throw std::system_error(errno, std::system_category());
+
+    try
+    {
+        auto content = header();
+        for (const auto& pair : requests)
+            content.append(frame(add_record(pair.first, pair.second)));
+
+        write_or_throw(compacted, content);
+
+        if (::fdatasync(compacted) != 0)
+            throw std::system_error(errno, std::system_category());
+
+        // Replacing the log is atomic, we either end up with the old or the compacted one.
+        if (::rename(compacted_path.c_str(), path.string().c_str()) != 0)
+            throw std::system_error(errno, std::system_category());
+    }
+    catch (...)
+    {
+        ::close(compacted);
+        ::unlink(compacted_path.c_str());
+        throw;
+    }
+
+    ::close(fd);
+    fd = compacted;
+    records = requests.size();
+    // The compacted log only holds complete records.
+    failed = false;
+
+    // Persists the rename.
+    int dir = ::open(path.parent_path().string().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir != -1)
+    {
+        ::fsync(dir);
+        ::close(dir);
+    }
+}
+
+void Store::compact_if_required()
+{
+    auto obsolete = records - requests.size();
+
+    if (obsolete >= configuration.compaction_threshold && obsolete > requests.size())
+        compact();
+}
+}
+}
+}
+}
+}
+
+namespace log_structured = core::trust::impl::log_structured;
+
+log_structured::Configuration log_structured::default_configuration()
+{
+    return log_structured::Configuration
+    {
+        // Compact once 1024 records became obsolete.
+        1024,
+        // Every modification is durable once it returns.
+        true
+    };
+}
+
+std::shared_ptr<core::trust::Store> log_structured::create_for_service(
+        const std::string& name,
+        xdg::BaseDirSpecification& spec,
+        const Configuration& configuration)
+{
+    if (name.empty())
+        throw core::trust::Errors::ServiceNameMustNotBeEmpty();
+
+    return std::make_shared<Store>(ensure_dir_or_throw(spec.data().home() / name) / "trust.log", configuration);
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_TRUST_IMPL_LOG_STRUCTURED_STORE_H_
+#define CORE_TRUST_IMPL_LOG_STRUCTURED_STORE_H_
+
+#include <core/trust/visibility.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace xdg
+{
+class BaseDirSpecification;
+}
+
+namespace core
+{
+namespace trust
+{
+class Store;
+namespace impl
+{
+namespace log_structured
+{
+// Configuration bundles tunables of the log-structured store.
+struct Configuration
+{
+    // The log is compacted once it contains at least this many records that
+    // do not contribute to the content of the store anymore, and more of them
+    // than live ones.
+    std::size_t compaction_threshold;
+    // If true, every modification is flushed to disk before returning.
+    bool sync_on_append;
+};
+
+// The defaults used by create_for_service(const std::string&, xdg::BaseDirSpecification&).
+CORE_TRUST_DLL_PUBLIC Configuration default_configuration();
+
+// create_for_service creates a Store implementation persisting requests in an append-only,
+// checksummed log, managing trust for the service identified by service_name. Uses spec to
+// determine a user-specific directory to place the log. All requests are indexed in memory,
+// with the index being rebuilt from the log on open. Only one instance must access a log at
+// any point in time.
+CORE_TRUST_DLL_PUBLIC std::shared_ptr<core::trust::Store> create_for_service(
+        const std::string& service_name,
+        xdg::BaseDirSpecification& spec,
+        const Configuration& configuration = default_configuration());
+}
+}
+}
+}
+
+#endif // CORE_TRUST_IMPL_LOG_STRUCTURED_STORE_H_
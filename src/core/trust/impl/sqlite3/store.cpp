@@ -24,10 +24,15 @@
 #include <sqlite3.h>
 #include <xdg.h>
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <mutex>
+#include <unordered_map>
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -120,6 +125,12 @@ public:
     PreparedStatement& operator=(const PreparedStatement&) = delete;
     bool operator==(const PreparedStatement&) const = delete;
 
+    // Returns true if no statement has been prepared for this instance.
+    bool empty() const
+    {
+        return statement == nullptr;
+    }
+
     template<int index>
     void bind_null()
     {
@@ -170,6 +181,12 @@ public:
 
     template<int index>
     void bind_int64(std::int64_t i)
+    {
+        bind_int64(index, i);
+    }
+
+    // As bind_int64<index>, for indices only known at runtime, e.g., in multi-row statements.
+    void bind_int64(int index, std::int64_t i)
     {
         int result; bool error;
         std::tie(result, error) = is_error(sqlite3_bind_int64(statement, index, i));
@@ -258,14 +275,16 @@ struct TaggedPreparedStatement : public PreparedStatement
 
 struct Database
 {
-    Database(const std::string& fn)
+    // Opens the database in file fn, with flags passed on to sqlite3_open_v2.
+    Database(const std::string& fn, int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE)
     {
-        auto result = sqlite3_open(fn.c_str(), &db);
+        auto result = sqlite3_open_v2(fn.c_str(), &db, flags, nullptr);
         if (result != SQLITE_OK)
         {
             std::stringstream ss;
             ss << "Problem opening database file " << fn << ": " << sqlite3_errstr(result);
-            throw std::runtime_error(ss.str());
+            sqlite3_close(db);
+            throw core::trust::Store::Errors::ErrorOpeningStore(ss.str().c_str());
         };
 
         sqlite3_extended_result_codes(db, 1);
@@ -287,6 +306,21 @@ struct Database
         prepare_statement(pragma).step();
     }
 
+    // Executes all statements in script, throwing std::runtime_error on failure.
+    void execute(const std::string& script)
+    {
+        char* msg = nullptr;
+        int result; bool e;
+        std::tie(result, e) = is_error(sqlite3_exec(db, script.c_str(), nullptr, nullptr, &msg));
+
+        if (e)
+        {
+            std::string what{sqlite3_errstr(result) + std::string(": ") + (msg ? msg : "")};
+            sqlite3_free(msg);
+            throw std::runtime_error(what);
+        }
+    }
+
     std::int32_t get_version()
     {
         auto stmt = prepare_statement("PRAGMA user_version;"); stmt.step();
@@ -298,7 +332,7 @@ struct Database
         sqlite3_stmt* stmt = nullptr;
         int result; bool e;
         std::tie(result, e) = is_error(
-                    sqlite3_prepare(
+                    sqlite3_prepare_v2(
                         db,
                         statement.c_str(),
                         statement.size(),
@@ -317,7 +351,7 @@ struct Database
         sqlite3_stmt* stmt = nullptr;
         int result; bool e;
         std::tie(result, e) = is_error(
-                    sqlite3_prepare(
+                    sqlite3_prepare_v2(
                         db,
                         Statement::statement().c_str(),
                         Statement::statement().size(),
@@ -350,7 +384,60 @@ struct Store
           public std::enable_shared_from_this<Store>
 {
     // Our schema version constant.
-    static constexpr const std::int32_t version{1};
+    static constexpr const std::int32_t version{4};
+
+    // Mode enumerates the ways a store can access its database.
+    enum class Mode
+    {
+        // Creates and upgrades the database as required, and allows for modifications.
+        read_write,
+        // Only reads from an existing database, without ever modifying it.
+        read_only
+    };
+
+    // Describes the table interning application ids, referenced by requests.
+    struct ApplicationsTable
+    {
+        ApplicationsTable() = delete;
+
+        // The name of the table.
+        static const std::string& name()
+        {
+            static const std::string s{"applications"};
+            return s;
+        }
+    };
+
+    // Describes the table aggregating requests per interned app id and feature, maintained
+    // by triggers on the requests table.
+    //
+    // |---------------------------------------------------------------------------------------------------------------|
+    // |  ApplicationId : int64 | Feature : int64 | Granted : int64 | Denied : int64 | First : int64 | Last : int64 |
+    // |---------------------------------------------------------------------------------------------------------------|
+    struct StatisticsTable
+    {
+        StatisticsTable() = delete;
+
+        // The name of the table.
+        static const std::string& name()
+        {
+            static const std::string s{"statistics"};
+            return s;
+        }
+
+        // Collects the indices of columns selected by Statements::SelectStatistics.
+        struct Column
+        {
+            Column() = delete;
+
+            struct ApplicationId { static const int index = 0; };
+            struct Feature { static const int index = 1; };
+            struct Granted { static const int index = 2; };
+            struct Denied { static const int index = 3; };
+            struct First { static const int index = 4; };
+            struct Last { static const int index = 5; };
+        };
+    };
 
     // Describes the table and its schema for storing requests.
     struct RequestsTable
@@ -364,11 +451,12 @@ struct Store
             return s;
         }
 
-        // Collects all columns, their names and indices.
+        // Collects all columns, their names and indices. The ApplicationId refers to
+        // the Id of an entry in the applications table, holding the actual app id as Name.
         //
-        // |-------------------------------------------------------------------------------------|
-        // |  Id : int | ApplicationId : Text | Feature : int | Timestamp : int64 | Answer : int |
-        // |-------------------------------------------------------------------------------------|
+        // |----------------------------------------------------------------------------------------|
+        // |  Id : int | ApplicationId : int64 | Feature : int64 | Timestamp : int64 | Answer : int |
+        // |----------------------------------------------------------------------------------------|
         struct Column
         {
             Column() = delete;
@@ -432,297 +520,1027 @@ struct Store
 
     struct Statements
     {
-        struct CreateDataTableIfNotExists
+        // Creates the tables holding requests and interned app ids, executed as a script.
+        struct CreateRequestsTablesIfNotExists
         {
             static const std::string& statement()
             {
                 static const std::string s
                 {
+                    "CREATE TABLE IF NOT EXISTS " +
+                    sqlite::Store::ApplicationsTable::name() + " (" +
+                    "'Id' INTEGER PRIMARY KEY, "
+                    "'Name' TEXT UNIQUE NOT NULL);"
                     "CREATE TABLE IF NOT EXISTS " +
                     sqlite::Store::RequestsTable::name() + " (" +
                     sqlite::Store::RequestsTable::Column::Id::name() + " INTEGER PRIMARY KEY ASC, " +
-                    sqlite::Store::RequestsTable::Column::ApplicationId::name() + " TEXT NOT NULL, " +
+                    sqlite::Store::RequestsTable::Column::ApplicationId::name() + " INTEGER NOT NULL, " +
                     sqlite::Store::RequestsTable::Column::Feature::name() + " BIGINT, " +
                     sqlite::Store::RequestsTable::Column::Timestamp::name() + " BIGINT, " +
                     sqlite::Store::RequestsTable::Column::Answer::name() + " INTEGER);"
+                    "CREATE INDEX IF NOT EXISTS requests_by_key ON " +
+                    sqlite::Store::RequestsTable::name() + " (ApplicationId, Feature, Timestamp);"
                 };
                 return s;
             }
-        };       
+        };
 
-        struct Delete
+        // Creates the statistics table and the triggers maintaining it, executed as a script.
+        // Removing a request recomputes the timestamps from the remaining requests, which the
+        // index covering timestamps answers with a single lookup each. Entries without any
+        // remaining requests are dropped.
+        struct CreateStatisticsIfNotExists
         {
             static const std::string& statement()
             {
+                static const std::string granted{std::to_string(static_cast<int>(Request::Answer::granted))};
+                static const std::string denied{std::to_string(static_cast<int>(Request::Answer::denied))};
+
                 static const std::string s
                 {
-                    "DELETE FROM " + sqlite::Store::RequestsTable::name()
+                    "CREATE TABLE IF NOT EXISTS " + sqlite::Store::StatisticsTable::name() + " ("
+                    "ApplicationId INTEGER NOT NULL, "
+                    "Feature BIGINT NOT NULL, "
+                    "Granted BIGINT NOT NULL, "
+                    "Denied BIGINT NOT NULL, "
+                    "First BIGINT, "
+                    "Last BIGINT, "
+                    "PRIMARY KEY (ApplicationId, Feature));"
+                    "CREATE TRIGGER IF NOT EXISTS statistics_after_insert AFTER INSERT ON " +
+                    sqlite::Store::RequestsTable::name() + " BEGIN "
+                    "INSERT OR IGNORE INTO " + sqlite::Store::StatisticsTable::name() +
+                    " VALUES (NEW.ApplicationId, NEW.Feature, 0, 0, NEW.Timestamp, NEW.Timestamp); "
+                    "UPDATE " + sqlite::Store::StatisticsTable::name() + " SET "
+                    "Granted = Granted + (NEW.Answer = " + granted + "), "
+                    "Denied = Denied + (NEW.Answer = " + denied + "), "
+                    "First = MIN(First, NEW.Timestamp), "
+                    "Last = MAX(Last, NEW.Timestamp) "
+                    "WHERE ApplicationId = NEW.ApplicationId AND Feature = NEW.Feature; "
+                    "END;"
+                    "CREATE TRIGGER IF NOT EXISTS statistics_after_delete AFTER DELETE ON " +
+                    sqlite::Store::RequestsTable::name() + " BEGIN "
+                    "UPDATE " + sqlite::Store::StatisticsTable::name() + " SET "
+                    "Granted = Granted - (OLD.Answer = " + granted + "), "
+                    "Denied = Denied - (OLD.Answer = " + denied + "), "
+                    "First = (SELECT MIN(Timestamp) FROM " + sqlite::Store::RequestsTable::name() +
+                    " WHERE ApplicationId = OLD.ApplicationId AND Feature = OLD.Feature), "
+                    "Last = (SELECT MAX(Timestamp) FROM " + sqlite::Store::RequestsTable::name() +
+                    " WHERE ApplicationId = OLD.ApplicationId AND Feature = OLD.Feature) "
+                    "WHERE ApplicationId = OLD.ApplicationId AND Feature = OLD.Feature; "
+                    "DELETE FROM " + sqlite::Store::StatisticsTable::name() +
+                    " WHERE ApplicationId = OLD.ApplicationId AND Feature = OLD.Feature AND Granted + Denied = 0; "
+                    "END;"
                 };
                 return s;
             }
         };
 
-        struct Insert
+        // Creates all tables, indices and triggers of the current schema, executed as a script.
+        struct CreateSchemaIfNotExists
         {
             static const std::string& statement()
             {
                 static const std::string s
                 {
-                    "INSERT INTO " + Store::RequestsTable::name() + " ('ApplicationId','Feature','Timestamp','Answer') VALUES (?,?,?,?);"
+                    CreateRequestsTablesIfNotExists::statement() +
+                    CreateStatisticsIfNotExists::statement()
                 };
                 return s;
             }
         };
 
-        struct RemoveApplication
+        // Moves a database from schema version 1, storing app ids as text in every
+        // request, to schema version 2, executed as a script within a transaction.
+        struct MigrateFromVersion1
         {
             static const std::string& statement()
             {
                 static const std::string s
                 {
-                    "DELETE FROM " + Store::RequestsTable::name() + " WHERE ApplicationId=?;"
+                    "ALTER TABLE " + sqlite::Store::RequestsTable::name() + " RENAME TO requests_v1;" +
+                    CreateRequestsTablesIfNotExists::statement() +
+                    "INSERT OR IGNORE INTO " + sqlite::Store::ApplicationsTable::name() + " (Name) "
+                    "SELECT DISTINCT ApplicationId FROM requests_v1;"
+                    "INSERT INTO " + sqlite::Store::RequestsTable::name() + " (Id, ApplicationId, Feature, Timestamp, Answer) "
+                    "SELECT requests_v1.Id, " + sqlite::Store::ApplicationsTable::name() + ".Id, "
+                    "requests_v1.Feature, requests_v1.Timestamp, requests_v1.Answer FROM requests_v1 JOIN " +
+                    sqlite::Store::ApplicationsTable::name() + " ON " +
+                    sqlite::Store::ApplicationsTable::name() + ".Name = requests_v1.ApplicationId;"
+                    "DROP TABLE requests_v1;"
                 };
                 return s;
             }
-
-            struct Parameter
-            {
-                struct ApplicationId { static const int index = 1; };
-            };
         };
-    };
 
-    // An implementation of the query interface for the SQLite-based store.
-    struct Query : public core::trust::Store::Query
-    {
-        struct Statements
+        // Computes statistics for all requests, executed as a script. Expects the statistics table to be empty.
+        struct PopulateStatistics
         {
-            // Encodes the parameter-index for the prepared delete statement.
-            struct Delete
+            static const std::string& statement()
             {
-                static const std::string& statement()
-                {
-                    static const std::string s
-                    {
-                        "DELETE FROM " +
-                        Store::RequestsTable::name() +
-                        " WHERE Id=?;"
-                    };
-
-                    return s;
-                }
-
-                struct Parameter
+                static const std::string s
                 {
-                    struct Id { static const int index = 1; };
+                    "INSERT INTO " + sqlite::Store::StatisticsTable::name() + " "
+                    "SELECT ApplicationId, Feature, "
+                    "SUM(Answer = " + std::to_string(static_cast<int>(Request::Answer::granted)) + "), "
+                    "SUM(Answer = " + std::to_string(static_cast<int>(Request::Answer::denied)) + "), "
+                    "MIN(Timestamp), MAX(Timestamp) FROM " + sqlite::Store::RequestsTable::name() +
+                    " GROUP BY ApplicationId, Feature;"
                 };
-            };
+                return s;
+            }
+        };
 
-            // Encodes the parameter-indices for the prepared select statement.
-            struct Select
+        // Moves a database from schema version 2 to schema version 3, adding statistics
+        // and computing them for all requests, executed as a script within a transaction.
+        struct MigrateFromVersion2
+        {
+            static const std::string& statement()
             {
-                static const std::string& statement()
-                {
-                    static const std::string select
-                    {
-                        "SELECT * FROM " +
-                        Store::RequestsTable::name() +
-                        " WHERE ApplicationId=IFNULL(?,ApplicationId) AND"
-                        " Feature=IFNULL(?,Feature) AND"
-                        " (Timestamp BETWEEN IFNULL(?, Timestamp) AND IFNULL(?,Timestamp)) AND"
-                        " Answer=IFNULL(?,Answer)"
-                        " ORDER BY Timestamp DESC;"
-                    };
-                    return select;
-                }
-
-                struct Parameter
+                static const std::string s
                 {
-                    struct ApplicationId { static const int index = 1; };
-                    struct Feature { static const int index = ApplicationId::index + 1; };
-                    struct Timestamp
-                    {
-                        struct LowerBound { static const int index = Feature::index + 1; };
-                        struct UpperBound { static const int index = LowerBound::index + 1; };
-                    };
-                    struct Answer { static const int index = Timestamp::UpperBound::index + 1; };
+                    CreateStatisticsIfNotExists::statement() +
+                    PopulateStatistics::statement()
                 };
-            };
+                return s;
+            }
         };
 
-        // Constructs the query and associates it with its store.
-        // That is: As long as a query is alive, the store is kept alive, too.
-        Query(const std::shared_ptr<Store>& store) : d{store}
-        {
-            // A freshly constructed query finds all entries.
-            all();
-        }
-
-        Status status() const
-        {
-            return d.status;
-        }
-
-        void for_application_id(const std::string& id)
-        {
-            d.select_statement.bind_text<
-                Statements::Select::Parameter::ApplicationId::index
-            >(id);
-        }
-
-        void for_feature(core::trust::Feature feature)
+        // Moves a database from schema version 3 to schema version 4, extending the index
+        // by timestamps, executed as a script within a transaction.
+        struct MigrateFromVersion3
         {
-            d.select_statement.bind_int64<
-                Statements::Select::Parameter::Feature::index
-            >(feature.value);
-        }
+            static const std::string& statement()
+            {
+                static const std::string s
+                {
+                    "DROP INDEX IF EXISTS requests_by_application;" +
+                    CreateRequestsTablesIfNotExists::statement()
+                };
+                return s;
+            }
+        };
 
-        void for_interval(const Request::Timestamp& begin, const Request::Timestamp& end)
+        // Drops the index and the trigger maintaining statistics for added requests
+        // ahead of loading requests in bulk, executed as a script within a transaction.
+        struct DropDeferredIndices
         {
-            d.select_statement.bind_int64<
-                Statements::Select::Parameter::Timestamp::LowerBound::index
-            >(begin.time_since_epoch().count());
-
-            d.select_statement.bind_int64<
-                Statements::Select::Parameter::Timestamp::UpperBound::index
-            >(end.time_since_epoch().count());
-        }
+            static const std::string& statement()
+            {
+                static const std::string s
+                {
+                    "DROP INDEX IF EXISTS requests_by_key;"
+                    "DROP TRIGGER IF EXISTS statistics_after_insert;"
+                };
+                return s;
+            }
+        };
 
-        void for_answer(Request::Answer answer)
+        // Recreates what DropDeferredIndices dropped once all requests have been loaded,
+        // recomputing statistics, executed as a script within a transaction.
+        struct RebuildDeferredIndices
         {
-            d.select_statement.bind_int<
-                Statements::Select::Parameter::Answer::index
-            >(static_cast<int>(answer));
-        }
+            static const std::string& statement()
+            {
+                static const std::string s
+                {
+                    "DELETE FROM " + sqlite::Store::StatisticsTable::name() + ";" +
+                    PopulateStatistics::statement() +
+                    CreateSchemaIfNotExists::statement()
+                };
+                return s;
+            }
+        };
 
-        void all()
+        struct Delete
         {
-            d.select_statement.reset();
-            d.select_statement.clear_bindings();
-        }
+            static const std::string& statement()
+            {
+                static const std::string s
+                {
+                    "DELETE FROM " + sqlite::Store::RequestsTable::name()
+                };
+                return s;
+            }
+        };
 
-        void execute()
+        // Selects the columns in the order of StatisticsTable::Column, resolving interned app ids.
+        struct SelectStatistics
         {
-            d.select_statement.reset();
-            auto result = d.select_statement.step();
-
-            switch(result)
+            static const std::string& statement()
             {
-            case TaggedPreparedStatement<Statements::Select>::State::done:
-                d.status = Status::eor;
-                break;
-            case TaggedPreparedStatement<Statements::Select>::State::row:
-                d.status = Status::has_more_results;
-                break;
+                static const std::string s
+                {
+                    "SELECT " + Store::ApplicationsTable::name() + ".Name, Feature, Granted, Denied, First, Last FROM " +
+                    Store::StatisticsTable::name() + " JOIN " + Store::ApplicationsTable::name() + " ON " +
+                    Store::StatisticsTable::name() + ".ApplicationId = " + Store::ApplicationsTable::name() + ".Id"
+                    " ORDER BY " + Store::ApplicationsTable::name() + ".Name ASC, Feature ASC;"
+                };
+                return s;
             }
-        }
+        };
 
-        void next()
+        struct DeleteApplications
         {
-            auto result = d.select_statement.step();
-
-            switch(result)
+            static const std::string& statement()
             {
-            case TaggedPreparedStatement<Statements::Select>::State::done:
-                d.status = Status::eor;
-                break;
-            case TaggedPreparedStatement<Statements::Select>::State::row:
-                d.status = Status::has_more_results;
-                break;
+                static const std::string s
+                {
+                    "DELETE FROM " + sqlite::Store::ApplicationsTable::name()
+                };
+                return s;
             }
-        }
+        };
 
-        void erase()
+        // Interns an app id, if not known yet.
+        struct InsertApplication
         {
-            if (Status::eor == d.status)
-                throw std::runtime_error("Cannot delete request as query points beyond the result set.");
+            static const std::string& statement()
+            {
+                static const std::string s
+                {
+                    "INSERT OR IGNORE INTO " + Store::ApplicationsTable::name() + " (Name) VALUES (?);"
+                };
+                return s;
+            }
 
-            auto id = d.select_statement.column_int<Store::RequestsTable::Column::Id::index>();
+            struct Parameter
+            {
+                struct Name { static const int index = 1; };
+            };
+        };
 
-            d.delete_statement.reset();
-            d.delete_statement.bind_int<Statements::Delete::Parameter::Id::index>(id);
-            d.delete_statement.step();
+        // Inserts a request, resolving the interned app id. Fails if the app id is not known.
+        struct Insert
+        {
+            static const std::string& statement()
+            {
+                static const std::string s
+                {
+                    "INSERT INTO " + Store::RequestsTable::name() + " ('ApplicationId','Feature','Timestamp','Answer') VALUES ("
+                    "(SELECT Id FROM " + Store::ApplicationsTable::name() + " WHERE Name=?),?,?,?);"
+                };
+                return s;
+            }
 
-            next();
-        }
+            struct Parameter
+            {
+                struct ApplicationId { static const int index = 1; };
+                struct Feature { static const int index = ApplicationId::index + 1; };
+                struct Timestamp { static const int index = Feature::index + 1; };
+                struct Answer { static const int index = Timestamp::index + 1; };
+            };
+        };
 
-        Request current()
+        // Looks up an interned app id.
+        struct SelectApplicationId
         {
-            switch(d.status)
-            {
-            case Status::error: throw Errors::QueryIsInErrorState{};
-            case Status::eor: throw Errors::NoCurrentResult{};
-            case Status::armed: throw Errors::NoCurrentResult{};
-            default:
+            static const std::string& statement()
             {
-                trust::Request request
+                static const std::string s
                 {
-                    d.select_statement.column_text<Store::RequestsTable::Column::ApplicationId::index>(),
-                    trust::Feature
-                    {
-                        static_cast<trust::Feature::IntegerType>(d.select_statement.column_int<Store::RequestsTable::Column::Feature::index>())
-                    },
-                    std::chrono::system_clock::time_point
-                    {
-                        std::chrono::system_clock::duration
-                        {
-                            d.select_statement.column_int64<Store::RequestsTable::Column::Timestamp::index>()
-                        }
-                    },
-                    (Request::Answer)d.select_statement.column_int<Store::RequestsTable::Column::Answer::index>()
+                    "SELECT Id FROM " + Store::ApplicationsTable::name() + " WHERE Name=?;"
                 };
-                return request;
-            }
+                return s;
             }
 
-            throw std::runtime_error("Oops ... we should never reach here.");
-        }
+            struct Parameter
+            {
+                struct Name { static const int index = 1; };
+            };
+        };
 
-        struct Private
+        // Inserts a number of requests with a single statement, referring to interned app ids.
+        template<std::size_t rows>
+        struct InsertInterned
         {
-            Private(const std::shared_ptr<Store>& store)
-                : store(store),
-                  delete_statement(store->db.prepare_tagged_statement<Statements::Delete>()),
-                  select_statement(store->db.prepare_tagged_statement<Statements::Select>())
+            static const std::string& statement()
             {
+                static const std::string s
+                {
+                    "INSERT INTO " + Store::RequestsTable::name() + " ('ApplicationId','Feature','Timestamp','Answer') VALUES " +
+                    values(rows) + ";"
+                };
+                return s;
             }
 
-            ~Private()
+            // Returns the parameter placeholders for n rows.
+            static std::string values(std::size_t n)
             {
+                return n == 1 ? "(?,?,?,?)" : "(?,?,?,?)," + values(n - 1);
             }
 
-            std::shared_ptr<Store> store;
-            TaggedPreparedStatement<Statements::Delete> delete_statement;
+            struct Parameter
+            {
+                // Returns the index of the first parameter of the given row.
+                static int first_of_row(std::size_t row) { return static_cast<int>(row * (Answer::index + 1)) + 1; }
+
+                struct ApplicationId { static const int index = 0; };
+                struct Feature { static const int index = ApplicationId::index + 1; };
+                struct Timestamp { static const int index = Feature::index + 1; };
+                struct Answer { static const int index = Timestamp::index + 1; };
+            };
+        };
+
+        struct BeginTransaction
+        {
+            static const std::string& statement()
+            {
+                static const std::string s{"BEGIN IMMEDIATE TRANSACTION;"};
+                return s;
+            }
+        };
+
+        struct CommitTransaction
+        {
+            static const std::string& statement()
+            {
+                static const std::string s{"COMMIT TRANSACTION;"};
+                return s;
+            }
+        };
+
+        struct RollbackTransaction
+        {
+            static const std::string& statement()
+            {
+                static const std::string s{"ROLLBACK TRANSACTION;"};
+                return s;
+            }
+        };
+
+        struct RemoveApplication
+        {
+            static const std::string& statement()
+            {
+                static const std::string s
+                {
+                    "DELETE FROM " + Store::RequestsTable::name() + " WHERE ApplicationId="
+                    "(SELECT Id FROM " + Store::ApplicationsTable::name() + " WHERE Name=?);"
+                };
+                return s;
+            }
+
+            struct Parameter
+            {
+                struct ApplicationId { static const int index = 1; };
+            };
+        };
+
+        struct RemoveFeature
+        {
+            static const std::string& statement()
+            {
+                static const std::string s
+                {
+                    "DELETE FROM " + Store::RequestsTable::name() + " WHERE Feature=?;"
+                };
+                return s;
+            }
+
+            struct Parameter
+            {
+                struct Feature { static const int index = 1; };
+            };
+        };
+
+        struct RemoveOlderThan
+        {
+            static const std::string& statement()
+            {
+                static const std::string s
+                {
+                    "DELETE FROM " + Store::RequestsTable::name() + " WHERE Timestamp<?;"
+                };
+                return s;
+            }
+
+            struct Parameter
+            {
+                struct Timestamp { static const int index = 1; };
+            };
+        };
+
+        struct RemoveApplicationName
+        {
+            static const std::string& statement()
+            {
+                static const std::string s
+                {
+                    "DELETE FROM " + Store::ApplicationsTable::name() + " WHERE Name=?;"
+                };
+                return s;
+            }
+
+            struct Parameter
+            {
+                struct ApplicationId { static const int index = 1; };
+            };
+        };
+    };
+
+    // An implementation of the query interface for the SQLite-based store.
+    struct Query : public core::trust::Store::Query
+    {
+        struct Statements
+        {
+            // Encodes the parameter-index for the prepared delete statement.
+            struct Delete
+            {
+                static const std::string& statement()
+                {
+                    static const std::string s
+                    {
+                        "DELETE FROM " +
+                        Store::RequestsTable::name() +
+                        " WHERE Id=?;"
+                    };
+
+                    return s;
+                }
+
+                struct Parameter
+                {
+                    struct Id { static const int index = 1; };
+                };
+            };
+
+            // Encodes the parameter-indices shared by all statements limited by the query.
+            struct Parameter
+            {
+                struct Feature { static const int index = 1; };
+                struct Timestamp
+                {
+                    struct LowerBound { static const int index = Feature::index + 1; };
+                    struct UpperBound { static const int index = LowerBound::index + 1; };
+                };
+                struct Answer { static const int index = Timestamp::UpperBound::index + 1; };
+                // Only present in statements limited to a single application.
+                struct ApplicationId { static const int index = Answer::index + 1; };
+                // Present in all statements, and thus explicitly numbered.
+                struct Limit { static const int index = ApplicationId::index + 1; };
+            };
+
+            // Limits requests by the parameters above. If limited to a single application,
+            // the application is matched by its interned id, and requests are looked up via the index.
+            static std::string where(bool for_application)
+            {
+                return
+                    " WHERE Feature=IFNULL(?,Feature) AND"
+                    " (Timestamp BETWEEN IFNULL(?, Timestamp) AND IFNULL(?,Timestamp)) AND"
+                    " Answer=IFNULL(?,Answer)" +
+                    std::string
+                    {
+                        for_application ?
+                            " AND ApplicationId=(SELECT Id FROM " + Store::ApplicationsTable::name() + " WHERE Name=?)" :
+                            ""
+                    };
+            }
+
+            // Unbound limits select all requests.
+            static std::string limit()
+            {
+                return " LIMIT IFNULL(?" + std::to_string(Parameter::Limit::index) + ",-1)";
+            }
+
+            // Orders requests by timestamp, latest first, before limiting them.
+            static std::string order_and_limit()
+            {
+                return " ORDER BY Timestamp DESC, " + Store::RequestsTable::name() + ".Id ASC" + limit();
+            }
+
+            // Selects the columns of requests in the order of RequestsTable::Column,
+            // resolving interned app ids.
+            static const std::string& select_requests()
+            {
+                static const std::string s
+                {
+                    "SELECT " + Store::RequestsTable::name() + ".Id, " +
+                    Store::ApplicationsTable::name() + ".Name, Feature, Timestamp, Answer FROM " +
+                    Store::RequestsTable::name() + " JOIN " + Store::ApplicationsTable::name() + " ON " +
+                    Store::RequestsTable::name() + ".ApplicationId = " + Store::ApplicationsTable::name() + ".Id"
+                };
+                return s;
+            }
+
+            struct Select
+            {
+                static const std::string& statement()
+                {
+                    static const std::string s{select_requests() + where(false) + order_and_limit() + ";"};
+                    return s;
+                }
+            };
+
+            struct SelectForApplication
+            {
+                static const std::string& statement()
+                {
+                    static const std::string s{select_requests() + where(true) + order_and_limit() + ";"};
+                    return s;
+                }
+            };
+
+            // Deletes all requests selected by Select, with a single statement.
+            struct DeleteAll
+            {
+                static const std::string& statement()
+                {
+                    static const std::string s
+                    {
+                        "DELETE FROM " + Store::RequestsTable::name() + " WHERE Id IN (SELECT Id FROM " +
+                        Store::RequestsTable::name() + where(false) + order_and_limit() + ");"
+                    };
+                    return s;
+                }
+            };
+
+            // Deletes all requests selected by SelectForApplication, with a single statement.
+            struct DeleteAllForApplication
+            {
+                static const std::string& statement()
+                {
+                    static const std::string s
+                    {
+                        "DELETE FROM " + Store::RequestsTable::name() + " WHERE Id IN (SELECT Id FROM " +
+                        Store::RequestsTable::name() + where(true) + order_and_limit() + ");"
+                    };
+                    return s;
+                }
+            };
+
+            // Counts the requests selected by Select, without ordering or resolving them.
+            struct Count
+            {
+                static const std::string& statement()
+                {
+                    static const std::string s
+                    {
+                        "SELECT COUNT(*) FROM (SELECT 1 FROM " + Store::RequestsTable::name() + where(false) + limit() + ");"
+                    };
+                    return s;
+                }
+            };
+
+            // Counts the requests selected by SelectForApplication, without ordering or resolving them.
+            struct CountForApplication
+            {
+                static const std::string& statement()
+                {
+                    static const std::string s
+                    {
+                        "SELECT COUNT(*) FROM (SELECT 1 FROM " + Store::RequestsTable::name() + where(true) + limit() + ");"
+                    };
+                    return s;
+                }
+            };
+
+            // Checks for requests selected by Select, stopping at the first one.
+            struct Exists
+            {
+                static const std::string& statement()
+                {
+                    static const std::string s
+                    {
+                        "SELECT EXISTS (SELECT 1 FROM " + Store::RequestsTable::name() + where(false) + limit() + ");"
+                    };
+                    return s;
+                }
+            };
+
+            // Checks for requests selected by SelectForApplication, stopping at the first one.
+            struct ExistsForApplication
+            {
+                static const std::string& statement()
+                {
+                    static const std::string s
+                    {
+                        "SELECT EXISTS (SELECT 1 FROM " + Store::RequestsTable::name() + where(true) + limit() + ");"
+                    };
+                    return s;
+                }
+            };
+        };
+
+        // Constructs the query and associates it with its store.
+        // That is: As long as a query is alive, the store is kept alive, too.
+        Query(const std::shared_ptr<Store>& store) : d{store}
+        {
+            // A freshly constructed query finds all entries.
+            all();
+        }
+
+        Status status() const
+        {
+            return d.status;
+        }
+
+        void for_application_id(const std::string& id)
+        {
+            std::lock_guard<std::mutex> lg(d.store->guard);
+
+            // Empty ids are not bound, and thus do not limit the query.
+            d.for_application = not id.empty();
+            d.application_id = id;
+            d.status = Status::armed;
+
+            d.for_each_prepared_statement_for_application([&id](PreparedStatement& statement)
+            {
+                statement.reset();
+                statement.bind_text<
+                    Statements::Parameter::ApplicationId::index
+                >(id);
+            });
+        }
+
+        void for_feature(core::trust::Feature feature)
+        {
+            d.bind([feature](PreparedStatement& statement)
+            {
+                statement.bind_int64<
+                    Statements::Parameter::Feature::index
+                >(static_cast<std::int64_t>(feature.value));
+            });
+        }
+
+        void for_interval(const Request::Timestamp& begin, const Request::Timestamp& end)
+        {
+            d.bind([begin, end](PreparedStatement& statement)
+            {
+                statement.bind_int64<
+                    Statements::Parameter::Timestamp::LowerBound::index
+                >(begin.time_since_epoch().count());
+
+                statement.bind_int64<
+                    Statements::Parameter::Timestamp::UpperBound::index
+                >(end.time_since_epoch().count());
+            });
+        }
+
+        void for_answer(Request::Answer answer)
+        {
+            d.bind([answer](PreparedStatement& statement)
+            {
+                statement.bind_int<
+                    Statements::Parameter::Answer::index
+                >(static_cast<int>(answer));
+            });
+        }
+
+        void limit(std::size_t count)
+        {
+            // Limits beyond the range of sqlite integers do not limit the query.
+            auto value = std::min<std::size_t>(count, std::numeric_limits<std::int64_t>::max());
+
+            d.bind([value](PreparedStatement& statement)
+            {
+                statement.bind_int64<
+                    Statements::Parameter::Limit::index
+                >(static_cast<std::int64_t>(value));
+            });
+        }
+
+        void all()
+        {
+            std::lock_guard<std::mutex> lg(d.store->guard);
+
+            d.for_each_prepared_statement([](PreparedStatement& statement)
+            {
+                statement.reset();
+                statement.clear_bindings();
+            });
+
+            d.bindings.clear();
+            d.for_application = false;
+        }
+
+        void execute()
+        {
+            std::lock_guard<std::mutex> lg(d.store->guard);
+
+            d.select().reset();
+            update_status(d.select().step());
+        }
+
+        void next()
+        {
+            std::lock_guard<std::mutex> lg(d.store->guard);
+
+            update_status(d.select().step());
+        }
+
+        void erase()
+        {
+            d.store->throw_if_read_only();
+
+            std::lock_guard<std::mutex> lg(d.store->guard);
+
+            if (Status::eor == d.status)
+                throw std::runtime_error("Cannot delete request as query points beyond the result set.");
+
+            auto id = d.select().column_int64<Store::RequestsTable::Column::Id::index>();
+
+            d.delete_statement.reset();
+            d.delete_statement.bind_int64<Statements::Delete::Parameter::Id::index>(id);
+            d.delete_statement.step();
+
+            update_status(d.select().step());
+        }
+
+        void erase_all()
+        {
+            d.store->throw_if_read_only();
+
+            std::lock_guard<std::mutex> lg(d.store->guard);
+
+            // We do not keep reading from the table while deleting from it.
+            d.select().reset();
+
+            // A single statement, and thus a single implicit transaction. Statistics
+            // are updated by triggers within the very same transaction.
+            auto& statement = d.for_application ?
+                        d.prepared(d.delete_all_for_application_statement) :
+                        d.prepared(d.delete_all_statement);
+            statement.reset();
+            statement.step();
+
+            d.status = Status::eor;
+        }
+
+        std::size_t count()
+        {
+            std::lock_guard<std::mutex> lg(d.store->guard);
+
+            auto& statement = d.for_application ?
+                        d.prepared(d.count_for_application_statement) :
+                        d.prepared(d.count_statement);
+            statement.reset();
+            statement.step();
+
+            auto result = static_cast<std::size_t>(statement.column_int64<0>());
+            // We do not keep the read transaction open.
+            statement.reset();
+            return result;
+        }
+
+        bool exists()
+        {
+            std::lock_guard<std::mutex> lg(d.store->guard);
+
+            auto& statement = d.for_application ?
+                        d.prepared(d.exists_for_application_statement) :
+                        d.prepared(d.exists_statement);
+            statement.reset();
+            statement.step();
+
+            auto result = statement.column_int<0>() != 0;
+            // We do not keep the read transaction open.
+            statement.reset();
+            return result;
+        }
+
+        Request current()
+        {
+            switch(d.status)
+            {
+            case Status::error: throw Errors::QueryIsInErrorState{};
+            case Status::eor: throw Errors::NoCurrentResult{};
+            case Status::armed: throw Errors::NoCurrentResult{};
+            default:
+            {
+                trust::Request request
+                {
+                    d.select().column_text<Store::RequestsTable::Column::ApplicationId::index>(),
+                    trust::Feature
+                    {
+                        static_cast<trust::Feature::IntegerType>(d.select().column_int64<Store::RequestsTable::Column::Feature::index>())
+                    },
+                    std::chrono::system_clock::time_point
+                    {
+                        std::chrono::system_clock::duration
+                        {
+                            d.select().column_int64<Store::RequestsTable::Column::Timestamp::index>()
+                        }
+                    },
+                    (Request::Answer)d.select().column_int<Store::RequestsTable::Column::Answer::index>()
+                };
+                return request;
+            }
+            }
+
+            throw std::runtime_error("Oops ... we should never reach here.");
+        }
+
+        // Updates the status of the query from the result of stepping the select statement.
+        void update_status(PreparedStatement::State result)
+        {
+            switch(result)
+            {
+            case PreparedStatement::State::done:
+                d.status = Status::eor;
+                break;
+            case PreparedStatement::State::row:
+                d.status = Status::has_more_results;
+                break;
+            }
+        }
+
+        struct Private
+        {
+            // Binds the limits of the query to a statement.
+            typedef std::function<void(PreparedStatement&)> Binding;
+
+            Private(const std::shared_ptr<Store>& store)
+                : store(store),
+                  delete_statement(store->db.prepare_tagged_statement<Statements::Delete>()),
+                  select_statement(store->db.prepare_tagged_statement<Statements::Select>()),
+                  select_for_application_statement(store->db.prepare_tagged_statement<Statements::SelectForApplication>())
+            {
+            }
+
+            ~Private()
+            {
+            }
+
+            // Returns the select statement matching the filters of the query.
+            PreparedStatement& select()
+            {
+                if (for_application)
+                    return select_for_application_statement;
+
+                return select_statement;
+            }
+
+            // Prepares statement on first use, binding all limits of the query so far.
+            template<typename Statement>
+            PreparedStatement& prepared(TaggedPreparedStatement<Statement>& statement)
+            {
+                if (statement.empty())
+                {
+                    statement = store->db.prepare_tagged_statement<Statement>();
+
+                    for (const auto& binding : bindings)
+                        binding(statement);
+
+                    if (for_application)
+                        statement.template bind_text<Statements::Parameter::ApplicationId::index>(application_id);
+                }
+
+                return statement;
+            }
+
+            // Binds a limit to all prepared statements, and remembers it for statements prepared later on.
+            // Statements cannot be rebound while stepping through them, and changing limits thus
+            // invalidates the cursor of the query.
+            void bind(const Binding& binding)
+            {
+                std::lock_guard<std::mutex> lg(store->guard);
+
+                status = Status::armed;
+
+                for_each_prepared_statement([&binding](PreparedStatement& statement)
+                {
+                    statement.reset();
+                    binding(statement);
+                });
+
+                bindings.push_back(binding);
+            }
+
+            // Invokes f for all prepared statements limited by the query.
+            template<typename Function>
+            void for_each_prepared_statement(const Function& f)
+            {
+                f(select_statement);
+
+                for (auto statement : std::initializer_list<PreparedStatement*>{&delete_all_statement, &count_statement, &exists_statement})
+                    if (not statement->empty())
+                        f(*statement);
+
+                for_each_prepared_statement_for_application(f);
+            }
+
+            // Invokes f for all prepared statements limited to a single application.
+            template<typename Function>
+            void for_each_prepared_statement_for_application(const Function& f)
+            {
+                f(select_for_application_statement);
+
+                for (auto statement : std::initializer_list<PreparedStatement*>{&delete_all_for_application_statement, &count_for_application_statement, &exists_for_application_statement})
+                    if (not statement->empty())
+                        f(*statement);
+            }
+
+            std::shared_ptr<Store> store;
+            TaggedPreparedStatement<Statements::Delete> delete_statement;
             TaggedPreparedStatement<Statements::Select> select_statement;
+            TaggedPreparedStatement<Statements::SelectForApplication> select_for_application_statement;
+            // Only prepared on first use, see prepared.
+            TaggedPreparedStatement<Statements::DeleteAll> delete_all_statement;
+            TaggedPreparedStatement<Statements::DeleteAllForApplication> delete_all_for_application_statement;
+            TaggedPreparedStatement<Statements::Count> count_statement;
+            TaggedPreparedStatement<Statements::CountForApplication> count_for_application_statement;
+            TaggedPreparedStatement<Statements::Exists> exists_statement;
+            TaggedPreparedStatement<Statements::ExistsForApplication> exists_for_application_statement;
+            // The limits of the query bound so far.
+            std::vector<Binding> bindings;
+            // True if the query is limited to a specific application.
+            bool for_application = false;
+            std::string application_id;
             Status status = Status::armed;
             std::string error;
         } d;
     };
 
-    Store(const std::string &service_name, xdg::BaseDirSpecification& spec);
+    Store(const std::string &service_name, xdg::BaseDirSpecification& spec, Mode mode = Mode::read_write);
     ~Store();
 
+    // Throws StoreIsReadOnly if the store must not be modified.
+    void throw_if_read_only() const;
+
     // Handles upgrades to the underlying database if the schema changes.
     void upgrade(std::int32_t from_version);
 
+    // Runs script within a transaction and sets the schema version to to_version, as a whole
+    // or not at all. Throws ErrorOpeningStore on failure.
+    void migrate(const std::string& script, std::int32_t to_version);
+
     const char* error() const;
 
-    // Creates the data table holding all requests if it not already exists.
-    void create_data_table_if_not_exists();
+    // Creates the tables holding all requests and app ids if they do not already exist.
+    void create_schema_if_not_exists();
+
+    // Inserts request into the data table, interning its app id. Has to be called with
+    // guard held and within a transaction.
+    void insert(const Request& request);
+
+    // Interns id and returns its interned value. Has to be called with guard held
+    // and within a transaction.
+    std::int64_t intern(const std::string& id);
+
+    // Number of requests inserted with a single statement when loading requests.
+    static constexpr const std::size_t rows_per_insert{64};
+
+    // Invokes f within a transaction, committing if f returns and rolling back if f
+    // throws. Has to be called with guard held.
+    template<typename Function>
+    void within_transaction(const Function& f)
+    {
+        begin_transaction_statement.reset();
+        begin_transaction_statement.step();
+
+        try
+        {
+            f();
+
+            commit_transaction_statement.reset();
+            commit_transaction_statement.step();
+        } catch(...)
+        {
+            // sqlite might have rolled back the transaction already, and we
+            // rather report the original error.
+            try
+            {
+                rollback_transaction_statement.reset();
+                rollback_transaction_statement.step();
+            } catch(...)
+            {
+            }
+
+            throw;
+        }
+    }
 
     // From core::trust::Store
     void reset();
     void add(const Request& request);
+    void add_all(const std::vector<Request>& requests);
+    std::size_t load(const RequestSource& source, bool defer_indices);
     void remove_application(const std::string& id);
+    void remove_feature(Feature feature);
+    void remove_older_than(const Request::Timestamp& timestamp);
     std::shared_ptr<core::trust::Store::Query> query();
+    std::vector<Statistics> statistics();
 
+    Mode mode;
+    // Serializes access to db by the store and all of its queries, keeping queries
+    // from stepping through statements within transactions of concurrent writers.
     std::mutex guard;
     Database db;
-    TaggedPreparedStatement<Statements::CreateDataTableIfNotExists> create_data_table_statement;
 
     TaggedPreparedStatement<Statements::Delete> delete_statement;
+    TaggedPreparedStatement<Statements::DeleteApplications> delete_applications_statement;
+    TaggedPreparedStatement<Statements::InsertApplication> insert_application_statement;
     TaggedPreparedStatement<Statements::Insert> insert_statement;
+    TaggedPreparedStatement<Statements::SelectApplicationId> select_application_id_statement;
+    TaggedPreparedStatement<Statements::InsertInterned<rows_per_insert>> insert_chunk_statement;
+    TaggedPreparedStatement<Statements::InsertInterned<1>> insert_interned_statement;
+    TaggedPreparedStatement<Statements::BeginTransaction> begin_transaction_statement;
+    TaggedPreparedStatement<Statements::CommitTransaction> commit_transaction_statement;
+    TaggedPreparedStatement<Statements::RollbackTransaction> rollback_transaction_statement;
     TaggedPreparedStatement<Statements::RemoveApplication> remove_application_statement;
+    TaggedPreparedStatement<Statements::RemoveApplicationName> remove_application_name_statement;
+    TaggedPreparedStatement<Statements::RemoveFeature> remove_feature_statement;
+    TaggedPreparedStatement<Statements::RemoveOlderThan> remove_older_than_statement;
 };
 }
 }
@@ -732,15 +1550,72 @@ struct Store
 namespace trust = core::trust;
 namespace sqlite = core::trust::impl::sqlite;
 
-sqlite::Store::Store(const std::string& service_name, xdg::BaseDirSpecification& spec)
-    : db{(ensure_dir_or_throw(spec.data().home() / service_name) / "trust.db").string()},
-      create_data_table_statement{db.prepare_tagged_statement<Statements::CreateDataTableIfNotExists>()}
+namespace
+{
+// Returns the path to the trust database of service_name, creating
+// the containing directory if mode permits.
+std::string database_path(const std::string& service_name, xdg::BaseDirSpecification& spec, sqlite::Store::Mode mode)
+{
+    auto dir = spec.data().home() / service_name;
+
+    if (mode == sqlite::Store::Mode::read_write)
+        sqlite::ensure_dir_or_throw(dir);
+
+    return (dir / "trust.db").string();
+}
+
+// Returns the flags for opening a database in mode.
+int open_flags(sqlite::Store::Mode mode)
+{
+    switch (mode)
+    {
+    case sqlite::Store::Mode::read_only:
+        return SQLITE_OPEN_READONLY;
+    case sqlite::Store::Mode::read_write:
+        break;
+    }
+
+    return SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+}
+}
+
+sqlite::Store::Store(const std::string& service_name, xdg::BaseDirSpecification& spec, Mode mode)
+    : mode{mode},
+      db{database_path(service_name, spec, mode), open_flags(mode)}
 {
+    if (mode == Mode::read_only)
+    {
+        // Read-only stores only run queries, which fail to prepare if the database has not been set up.
+        // Version 3 only lacks timestamps in the index, and queries work all the same.
+        auto version = db.get_version();
+        if (version != Store::version && version != 3) throw trust::Store::Errors::ErrorOpeningStore
+        {
+            "Trust database does not exist or has an unsupported schema version."
+        };
+
+        return;
+    }
+
+    // Write-ahead logging allows for read-only stores in other processes to read
+    // the database while we are modifying it.
+    db.prepare_statement("PRAGMA journal_mode=WAL;").step();
+
     upgrade(db.get_version());
 
     delete_statement = db.prepare_tagged_statement<Statements::Delete>();
+    delete_applications_statement = db.prepare_tagged_statement<Statements::DeleteApplications>();
+    insert_application_statement = db.prepare_tagged_statement<Statements::InsertApplication>();
     insert_statement = db.prepare_tagged_statement<Statements::Insert>();
+    select_application_id_statement = db.prepare_tagged_statement<Statements::SelectApplicationId>();
+    insert_chunk_statement = db.prepare_tagged_statement<Statements::InsertInterned<rows_per_insert>>();
+    insert_interned_statement = db.prepare_tagged_statement<Statements::InsertInterned<1>>();
+    begin_transaction_statement = db.prepare_tagged_statement<Statements::BeginTransaction>();
+    commit_transaction_statement = db.prepare_tagged_statement<Statements::CommitTransaction>();
+    rollback_transaction_statement = db.prepare_tagged_statement<Statements::RollbackTransaction>();
     remove_application_statement = db.prepare_tagged_statement<Statements::RemoveApplication>();
+    remove_application_name_statement = db.prepare_tagged_statement<Statements::RemoveApplicationName>();
+    remove_feature_statement = db.prepare_tagged_statement<Statements::RemoveFeature>();
+    remove_older_than_statement = db.prepare_tagged_statement<Statements::RemoveOlderThan>();
 }
 
 sqlite::Store::~Store()
@@ -749,29 +1624,82 @@ sqlite::Store::~Store()
 
 void sqlite::Store::upgrade(std::int32_t from_version)
 {
-    switch (from_version)
+    if (from_version == 0)
     {
-    case 0:
-        create_data_table_if_not_exists();
+        create_schema_if_not_exists();
         db.set_version(Store::version);
-        break;
-    default:
-        break;
+        return;
+    }
+
+    // Requests refer to interned app ids from version 2 on, and we reclaim
+    // the space previously taken by the app ids afterwards.
+    if (from_version == 1)
+    {
+        migrate(Statements::MigrateFromVersion1::statement(), 2);
+        db.execute("VACUUM;");
+        from_version = 2;
+    }
+
+    // Statistics are maintained from version 3 on.
+    if (from_version == 2)
+    {
+        migrate(Statements::MigrateFromVersion2::statement(), 3);
+        from_version = 3;
+    }
+
+    // Timestamps are covered by the index from version 4 on.
+    if (from_version == 3)
+        migrate(Statements::MigrateFromVersion3::statement(), 4);
+}
+
+void sqlite::Store::migrate(const std::string& script, std::int32_t to_version)
+{
+    try
+    {
+        db.execute(
+                    "BEGIN IMMEDIATE TRANSACTION;" +
+                    script +
+                    "PRAGMA user_version=" + std::to_string(to_version) + ";"
+                    "COMMIT TRANSACTION;");
+    } catch(const std::runtime_error& e)
+    {
+        try
+        {
+            db.execute("ROLLBACK TRANSACTION;");
+        } catch(...)
+        {
+        }
+
+        throw trust::Store::Errors::ErrorOpeningStore{(std::string{"Failed to migrate trust database: "} + e.what()).c_str()};
     }
 }
 
-void sqlite::Store::create_data_table_if_not_exists()
+void sqlite::Store::create_schema_if_not_exists()
+{
+    db.execute(Statements::CreateSchemaIfNotExists::statement());
+}
+
+void sqlite::Store::throw_if_read_only() const
 {
-    create_data_table_statement.step();
+    if (mode == Mode::read_only)
+        throw trust::Store::Errors::StoreIsReadOnly{};
 }
 
 void sqlite::Store::reset()
 {
+    throw_if_read_only();
+
     std::lock_guard<std::mutex> lg(guard);
     try
     {
-        delete_statement.reset();
-        delete_statement.step();
+        within_transaction([this]()
+        {
+            delete_statement.reset();
+            delete_statement.step();
+
+            delete_applications_statement.reset();
+            delete_applications_statement.step();
+        });
     } catch(const std::runtime_error& e)
     {
         throw trust::Store::Errors::ErrorResettingStore{e.what()};
@@ -781,23 +1709,206 @@ void sqlite::Store::reset()
 
 void sqlite::Store::add(const trust::Request& request)
 {
+    throw_if_read_only();
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    // Interning the app id and inserting the request are committed together.
+    within_transaction([this, &request]()
+    {
+        insert(request);
+    });
+}
+
+void sqlite::Store::add_all(const std::vector<trust::Request>& requests)
+{
+    throw_if_read_only();
+
     std::lock_guard<std::mutex> lg(guard);
 
+    // All requests are committed with a single transaction, and thus a single sync to disk.
+    within_transaction([this, &requests]()
+    {
+        for (const auto& request : requests)
+            insert(request);
+    });
+}
+
+void sqlite::Store::insert(const trust::Request& request)
+{
+    // Empty app ids are not bound, and we must not pick up the binding of a previous request.
+    insert_application_statement.reset();
+    insert_application_statement.clear_bindings();
+    insert_application_statement.bind_text<Statements::InsertApplication::Parameter::Name::index>(request.from);
+    insert_application_statement.step();
+
     insert_statement.reset();
-    insert_statement.bind_text<sqlite::Store::RequestsTable::Column::ApplicationId::index>(request.from);
-    insert_statement.bind_int<sqlite::Store::RequestsTable::Column::Feature::index>(request.feature.value);
-    insert_statement.bind_int64<sqlite::Store::RequestsTable::Column::Timestamp::index>(request.when.time_since_epoch().count());
-    insert_statement.bind_int<sqlite::Store::RequestsTable::Column::Answer::index>(static_cast<int>(request.answer));
+    insert_statement.clear_bindings();
+    insert_statement.bind_text<Statements::Insert::Parameter::ApplicationId::index>(request.from);
+    insert_statement.bind_int64<Statements::Insert::Parameter::Feature::index>(static_cast<std::int64_t>(request.feature.value));
+    insert_statement.bind_int64<Statements::Insert::Parameter::Timestamp::index>(request.when.time_since_epoch().count());
+    insert_statement.bind_int<Statements::Insert::Parameter::Answer::index>(static_cast<int>(request.answer));
     insert_statement.step();
 }
 
+std::size_t sqlite::Store::load(const RequestSource& source, bool defer_indices)
+{
+    throw_if_read_only();
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    std::size_t count{0};
+
+    // Binds request to the given row of statement, with app ids being interned once per app.
+    std::unordered_map<std::string, std::int64_t> ids;
+    auto bind = [this, &ids](PreparedStatement& statement, std::size_t row, const trust::Request& request)
+    {
+        typedef Statements::InsertInterned<1>::Parameter Parameter;
+
+        auto it = ids.find(request.from);
+        if (it == ids.end())
+            it = ids.insert(std::make_pair(request.from, intern(request.from))).first;
+
+        auto first = Parameter::first_of_row(row);
+        statement.bind_int64(first + Parameter::ApplicationId::index, it->second);
+        statement.bind_int64(first + Parameter::Feature::index, static_cast<std::int64_t>(request.feature.value));
+        statement.bind_int64(first + Parameter::Timestamp::index, request.when.time_since_epoch().count());
+        statement.bind_int64(first + Parameter::Answer::index, static_cast<std::int64_t>(request.answer));
+    };
+
+    // All requests are committed with a single transaction, inserted in chunks of
+    // rows_per_insert requests with a single statement each.
+    within_transaction([&]()
+    {
+        if (defer_indices)
+            db.execute(Statements::DropDeferredIndices::statement());
+
+        std::vector<trust::Request> chunk; chunk.reserve(rows_per_insert);
+        trust::Request request;
+
+        while (source(request))
+        {
+            chunk.push_back(request);
+
+            if (chunk.size() < rows_per_insert)
+                continue;
+
+            insert_chunk_statement.reset();
+            for (std::size_t row = 0; row < chunk.size(); row++)
+                bind(insert_chunk_statement, row, chunk[row]);
+            insert_chunk_statement.step();
+
+            count += chunk.size();
+            chunk.clear();
+        }
+
+        for (const auto& request : chunk)
+        {
+            insert_interned_statement.reset();
+            bind(insert_interned_statement, 0, request);
+            insert_interned_statement.step();
+        }
+
+        count += chunk.size();
+
+        if (defer_indices)
+            db.execute(Statements::RebuildDeferredIndices::statement());
+    });
+
+    return count;
+}
+
+std::int64_t sqlite::Store::intern(const std::string& id)
+{
+    insert_application_statement.reset();
+    insert_application_statement.clear_bindings();
+    insert_application_statement.bind_text<Statements::InsertApplication::Parameter::Name::index>(id);
+    insert_application_statement.step();
+
+    select_application_id_statement.reset();
+    select_application_id_statement.clear_bindings();
+    select_application_id_statement.bind_text<Statements::SelectApplicationId::Parameter::Name::index>(id);
+
+    if (select_application_id_statement.step() != PreparedStatement::State::row)
+        throw std::runtime_error("Failed to intern app id: " + id);
+
+    auto result = select_application_id_statement.column_int64<0>();
+    // We must not hold a read cursor while inserting requests.
+    select_application_id_statement.reset();
+
+    return result;
+}
+
 void sqlite::Store::remove_application(const std::string& id)
+{
+    throw_if_read_only();
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    // Requests are looked up via the index on their interned app id, which is dropped afterwards.
+    within_transaction([this, &id]()
+    {
+        remove_application_statement.reset();
+        remove_application_statement.bind_text<Statements::RemoveApplication::Parameter::ApplicationId::index>(id);
+        remove_application_statement.step();
+
+        remove_application_name_statement.reset();
+        remove_application_name_statement.bind_text<Statements::RemoveApplicationName::Parameter::ApplicationId::index>(id);
+        remove_application_name_statement.step();
+    });
+}
+
+void sqlite::Store::remove_feature(trust::Feature feature)
+{
+    throw_if_read_only();
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    // A single statement covering all applications, and thus a single implicit transaction.
+    remove_feature_statement.reset();
+    remove_feature_statement.bind_int64<Statements::RemoveFeature::Parameter::Feature::index>(static_cast<std::int64_t>(feature.value));
+    remove_feature_statement.step();
+}
+
+void sqlite::Store::remove_older_than(const trust::Request::Timestamp& timestamp)
+{
+    throw_if_read_only();
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    remove_older_than_statement.reset();
+    remove_older_than_statement.bind_int64<Statements::RemoveOlderThan::Parameter::Timestamp::index>(timestamp.time_since_epoch().count());
+    remove_older_than_statement.step();
+}
+
+std::vector<trust::Store::Statistics> sqlite::Store::statistics()
 {
     std::lock_guard<std::mutex> lg(guard);
 
-    remove_application_statement.reset();
-    remove_application_statement.bind_text<Statements::RemoveApplication::Parameter::ApplicationId::index>(id);
-    remove_application_statement.step();
+    // Read-only stores do not prepare statements up front, and we thus prepare on demand.
+    auto select = db.prepare_tagged_statement<Statements::SelectStatistics>();
+
+    std::vector<Statistics> result;
+
+    while (select.step() == PreparedStatement::State::row)
+    {
+        auto timestamp = [](std::int64_t ticks)
+        {
+            return trust::Request::Timestamp{trust::Request::Duration{ticks}};
+        };
+
+        result.push_back(Statistics
+        {
+            select.column_text<StatisticsTable::Column::ApplicationId::index>(),
+            trust::Feature{static_cast<trust::Feature::IntegerType>(select.column_int64<StatisticsTable::Column::Feature::index>())},
+            static_cast<std::uint64_t>(select.column_int64<StatisticsTable::Column::Granted::index>()),
+            static_cast<std::uint64_t>(select.column_int64<StatisticsTable::Column::Denied::index>()),
+            timestamp(select.column_int64<StatisticsTable::Column::First::index>()),
+            timestamp(select.column_int64<StatisticsTable::Column::Last::index>())
+        });
+    }
+
+    return result;
 }
 
 std::shared_ptr<trust::Store::Query> sqlite::Store::query()
@@ -813,7 +1924,15 @@ std::shared_ptr<core::trust::Store> core::trust::impl::sqlite::create_for_servic
     return std::make_shared<sqlite::Store>(name, spec);
 }
 
-std::shared_ptr<core::trust::Store> core::trust::create_default_store(const std::string& service_name)
+std::shared_ptr<core::trust::Store> core::trust::impl::sqlite::create_read_only_for_service(const std::string& name, xdg::BaseDirSpecification& spec)
+{
+    if (name.empty())
+        throw core::trust::Errors::ServiceNameMustNotBeEmpty();
+
+    return std::make_shared<sqlite::Store>(name, spec, sqlite::Store::Mode::read_only);
+}
+
+std::shared_ptr<core::trust::Store> core::trust::create_read_only_store(const std::string& service_name)
 {
-    return core::trust::impl::sqlite::create_for_service(service_name, *xdg::BaseDirSpecification::create());
+    return core::trust::impl::sqlite::create_read_only_for_service(service_name, *xdg::BaseDirSpecification::create());
 }
@@ -41,6 +41,11 @@ namespace sqlite
 // trust for the service identified by service_name. Uses spec to determine a user-specific
 // directory to place the trust database.
 CORE_TRUST_DLL_PUBLIC std::shared_ptr<core::trust::Store> create_for_service(const std::string& service_name, xdg::BaseDirSpecification& spec);
+
+// create_read_only_for_service opens the existing sqlite3 trust database of the service
+// identified by service_name for reading, in the directory determined by spec. All
+// modifications of the returned store throw core::trust::Store::Errors::StoreIsReadOnly.
+CORE_TRUST_DLL_PUBLIC std::shared_ptr<core::trust::Store> create_read_only_for_service(const std::string& service_name, xdg::BaseDirSpecification& spec);
 }
 }
 }
@@ -24,6 +24,7 @@
 
 #include <boost/format.hpp>
 
+#include <future>
 #include <regex>
 // For std::cerr
 #include <iostream>
@@ -127,6 +128,93 @@ mir::PromptSessionVirtualTable::Ptr mir::ConnectionVirtualTable::create_prompt_s
     };
 }
 
+mir::PromptSessionAncestryCache::PromptSessionAncestryCache(
+        const mir::PromptSessionAncestryCache::ProcessStartTimeResolver& start_time_resolver,
+        std::size_t capacity)
+    : start_time_resolver{start_time_resolver},
+      capacity{capacity}
+{
+}
+
+bool mir::PromptSessionAncestryCache::lookup(core::trust::Pid pid, std::int64_t start_time, core::trust::Pid& ancestor)
+{
+    if (not start_time_resolver)
+        return false;
+
+    std::unique_lock<std::mutex> ul(guard);
+
+    auto it = entries.find(std::make_pair(pid, start_time));
+    if (it == entries.end())
+        return false;
+
+    auto entry = it->second;
+    it->second.last_used = ++clock;
+
+    // We do not hold the lock while reaching out to /proc.
+    ul.unlock();
+
+    std::int64_t ancestor_start_time{-1};
+    try
+    {
+        ancestor_start_time = start_time_resolver(entry.ancestor);
+    } catch(...)
+    {
+        // The ancestor went away, falling through to dropping the entry.
+    }
+
+    if (ancestor_start_time != entry.ancestor_start_time)
+    {
+        // The ancestor pid has been recycled in the meantime.
+        forget(pid, start_time);
+        return false;
+    }
+
+    ancestor = entry.ancestor;
+    return true;
+}
+
+void mir::PromptSessionAncestryCache::remember(core::trust::Pid pid, std::int64_t start_time, core::trust::Pid ancestor)
+{
+    if (not start_time_resolver || capacity == 0)
+        return;
+
+    Entry entry{ancestor, start_time_resolver(ancestor), 0};
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto key = std::make_pair(pid, start_time);
+
+    if (entries.count(key) == 0 && entries.size() >= capacity)
+        evict_least_recently_used();
+
+    entry.last_used = ++clock;
+    entries[key] = entry;
+}
+
+void mir::PromptSessionAncestryCache::forget(core::trust::Pid pid, std::int64_t start_time)
+{
+    std::lock_guard<std::mutex> lg(guard);
+    entries.erase(std::make_pair(pid, start_time));
+}
+
+std::size_t mir::PromptSessionAncestryCache::size() const
+{
+    std::lock_guard<std::mutex> lg(guard);
+    return entries.size();
+}
+
+void mir::PromptSessionAncestryCache::evict_least_recently_used()
+{
+    auto victim = entries.begin();
+
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+        if (it->second.last_used < victim->second.last_used)
+            victim = it;
+
+    if (victim != entries.end())
+        entries.erase(victim);
+}
+
 mir::PromptProviderHelper::PromptProviderHelper(
         const mir::PromptProviderHelper::CreationArguments& args) : creation_arguments(args)
 {
@@ -135,10 +223,16 @@ mir::PromptProviderHelper::PromptProviderHelper(
 core::posix::ChildProcess mir::PromptProviderHelper::exec_prompt_provider_with_arguments(
         const mir::PromptProviderHelper::InvocationArguments& args)
 {
-    static auto child_setup = []() {};
+    auto translated = args;
+    translated.description = i18n::tr(args.description, i18n::service_text_domain());
 
-    auto app_name = args.app_info.name;
-    auto description = i18n::tr(args.description, i18n::service_text_domain());
+    return exec_prompt_provider_with_translated_arguments(translated);
+}
+
+core::posix::ChildProcess mir::PromptProviderHelper::exec_prompt_provider_with_translated_arguments(
+        const mir::PromptProviderHelper::InvocationArguments& args)
+{
+    static auto child_setup = []() {};
 
     std::vector<std::string> argv
     {
@@ -146,7 +240,7 @@ core::posix::ChildProcess mir::PromptProviderHelper::exec_prompt_provider_with_a
         "--" + std::string{core::trust::mir::cli::option_icon}, args.app_info.icon,
         "--" + std::string{core::trust::mir::cli::option_name}, args.app_info.name,
         "--" + std::string{core::trust::mir::cli::option_id}, args.app_info.id,
-        "--" + std::string{core::trust::mir::cli::option_description}, description
+        "--" + std::string{core::trust::mir::cli::option_description}, args.description
     };
 
     // We just copy the environment
@@ -220,8 +314,19 @@ std::function<core::trust::Pid(core::trust::Pid)> mir::Agent::get_parent_pid_res
     };
 }
 
+mir::PromptSessionAncestryCache::ProcessStartTimeResolver mir::Agent::get_process_start_time_resolver()
+{
+    return [] (core::trust::Pid pid) {
+        core::posix::Process proc(pid.value);
+        core::posix::linux::proc::process::Stat stat;
+        proc >> stat;
+        return stat.start_time;
+    };
+}
+
 mir::Agent::Agent(const mir::Agent::Configuration& config)
-    : config(config)
+    : config(config),
+      ancestry_cache{config.process_start_time_resolver}
 {
 }
 
@@ -255,6 +360,38 @@ core::trust::Request::Answer mir::Agent::authenticate_request_with_parameters(co
         /* fd */ -1
     };
 
+    typedef std::chrono::steady_clock Clock;
+
+    auto since = [](Clock::time_point then)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - then);
+    };
+
+    const auto request_received = Clock::now();
+    StageLatencies latencies{};
+
+    // Resolving the app info hits the filesystem and translating the description
+    // might load message catalogs. Neither depends on the compositor, and we take both
+    // off the critical path by running them concurrently to setting up the prompt session.
+    struct Presentation
+    {
+        AppInfo app_info;
+        std::string description;
+    };
+
+    auto presentation = std::async(std::launch::async, [this, &parameters, &latencies, since]()
+    {
+        auto start = Clock::now();
+        auto app_info = config.app_info_resolver->resolve(parameters.application.id);
+        latencies.app_info_resolution = since(start);
+
+        start = Clock::now();
+        auto description = i18n::tr(parameters.description, i18n::service_text_domain());
+        latencies.description_translation = since(start);
+
+        return Presentation{app_info, description};
+    });
+
     // Mir expects a PID of a process that have a Mir session. Meanwhile, the trust-store
     // users supply us the PID of the requesting process, which might not be the same process.
     // For example, QtWebEngine uses a helper process to record the audio. In this case,
@@ -262,9 +399,33 @@ core::trust::Request::Answer mir::Agent::authenticate_request_with_parameters(co
     //
     // What we do here is that, when we encounter such error from Mir, get the process's
     // parent pid, and then try again.
+    //
+    // Walking up the process tree costs a round trip to Mir per step. For that, we remember
+    // the ancestor that we eventually found, keyed by pid and process start time of the
+    // requesting process, and try the ancestor straight away for subsequent requests.
 
     core::trust::Pid pid = parameters.application.pid;
 
+    // Identifies the requesting process in the ancestry cache, if caching is enabled.
+    bool cacheable{static_cast<bool>(config.process_start_time_resolver)};
+    std::int64_t start_time{0};
+
+    if (cacheable)
+    {
+        try
+        {
+            start_time = config.process_start_time_resolver(pid);
+        } catch(...)
+        {
+            // We cannot identify the process reliably, and do not consult the cache.
+            cacheable = false;
+        }
+    }
+
+    bool pid_from_cache = cacheable && ancestry_cache.lookup(pid, start_time, pid);
+
+    auto stage_start = Clock::now();
+
     while (true) {
         // We setup the prompt session and wire up to our own internal callback helper.
         prompt_session =
@@ -286,6 +447,15 @@ core::trust::Request::Answer mir::Agent::authenticate_request_with_parameters(co
             };
         }
 
+        // The cached ancestor lost its session, we start over with the requesting process.
+        if (pid_from_cache)
+        {
+            ancestry_cache.forget(parameters.application.pid, start_time);
+            pid_from_cache = false;
+            pid = parameters.application.pid;
+            continue;
+        }
+
         // Find the parent process.
         pid = config.parent_pid_resolver(pid);
         if (pid.value <= 1) { // We're pretty sure that init doesn't have
@@ -297,19 +467,44 @@ core::trust::Request::Answer mir::Agent::authenticate_request_with_parameters(co
         }
     }
 
+    // We only remember ancestors that we had to search for.
+    if (cacheable && not pid_from_cache && pid != parameters.application.pid)
+    {
+        try
+        {
+            ancestry_cache.remember(parameters.application.pid, start_time, pid);
+        } catch(...)
+        {
+            // Failing to cache is not fatal, we just carry on.
+        }
+    }
+
+    latencies.prompt_session_setup = since(stage_start);
+
     // Acquire a new fd for the prompt provider.
+    stage_start = Clock::now();
     scope.fd = prompt_session->new_fd_for_prompt_provider();
+    latencies.fd_acquisition = since(stage_start);
+
+    // Join with the presentation stage, rethrowing any error raised there.
+    stage_start = Clock::now();
+    auto resolved = presentation.get();
+    latencies.pipeline_stall = since(stage_start);
 
     // And prepare the actual execution in a child process.
     mir::PromptProviderHelper::InvocationArguments args
     {
         scope.fd,
-        config.app_info_resolver->resolve(parameters.application.id),
-        parameters.description
+        resolved.app_info,
+        resolved.description
     };
 
-    // Ask the helper to fire up the prompt provider.
-    cb_context.prompt_provider_process = config.exec_helper->exec_prompt_provider_with_arguments(args);
+    // Ask the helper to fire up the prompt provider, the description has been translated already.
+    cb_context.prompt_provider_process = config.exec_helper->exec_prompt_provider_with_translated_arguments(args);
+    latencies.time_to_prompt = since(request_received);
+
+    if (config.latency_reporter)
+        config.latency_reporter(latencies);
     // And subsequently wait for it to finish.
     auto result = cb_context.prompt_provider_process.wait_for(core::posix::wait::Flags::untraced);
 
@@ -358,6 +553,9 @@ std::shared_ptr<core::trust::Agent> mir::create_agent_for_mir_connection(MirConn
         mir::Agent::translator_only_accepting_exit_status_success(),
         anr,
         mir::Agent::get_parent_pid_resolver(),
+        mir::Agent::get_process_start_time_resolver(),
+        // No latency reporting by default.
+        {}
     };
     return mir::Agent::Ptr{new mir::Agent{config}};
 }
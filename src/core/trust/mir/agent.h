@@ -29,8 +29,11 @@
 
 #include <boost/filesystem.hpp>
 
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <mutex>
 
 namespace core
@@ -140,9 +143,14 @@ struct CORE_TRUST_DLL_PUBLIC PromptProviderHelper
     virtual ~PromptProviderHelper() = default;
 
     // Execs the executable provided at construction time for the arguments and
-    // returns the corresponding child process.
+    // returns the corresponding child process. The description is translated
+    // within the text domain of the service prior to presenting it to the user.
     virtual core::posix::ChildProcess exec_prompt_provider_with_arguments(const InvocationArguments& args);
 
+    // Just like exec_prompt_provider_with_arguments, but for arguments whose description
+    // has been translated by the caller already, and is presented to the user as is.
+    virtual core::posix::ChildProcess exec_prompt_provider_with_translated_arguments(const InvocationArguments& args);
+
     // We store all arguments passed at construction.
     CreationArguments creation_arguments;
 };
@@ -158,6 +166,60 @@ struct AppInfoResolver
     virtual AppInfo resolve(const std::string& app_id) = 0;
 };
 
+// A PromptSessionAncestryCache remembers which ancestor of a requesting process
+// owns the Mir session that prompt sessions have to be created for. Entries are
+// keyed by pid and process start time, and are only handed out if the ancestor
+// still refers to the very same process, too. All functions are thread-safe.
+class CORE_TRUST_DLL_PUBLIC PromptSessionAncestryCache
+{
+public:
+    // Functor abstracting pid -> process start time resolving.
+    typedef std::function<std::int64_t(core::trust::Pid)> ProcessStartTimeResolver;
+
+    // The default number of entries an instance holds on to.
+    static constexpr const std::size_t default_capacity{64};
+
+    // Sets up an empty cache relying on start_time_resolver for validating entries.
+    PromptSessionAncestryCache(const ProcessStartTimeResolver& start_time_resolver,
+                               std::size_t capacity = default_capacity);
+
+    // Returns true and the cached ancestor of pid (started at start_time) in ancestor,
+    // iff a valid entry is known. Stale entries are dropped.
+    bool lookup(core::trust::Pid pid, std::int64_t start_time, core::trust::Pid& ancestor);
+
+    // Remembers that the process pid (started at start_time) is associated with
+    // the Mir session of ancestor.
+    void remember(core::trust::Pid pid, std::int64_t start_time, core::trust::Pid ancestor);
+
+    // Drops any entry known for pid (started at start_time).
+    void forget(core::trust::Pid pid, std::int64_t start_time);
+
+    // Returns the number of entries currently held by the cache.
+    std::size_t size() const;
+
+private:
+    // An Entry describes a cached ancestor.
+    struct Entry
+    {
+        // The pid of the ancestor owning a Mir session.
+        core::trust::Pid ancestor;
+        // The start time of the ancestor, for validation purposes.
+        std::int64_t ancestor_start_time;
+        // Logical timestamp of the last access, used for eviction.
+        std::uint64_t last_used;
+    };
+
+    // Evicts the least recently used entry. Has to be called with guard held.
+    void evict_least_recently_used();
+
+    ProcessStartTimeResolver start_time_resolver;
+    std::size_t capacity;
+
+    mutable std::mutex guard;
+    std::uint64_t clock{0};
+    std::map<std::pair<core::trust::Pid, std::int64_t>, Entry> entries;
+};
+
 // Implements the trust::Agent interface and dispatches calls to a helper
 // prompt provider, tying it together with the requesting service and app
 // by leveraging Mir's trusted session/prompting support.
@@ -166,6 +228,25 @@ struct CORE_TRUST_DLL_PUBLIC Agent : public core::trust::Agent
     // Convenience typedef
     typedef std::shared_ptr<Agent> Ptr;
 
+    // StageLatencies breaks down the time spent in the individual stages of
+    // setting up a prompt. App info resolution and description translation run
+    // concurrently to the compositor round trips.
+    struct StageLatencies
+    {
+        // Creating the prompt session, including walking up the process tree.
+        std::chrono::microseconds prompt_session_setup;
+        // Acquiring a pre-authenticated fd for the prompt provider.
+        std::chrono::microseconds fd_acquisition;
+        // Resolving the app info of the requesting application.
+        std::chrono::microseconds app_info_resolution;
+        // Translating the description of the request.
+        std::chrono::microseconds description_translation;
+        // Waiting for app info and description after the compositor calls finished.
+        std::chrono::microseconds pipeline_stall;
+        // From receiving the request to exec'ing the prompt provider.
+        std::chrono::microseconds time_to_prompt;
+    };
+
     // A Configuration bundles creation-time configuration options.
     struct Configuration
     {
@@ -180,6 +261,11 @@ struct CORE_TRUST_DLL_PUBLIC Agent : public core::trust::Agent
         AppInfoResolver::Ptr app_info_resolver;
         // A function for retreiving a process's parent pid.
         std::function<core::trust::Pid(const core::trust::Pid)> parent_pid_resolver;
+        // A function for retrieving a process's start time. If set, the agent caches the
+        // ancestor owning a Mir session for requesting processes, validated by start time.
+        PromptSessionAncestryCache::ProcessStartTimeResolver process_start_time_resolver;
+        // Invoked with a breakdown of per-stage latencies for every prompt, if set.
+        std::function<void(const StageLatencies&)> latency_reporter;
     };
 
     // Helper struct for injecting state into on_trust_changed_state_state callbacks.
@@ -208,6 +294,9 @@ struct CORE_TRUST_DLL_PUBLIC Agent : public core::trust::Agent
     // Returns a function resolving parent pid of a process using process-cpp.
     static std::function<core::trust::Pid(core::trust::Pid)> get_parent_pid_resolver();
 
+    // Returns a function resolving the start time of a process using process-cpp.
+    static PromptSessionAncestryCache::ProcessStartTimeResolver get_process_start_time_resolver();
+
     // Creates a new MirAgent instance with the given Configuration.
     Agent(const Configuration& config);
 
@@ -218,6 +307,8 @@ struct CORE_TRUST_DLL_PUBLIC Agent : public core::trust::Agent
 
     // The configured options.
     Configuration config;
+    // Maps requesting processes to the ancestor owning a Mir session.
+    PromptSessionAncestryCache ancestry_cache;
 };
 
 CORE_TRUST_DLL_PUBLIC bool operator==(const PromptProviderHelper::InvocationArguments&, const PromptProviderHelper::InvocationArguments&);
@@ -0,0 +1,157 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/notifying_store.h>
+
+#include <map>
+#include <mutex>
+
+namespace
+{
+typedef core::trust::dbus::Store::Changed::Kind Kind;
+
+// Decorates queries, notifying observers whenever results are erased.
+class Query : public core::trust::ForwardingStore::Query
+{
+public:
+    Query(const std::shared_ptr<core::trust::Store::Query>& impl, const std::function<void(Kind, const core::trust::Request&)>& notify)
+        : core::trust::ForwardingStore::Query{impl}, notify{notify}
+    {
+    }
+
+    void erase() override
+    {
+        // We remember the request about to be erased for announcing the change.
+        auto erased = impl->status() == core::trust::Store::Query::Status::has_more_results;
+        core::trust::Request request{};
+        if (erased)
+            request = impl->current();
+
+        impl->erase();
+
+        if (erased)
+            notify(Kind::erased, request);
+    }
+    void erase_all() override { impl->erase_all(); notify(Kind::results_erased, core::trust::Request{}); }
+
+private:
+    std::function<void(Kind, const core::trust::Request&)> notify;
+};
+}
+
+struct core::trust::NotifyingStore::Observers
+{
+    // Hands a modification to all observers.
+    void notify(Kind kind, const core::trust::Request& request)
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        for (const auto& pair : observers)
+            pair.second(kind, request);
+    }
+
+    std::mutex guard;
+    Connection next_connection{0};
+    std::map<Connection, Observer> observers;
+};
+
+core::trust::NotifyingStore::NotifyingStore(const std::shared_ptr<core::trust::Store>& impl)
+    : core::trust::ForwardingStore{impl},
+      observers{std::make_shared<Observers>()}
+{
+}
+
+core::trust::NotifyingStore::Connection core::trust::NotifyingStore::connect(const core::trust::NotifyingStore::Observer& observer)
+{
+    std::lock_guard<std::mutex> lg(observers->guard);
+
+    auto connection = observers->next_connection++;
+    observers->observers[connection] = observer;
+
+    return connection;
+}
+
+void core::trust::NotifyingStore::disconnect(core::trust::NotifyingStore::Connection connection)
+{
+    // Blocks until notifications in flight have been handed to the observer.
+    std::lock_guard<std::mutex> lg(observers->guard);
+    observers->observers.erase(connection);
+}
+
+void core::trust::NotifyingStore::reset()
+{
+    impl->reset();
+    observers->notify(Kind::reset, core::trust::Request{});
+}
+
+void core::trust::NotifyingStore::add(const core::trust::Request& request)
+{
+    impl->add(request);
+    observers->notify(Kind::added, request);
+}
+
+void core::trust::NotifyingStore::add_all(const std::vector<core::trust::Request>& requests)
+{
+    impl->add_all(requests);
+
+    for (const auto& request : requests)
+        observers->notify(Kind::added, request);
+}
+
+std::size_t core::trust::NotifyingStore::load(const core::trust::Store::RequestSource& source, bool defer_indices)
+{
+    // Loads might be large, and clients drop their cache altogether.
+    auto result = impl->load(source, defer_indices);
+    observers->notify(Kind::imported, core::trust::Request{});
+    return result;
+}
+
+void core::trust::NotifyingStore::remove_application(const std::string& id)
+{
+    impl->remove_application(id);
+
+    core::trust::Request request{};
+    request.from = id;
+    observers->notify(Kind::application_removed, request);
+}
+
+void core::trust::NotifyingStore::remove_feature(core::trust::Feature feature)
+{
+    impl->remove_feature(feature);
+
+    core::trust::Request request{};
+    request.feature = feature;
+    observers->notify(Kind::feature_removed, request);
+}
+
+void core::trust::NotifyingStore::remove_older_than(const core::trust::Request::Timestamp& timestamp)
+{
+    impl->remove_older_than(timestamp);
+
+    core::trust::Request request{};
+    request.when = timestamp;
+    observers->notify(Kind::older_removed, request);
+}
+
+std::shared_ptr<core::trust::Store::Query> core::trust::NotifyingStore::query()
+{
+    auto observers = this->observers;
+
+    return std::make_shared<::Query>(impl->query(), [observers](Kind kind, const core::trust::Request& request)
+    {
+        observers->notify(kind, request);
+    });
+}
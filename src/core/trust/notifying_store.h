@@ -0,0 +1,84 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_NOTIFYING_STORE_H_
+#define CORE_TRUST_NOTIFYING_STORE_H_
+
+#include <core/trust/expose.h>
+#include <core/trust/forwarding_store.h>
+
+#include <core/trust/dbus/interface.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace core
+{
+namespace trust
+{
+// Forwards to an actual store implementation, and notifies observers of every
+// modification applied through it once the modification succeeded. Exposed stores
+// announce these notifications to their clients, and all writers within the process,
+// e.g., a core::trust::CachedAgent, have to go through the very same instance.
+class CORE_TRUST_DLL_PUBLIC NotifyingStore : public core::trust::ForwardingStore
+{
+public:
+    // Just to safe some typing.
+    typedef std::shared_ptr<NotifyingStore> Ptr;
+
+    // Invoked for every modification, with the affected request.
+    typedef std::function<void(core::trust::dbus::Store::Changed::Kind, const Request&)> Observer;
+
+    // Identifies an observer installed with connect.
+    typedef std::uint64_t Connection;
+
+    NotifyingStore(const std::shared_ptr<Store>& impl);
+
+    // Installs observer, returning a connection for removing it again.
+    Connection connect(const Observer& observer);
+
+    // Removes the observer installed under connection.
+    void disconnect(Connection connection);
+
+    // From core::trust::Store
+    void reset() override;
+    void add(const Request& request) override;
+    void add_all(const std::vector<Request>& requests) override;
+    std::size_t load(const RequestSource& source, bool defer_indices) override;
+    void remove_application(const std::string& id) override;
+    void remove_feature(Feature feature) override;
+    void remove_older_than(const Request::Timestamp& timestamp) override;
+    std::shared_ptr<core::trust::Store::Query> query() override;
+
+private:
+    // Shared with queries, which might outlive the store.
+    struct Observers;
+
+    std::shared_ptr<Observers> observers;
+};
+
+// Exposes store on bus under the given name, announcing all modifications applied through
+// notifications to clients. store has to forward modifications to notifications.
+CORE_TRUST_DLL_PUBLIC std::unique_ptr<Token> expose_store_to_bus_with_name(
+        const std::shared_ptr<Store>& store,
+        const NotifyingStore::Ptr& notifications,
+        const std::shared_ptr<core::dbus::Bus>& bus,
+        const std::string& name);
+}
+}
+
+#endif // CORE_TRUST_NOTIFYING_STORE_H_
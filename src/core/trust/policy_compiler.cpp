@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/policy_compiler.h>
+#include <core/trust/policy_snapshot.h>
+
+#include <boost/program_options.hpp>
+
+#include <fstream>
+#include <iostream>
+
+namespace Options = boost::program_options;
+
+core::trust::PolicyCompiler::Configuration core::trust::PolicyCompiler::Configuration::parse_from_command_line(int argc, const char** argv)
+{
+    Options::variables_map vm;
+
+    Options::options_description options{"Known options"};
+    options.add_options()
+            (Parameters::Policy::name, Options::value<std::string>()->required(), Parameters::Policy::description)
+            (Parameters::Output::name, Options::value<std::string>()->required(), Parameters::Output::description);
+
+    Options::command_line_parser parser
+    {
+        argc,
+        argv
+    };
+
+    auto parsed_options = parser.options(options).allow_unregistered().run();
+    Options::store(parsed_options, vm);
+    Options::notify(vm);
+
+    return core::trust::PolicyCompiler::Configuration
+    {
+        vm[Parameters::Policy::name].as<std::string>(),
+        vm[Parameters::Output::name].as<std::string>()
+    };
+}
+
+core::posix::exit::Status core::trust::PolicyCompiler::main(const core::trust::PolicyCompiler::Configuration& configuration)
+{
+    std::ifstream in{configuration.policy};
+
+    if (not in)
+    {
+        std::cerr << "Could not open policy " << configuration.policy << std::endl;
+        return core::posix::exit::Status::failure;
+    }
+
+    try
+    {
+        auto rules = core::trust::PolicySnapshot::parse_rules(in);
+        core::trust::PolicySnapshot::compile(rules, configuration.output);
+    } catch(const std::exception& e)
+    {
+        std::cerr << "Could not compile policy " << configuration.policy << ": " << e.what() << std::endl;
+        return core::posix::exit::Status::failure;
+    }
+
+    return core::posix::exit::Status::success;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_POLICY_COMPILER_H_
+#define CORE_TRUST_POLICY_COMPILER_H_
+
+#include <core/posix/exit.h>
+
+#include <string>
+
+namespace core
+{
+namespace trust
+{
+// A helper executable compiling a policy file into a snapshot consulted by
+// trust-stored before the per-service trust store. Invoke it with:
+//   trust-store-policy-compiler
+//   --policy /etc/trust-store/policy
+//   --output /var/lib/trust-store/policy.snapshot
+// Please see core::trust::PolicySnapshot::parse_rules for a description of the
+// policy format. Please note that application ids are matched after stripping
+// their version, i.e., patterns should refer to package_app.
+struct PolicyCompiler
+{
+    // Command-line parameters, their name and their description
+    struct Parameters
+    {
+        Parameters() = delete;
+
+        struct Policy
+        {
+            static constexpr const char* name{"policy"};
+            static constexpr const char* description{"The policy file that should be compiled."};
+        };
+
+        struct Output
+        {
+            static constexpr const char* name{"output"};
+            static constexpr const char* description{"The path the compiled snapshot should be written to."};
+        };
+    };
+
+    // Parameters for execution of the compiler executable.
+    struct Configuration
+    {
+        // Parses command line args and produces a configuration
+        static Configuration parse_from_command_line(int argc, const char** argv);
+        // The policy file that should be compiled.
+        std::string policy;
+        // The path the compiled snapshot should be written to.
+        std::string output;
+    };
+
+    static core::posix::exit::Status main(const Configuration& configuration);
+};
+}
+}
+
+#endif // CORE_TRUST_POLICY_COMPILER_H_
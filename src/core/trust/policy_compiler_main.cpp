@@ -0,0 +1,24 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/policy_compiler.h>
+
+int main(int argc, const char** argv)
+{
+    auto result = core::trust::PolicyCompiler::main(core::trust::PolicyCompiler::Configuration::parse_from_command_line(argc, argv));
+
+    return result == core::posix::exit::Status::success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,533 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/policy_snapshot.h>
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <map>
+#include <sstream>
+#include <system_error>
+#include <tuple>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace
+{
+// A snapshot is laid out as follows:
+//
+// |-----------------------------------------------------------------------------------------|
+// | Header      | Magic | Version : u32 | Entries : u32 | Slots : u32 | Buckets : u32 |      |
+// |             | PrefixSizes : u32 | PoolSize : u32                                        |
+// | PrefixSizes | u32 for every distinct prefix size, in descending order                   |
+// | Seeds       | u32 for every bucket, selecting the hash function for the bucket          |
+// | Slots       | u32 for every slot, indexing into Entries or empty_slot                   |
+// | Entries     | Offset : u32 | Size : u32 | Feature : u64 | Answer : u8 | IsPrefix : u8 | Padding : u16 |
+// | Pool        | The patterns of all entries, without the trailing '*' of prefixes         |
+// |-----------------------------------------------------------------------------------------|
+//
+// All integers are stored in little-endian order. A key is mapped to its slot by first hashing it into
+// a bucket, and then hashing it with the seed of its bucket, with seeds chosen at compile time such that
+// no two keys share a slot.
+constexpr const char magic[] = {'T', 'R', 'U', 'S', 'T', 'P', 'O', 'L'};
+constexpr const std::uint32_t format_version{1};
+constexpr const std::size_t header_size{sizeof(magic) + 6 * sizeof(std::uint32_t)};
+constexpr const std::size_t entry_size{2 * sizeof(std::uint32_t) + sizeof(std::uint64_t) + 4};
+constexpr const std::uint32_t empty_slot{0xffffffff};
+
+// We give up compiling a snapshot if no seed can be found for a bucket within this many attempts.
+constexpr const std::uint32_t max_seed{1 << 24};
+
+template<typename Integer>
+void put(std::string& out, Integer value)
+{
+    for (std::size_t i = 0; i < sizeof(Integer); i++)
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+template<typename Integer>
+Integer get(const char* in)
+{
+    Integer value{0};
+
+    for (std::size_t i = 0; i < sizeof(Integer); i++)
+        value |= static_cast<Integer>(static_cast<std::uint8_t>(in[i])) << (8 * i);
+
+    return value;
+}
+
+std::uint64_t mix(std::uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+std::uint64_t hash_key(const char* pattern, std::size_t size, bool is_prefix, core::trust::Feature feature)
+{
+    std::uint64_t h{14695981039346656037ULL};
+
+    for (std::size_t i = 0; i < size; i++)
+    {
+        h ^= static_cast<std::uint8_t>(pattern[i]);
+        h *= 1099511628211ULL;
+    }
+
+    return mix(mix(h ^ feature.value) + (is_prefix ? 1 : 2));
+}
+
+std::uint32_t bucket_for(std::uint64_t hash, std::uint32_t bucket_count)
+{
+    return hash % bucket_count;
+}
+
+std::uint32_t slot_for(std::uint64_t hash, std::uint32_t seed, std::uint32_t slot_count)
+{
+    return mix(hash ^ ((seed + 1) * 0x9e3779b97f4a7c15ULL)) % slot_count;
+}
+
+// write_or_throw writes all of data to fd.
+void write_or_throw(int fd, const std::string& data)
+{
+    std::size_t written{0};
+
+    while (written < data.size())
+    {
+        auto rc = ::write(fd, data.data() + written, data.size() - written);
+
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::system_category());
+        }
+
+        written += rc;
+    }
+}
+
+std::runtime_error malformed(const boost::filesystem::path& path, const std::string& reason)
+{
+    return std::runtime_error{"Malformed policy snapshot " + path.string() + ": " + reason};
+}
+}
+
+std::vector<core::trust::PolicySnapshot::Rule> core::trust::PolicySnapshot::parse_rules(std::istream& in)
+{
+    std::vector<core::trust::PolicySnapshot::Rule> rules;
+
+    std::string line; std::size_t line_number{0};
+    while (std::getline(in, line))
+    {
+        line_number++;
+
+        auto first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        std::stringstream ss{line};
+        std::string pattern, answer, trailing; std::uint64_t feature;
+
+        if (not (ss >> pattern >> feature >> answer) || (ss >> trailing) || (answer != "granted" && answer != "denied"))
+            throw std::runtime_error{"Could not parse rule in line " + std::to_string(line_number) + ": " + line};
+
+        rules.push_back(core::trust::PolicySnapshot::Rule
+        {
+            pattern,
+            core::trust::Feature{feature},
+            answer == "granted" ? core::trust::Request::Answer::granted : core::trust::Request::Answer::denied
+        });
+    }
+
+    return rules;
+}
+
+void core::trust::PolicySnapshot::compile(const std::vector<core::trust::PolicySnapshot::Rule>& rules, const boost::filesystem::path& path)
+{
+    struct Key
+    {
+        std::string pattern;
+        bool is_prefix;
+        std::uint64_t feature;
+
+        bool operator<(const Key& rhs) const
+        {
+            return std::tie(pattern, is_prefix, feature) < std::tie(rhs.pattern, rhs.is_prefix, rhs.feature);
+        }
+    };
+
+    // Later rules override earlier ones.
+    std::map<Key, core::trust::Request::Answer> answers;
+    for (const auto& rule : rules)
+    {
+        auto star = rule.pattern.find('*');
+
+        if (rule.pattern.empty() || (star != std::string::npos && star != rule.pattern.size() - 1)) throw std::runtime_error
+        {
+            "Invalid pattern, '*' is only supported as last character: " + rule.pattern
+        };
+
+        bool is_prefix = star != std::string::npos;
+        answers[Key{rule.pattern.substr(0, star), is_prefix, rule.feature.value}] = rule.answer;
+    }
+
+    std::vector<std::pair<Key, core::trust::Request::Answer>> entries(answers.begin(), answers.end());
+    std::uint32_t entry_count = entries.size();
+    std::uint32_t slot_count = entry_count + entry_count / 4 + 1;
+    std::uint32_t bucket_count = entry_count / 4 + 1;
+
+    std::vector<std::uint64_t> hashes;
+    std::vector<std::vector<std::uint32_t>> buckets(bucket_count);
+    std::vector<std::uint32_t> prefix_sizes;
+
+    for (std::uint32_t i = 0; i < entry_count; i++)
+    {
+        const auto& key = entries[i].first;
+        hashes.push_back(hash_key(key.pattern.data(), key.pattern.size(), key.is_prefix, core::trust::Feature{key.feature}));
+        buckets[bucket_for(hashes.back(), bucket_count)].push_back(i);
+
+        if (key.is_prefix)
+            prefix_sizes.push_back(key.pattern.size());
+    }
+
+    std::sort(prefix_sizes.begin(), prefix_sizes.end(), std::greater<std::uint32_t>());
+    prefix_sizes.erase(std::unique(prefix_sizes.begin(), prefix_sizes.end()), prefix_sizes.end());
+
+    // We place large buckets first, while there is still plenty of room.
+    std::vector<std::uint32_t> order(bucket_count);
+    for (std::uint32_t i = 0; i < bucket_count; i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&buckets](std::uint32_t lhs, std::uint32_t rhs)
+    {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    std::vector<std::uint32_t> seeds(bucket_count, 0);
+    std::vector<std::uint32_t> slots(slot_count, empty_slot);
+
+    for (auto bucket : order)
+    {
+        if (buckets[bucket].empty())
+            break;
+
+        std::vector<std::uint32_t> candidates;
+        std::uint32_t seed{0};
+
+        for (; seed < max_seed; seed++)
+        {
+            candidates.clear();
+
+            for (auto entry : buckets[bucket])
+            {
+                auto slot = slot_for(hashes[entry], seed, slot_count);
+
+                if (slots[slot] != empty_slot || std::find(candidates.begin(), candidates.end(), slot) != candidates.end())
+                    break;
+
+                candidates.push_back(slot);
+            }
+
+            if (candidates.size() == buckets[bucket].size())
+                break;
+        }
+
+        if (seed == max_seed) throw std::runtime_error
+        {
+            "Could not compute a perfect hash for the given rules."
+        };
+
+        seeds[bucket] = seed;
+        for (std::size_t i = 0; i < candidates.size(); i++)
+            slots[candidates[i]] = buckets[bucket][i];
+    }
+
+    std::string pool, out{magic, sizeof(magic)};
+    put<std::uint32_t>(out, format_version);
+    put<std::uint32_t>(out, entry_count);
+    put<std::uint32_t>(out, slot_count);
+    put<std::uint32_t>(out, bucket_count);
+    put<std::uint32_t>(out, prefix_sizes.size());
+
+    for (const auto& entry : entries)
+        pool.append(entry.first.pattern);
+    put<std::uint32_t>(out, pool.size());
+
+    for (auto size : prefix_sizes)
+        put<std::uint32_t>(out, size);
+    for (auto seed : seeds)
+        put<std::uint32_t>(out, seed);
+    for (auto slot : slots)
+        put<std::uint32_t>(out, slot);
+
+    std::uint32_t offset{0};
+    for (const auto& entry : entries)
+    {
+        put<std::uint32_t>(out, offset);
+        put<std::uint32_t>(out, entry.first.pattern.size());
+        put<std::uint64_t>(out, entry.first.feature);
+        put<std::uint8_t>(out, static_cast<std::uint8_t>(entry.second));
+        put<std::uint8_t>(out, entry.first.is_prefix ? 1 : 0);
+        put<std::uint16_t>(out, 0);
+
+        offset += entry.first.pattern.size();
+    }
+
+    out.append(pool);
+
+    auto temporary = path.string() + ".compiling";
+
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0)
+        throw std::system_error(errno, std::system_category());
+
+    try
+    {
+        write_or_throw(fd, out);
+        if (::fsync(fd) != 0)
+            throw std::system_error(errno, std::system_category());
+    } catch(...)
+    {
+        ::close(fd);
+        ::unlink(temporary.c_str());
+        throw;
+    }
+
+    ::close(fd);
+
+    if (::rename(temporary.c_str(), path.string().c_str()) != 0)
+    {
+        auto error = errno;
+        ::unlink(temporary.c_str());
+        throw std::system_error(error, std::system_category());
+    }
+}
+
+core::trust::PolicySnapshot::Ptr core::trust::PolicySnapshot::open(const boost::filesystem::path& path)
+{
+    int fd = ::open(path.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw std::runtime_error
+    {
+        "Could not open policy snapshot " + path.string() + ": " + std::strerror(errno)
+    };
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        auto error = errno;
+        ::close(fd);
+        throw std::runtime_error{"Could not stat policy snapshot " + path.string() + ": " + std::strerror(error)};
+    }
+
+    if (static_cast<std::size_t>(st.st_size) < header_size)
+    {
+        ::close(fd);
+        throw malformed(path, "truncated header");
+    }
+
+    // A shared mapping of the file, with all processes relying on the same snapshot
+    // sharing the same pages. The mapping stays valid after closing the fd.
+    auto addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    auto error = errno;
+    ::close(fd);
+
+    if (addr == MAP_FAILED) throw std::runtime_error
+    {
+        "Could not map policy snapshot " + path.string() + ": " + std::strerror(error)
+    };
+
+    core::trust::PolicySnapshot::Ptr snapshot{new core::trust::PolicySnapshot{static_cast<const char*>(addr), static_cast<std::size_t>(st.st_size)}};
+
+    const char* data = snapshot->data;
+
+    if (std::memcmp(data, magic, sizeof(magic)) != 0)
+        throw malformed(path, "unknown magic");
+    if (get<std::uint32_t>(data + sizeof(magic)) != format_version)
+        throw malformed(path, "unsupported format version");
+
+    snapshot->entry_count = get<std::uint32_t>(data + sizeof(magic) + 4);
+    snapshot->slot_count = get<std::uint32_t>(data + sizeof(magic) + 8);
+    snapshot->bucket_count = get<std::uint32_t>(data + sizeof(magic) + 12);
+    snapshot->prefix_size_count = get<std::uint32_t>(data + sizeof(magic) + 16);
+    std::uint64_t pool_size = get<std::uint32_t>(data + sizeof(magic) + 20);
+
+    if (snapshot->slot_count == 0 || snapshot->bucket_count == 0)
+        throw malformed(path, "empty index");
+
+    std::uint64_t expected_size = header_size
+            + 4ull * snapshot->prefix_size_count
+            + 4ull * snapshot->bucket_count
+            + 4ull * snapshot->slot_count
+            + static_cast<std::uint64_t>(entry_size) * snapshot->entry_count
+            + pool_size;
+
+    if (expected_size != snapshot->data_size)
+        throw malformed(path, "unexpected size");
+
+    snapshot->prefix_sizes = data + header_size;
+    snapshot->seeds = snapshot->prefix_sizes + 4 * snapshot->prefix_size_count;
+    snapshot->slots = snapshot->seeds + 4 * snapshot->bucket_count;
+    snapshot->entries = snapshot->slots + 4 * snapshot->slot_count;
+    snapshot->pool = snapshot->entries + entry_size * snapshot->entry_count;
+
+    // We validate the index once, such that lookups can rely on it.
+    for (std::uint32_t i = 0; i < snapshot->slot_count; i++)
+    {
+        auto slot = get<std::uint32_t>(snapshot->slots + 4 * i);
+        if (slot != empty_slot && slot >= snapshot->entry_count)
+            throw malformed(path, "slot out of range");
+    }
+
+    for (std::uint32_t i = 0; i < snapshot->entry_count; i++)
+    {
+        const char* entry = snapshot->entries + entry_size * i;
+        std::uint64_t end = static_cast<std::uint64_t>(get<std::uint32_t>(entry)) + get<std::uint32_t>(entry + 4);
+
+        if (end > pool_size)
+            throw malformed(path, "pattern out of range");
+        if (get<std::uint8_t>(entry + 16) > static_cast<std::uint8_t>(core::trust::Request::Answer::granted))
+            throw malformed(path, "unknown answer");
+    }
+
+    return snapshot;
+}
+
+core::trust::PolicySnapshot::PolicySnapshot(const char* data, std::size_t size)
+    : data{data},
+      data_size{size},
+      entry_count{0},
+      slot_count{0},
+      bucket_count{0},
+      prefix_size_count{0},
+      prefix_sizes{nullptr},
+      seeds{nullptr},
+      slots{nullptr},
+      entries{nullptr},
+      pool{nullptr}
+{
+}
+
+core::trust::PolicySnapshot::~PolicySnapshot()
+{
+    ::munmap(const_cast<char*>(data), data_size);
+}
+
+bool core::trust::PolicySnapshot::lookup(const std::string& app_id, core::trust::Feature feature, core::trust::Request::Answer& answer) const
+{
+    auto index = find(app_id.data(), app_id.size(), false, feature);
+
+    // Prefix sizes are sorted in descending order, the longest matching prefix wins.
+    for (std::uint32_t i = 0; i < prefix_size_count && index < 0; i++)
+    {
+        auto size = get<std::uint32_t>(prefix_sizes + 4 * i);
+
+        if (size <= app_id.size())
+            index = find(app_id.data(), size, true, feature);
+    }
+
+    if (index < 0)
+        return false;
+
+    answer = static_cast<core::trust::Request::Answer>(get<std::uint8_t>(entries + entry_size * index + 16));
+    return true;
+}
+
+std::size_t core::trust::PolicySnapshot::size() const
+{
+    return entry_count;
+}
+
+std::int64_t core::trust::PolicySnapshot::find(const char* pattern, std::size_t pattern_size, bool is_prefix, core::trust::Feature feature) const
+{
+    auto hash = hash_key(pattern, pattern_size, is_prefix, feature);
+    auto seed = get<std::uint32_t>(seeds + 4 * bucket_for(hash, bucket_count));
+    auto index = get<std::uint32_t>(slots + 4 * slot_for(hash, seed, slot_count));
+
+    if (index == empty_slot)
+        return -1;
+
+    // The slot might be occupied by a different key, so we compare the full key.
+    const char* entry = entries + entry_size * index;
+
+    if (get<std::uint32_t>(entry + 4) != pattern_size ||
+        get<std::uint64_t>(entry + 8) != feature.value ||
+        get<std::uint8_t>(entry + 17) != (is_prefix ? 1 : 0) ||
+        std::memcmp(pool + get<std::uint32_t>(entry), pattern, pattern_size) != 0)
+        return -1;
+
+    return index;
+}
+
+core::trust::PolicySnapshotAgent::PolicySnapshotAgent(
+        const core::trust::PolicySnapshot::Ptr& snapshot,
+        const std::shared_ptr<core::trust::Agent>& impl)
+    : snapshot{snapshot},
+      impl{impl}
+{
+    if (not snapshot) throw std::runtime_error
+    {
+        "Missing policy snapshot."
+    };
+
+    if (not impl) throw std::runtime_error
+    {
+        "Missing agent implementation."
+    };
+}
+
+core::trust::Request::Answer core::trust::PolicySnapshotAgent::authenticate_request_with_parameters(const core::trust::Agent::RequestParameters& parameters)
+{
+    core::trust::Request::Answer answer;
+
+    if (snapshot->lookup(parameters.application.id, parameters.feature, answer))
+        return answer;
+
+    return impl->authenticate_request_with_parameters(parameters);
+}
+
+core::trust::Agent::BatchAnswer core::trust::PolicySnapshotAgent::authenticate_batch_request_with_parameters(const core::trust::Agent::BatchRequestParameters& parameters)
+{
+    core::trust::Agent::BatchAnswer answers;
+
+    // We only pass on the features that are not covered by the snapshot.
+    auto remaining = parameters;
+    remaining.features.clear();
+
+    for (const auto& feature : parameters.features)
+    {
+        core::trust::Request::Answer answer;
+
+        if (snapshot->lookup(parameters.application.id, feature, answer))
+            answers[feature] = answer;
+        else
+            remaining.features.insert(feature);
+    }
+
+    if (not remaining.features.empty())
+    {
+        auto delegated = impl->authenticate_batch_request_with_parameters(remaining);
+        answers.insert(delegated.begin(), delegated.end());
+    }
+
+    return answers;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_POLICY_SNAPSHOT_H_
+#define CORE_TRUST_POLICY_SNAPSHOT_H_
+
+#include <core/trust/agent.h>
+#include <core/trust/request.h>
+#include <core/trust/visibility.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace core
+{
+namespace trust
+{
+// A PolicySnapshot is an immutable, precompiled set of answers for (application id pattern, feature)
+// pairs. Snapshots are compiled ahead of time into a binary file featuring a perfect-hash index, and
+// are mapped read-only into memory when opened. With that, all users and services consulting the same
+// snapshot share its pages via the page cache, and lookups neither parse nor allocate.
+//
+// A pattern either matches an application id exactly, or, if it ends in '*', matches all application
+// ids starting with the characters preceding the '*'. Exact matches take precedence over prefix matches,
+// longer prefixes take precedence over shorter ones.
+class CORE_TRUST_DLL_PUBLIC PolicySnapshot
+{
+public:
+    // Just a convenience typedef.
+    typedef std::shared_ptr<PolicySnapshot> Ptr;
+
+    // A Rule associates an answer with an application id pattern and a feature.
+    struct Rule
+    {
+        std::string pattern;
+        Feature feature;
+        Request::Answer answer;
+    };
+
+    // Parses rules from in, one rule per line:
+    //   com.ubuntu.camera_camera     0     granted
+    //   com.ubuntu.*                 1     denied
+    //   ---------------------------------------------
+    //   | -- pattern --        feature     answer   |
+    // Empty lines and lines starting with '#' are ignored.
+    // Throws std::runtime_error if a line cannot be parsed.
+    static std::vector<Rule> parse_rules(std::istream& in);
+
+    // Compiles rules into a snapshot stored at path. Later rules override
+    // earlier ones for the same pattern and feature. The snapshot is written
+    // to a temporary file that is renamed over path, leaving instances that
+    // still map a previous snapshot unaffected.
+    // Throws std::runtime_error in case of issues.
+    static void compile(const std::vector<Rule>& rules, const boost::filesystem::path& path);
+
+    // Maps the snapshot stored at path into memory.
+    // Throws std::runtime_error if the snapshot cannot be opened or is malformed.
+    static Ptr open(const boost::filesystem::path& path);
+
+    PolicySnapshot(const PolicySnapshot&) = delete;
+    PolicySnapshot& operator=(const PolicySnapshot&) = delete;
+
+    ~PolicySnapshot();
+
+    // Returns true and the precompiled answer in answer if the snapshot
+    // covers app_id and feature, false otherwise.
+    bool lookup(const std::string& app_id, Feature feature, Request::Answer& answer) const;
+
+    // Returns the number of rules in the snapshot.
+    std::size_t size() const;
+
+private:
+    PolicySnapshot(const char* data, std::size_t size);
+
+    // Returns the index of the entry for the given key, or -1 if the snapshot does not know about the key.
+    std::int64_t find(const char* pattern, std::size_t pattern_size, bool is_prefix, Feature feature) const;
+
+    // The mapped snapshot.
+    const char* data;
+    std::size_t data_size;
+
+    // Pointers into the individual sections of the mapped snapshot.
+    std::uint32_t entry_count;
+    std::uint32_t slot_count;
+    std::uint32_t bucket_count;
+    std::uint32_t prefix_size_count;
+    const char* prefix_sizes;
+    const char* seeds;
+    const char* slots;
+    const char* entries;
+    const char* pool;
+};
+
+// An agent implementation answering requests covered by a PolicySnapshot, and
+// passing on all other requests to the next agent.
+class CORE_TRUST_DLL_PUBLIC PolicySnapshotAgent : public core::trust::Agent
+{
+public:
+    // Throws std::runtime_error if snapshot or impl is null.
+    PolicySnapshotAgent(const PolicySnapshot::Ptr& snapshot, const std::shared_ptr<Agent>& impl);
+
+    // From core::trust::Agent
+    Request::Answer authenticate_request_with_parameters(const RequestParameters& parameters) override;
+    BatchAnswer authenticate_batch_request_with_parameters(const BatchRequestParameters& parameters) override;
+
+private:
+    PolicySnapshot::Ptr snapshot;
+    std::shared_ptr<Agent> impl;
+};
+}
+}
+
+#endif // CORE_TRUST_POLICY_SNAPSHOT_H_
@@ -20,27 +20,72 @@
 
 #include <boost/program_options.hpp>
 
-#include <istream>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
 
 namespace Options = boost::program_options;
 
-std::istream& operator>>(std::istream& in, core::trust::Feature& f)
+namespace
 {
-    return in >> f.value;
+// Characters separating the fields of a request.
+constexpr const char* whitespace{" \t\r"};
+
+// Returns the next field of line at or after pos, advancing pos past it.
+// Returns an empty field if line holds no further field.
+std::string next_field(const std::string& line, std::string::size_type& pos)
+{
+    auto begin = line.find_first_not_of(whitespace, pos);
+    if (begin == std::string::npos)
+    {
+        pos = line.size();
+        return std::string{};
+    }
+
+    auto end = line.find_first_of(whitespace, begin);
+    if (end == std::string::npos)
+        end = line.size();
+
+    pos = end;
+    return line.substr(begin, end - begin);
+}
 }
 
-std::istream& operator>>(std::istream& in, core::trust::Request::Answer& answer)
+bool core::trust::Preseed::parse_request(const std::string& line, core::trust::Request& request)
 {
-    std::string s; in >> s;
+    std::string::size_type pos{0};
 
-    if (s == "denied")
-        answer = core::trust::Request::Answer::denied;
-    else if (s == "granted")
-        answer = core::trust::Request::Answer::granted;
+    auto app_id = next_field(line, pos);
+    if (app_id.empty() || app_id[0] == '#')
+        return false;
+
+    auto feature = next_field(line, pos);
+    auto answer = next_field(line, pos);
+
+    if (feature.empty() || answer.empty() || not next_field(line, pos).empty())
+        throw std::runtime_error{"Expected app id, feature and answer: " + line};
+
+    // We rely on strtoull instead of streams, which are considerably slower for large inputs.
+    char* end{nullptr}; errno = 0;
+    auto value = std::strtoull(feature.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || feature[0] == '-')
+        throw std::runtime_error{"Could not parse feature: " + feature};
+
+    request.from = app_id;
+    request.feature = core::trust::Feature{static_cast<core::trust::Feature::IntegerType>(value)};
+
+    if (answer == "denied")
+        request.answer = core::trust::Request::Answer::denied;
+    else if (answer == "granted")
+        request.answer = core::trust::Request::Answer::granted;
     else
-        throw std::logic_error{"Could not parse answer: " + s};
+        throw std::runtime_error{"Could not parse answer: " + answer};
 
-    return in;
+    return true;
 }
 
 core::trust::Preseed::Configuration core::trust::Preseed::Configuration::parse_from_command_line(int argc, const char** argv)
@@ -50,7 +95,9 @@ core::trust::Preseed::Configuration core::trust::Preseed::Configuration::parse_f
     Options::options_description options{"Known options"};
     options.add_options()
             (Parameters::ForService::name, Options::value<std::string>()->required(), Parameters::ForService::description)
-            (Parameters::Request::name, Options::value<std::vector<std::string>>()->composing(), Parameters::Request::description);
+            (Parameters::Request::name, Options::value<std::vector<std::string>>()->composing(), Parameters::Request::description)
+            (Parameters::Input::name, Options::value<std::string>(), Parameters::Input::description)
+            (Parameters::BulkLoad::name, Options::bool_switch()->default_value(false), Parameters::BulkLoad::description);
 
     Options::command_line_parser parser
     {
@@ -63,24 +110,43 @@ core::trust::Preseed::Configuration core::trust::Preseed::Configuration::parse_f
     Options::notify(vm);
 
     auto service_name = vm[Parameters::ForService::name].as<std::string>();
-    auto requests = vm[Parameters::Request::name].as<std::vector<std::string>>();
 
     core::trust::Preseed::Configuration config
     {
         core::trust::create_default_store(service_name),
-        {} // The empty set.
+        {}, // The empty set.
+        nullptr,
+        vm[Parameters::BulkLoad::name].as<bool>()
     };
 
-    for (const auto& request : requests)
+    if (vm.count(Parameters::Request::name) > 0)
+    {
+        for (const auto& request : vm[Parameters::Request::name].as<std::vector<std::string>>())
+        {
+            core::trust::Request r;
+
+            // Parse the request.
+            if (not parse_request(request, r))
+                continue;
+            // And set the timestamp to now.
+            r.when = std::chrono::system_clock::now();
+
+            config.requests.push_back(r);
+        }
+    }
+
+    if (vm.count(Parameters::Input::name) > 0)
     {
-        std::stringstream ss{request}; core::trust::Request r;
+        auto path = vm[Parameters::Input::name].as<std::string>();
 
-        // Parse the request.
-        ss >> r.from >> r.feature >> r.answer;
-        // And set the timestamp to now.
-        r.when = std::chrono::system_clock::now();
+        if (path == "-")
+            // We must not delete std::cin.
+            config.input.reset(&std::cin, [](std::istream*) {});
+        else
+            config.input = std::make_shared<std::ifstream>(path);
 
-        config.requests.push_back(r);
+        if (not *config.input)
+            throw std::runtime_error{"Could not open input: " + path};
     }
 
     return config;
@@ -88,8 +154,60 @@ core::trust::Preseed::Configuration core::trust::Preseed::Configuration::parse_f
 
 core::posix::exit::Status core::trust::Preseed::main(const core::trust::Preseed::Configuration& configuration)
 {
-    for (const auto& request : configuration.requests)
-        configuration.store->add(request);
+    auto requests = configuration.requests.begin();
+    std::size_t line_number{0};
+    std::string line;
+
+    // Hands out requests given on the command line first, followed by those read from the input.
+    auto source = [&](core::trust::Request& request)
+    {
+        if (requests != configuration.requests.end())
+        {
+            request = *requests++;
+            return true;
+        }
+
+        if (not configuration.input)
+            return false;
+
+        while (std::getline(*configuration.input, line))
+        {
+            line_number++;
+
+            try
+            {
+                if (not parse_request(line, request))
+                    continue;
+            } catch(const std::runtime_error& e)
+            {
+                throw std::runtime_error{"Line " + std::to_string(line_number) + ": " + e.what()};
+            }
+
+            request.when = std::chrono::system_clock::now();
+            return true;
+        }
+
+        return false;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::size_t count{0};
+
+    try
+    {
+        count = configuration.store->load(source, configuration.bulk_load);
+    } catch(const std::runtime_error& e)
+    {
+        std::cerr << "Failed to preseed trust store: " << e.what() << std::endl;
+        return core::posix::exit::Status::failure;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    // Guard against dividing by zero for small loads.
+    auto rate = count * 1000 / std::max<std::chrono::milliseconds::rep>(elapsed.count(), 1);
+
+    std::cout << "Loaded " << count << " requests in " << elapsed.count() << " ms (" << rate << " requests/s)" << std::endl;
 
     return core::posix::exit::Status::success;
 }
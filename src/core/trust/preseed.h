@@ -23,6 +23,8 @@
 
 #include <core/posix/exit.h>
 
+#include <istream>
+#include <memory>
 #include <vector>
 
 namespace core
@@ -40,6 +42,10 @@ namespace trust
 //   --request "does.not.exist.app      4           granted"
 //             ---------------------------------------------
 //             | ---- app id ----    feature        answer |
+//
+// Large numbers of requests are better streamed from a file, or from stdin if '-', with
+// one request per line in the same format, blank lines and lines starting with '#' ignored:
+//   trust-store-preseed --for-service MyFunkyServiceName --input requests.txt --bulk-load
 struct Preseed
 {
     // Command-line parameters, their name and their description
@@ -58,6 +64,18 @@ struct Preseed
             static constexpr const char* name{"request"};
             static constexpr const char* description{"Requests to be seeded into the trust store. Can be specified multiple times."};
         };
+
+        struct Input
+        {
+            static constexpr const char* name{"input"};
+            static constexpr const char* description{"File to read requests from, one per line, or '-' for stdin."};
+        };
+
+        struct BulkLoad
+        {
+            static constexpr const char* name{"bulk-load"};
+            static constexpr const char* description{"Defer building indices until all requests have been loaded, for large inputs."};
+        };
     };
 
     // Parameters for execution of the preseed executable.
@@ -69,8 +87,17 @@ struct Preseed
         std::shared_ptr<Store> store;
         // The set of requests that should be preseeded into the store.
         std::vector<core::trust::Request> requests;
+        // Stream to read further requests from, one per line, or null.
+        std::shared_ptr<std::istream> input;
+        // True if the store should defer building indices until all requests have been loaded.
+        bool bulk_load;
     };
 
+    // Parses a single line of the form "app_id feature answer" into request, except for its
+    // timestamp. Returns false for blank lines and comments, and throws std::runtime_error
+    // if line is malformed.
+    static bool parse_request(const std::string& line, core::trust::Request& request);
+
     static core::posix::exit::Status main(const Configuration& configuration);
 };
 }
@@ -18,8 +18,13 @@
 
 #include <core/trust/preseed.h>
 
+#include <iostream>
+
 int main(int argc, const char** argv)
 {
+    // Requests might be streamed from stdin, which we never mix with C stdio.
+    std::ios::sync_with_stdio(false);
+
     auto result = core::trust::Preseed::main(core::trust::Preseed::Configuration::parse_from_command_line(argc, argv));
 
     return result == core::posix::exit::Status::success ? EXIT_SUCCESS : EXIT_FAILURE;
@@ -50,3 +50,9 @@ core::trust::Request::Answer core::trust::PrivilegeEscalationPreventionAgent::au
     if (uid_functor() != parameters.application.uid) throw Error{};
     return impl->authenticate_request_with_parameters(parameters);
 }
+
+core::trust::Agent::BatchAnswer core::trust::PrivilegeEscalationPreventionAgent::authenticate_batch_request_with_parameters(const core::trust::Agent::BatchRequestParameters& parameters)
+{
+    if (uid_functor() != parameters.application.uid) throw Error{};
+    return impl->authenticate_batch_request_with_parameters(parameters);
+}
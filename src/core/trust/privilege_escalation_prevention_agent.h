@@ -53,6 +53,7 @@ public:
 
     // From core::trust::Agent
     Request::Answer authenticate_request_with_parameters(const RequestParameters& parameters) override;
+    BatchAnswer authenticate_batch_request_with_parameters(const BatchRequestParameters& parameters) override;
 
 private:
     UserIdFunctor uid_functor;
@@ -0,0 +1,192 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <core/trust/publishing_store.h>
+
+#include <map>
+#include <set>
+#include <stdexcept>
+
+namespace
+{
+// Executes query and returns one of its results for every distinct pair of
+// application id and feature, i.e., the keys affected by erasing all results.
+std::vector<core::trust::Request> distinct_keys(const std::shared_ptr<core::trust::Store::Query>& query)
+{
+    std::map<std::pair<std::string, core::trust::Feature::IntegerType>, core::trust::Request> keys;
+
+    query->execute();
+    while (query->status() == core::trust::Store::Query::Status::has_more_results)
+    {
+        auto request = query->current();
+        keys.insert(std::make_pair(std::make_pair(request.from, request.feature.value), request));
+        query->next();
+    }
+
+    std::vector<core::trust::Request> result;
+    for (const auto& pair : keys)
+        result.push_back(pair.second);
+    return result;
+}
+
+// Publishes the most recent answer recorded for app_id and feature. The request
+// just added is not necessarily the most recent one, given its timestamp.
+void republish(
+        const std::shared_ptr<core::trust::Store>& impl,
+        const core::trust::remote::posix::DecisionTable::Ptr& table,
+        const core::trust::PublishingStore::IsAuthoritative& is_authoritative,
+        const std::string& app_id,
+        core::trust::Feature feature)
+{
+    if (not is_authoritative(app_id, feature))
+        return;
+
+    auto query = impl->query();
+    query->for_application_id(app_id);
+    query->for_feature(feature);
+    query->limit(1);
+    query->execute();
+
+    if (query->status() == core::trust::Store::Query::Status::has_more_results)
+        table->publish(app_id, feature, query->current().answer);
+    else
+        table->withdraw(app_id, feature);
+}
+
+// Decorates queries, republishing decisions whenever results are erased.
+class Query : public core::trust::ForwardingStore::Query
+{
+public:
+    Query(const std::shared_ptr<core::trust::Store::Query>& impl, const std::function<void(const core::trust::Request&)>& republish)
+        : core::trust::ForwardingStore::Query{impl}, republish{republish}
+    {
+    }
+
+    void erase() override { auto erased = impl->current(); impl->erase(); republish(erased); }
+    void erase_all() override
+    {
+        auto erased = distinct_keys(impl);
+        impl->erase_all();
+        for (const auto& request : erased)
+            republish(request);
+    }
+
+private:
+    std::function<void(const core::trust::Request&)> republish;
+};
+}
+
+core::trust::PublishingStore::PublishingStore(const std::shared_ptr<core::trust::Store>& impl,
+                                              const core::trust::remote::posix::DecisionTable::Ptr& table,
+                                              const core::trust::PublishingStore::IsAuthoritative& is_authoritative)
+    : core::trust::ForwardingStore{impl},
+      table{table},
+      is_authoritative{is_authoritative}
+{
+    if (not table) throw std::runtime_error
+    {
+        "Missing decision table for publishing decisions."
+    };
+
+    if (not is_authoritative) throw std::runtime_error
+    {
+        "Missing functor for telling authoritative answers."
+    };
+}
+
+void core::trust::PublishingStore::reset()
+{
+    impl->reset();
+    table->clear();
+}
+
+void core::trust::PublishingStore::add(const core::trust::Request& request)
+{
+    impl->add(request);
+    republish(impl, table, is_authoritative, request.from, request.feature);
+}
+
+void core::trust::PublishingStore::add_all(const std::vector<core::trust::Request>& requests)
+{
+    impl->add_all(requests);
+    for (const auto& request : requests)
+        republish(impl, table, is_authoritative, request.from, request.feature);
+}
+
+std::size_t core::trust::PublishingStore::load(const core::trust::Store::RequestSource& source, bool defer_indices)
+{
+    // Loads might be large, and we only remember the distinct keys affected.
+    std::set<std::pair<std::string, core::trust::Feature::IntegerType>> keys;
+
+    auto result = impl->load([&source, &keys](core::trust::Request& request)
+    {
+        if (not source(request))
+            return false;
+
+        keys.insert(std::make_pair(request.from, request.feature.value));
+        return true;
+    }, defer_indices);
+
+    for (const auto& key : keys)
+        republish(impl, table, is_authoritative, key.first, core::trust::Feature{key.second});
+
+    return result;
+}
+
+void core::trust::PublishingStore::remove_application(const std::string& id)
+{
+    impl->remove_application(id);
+    table->withdraw_application(id);
+}
+
+void core::trust::PublishingStore::remove_feature(core::trust::Feature feature)
+{
+    auto query = impl->query();
+    query->for_feature(feature);
+
+    auto removed = distinct_keys(query);
+    impl->remove_feature(feature);
+    for (const auto& request : removed)
+        republish(impl, table, is_authoritative, request.from, request.feature);
+}
+
+void core::trust::PublishingStore::remove_older_than(const core::trust::Request::Timestamp& timestamp)
+{
+    // Nothing precedes the earliest point in time.
+    if (timestamp == core::trust::Request::Timestamp::min())
+        return;
+
+    auto query = impl->query();
+    query->for_interval(core::trust::Request::Timestamp::min(), timestamp - core::trust::Request::Duration{1});
+
+    auto removed = distinct_keys(query);
+    impl->remove_older_than(timestamp);
+    for (const auto& request : removed)
+        republish(impl, table, is_authoritative, request.from, request.feature);
+}
+
+std::shared_ptr<core::trust::Store::Query> core::trust::PublishingStore::query()
+{
+    auto impl = this->impl;
+    auto table = this->table;
+    auto is_authoritative = this->is_authoritative;
+
+    return std::make_shared<::Query>(impl->query(), [impl, table, is_authoritative](const core::trust::Request& erased)
+    {
+        republish(impl, table, is_authoritative, erased.from, erased.feature);
+    });
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef CORE_TRUST_PUBLISHING_STORE_H_
+#define CORE_TRUST_PUBLISHING_STORE_H_
+
+#include <core/trust/forwarding_store.h>
+
+#include <core/trust/remote/decision_table.h>
+
+#include <functional>
+#include <memory>
+
+namespace core
+{
+namespace trust
+{
+// Forwards to an actual store implementation, keeping the decisions published to
+// trusted helpers in sync with the most recent answers recorded in the store.
+class CORE_TRUST_DLL_PUBLIC PublishingStore : public core::trust::ForwardingStore
+{
+public:
+    // Returns true if the answer recorded for the given application id and feature
+    // is authoritative, i.e., not overridden by agents consulted before the store.
+    typedef std::function<bool(const std::string&, Feature)> IsAuthoritative;
+
+    PublishingStore(const std::shared_ptr<Store>& impl,
+                    const remote::posix::DecisionTable::Ptr& table,
+                    const IsAuthoritative& is_authoritative);
+
+    // From core::trust::Store
+    void reset() override;
+    void add(const Request& request) override;
+    void add_all(const std::vector<Request>& requests) override;
+    std::size_t load(const RequestSource& source, bool defer_indices) override;
+    void remove_application(const std::string& id) override;
+    void remove_feature(Feature feature) override;
+    void remove_older_than(const Request::Timestamp& timestamp) override;
+    std::shared_ptr<core::trust::Store::Query> query() override;
+
+private:
+    remote::posix::DecisionTable::Ptr table;
+    IsAuthoritative is_authoritative;
+};
+}
+}
+
+#endif // CORE_TRUST_PUBLISHING_STORE_H_
@@ -26,6 +26,30 @@ core::trust::Request::Answer remote::Agent::Stub::authenticate_request_with_para
     return send(parameters);
 }
 
+core::trust::Agent::BatchAnswer remote::Agent::Stub::authenticate_batch_request_with_parameters(const core::trust::Agent::BatchRequestParameters& parameters)
+{
+    return send_batch(parameters);
+}
+
+core::trust::Agent::BatchAnswer remote::Agent::Stub::send_batch(const core::trust::Agent::BatchRequestParameters& parameters)
+{
+    core::trust::Agent::BatchAnswer answers;
+
+    for (const auto& feature : parameters.features)
+    {
+        answers[feature] = send(core::trust::Agent::RequestParameters
+        {
+            parameters.application.uid,
+            parameters.application.pid,
+            parameters.application.id,
+            feature,
+            parameters.description
+        });
+    }
+
+    return answers;
+}
+
 remote::Agent::Skeleton::Skeleton(const std::shared_ptr<core::trust::Agent>& impl) : impl{impl}
 {
 }
@@ -34,3 +58,12 @@ core::trust::Request::Answer remote::Agent::Skeleton::authenticate_request_with_
 {
     return impl->authenticate_request_with_parameters(parameters);
 }
+
+core::trust::Agent::BatchAnswer remote::Agent::Skeleton::authenticate_batch_request_with_parameters(const core::trust::Agent::BatchRequestParameters& parameters)
+{
+    return impl->authenticate_batch_request_with_parameters(parameters);
+}
+
+void remote::Agent::Skeleton::revoke(const remote::Revocation&)
+{
+}
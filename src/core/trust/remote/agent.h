@@ -32,6 +32,17 @@ namespace trust
 {
 namespace remote
 {
+// Describes decisions that stubs must no longer answer from their caches.
+struct Revocation
+{
+    // Decisions for applications running under this user id are affected.
+    core::trust::Uid uid;
+    // If true, all decisions for uid are revoked, otherwise only the ones for feature.
+    bool all_features;
+    // The feature that decisions are revoked for.
+    core::trust::Feature feature;
+};
+
 // Abstracts listeners for incoming requests, possible implementations:
 //   * Listening to a socket
 //   * DBus
@@ -50,6 +61,14 @@ struct Agent
         // or throwing an exception if no conclusive answer could be obtained from
         // the user.
         virtual core::trust::Request::Answer send(const RequestParameters& parameters) = 0;
+
+        // From core::trust::Agent
+        virtual BatchAnswer authenticate_batch_request_with_parameters(const BatchRequestParameters& parameters);
+
+        // Sends out the batch request to the receiving end, either returning the answers
+        // or throwing an exception if no conclusive answer could be obtained from the user.
+        // The default implementation sends out one request per feature.
+        virtual BatchAnswer send_batch(const BatchRequestParameters& parameters);
     };
 
     // Models the receiving end of a remote agent, meant to be used by the trust store daemon.
@@ -63,6 +82,13 @@ struct Agent
         // From core::trust::Agent, dispatches to the actual implementation.
         virtual core::trust::Request::Answer authenticate_request_with_parameters(const RequestParameters& parameters);
 
+        // From core::trust::Agent, dispatches to the actual implementation.
+        virtual BatchAnswer authenticate_batch_request_with_parameters(const BatchRequestParameters& parameters);
+
+        // Tells the sending end to drop cached decisions covered by revocation.
+        // The default implementation does nothing, for stubs that do not cache.
+        virtual void revoke(const Revocation& revocation);
+
         // The actual agent implementation that we are dispatching to.
         std::shared_ptr<core::trust::Agent> impl;
     };
@@ -22,13 +22,20 @@
 #include <core/trust/runtime.h>
 
 core::trust::remote::dbus::Agent::Stub::Stub(const core::trust::remote::dbus::Agent::Stub::Configuration& configuration)
-    : agent_registry_skeleton
+    : start_time_resolver{configuration.start_time_resolver},
+      decision_cache{configuration.decision_cache},
+      agent_registry_skeleton
       {
           core::trust::dbus::AgentRegistry::Skeleton::Configuration
           {
               configuration.object,
               configuration.bus,
-              agent_registry
+              agent_registry,
+              [this](const core::trust::Uid& uid, bool all_features, const core::trust::Feature& feature)
+              {
+                  if (decision_cache)
+                      decision_cache->revoke(core::trust::remote::Revocation{uid, all_features, feature});
+              }
           }
       }
 {
@@ -36,12 +43,52 @@ core::trust::remote::dbus::Agent::Stub::Stub(const core::trust::remote::dbus::Ag
 
 core::trust::Request::Answer core::trust::remote::dbus::Agent::Stub::send(const core::trust::Agent::RequestParameters& parameters)
 {
-    if (not agent_registry.has_agent_for_user(parameters.application.uid))
+    auto agent = agent_registry.try_resolve_agent_for_user(parameters.application.uid);
+
+    if (not agent)
         return core::trust::Request::Answer::denied;
 
-    auto agent = agent_registry.agent_for_user(parameters.application.uid);
+    if (not decision_cache)
+        return (*agent)->authenticate_request_with_parameters(parameters);
+
+    core::trust::remote::DecisionCache::Key key
+    {
+        parameters.application.uid,
+        parameters.application.pid,
+        start_time_resolver(parameters.application.pid),
+        parameters.feature
+    };
+
+    core::trust::Request::Answer answer;
+
+    if (decision_cache->lookup(key, answer))
+        return answer;
+
+    // Revocations arriving while the request is in flight might render the answer stale.
+    auto generation = decision_cache->generation();
+
+    answer = (*agent)->authenticate_request_with_parameters(parameters);
+
+    // We only remember the answer if the pid still refers to the very same process.
+    if (start_time_resolver(parameters.application.pid) == key.start_time)
+        decision_cache->remember(key, answer, generation);
 
-    return agent->authenticate_request_with_parameters(parameters);
+    return answer;
+}
+
+core::trust::Agent::BatchAnswer core::trust::remote::dbus::Agent::Stub::send_batch(const core::trust::Agent::BatchRequestParameters& parameters)
+{
+    auto agent = agent_registry.try_resolve_agent_for_user(parameters.application.uid);
+
+    if (not agent)
+    {
+        core::trust::Agent::BatchAnswer answers;
+        for (const auto& feature : parameters.features)
+            answers[feature] = core::trust::Request::Answer::denied;
+        return answers;
+    }
+
+    return (*agent)->authenticate_batch_request_with_parameters(parameters);
 }
 
 core::trust::remote::dbus::Agent::Skeleton::Skeleton(core::trust::remote::dbus::Agent::Skeleton::Configuration configuration)
@@ -79,6 +126,12 @@ core::trust::Request::Answer core::trust::remote::dbus::Agent::Skeleton::authent
     return remote::Agent::Skeleton::authenticate_request_with_parameters(parameters);
 }
 
+void core::trust::remote::dbus::Agent::Skeleton::revoke(const core::trust::remote::Revocation& revocation)
+{
+    // Stubs only ever learn about decisions for the user we registered our agent for.
+    agent_registry_stub.revoke_decisions_for_user_async(core::trust::Uid{::getuid()}, revocation.all_features, revocation.feature);
+}
+
 std::shared_ptr<core::trust::Agent> core::trust::dbus::create_multi_user_agent_for_bus_connection(
         const std::shared_ptr<core::dbus::Bus>& connection,
         const std::string& service_name)
@@ -94,7 +147,10 @@ std::shared_ptr<core::trust::Agent> core::trust::dbus::create_multi_user_agent_f
     core::trust::remote::dbus::Agent::Stub::Configuration config
     {
         object,
-        connection
+        connection,
+        core::trust::remote::helpers::proc_stat_start_time_resolver(),
+        // Decisions are not cached.
+        {}
     };
 
     return std::shared_ptr<core::trust::remote::dbus::Agent::Stub>
@@ -20,6 +20,7 @@
 #define CORE_TRUST_REMOTE_DBUS_H_
 
 #include <core/trust/remote/agent.h>
+#include <core/trust/remote/decision_cache.h>
 #include <core/trust/remote/helpers.h>
 
 #include <core/trust/dbus/agent.h>
@@ -64,6 +65,12 @@ struct CORE_TRUST_DLL_PUBLIC Agent
             core::dbus::Object::Ptr object;
             // Bus-connection for sending out replies.
             core::dbus::Bus::Ptr bus;
+            // Helper for resolving a pid to the process's start time, required if
+            // decision_cache is set.
+            helpers::ProcessStartTimeResolver start_time_resolver;
+            // If set, answers are cached and repeated requests of a process are answered
+            // locally until the answer expires or a skeleton revokes it.
+            DecisionCache::Ptr decision_cache;
         };
 
         // Sets up the stub.
@@ -72,6 +79,13 @@ struct CORE_TRUST_DLL_PUBLIC Agent
         // Delivers the request described by the given parameters to the other side.
         core::trust::Request::Answer send(const RequestParameters& parameters) override;
 
+        // Delivers the batch request described by the given parameters to the other side.
+        BatchAnswer send_batch(const BatchRequestParameters& parameters) override;
+
+        // Helper for resolving a pid to the process's start time.
+        helpers::ProcessStartTimeResolver start_time_resolver;
+        // Caches answers if set.
+        DecisionCache::Ptr decision_cache;
         // Our actual agent registry implementation.
         core::trust::LockingAgentRegistry agent_registry;
         // That we expose over the bus.
@@ -104,6 +118,10 @@ struct CORE_TRUST_DLL_PUBLIC Agent
         // From core::trust::Agent, dispatches to the actual implementation.
         core::trust::Request::Answer authenticate_request_with_parameters(const RequestParameters& parameters);
 
+        // From core::trust::remote::Agent::Skeleton, hands the revocation
+        // over to the remote agent registry.
+        void revoke(const Revocation& revocation) override;
+
         // Store all creation-time parameters.
         Configuration config;
         // Stub for accessing the remote agent registry.
@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/remote/decision_cache.h>
+
+#include <algorithm>
+
+namespace remote = core::trust::remote;
+
+remote::DecisionCache::DecisionCache(const Configuration& configuration)
+    : configuration(configuration)
+{
+}
+
+bool remote::DecisionCache::lookup(const Key& key, core::trust::Request::Answer& answer)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = entries.find(Index{key.uid, key.pid, key.start_time, key.feature});
+
+    if (it == entries.end())
+        return false;
+
+    if (it->second.expires_at <= std::chrono::steady_clock::now())
+    {
+        entries.erase(it);
+        return false;
+    }
+
+    answer = it->second.answer;
+    return true;
+}
+
+std::uint64_t remote::DecisionCache::generation() const
+{
+    std::lock_guard<std::mutex> lg(guard);
+    return revocations;
+}
+
+void remote::DecisionCache::remember(const Key& key, core::trust::Request::Answer answer, std::uint64_t generation)
+{
+    if (configuration.capacity == 0 || configuration.ttl.count() <= 0)
+        return;
+
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (generation != revocations)
+        return;
+
+    Index index{key.uid, key.pid, key.start_time, key.feature};
+
+    if (entries.count(index) == 0 && entries.size() >= configuration.capacity)
+    {
+        // All entries share the same ttl, and the one expiring first is the oldest one.
+        auto oldest = std::min_element(
+                    entries.begin(),
+                    entries.end(),
+                    [](const std::pair<const Index, Entry>& lhs, const std::pair<const Index, Entry>& rhs)
+                    {
+                        return lhs.second.expires_at < rhs.second.expires_at;
+                    });
+
+        entries.erase(oldest);
+    }
+
+    entries[index] = Entry{answer, now + configuration.ttl};
+}
+
+void remote::DecisionCache::revoke(const Revocation& revocation)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    ++revocations;
+
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (std::get<0>(it->first) == revocation.uid &&
+                (revocation.all_features || std::get<3>(it->first) == revocation.feature))
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+}
+
+std::size_t remote::DecisionCache::size() const
+{
+    std::lock_guard<std::mutex> lg(guard);
+    return entries.size();
+}
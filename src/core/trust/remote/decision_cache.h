@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_REMOTE_DECISION_CACHE_H_
+#define CORE_TRUST_REMOTE_DECISION_CACHE_H_
+
+#include <core/trust/remote/agent.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace core
+{
+namespace trust
+{
+namespace remote
+{
+// A DecisionCache remembers answers obtained by remote stubs for a short period of
+// time, sparing repeated checks of the same process the round trip to the skeleton.
+// Entries are keyed by the process start time, too, and never outlive the process
+// they have been obtained for. Skeletons explicitly revoke entries whenever decisions
+// change on their side. All functions are thread-safe.
+class CORE_TRUST_DLL_PUBLIC DecisionCache
+{
+public:
+    // Just for convenience
+    typedef std::shared_ptr<DecisionCache> Ptr;
+
+    // Identifies a decision for a specific process and feature.
+    struct Key
+    {
+        // The user id that the requesting process is running under.
+        core::trust::Uid uid;
+        // The process id of the requesting process.
+        core::trust::Pid pid;
+        // The start time of the requesting process.
+        std::int64_t start_time;
+        // The feature that the decision applies to.
+        core::trust::Feature feature;
+    };
+
+    // All creation time arguments go here.
+    struct Configuration
+    {
+        // Entries expire after this period of time.
+        std::chrono::milliseconds ttl;
+        // The maximum number of entries, the ones expiring first are evicted.
+        std::size_t capacity;
+    };
+
+    // Sets up an empty cache.
+    DecisionCache(const Configuration& configuration);
+
+    // Returns true and the cached answer for key in answer, iff an entry is known
+    // and has not expired yet. Expired entries are dropped.
+    bool lookup(const Key& key, core::trust::Request::Answer& answer);
+
+    // Returns the current generation, to be handed to remember.
+    std::uint64_t generation() const;
+
+    // Remembers answer for key, unless a revocation happened since generation
+    // has been queried. Answers obtained before a revocation might be stale.
+    void remember(const Key& key, core::trust::Request::Answer answer, std::uint64_t generation);
+
+    // Drops all entries covered by revocation, bumping the generation.
+    void revoke(const Revocation& revocation);
+
+    // Returns the number of entries currently held by the cache.
+    std::size_t size() const;
+
+private:
+    // An Entry describes a cached answer.
+    struct Entry
+    {
+        // The cached answer.
+        core::trust::Request::Answer answer;
+        // The point in time when the entry expires.
+        std::chrono::steady_clock::time_point expires_at;
+    };
+
+    typedef std::tuple<core::trust::Uid, core::trust::Pid, std::int64_t, core::trust::Feature> Index;
+
+    Configuration configuration;
+
+    mutable std::mutex guard;
+    std::uint64_t revocations{0};
+    std::map<Index, Entry> entries;
+};
+}
+}
+}
+
+#endif // CORE_TRUST_REMOTE_DECISION_CACHE_H_
@@ -0,0 +1,566 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/remote/decision_table.h>
+
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MFD_CLOEXEC
+#include <linux/memfd.h>
+#endif
+
+namespace remote = core::trust::remote;
+
+// We only rely on 32-bit atomics, 64-bit atomic loads might require write access on some architectures.
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "Decision tables require lock-free atomics.");
+
+struct remote::posix::DecisionTable::Header
+{
+    // Marks the memory as a trust-store decision table.
+    static constexpr const std::uint32_t expected_magic{0x74646563};
+
+    std::uint32_t magic;
+    std::uint32_t slot_count;
+    // The key of the hash function, shared with readers but not with applications.
+    std::uint64_t key[2];
+    // Odd while the owner is modifying the table.
+    alignas(64) std::atomic<std::uint32_t> sequence;
+    // Set to 1 once the owner stopped maintaining the table.
+    std::atomic<std::uint32_t> retired;
+    // The number of published answers.
+    std::atomic<std::uint32_t> published;
+    // The number of slots that are not empty, i.e., published or withdrawn ones.
+    std::atomic<std::uint32_t> used;
+};
+
+struct remote::posix::DecisionTable::Slot
+{
+    enum State : std::uint32_t
+    {
+        empty = 0,
+        published = 1,
+        withdrawn = 2
+    };
+
+    std::atomic<std::uint32_t> hash_low;
+    std::atomic<std::uint32_t> hash_high;
+    std::atomic<std::uint32_t> feature_low;
+    std::atomic<std::uint32_t> feature_high;
+    std::atomic<std::uint32_t> state;
+    std::atomic<std::uint32_t> answer;
+};
+
+namespace
+{
+// Readers give up after retrying this many times while the owner modifies the table.
+constexpr const unsigned int max_read_attempts{64};
+
+std::system_error last_system_error()
+{
+    return std::system_error{errno, std::system_category()};
+}
+
+std::uint32_t round_up_to_power_of_two(std::uint32_t value)
+{
+    std::uint32_t result{1};
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+
+// We keep at least a quarter of all slots empty, bounding the length of probe sequences.
+std::uint32_t max_used_slots(std::uint32_t slot_count)
+{
+    return slot_count - slot_count / 4;
+}
+
+std::uint64_t rotl(std::uint64_t x, int b)
+{
+    return (x << b) | (x >> (64 - b));
+}
+
+// SipHash-2-4, keeping applications from crafting colliding ids without knowing the key.
+std::uint64_t siphash(const std::uint64_t key[2], const char* data, std::size_t size)
+{
+    std::uint64_t v0 = 0x736f6d6570736575ULL ^ key[0];
+    std::uint64_t v1 = 0x646f72616e646f6dULL ^ key[1];
+    std::uint64_t v2 = 0x6c7967656e657261ULL ^ key[0];
+    std::uint64_t v3 = 0x7465646279746573ULL ^ key[1];
+
+    auto round = [&v0, &v1, &v2, &v3]()
+    {
+        v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+        v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+    };
+
+    auto load = [data](std::size_t offset, std::size_t count)
+    {
+        std::uint64_t value{0};
+        for (std::size_t i = 0; i < count; i++)
+            value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(data[offset + i])) << (8 * i);
+        return value;
+    };
+
+    std::size_t offset{0};
+    for (; offset + 8 <= size; offset += 8)
+    {
+        auto m = load(offset, 8);
+        v3 ^= m; round(); round(); v0 ^= m;
+    }
+
+    auto b = (static_cast<std::uint64_t>(size) << 56) | load(offset, size - offset);
+    v3 ^= b; round(); round(); v0 ^= b;
+
+    v2 ^= 0xff; round(); round(); round(); round();
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+// Marks the table as being modified for the lifetime of an instance.
+class WriteSection
+{
+public:
+    WriteSection(std::atomic<std::uint32_t>& sequence) : sequence(sequence)
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    ~WriteSection()
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    std::atomic<std::uint32_t>& sequence;
+};
+}
+
+remote::posix::DecisionTable::Ptr remote::posix::DecisionTable::create(std::uint32_t slot_count)
+{
+    if (slot_count == 0 || slot_count > max_slot_count) throw std::runtime_error
+    {
+        "Invalid geometry for decision table."
+    };
+
+    slot_count = round_up_to_power_of_two(slot_count);
+    auto size = sizeof(Header) + std::size_t{slot_count} * sizeof(Slot);
+
+    int memfd = ::syscall(SYS_memfd_create, "trust-store-decisions", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd == -1)
+        throw last_system_error();
+
+    // Fresh memory is zeroed, with all slots being empty.
+    if (::ftruncate(memfd, size) == -1)
+    {
+        auto error = last_system_error();
+        ::close(memfd);
+        throw error;
+    }
+
+    auto base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    if (base == MAP_FAILED)
+    {
+        auto error = last_system_error();
+        ::close(memfd);
+        throw error;
+    }
+
+    // Sealing the size prevents readers from truncating the memory under our feet. Where
+    // supported, we prevent anybody but us from writing to the table, too. Our own mapping
+    // stays writable.
+    int seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+    int rc{-1};
+#ifdef F_SEAL_FUTURE_WRITE
+    rc = ::fcntl(memfd, F_ADD_SEALS, seals | F_SEAL_FUTURE_WRITE);
+#endif
+    // Older kernels do not know about F_SEAL_FUTURE_WRITE.
+    if (rc == -1)
+        rc = ::fcntl(memfd, F_ADD_SEALS, seals);
+
+    if (rc == -1)
+    {
+        auto error = last_system_error();
+        ::munmap(base, size); ::close(memfd);
+        throw error;
+    }
+
+    std::random_device rd;
+    std::uint64_t key[2]
+    {
+        (static_cast<std::uint64_t>(rd()) << 32) | rd(),
+        (static_cast<std::uint64_t>(rd()) << 32) | rd()
+    };
+
+    auto header = new (base) Header;
+    header->magic = Header::expected_magic;
+    header->slot_count = slot_count;
+    header->key[0] = key[0];
+    header->key[1] = key[1];
+    header->sequence = 0;
+    header->retired = 0;
+    header->published = 0;
+    header->used = 0;
+
+    return Ptr{new DecisionTable{memfd, base, size, slot_count, key, true}};
+}
+
+remote::posix::DecisionTable::Ptr remote::posix::DecisionTable::attach(int memfd)
+{
+    auto fail = [memfd](const std::string& what) -> std::runtime_error
+    {
+        ::close(memfd);
+        return std::runtime_error{"Cannot attach to decision table: " + what};
+    };
+
+    // We only ever map memory that cannot shrink anymore.
+    auto seals = ::fcntl(memfd, F_GET_SEALS);
+    if (seals == -1 || (seals & F_SEAL_SHRINK) == 0)
+        throw fail("memory is not sealed against shrinking");
+
+    struct stat st;
+    if (::fstat(memfd, &st) == -1 || st.st_size < static_cast<off_t>(sizeof(Header)))
+        throw fail("memory too small");
+
+    std::size_t size = st.st_size;
+
+    auto base = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, memfd, 0);
+    if (base == MAP_FAILED)
+        throw fail(std::strerror(errno));
+
+    auto header = static_cast<Header*>(base);
+    auto slot_count = header->slot_count;
+
+    bool valid = header->magic == Header::expected_magic
+            && slot_count > 0 && slot_count <= max_slot_count
+            && (slot_count & (slot_count - 1)) == 0
+            && size >= sizeof(Header) + std::size_t{slot_count} * sizeof(Slot);
+
+    if (not valid)
+    {
+        ::munmap(base, size);
+        throw fail("invalid header");
+    }
+
+    return Ptr{new DecisionTable{memfd, base, size, slot_count, header->key, false}};
+}
+
+remote::posix::DecisionTable::DecisionTable(int memfd, void* base, std::size_t size, std::uint32_t slot_count, const std::uint64_t key[2], bool owned)
+    : memfd_{memfd},
+      base{base},
+      size_{size},
+      slot_count_{slot_count},
+      key{key[0], key[1]},
+      owned{owned},
+      header{static_cast<Header*>(base)}
+{
+}
+
+remote::posix::DecisionTable::~DecisionTable()
+{
+    ::munmap(base, size_);
+    ::close(memfd_);
+}
+
+void remote::posix::DecisionTable::publish(const std::string& app_id, core::trust::Feature feature, core::trust::Request::Answer answer)
+{
+    throw_if_not_owned();
+
+    auto h = hash(app_id.data(), app_id.size());
+
+    std::lock_guard<std::mutex> lg(guard);
+    WriteSection ws{header->sequence};
+
+    auto index = find(h, feature);
+    if (index != slot_count_)
+    {
+        slot(index).answer.store(static_cast<std::uint32_t>(answer), std::memory_order_relaxed);
+        return;
+    }
+
+    auto published = header->published.load(std::memory_order_relaxed);
+    auto used = header->used.load(std::memory_order_relaxed);
+
+    if (used + 1 > max_used_slots(slot_count_))
+    {
+        // We are out of room, readers keep on asking for this decision.
+        if (published + 1 > max_used_slots(slot_count_))
+            return;
+
+        rehash();
+    }
+
+    for (std::uint32_t i = 0; i < slot_count_; i++)
+    {
+        auto& s = slot(h + i);
+        auto state = s.state.load(std::memory_order_relaxed);
+
+        if (state == Slot::published)
+            continue;
+
+        s.hash_low.store(static_cast<std::uint32_t>(h), std::memory_order_relaxed);
+        s.hash_high.store(static_cast<std::uint32_t>(h >> 32), std::memory_order_relaxed);
+        s.feature_low.store(static_cast<std::uint32_t>(feature.value), std::memory_order_relaxed);
+        s.feature_high.store(static_cast<std::uint32_t>(feature.value >> 32), std::memory_order_relaxed);
+        s.answer.store(static_cast<std::uint32_t>(answer), std::memory_order_relaxed);
+        s.state.store(Slot::published, std::memory_order_relaxed);
+
+        header->published.store(header->published.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (state == Slot::empty)
+            header->used.store(header->used.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        return;
+    }
+}
+
+void remote::posix::DecisionTable::withdraw(const std::string& app_id, core::trust::Feature feature)
+{
+    throw_if_not_owned();
+
+    auto h = hash(app_id.data(), app_id.size());
+
+    std::lock_guard<std::mutex> lg(guard);
+    WriteSection ws{header->sequence};
+
+    auto index = find(h, feature);
+    if (index == slot_count_)
+        return;
+
+    slot(index).state.store(Slot::withdrawn, std::memory_order_relaxed);
+    header->published.store(header->published.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+}
+
+void remote::posix::DecisionTable::withdraw_application(const std::string& app_id)
+{
+    throw_if_not_owned();
+
+    auto h = hash(app_id.data(), app_id.size());
+
+    std::lock_guard<std::mutex> lg(guard);
+    WriteSection ws{header->sequence};
+
+    for (std::uint32_t i = 0; i < slot_count_; i++)
+    {
+        auto& s = slot(i);
+
+        if (s.state.load(std::memory_order_relaxed) != Slot::published)
+            continue;
+
+        if (s.hash_low.load(std::memory_order_relaxed) != static_cast<std::uint32_t>(h) ||
+            s.hash_high.load(std::memory_order_relaxed) != static_cast<std::uint32_t>(h >> 32))
+            continue;
+
+        s.state.store(Slot::withdrawn, std::memory_order_relaxed);
+        header->published.store(header->published.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+}
+
+void remote::posix::DecisionTable::clear()
+{
+    throw_if_not_owned();
+
+    std::lock_guard<std::mutex> lg(guard);
+    WriteSection ws{header->sequence};
+
+    for (std::uint32_t i = 0; i < slot_count_; i++)
+        slot(i).state.store(Slot::empty, std::memory_order_relaxed);
+
+    header->published.store(0, std::memory_order_relaxed);
+    header->used.store(0, std::memory_order_relaxed);
+}
+
+void remote::posix::DecisionTable::retire()
+{
+    clear();
+
+    std::lock_guard<std::mutex> lg(guard);
+    WriteSection ws{header->sequence};
+
+    header->retired.store(1, std::memory_order_relaxed);
+}
+
+bool remote::posix::DecisionTable::lookup(const char* app_id, std::size_t size, core::trust::Feature feature, core::trust::Request::Answer& answer) const
+{
+    auto h = hash(app_id, size);
+
+    for (unsigned int attempt = 0; attempt < max_read_attempts; attempt++)
+    {
+        auto before = header->sequence.load(std::memory_order_acquire);
+
+        // The owner is modifying the table right now.
+        if (before & 1)
+            continue;
+
+        bool found{false};
+        std::uint32_t value{0};
+
+        for (std::uint32_t i = 0; i < slot_count_ && not header->retired.load(std::memory_order_relaxed); i++)
+        {
+            auto& s = slot(h + i);
+            auto state = s.state.load(std::memory_order_relaxed);
+
+            if (state == Slot::empty)
+                break;
+
+            if (state == Slot::published &&
+                s.hash_low.load(std::memory_order_relaxed) == static_cast<std::uint32_t>(h) &&
+                s.hash_high.load(std::memory_order_relaxed) == static_cast<std::uint32_t>(h >> 32) &&
+                s.feature_low.load(std::memory_order_relaxed) == static_cast<std::uint32_t>(feature.value) &&
+                s.feature_high.load(std::memory_order_relaxed) == static_cast<std::uint32_t>(feature.value >> 32))
+            {
+                found = true;
+                value = s.answer.load(std::memory_order_relaxed);
+                break;
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Whatever we read is only valid if the owner has not touched the table in the meantime.
+        if (header->sequence.load(std::memory_order_relaxed) != before)
+            continue;
+
+        if (not found || value > static_cast<std::uint32_t>(core::trust::Request::Answer::granted))
+            return false;
+
+        answer = static_cast<core::trust::Request::Answer>(value);
+        return true;
+    }
+
+    return false;
+}
+
+bool remote::posix::DecisionTable::lookup(const std::string& app_id, core::trust::Feature feature, core::trust::Request::Answer& answer) const
+{
+    return lookup(app_id.data(), app_id.size(), feature, answer);
+}
+
+int remote::posix::DecisionTable::memfd() const
+{
+    return memfd_;
+}
+
+std::uint32_t remote::posix::DecisionTable::slot_count() const
+{
+    return slot_count_;
+}
+
+std::uint32_t remote::posix::DecisionTable::size() const
+{
+    return header->published.load(std::memory_order_relaxed);
+}
+
+std::uint64_t remote::posix::DecisionTable::hash(const char* app_id, std::size_t size) const
+{
+    return siphash(key, app_id, size);
+}
+
+remote::posix::DecisionTable::Slot& remote::posix::DecisionTable::slot(std::uint32_t index) const
+{
+    return reinterpret_cast<Slot*>(static_cast<unsigned char*>(base) + sizeof(Header))[index & (slot_count_ - 1)];
+}
+
+std::uint32_t remote::posix::DecisionTable::find(std::uint64_t hash, core::trust::Feature feature) const
+{
+    for (std::uint32_t i = 0; i < slot_count_; i++)
+    {
+        auto& s = slot(hash + i);
+        auto state = s.state.load(std::memory_order_relaxed);
+
+        if (state == Slot::empty)
+            break;
+
+        if (state == Slot::published &&
+            s.hash_low.load(std::memory_order_relaxed) == static_cast<std::uint32_t>(hash) &&
+            s.hash_high.load(std::memory_order_relaxed) == static_cast<std::uint32_t>(hash >> 32) &&
+            s.feature_low.load(std::memory_order_relaxed) == static_cast<std::uint32_t>(feature.value) &&
+            s.feature_high.load(std::memory_order_relaxed) == static_cast<std::uint32_t>(feature.value >> 32))
+            return (hash + i) & (slot_count_ - 1);
+    }
+
+    return slot_count_;
+}
+
+void remote::posix::DecisionTable::rehash()
+{
+    struct Decision
+    {
+        std::uint32_t hash_low, hash_high, feature_low, feature_high, answer;
+    };
+
+    std::vector<Decision> decisions;
+    for (std::uint32_t i = 0; i < slot_count_; i++)
+    {
+        auto& s = slot(i);
+
+        if (s.state.load(std::memory_order_relaxed) == Slot::published)
+            decisions.push_back(Decision
+            {
+                s.hash_low.load(std::memory_order_relaxed),
+                s.hash_high.load(std::memory_order_relaxed),
+                s.feature_low.load(std::memory_order_relaxed),
+                s.feature_high.load(std::memory_order_relaxed),
+                s.answer.load(std::memory_order_relaxed)
+            });
+
+        s.state.store(Slot::empty, std::memory_order_relaxed);
+    }
+
+    for (const auto& d : decisions)
+    {
+        auto h = (static_cast<std::uint64_t>(d.hash_high) << 32) | d.hash_low;
+
+        for (std::uint32_t i = 0; i < slot_count_; i++)
+        {
+            auto& s = slot(h + i);
+
+            if (s.state.load(std::memory_order_relaxed) != Slot::empty)
+                continue;
+
+            s.hash_low.store(d.hash_low, std::memory_order_relaxed);
+            s.hash_high.store(d.hash_high, std::memory_order_relaxed);
+            s.feature_low.store(d.feature_low, std::memory_order_relaxed);
+            s.feature_high.store(d.feature_high, std::memory_order_relaxed);
+            s.answer.store(d.answer, std::memory_order_relaxed);
+            s.state.store(Slot::published, std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    header->published.store(decisions.size(), std::memory_order_relaxed);
+    header->used.store(decisions.size(), std::memory_order_relaxed);
+}
+
+void remote::posix::DecisionTable::throw_if_not_owned() const
+{
+    if (not owned) throw std::logic_error
+    {
+        "Cannot modify a decision table attached to."
+    };
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_REMOTE_DECISION_TABLE_H_
+#define CORE_TRUST_REMOTE_DECISION_TABLE_H_
+
+#include <core/trust/request.h>
+#include <core/trust/visibility.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace core
+{
+namespace trust
+{
+namespace remote
+{
+namespace posix
+{
+// A DecisionTable publishes the answers currently recorded for (application id, feature)
+// pairs to other processes. The table is an open-addressing hash table living in a sealed
+// memfd, with application ids hashed by a keyed hash function. A single process owns and
+// modifies the table, other processes map it read-only and consult it without entering
+// the kernel. Readers are kept consistent by a sequence lock, that is, they retry if the
+// owner modified the table while they were reading it.
+class CORE_TRUST_DLL_PUBLIC DecisionTable
+{
+public:
+    // Just for convenience
+    typedef std::shared_ptr<DecisionTable> Ptr;
+
+    // The maximum number of slots that a table might hold.
+    static constexpr const std::uint32_t max_slot_count{1 << 20};
+
+    // The default number of slots, good for publishing roughly 3000 decisions.
+    static constexpr const std::uint32_t default_slot_count{4096};
+
+    // Creates a new, empty table with slot_count slots, rounded up to the next power of two.
+    // Throws std::system_error in case of issues.
+    static Ptr create(std::uint32_t slot_count);
+
+    // Maps the table described by memfd read-only, taking ownership of the fd.
+    // Throws std::runtime_error if memfd does not describe a valid table.
+    static Ptr attach(int memfd);
+
+    DecisionTable(const DecisionTable&) = delete;
+    DecisionTable& operator=(const DecisionTable&) = delete;
+
+    // Unmaps the table and closes the memfd.
+    ~DecisionTable();
+
+    // Publishes answer for app_id and feature, replacing any answer published before. The
+    // decision is silently dropped if the table is full, and readers fall back to asking.
+    // Throws std::logic_error if the table has been attached to.
+    void publish(const std::string& app_id, core::trust::Feature feature, core::trust::Request::Answer answer);
+
+    // Withdraws the answer published for app_id and feature, if any.
+    // Throws std::logic_error if the table has been attached to.
+    void withdraw(const std::string& app_id, core::trust::Feature feature);
+
+    // Withdraws all answers published for app_id.
+    // Throws std::logic_error if the table has been attached to.
+    void withdraw_application(const std::string& app_id);
+
+    // Withdraws all answers.
+    // Throws std::logic_error if the table has been attached to.
+    void clear();
+
+    // Withdraws all answers and tells readers that the table is not maintained anymore.
+    // Throws std::logic_error if the table has been attached to.
+    void retire();
+
+    // Returns true and the answer published for the first size bytes of app_id and feature
+    // in answer. Returns false if no answer has been published, or if the owner kept on
+    // modifying the table while we tried to read it. Never blocks and never allocates.
+    bool lookup(const char* app_id, std::size_t size, core::trust::Feature feature, core::trust::Request::Answer& answer) const;
+
+    // Returns true and the answer published for app_id and feature in answer.
+    bool lookup(const std::string& app_id, core::trust::Feature feature, core::trust::Request::Answer& answer) const;
+
+    // Returns the fd referring to the shared memory backing the table.
+    int memfd() const;
+
+    // Returns the number of slots in the table.
+    std::uint32_t slot_count() const;
+
+    // Returns the number of answers currently published.
+    std::uint32_t size() const;
+
+private:
+    // The layout of the shared memory region preceding the slots.
+    struct Header;
+    // The layout of a single slot.
+    struct Slot;
+
+    DecisionTable(int memfd, void* base, std::size_t size, std::uint32_t slot_count, const std::uint64_t key[2], bool owned);
+
+    // Hashes the first size bytes of app_id with the key of the table.
+    std::uint64_t hash(const char* app_id, std::size_t size) const;
+
+    // Returns the slot at the given, unmasked index.
+    Slot& slot(std::uint32_t index) const;
+
+    // Returns the index of the slot holding hash and feature, or slot_count_ if
+    // there is none. Has to be called with guard held.
+    std::uint32_t find(std::uint64_t hash, core::trust::Feature feature) const;
+
+    // Reinserts all published answers, dropping withdrawn slots. Has to be called
+    // with guard held and within a write section.
+    void rehash();
+
+    // Throws std::logic_error if we do not own the table.
+    void throw_if_not_owned() const;
+
+    int memfd_;
+    void* base;
+    std::size_t size_;
+    // We keep private copies of the geometry and the key, the owner
+    // might modify the shared header at any time.
+    std::uint32_t slot_count_;
+    std::uint64_t key[2];
+    bool owned;
+    Header* header;
+    // Serializes modifications, only ever used by the owner.
+    std::mutex guard;
+};
+}
+}
+}
+}
+
+#endif // CORE_TRUST_REMOTE_DECISION_TABLE_H_
@@ -23,9 +23,101 @@
 
 #include <sys/apparmor.h>
 
+#include <atomic>
+
+#include <poll.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
 namespace trust = core::trust;
 namespace remote = core::trust::remote;
 
+namespace
+{
+// Pins down a process by its start time.
+class StartTimeProcessIdentity : public remote::helpers::ProcessIdentity
+{
+public:
+    StartTimeProcessIdentity(trust::Pid pid, const remote::helpers::ProcessStartTimeResolver& start_time_resolver)
+        : pid_{pid},
+          start_time_resolver{start_time_resolver},
+          start_time_{start_time_resolver(pid)}
+    {
+    }
+
+    trust::Pid pid() const override
+    {
+        return pid_;
+    }
+
+    std::int64_t start_time() const override
+    {
+        return start_time_;
+    }
+
+    bool is_alive() const override
+    {
+        // The process might be gone altogether, and resolving its start time throws.
+        try
+        {
+            return start_time_resolver(pid_) == start_time_;
+        } catch(const std::exception&)
+        {
+            return false;
+        }
+    }
+
+private:
+    trust::Pid pid_;
+    remote::helpers::ProcessStartTimeResolver start_time_resolver;
+    std::int64_t start_time_;
+};
+
+// Pins down a process by a pidfd. The pid cannot be recycled while the process is
+// alive, and the pidfd becomes readable once the process has exited.
+class PidFdProcessIdentity : public remote::helpers::ProcessIdentity
+{
+public:
+    // Takes ownership of pidfd.
+    PidFdProcessIdentity(trust::Pid pid, int pidfd, std::int64_t start_time)
+        : pid_{pid},
+          pidfd{pidfd},
+          start_time_{start_time}
+    {
+    }
+
+    ~PidFdProcessIdentity()
+    {
+        ::close(pidfd);
+    }
+
+    trust::Pid pid() const override
+    {
+        return pid_;
+    }
+
+    std::int64_t start_time() const override
+    {
+        return start_time_;
+    }
+
+    bool is_alive() const override
+    {
+        ::pollfd pfd{pidfd, POLLIN, 0};
+        return ::poll(&pfd, 1, 0) == 0;
+    }
+
+private:
+    trust::Pid pid_;
+    int pidfd;
+    std::int64_t start_time_;
+};
+}
+
 // Queries the start time of a process by reading /proc/{PID}/stat.
 remote::helpers::ProcessStartTimeResolver remote::helpers::proc_stat_start_time_resolver()
 {
@@ -39,6 +131,51 @@ remote::helpers::ProcessStartTimeResolver remote::helpers::proc_stat_start_time_
     };
 }
 
+remote::helpers::ProcessIdentityResolver remote::helpers::start_time_process_identity_resolver(
+        const remote::helpers::ProcessStartTimeResolver& start_time_resolver)
+{
+    return [start_time_resolver](trust::Pid pid)
+    {
+        return std::make_shared<StartTimeProcessIdentity>(pid, start_time_resolver);
+    };
+}
+
+remote::helpers::ProcessIdentityResolver remote::helpers::pidfd_process_identity_resolver(
+        const remote::helpers::ProcessStartTimeResolver& start_time_resolver)
+{
+    // We stop trying once we learn that the kernel does not support pidfds.
+    auto supported = std::make_shared<std::atomic<bool>>(true);
+
+    return [start_time_resolver, supported](trust::Pid pid) -> ProcessIdentity::Ptr
+    {
+        if (*supported)
+        {
+            int pidfd = ::syscall(SYS_pidfd_open, pid.value, 0);
+
+            if (pidfd != -1)
+            {
+                // Sampling after pinning down the process, the start time
+                // belongs to the pinned process as long as it is alive.
+                try
+                {
+                    return std::make_shared<PidFdProcessIdentity>(pid, pidfd, start_time_resolver(pid));
+                } catch(...)
+                {
+                    ::close(pidfd);
+                    throw;
+                }
+            }
+
+            // ENOSYS for older kernels, EPERM if filtered by seccomp.
+            if (errno == ENOSYS || errno == EPERM)
+                *supported = false;
+        }
+
+        // We leave the reporting of all other errors to the start time resolver.
+        return std::make_shared<StartTimeProcessIdentity>(pid, start_time_resolver);
+    };
+}
+
 remote::helpers::AppIdResolver remote::helpers::aa_get_task_con_app_id_resolver()
 {
     return [](trust::Pid pid)
@@ -22,7 +22,9 @@
 #include <core/trust/tagged_integer.h>
 #include <core/trust/visibility.h>
 
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 
 namespace core
@@ -39,6 +41,39 @@ typedef std::function<std::int64_t(Pid)> ProcessStartTimeResolver;
 // Queries the start time of a process by reading /proc/{PID}/stat.
 CORE_TRUST_DLL_PUBLIC ProcessStartTimeResolver proc_stat_start_time_resolver();
 
+// A ProcessIdentity pins down a specific process, and tells whether
+// its pid still refers to the very same process.
+class CORE_TRUST_DLL_PUBLIC ProcessIdentity
+{
+public:
+    // Just for convenience
+    typedef std::shared_ptr<ProcessIdentity> Ptr;
+
+    virtual ~ProcessIdentity() = default;
+
+    // Returns the pid of the process.
+    virtual Pid pid() const = 0;
+
+    // Returns the start time of the process, sampled once when pinning down the process.
+    virtual std::int64_t start_time() const = 0;
+
+    // Returns true iff the process is still alive and its pid has not been recycled.
+    virtual bool is_alive() const = 0;
+};
+
+// Functor abstracting pid -> process identity resolving
+typedef std::function<ProcessIdentity::Ptr(Pid)> ProcessIdentityResolver;
+
+// Pins down processes by sampling their start time once, and compares
+// against a fresh sample when checking for liveness.
+CORE_TRUST_DLL_PUBLIC ProcessIdentityResolver start_time_process_identity_resolver(
+        const ProcessStartTimeResolver& start_time_resolver);
+
+// Pins down processes with a pidfd, checking for liveness by polling the pidfd.
+// Falls back to start_time_process_identity_resolver if pidfds are not supported.
+CORE_TRUST_DLL_PUBLIC ProcessIdentityResolver pidfd_process_identity_resolver(
+        const ProcessStartTimeResolver& start_time_resolver);
+
 // Functor abstracting pid -> app name resolving
 typedef std::function<std::string(Pid)> AppIdResolver;
 
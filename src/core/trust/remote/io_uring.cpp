@@ -0,0 +1,283 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/remote/io_uring.h>
+
+#include <linux/io_uring.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace remote = core::trust::remote;
+
+namespace
+{
+int io_uring_setup(unsigned entries, io_uring_params* params)
+{
+    return ::syscall(__NR_io_uring_setup, entries, params);
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return ::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+int io_uring_register(int fd, unsigned opcode, const void* arg, unsigned nr_args)
+{
+    return ::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+std::system_error last_system_error()
+{
+    return std::system_error{errno, std::system_category()};
+}
+
+// The kernel updates the heads and tails concurrently.
+unsigned load_acquire(const unsigned* p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+void store_release(unsigned* p, unsigned value)
+{
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+bool probe_for_required_operations()
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    int fd = io_uring_setup(2, &params);
+    if (fd == -1)
+        return false;
+
+    // We rely on a single mapping for both rings.
+    bool result = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+    std::vector<unsigned char> buffer(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+    auto probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+
+    if (result && io_uring_register(fd, IORING_REGISTER_PROBE, probe, 256) == 0)
+    {
+        for (auto op : {IORING_OP_ACCEPT, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED})
+            result = result && op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    } else
+    {
+        result = false;
+    }
+
+    ::close(fd);
+    return result;
+}
+}
+
+bool remote::posix::IoUring::is_supported()
+{
+    static const bool supported = probe_for_required_operations();
+    return supported;
+}
+
+remote::posix::IoUring::Ptr remote::posix::IoUring::create(std::uint32_t entries)
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    int fd = io_uring_setup(entries, &params);
+    if (fd == -1)
+        throw last_system_error();
+
+    Ptr ring{new IoUring{fd}};
+
+    // Both rings share a single mapping, sized for the larger one.
+    ring->rings_size = std::max(
+                params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+
+    ring->rings = ::mmap(nullptr, ring->rings_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->rings == MAP_FAILED)
+    {
+        ring->rings = nullptr;
+        throw last_system_error();
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    auto sqes = ::mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+        throw last_system_error();
+
+    ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto base = static_cast<unsigned char*>(ring->rings);
+
+    ring->sq_head = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+    ring->sq_tail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+    ring->sq_mask = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+    ring->sq_entries = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_entries);
+    ring->sq_array = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+
+    ring->cq_head = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+    ring->cq_tail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+    ring->cq_mask = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+
+    return ring;
+}
+
+remote::posix::IoUring::IoUring(int fd)
+    : fd{fd},
+      rings{nullptr},
+      rings_size{0},
+      sqes{nullptr},
+      sqes_size{0}
+{
+}
+
+remote::posix::IoUring::~IoUring()
+{
+    if (sqes) ::munmap(sqes, sqes_size);
+    if (rings) ::munmap(rings, rings_size);
+
+    ::close(fd);
+}
+
+void remote::posix::IoUring::register_buffers(const std::vector<::iovec>& buffers)
+{
+    if (io_uring_register(fd, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) == -1)
+        throw last_system_error();
+}
+
+void remote::posix::IoUring::register_eventfd(int eventfd)
+{
+    if (io_uring_register(fd, IORING_REGISTER_EVENTFD, &eventfd, 1) == -1)
+        throw last_system_error();
+}
+
+void remote::posix::IoUring::prepare_read_fixed(int fd, void* buffer, std::uint32_t size, std::uint16_t buffer_index, std::uint64_t user_data, bool link)
+{
+    auto sqe = next_sqe();
+
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<std::uint64_t>(buffer);
+    sqe->len = size;
+    sqe->buf_index = buffer_index;
+    sqe->user_data = user_data;
+    sqe->flags = link ? IOSQE_IO_LINK : 0;
+}
+
+void remote::posix::IoUring::prepare_write_fixed(int fd, const void* buffer, std::uint32_t size, std::uint16_t buffer_index, std::uint64_t user_data, bool link)
+{
+    auto sqe = next_sqe();
+
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<std::uint64_t>(buffer);
+    sqe->len = size;
+    sqe->buf_index = buffer_index;
+    sqe->user_data = user_data;
+    sqe->flags = link ? IOSQE_IO_LINK : 0;
+}
+
+void remote::posix::IoUring::prepare_accept(int fd, bool multishot, std::uint64_t user_data)
+{
+    auto sqe = next_sqe();
+
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->ioprio = multishot ? IORING_ACCEPT_MULTISHOT : 0;
+    sqe->user_data = user_data;
+}
+
+void remote::posix::IoUring::submit_and_wait(std::uint32_t wait_nr)
+{
+    // Publish all queued entries to the kernel.
+    store_release(sq_tail, *sq_tail + sq_pending);
+
+    auto to_submit = sq_pending;
+    sq_pending = 0;
+
+    while (to_submit > 0 || wait_nr > 0)
+    {
+        enters++;
+
+        auto rc = io_uring_enter(fd, to_submit, wait_nr, wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0);
+
+        if (rc == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            throw last_system_error();
+        }
+
+        // The kernel might not have consumed all submissions at once.
+        to_submit -= std::min<unsigned>(rc, to_submit);
+        // The completions we have been waiting for are available now.
+        wait_nr = 0;
+    }
+}
+
+std::size_t remote::posix::IoUring::drain(const CompletionHandler& handler)
+{
+    std::size_t count{0};
+
+    auto head = *cq_head;
+
+    while (head != load_acquire(cq_tail))
+    {
+        const auto& cqe = cqes[head & cq_mask];
+        handler(cqe.user_data, cqe.res, cqe.flags);
+
+        store_release(cq_head, ++head);
+        count++;
+    }
+
+    return count;
+}
+
+std::uint64_t remote::posix::IoUring::enter_count() const
+{
+    return enters;
+}
+
+io_uring_sqe* remote::posix::IoUring::next_sqe()
+{
+    auto tail = *sq_tail + sq_pending;
+
+    if (tail - load_acquire(sq_head) >= sq_entries) throw std::runtime_error
+    {
+        "Submission queue of io_uring instance is full."
+    };
+
+    auto index = tail & sq_mask;
+    sq_array[index] = index;
+    sq_pending++;
+
+    auto sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+
+    return sqe;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_REMOTE_IO_URING_H_
+#define CORE_TRUST_REMOTE_IO_URING_H_
+
+#include <core/trust/visibility.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <sys/uio.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace core
+{
+namespace trust
+{
+namespace remote
+{
+namespace posix
+{
+// A thin wrapper around a kernel io_uring instance, talking to the kernel via raw
+// syscalls. Submissions are queued up with the prepare_* functions and handed to the
+// kernel in a single call to submit_and_wait. Instances are not thread-safe.
+class CORE_TRUST_DLL_PUBLIC IoUring
+{
+public:
+    // Just for convenience
+    typedef std::shared_ptr<IoUring> Ptr;
+
+    // Invoked for every completion with the user data of the submission, the result and the cqe flags.
+    typedef std::function<void(std::uint64_t, std::int32_t, std::uint32_t)> CompletionHandler;
+
+    // Returns true iff the kernel supports io_uring including all the operations we rely on.
+    // The result is determined once and cached afterwards.
+    static bool is_supported();
+
+    // Creates a new instance with room for at least entries submissions.
+    // Throws std::system_error in case of issues.
+    static Ptr create(std::uint32_t entries);
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    // Unmaps all rings and closes the io_uring instance, cancelling pending operations.
+    ~IoUring();
+
+    // Registers buffers for use with fixed reads and writes, referenced by their index.
+    // Throws std::system_error in case of issues.
+    void register_buffers(const std::vector<::iovec>& buffers);
+
+    // Registers fd as an eventfd that is signaled for every completion.
+    // Throws std::system_error in case of issues.
+    void register_eventfd(int fd);
+
+    // Queues a read of size bytes from fd into the registered buffer buffer_index, starting
+    // at buffer. If link is true, the next submission only starts once this one succeeded.
+    void prepare_read_fixed(int fd, void* buffer, std::uint32_t size, std::uint16_t buffer_index, std::uint64_t user_data, bool link);
+
+    // Queues a write of size bytes to fd from the registered buffer buffer_index, starting
+    // at buffer. If link is true, the next submission only starts once this one succeeded.
+    void prepare_write_fixed(int fd, const void* buffer, std::uint32_t size, std::uint16_t buffer_index, std::uint64_t user_data, bool link);
+
+    // Queues an accept on the listening socket fd. A multishot accept keeps on
+    // completing for every incoming connection, flagging completions with IORING_CQE_F_MORE.
+    void prepare_accept(int fd, bool multishot, std::uint64_t user_data);
+
+    // Submits all queued operations and waits for at least wait_nr completions.
+    // Throws std::system_error in case of issues.
+    void submit_and_wait(std::uint32_t wait_nr);
+
+    // Invokes handler for all available completions, consuming them.
+    // Returns the number of completions handled.
+    std::size_t drain(const CompletionHandler& handler);
+
+    // Returns the number of times we entered the kernel, for instrumentation purposes.
+    std::uint64_t enter_count() const;
+
+private:
+    IoUring(int fd);
+
+    // Returns the next free submission queue entry, cleared out.
+    // Throws std::runtime_error if the submission queue is full.
+    io_uring_sqe* next_sqe();
+
+    int fd;
+    // The mapping shared by submission and completion queue ring.
+    void* rings;
+    std::size_t rings_size;
+    // The mapping of the submission queue entries.
+    io_uring_sqe* sqes;
+    std::size_t sqes_size;
+
+    // Pointers into the submission queue ring.
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned* sq_array;
+    // Submissions queued up but not handed to the kernel yet.
+    unsigned sq_pending{0};
+
+    // Pointers into the completion queue ring.
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    io_uring_cqe* cqes;
+
+    std::uint64_t enters{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_TRUST_REMOTE_IO_URING_H_
@@ -26,13 +26,194 @@
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/format.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <mutex>
 
+#if defined(CORE_TRUST_HAVE_IO_URING)
+#include <linux/io_uring.h>
+#endif
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+
 namespace trust = core::trust;
 namespace remote = core::trust::remote;
 
+namespace
+{
+// The number of fds handed over in a shared-memory handshake.
+constexpr const std::size_t fds_per_shared_memory_handshake{4};
+
+// The number of times we poll the reply ring before blocking on its doorbell.
+constexpr const std::size_t spins_before_blocking{1024};
+
+// Frames are sent as is, and must not carry uninitialized padding.
+static_assert(sizeof(remote::posix::Request) == 32, "posix::Request must not have implicit padding.");
+static_assert(sizeof(remote::posix::Hello) == 8, "posix::Hello must not have implicit padding.");
+
+// Skeletons greet right after connecting, and we give up on silent peers after this timeout.
+constexpr const std::chrono::milliseconds hello_timeout{5000};
+
+// Returns true if hello has been sent by a peer speaking our protocol.
+bool is_compatible(const remote::posix::Hello& hello)
+{
+    return hello.magic == remote::posix::protocol_magic && hello.version == remote::posix::protocol_version;
+}
+
+#if defined(CORE_TRUST_HAVE_IO_URING)
+// User data tagging submissions to io_uring instances.
+constexpr const std::uint64_t io_uring_accept{1};
+constexpr const std::uint64_t io_uring_write{2};
+constexpr const std::uint64_t io_uring_read{3};
+#endif
+
+// Skeletons publish decisions for application ids without their version, as recorded by
+// core::trust::AppIdFormattingTrustAgent. Returns the size of app_id without its version.
+std::size_t size_of_versionless_app_id(const std::string& app_id)
+{
+    auto last = app_id.rfind('_');
+
+    if (last == std::string::npos || last == 0 || app_id.rfind('_', last - 1) == std::string::npos)
+        return app_id.size();
+
+    return last;
+}
+
+#if defined(CORE_TRUST_HAVE_IO_URING)
+// Creates an eventfd signaled for completions of ring, handing it over to descriptor.
+void notify_completions_via(const remote::posix::IoUring::Ptr& ring, boost::asio::posix::stream_descriptor& descriptor)
+{
+    int fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if (fd == -1) throw std::system_error
+    {
+        errno, std::system_category()
+    };
+
+    descriptor.assign(fd);
+    ring->register_eventfd(fd);
+}
+#endif
+
+// Removes a socket left behind in the filesystem by a previous instance that has
+// gone away, such that we are able to bind to endpoint again. Returns endpoint.
+const boost::asio::local::stream_protocol::endpoint& remove_if_stale(const boost::asio::local::stream_protocol::endpoint& endpoint)
+{
+    boost::asio::io_service io_service;
+    boost::asio::local::stream_protocol::socket socket{io_service};
+
+    boost::system::error_code ec;
+    socket.connect(endpoint, ec);
+
+    // Nobody is accepting connections on the endpoint anymore.
+    if (ec == boost::asio::error::connection_refused)
+        ::unlink(endpoint.path().c_str());
+
+    return endpoint;
+}
+
+// Waits until socket becomes ready for the given events, returning false on errors.
+bool wait_for_socket(int socket, short events)
+{
+    ::pollfd pfd{socket, events, 0};
+
+    int rc;
+    while ((rc = ::poll(&pfd, 1, -1)) == -1 && errno == EINTR);
+
+    return rc == 1 && (pfd.revents & events) != 0;
+}
+
+// Sends a single byte carrying fds as SCM_RIGHTS over socket.
+void send_fds(int socket, const std::vector<int>& fds, boost::system::error_code& ec)
+{
+    char byte{0};
+    ::iovec iov{&byte, sizeof(byte)};
+
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()), 0);
+
+    ::msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+
+    auto cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+    std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+
+    while (::sendmsg(socket, &msg, MSG_NOSIGNAL) == -1)
+    {
+        if (errno == EINTR)
+            continue;
+
+        if ((errno == EAGAIN || errno == EWOULDBLOCK) && wait_for_socket(socket, POLLOUT))
+            continue;
+
+        ec = boost::system::error_code{errno, boost::system::system_category()};
+        return;
+    }
+}
+
+// Receives a single byte carrying exactly count fds as SCM_RIGHTS from socket.
+// Throws std::runtime_error if anything else arrived, closing all received fds.
+std::vector<int> receive_fds(int socket, std::size_t count)
+{
+    char byte{0};
+    ::iovec iov{&byte, sizeof(byte)};
+
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * count), 0);
+
+    ::msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+
+    ssize_t rc;
+    while ((rc = ::recvmsg(socket, &msg, MSG_CMSG_CLOEXEC)) == -1)
+    {
+        if (errno == EINTR)
+            continue;
+
+        if ((errno == EAGAIN || errno == EWOULDBLOCK) && wait_for_socket(socket, POLLIN))
+            continue;
+
+        throw std::system_error{errno, std::system_category()};
+    }
+
+    std::vector<int> fds;
+    for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+            continue;
+
+        std::size_t n = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        std::vector<int> received(n);
+        std::memcpy(received.data(), CMSG_DATA(cmsg), sizeof(int) * n);
+        fds.insert(fds.end(), received.begin(), received.end());
+    }
+
+    if (rc != 1 || (msg.msg_flags & MSG_CTRUNC) || fds.size() != count)
+    {
+        for (auto fd : fds)
+            ::close(fd);
+
+        throw std::runtime_error{"Malformed handshake."};
+    }
+
+    return fds;
+}
+}
+
 remote::posix::Stub::PeerCredentialsResolver remote::posix::Stub::get_sock_opt_credentials_resolver()
 {
     return [](int socket)
@@ -57,8 +238,7 @@ remote::posix::Stub::PeerCredentialsResolver remote::posix::Stub::get_sock_opt_c
 
 bool remote::posix::Stub::Session::Registry::has_session_for_uid(core::trust::Uid uid) const
 {
-    std::lock_guard<std::mutex> lg(guard);
-    return sessions.count(uid) > 0;
+    return sessions.contains(uid);
 }
 
 void remote::posix::Stub::Session::Registry::add_session_for_uid(core::trust::Uid uid, Session::Ptr session)
@@ -68,24 +248,83 @@ void remote::posix::Stub::Session::Registry::add_session_for_uid(core::trust::Ui
         "Cannot add null session to registry."
     };
 
-    std::lock_guard<std::mutex> lg(guard);
-    sessions[uid] = session;
+    sessions.update([uid, session](std::map<core::trust::Uid, std::vector<Session::Ptr>>& map)
+    {
+        map[uid].push_back(session);
+    });
 }
 
 void remote::posix::Stub::Session::Registry::remove_session_for_uid(core::trust::Uid uid)
 {
-    std::lock_guard<std::mutex> lg(guard);
     sessions.erase(uid);
 }
 
+void remote::posix::Stub::Session::Registry::remove_session_for_uid(core::trust::Uid uid, const Session::Ptr& session)
+{
+    sessions.update([uid, session](std::map<core::trust::Uid, std::vector<Session::Ptr>>& map)
+    {
+        auto it = map.find(uid);
+        if (it == map.end())
+            return;
+
+        it->second.erase(std::remove(it->second.begin(), it->second.end(), session), it->second.end());
+
+        if (it->second.empty())
+            map.erase(it);
+    });
+}
+
 remote::posix::Stub::Session::Ptr remote::posix::Stub::Session::Registry::resolve_session_for_uid(core::trust::Uid uid)
 {
-    std::lock_guard<std::mutex> lg(guard);
-    return sessions.at(uid);
+    auto session = try_resolve_session_for_uid(uid);
+
+    if (not session) throw std::out_of_range
+    {
+        "No session known for uid " + std::to_string(uid.value)
+    };
+
+    return *session;
+}
+
+boost::optional<remote::posix::Stub::Session::Ptr> remote::posix::Stub::Session::Registry::try_resolve_session_for_uid(core::trust::Uid uid)
+{
+    auto candidates = resolve_sessions_for_uid_by_load(uid);
+
+    if (candidates.empty())
+        return boost::optional<Session::Ptr>{};
+
+    return candidates.front();
+}
+
+std::vector<remote::posix::Stub::Session::Ptr> remote::posix::Stub::Session::Registry::resolve_sessions_for_uid_by_load(core::trust::Uid uid)
+{
+    typedef std::pair<std::size_t, Session::Ptr> Candidate;
+
+    std::vector<Candidate> candidates;
+
+    if (auto all = sessions.try_resolve(uid))
+    {
+        // The load might change while we are sorting, and we sort by a snapshot of the load.
+        for (const auto& session : *all)
+            if (session->healthy)
+                candidates.push_back(std::make_pair(session->in_flight.load(), session));
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs)
+    {
+        return lhs.first < rhs.first;
+    });
+
+    std::vector<Session::Ptr> result;
+    for (const auto& candidate : candidates)
+        result.push_back(candidate.second);
+
+    return result;
 }
 
 remote::posix::Stub::Session::Session(boost::asio::io_service& io_service)
-    : socket{io_service}
+    : socket{io_service},
+      revocations{io_service}
 {
 }
 
@@ -107,16 +346,40 @@ remote::posix::Stub::Ptr remote::posix::Stub::create_stub_for_configuration(cons
 // Throws in case of errors.
 remote::posix::Stub::Stub(remote::posix::Stub::Configuration configuration)
     : io_service(configuration.io_service),
-      end_point{configuration.endpoint},
+      end_point{remove_if_stale(configuration.endpoint)},
       acceptor{io_service, end_point},
-      start_time_resolver{configuration.start_time_resolver},
+      process_identity_resolver{configuration.process_identity_resolver ?
+                                    configuration.process_identity_resolver :
+                                    helpers::pidfd_process_identity_resolver(configuration.start_time_resolver)},
       peer_credentials_resolver{configuration.peer_credentials_resolver},
-      session_registry{configuration.session_registry}
+      session_registry{configuration.session_registry},
+      shared_memory_ring_capacity{configuration.shared_memory_ring_capacity},
+      accept_completions{io_service},
+      accept_completion_count{0},
+      multishot_accept{true},
+      reconnect_grace_period{configuration.reconnect_grace_period},
+      decision_cache{configuration.decision_cache},
+      consult_decision_tables{configuration.consult_decision_tables}
 {
+#if defined(CORE_TRUST_HAVE_IO_URING)
+    if (configuration.io_backend == IoBackend::io_uring && IoUring::is_supported())
+    {
+        accept_ring = IoUring::create(8);
+        notify_completions_via(accept_ring, accept_completions);
+    }
+#endif
 }
 
 void remote::posix::Stub::start_accept()
 {
+#if defined(CORE_TRUST_HAVE_IO_URING)
+    if (accept_ring)
+    {
+        start_accept_via_io_uring(true);
+        return;
+    }
+#endif
+
     remote::posix::Stub::Session::Ptr session
     {
         new remote::posix::Stub::Session{io_service}
@@ -130,206 +393,1332 @@ void remote::posix::Stub::start_accept()
                             session));
 }
 
+#if defined(CORE_TRUST_HAVE_IO_URING)
+void remote::posix::Stub::start_accept_via_io_uring(bool rearm)
+{
+    if (rearm)
+    {
+        accept_ring->prepare_accept(acceptor.native_handle(), multishot_accept, io_uring_accept);
+        accept_ring->submit_and_wait(0);
+    }
+
+    accept_completions.async_read_some(
+                boost::asio::buffer(&accept_completion_count, sizeof(accept_completion_count)),
+                boost::bind(&remote::posix::Stub::on_io_uring_accept_completions,
+                            shared_from_this(),
+                            boost::asio::placeholders::error()));
+}
+
+void remote::posix::Stub::on_io_uring_accept_completions(const boost::system::error_code& ec)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+
+    bool rearm{false};
+    bool stop{false};
+
+    accept_ring->drain([this, &rearm, &stop](std::uint64_t, std::int32_t res, std::uint32_t flags)
+    {
+        // Older kernels do not support multishot accepts, and we fall back to single shots.
+        if (res == -EINVAL && multishot_accept)
+            multishot_accept = false;
+        // The acceptor is gone, and we stop accepting.
+        else if (res == -EINVAL || res == -EBADF || res == -ECANCELED)
+            stop = true;
+
+        // The accept is not going to complete again.
+        if (not (flags & IORING_CQE_F_MORE))
+            rearm = true;
+
+        if (res < 0)
+            return;
+
+        remote::posix::Stub::Session::Ptr session
+        {
+            new remote::posix::Stub::Session{io_service}
+        };
+
+        session->socket.assign(boost::asio::local::stream_protocol(), res);
+        await_hello(session);
+    });
+
+    if (stop)
+        return;
+
+    start_accept_via_io_uring(rearm);
+}
+#endif
+
 remote::posix::Stub::~Stub()
 {
     acceptor.cancel();
+
+    boost::system::error_code ignored;
+    accept_completions.cancel(ignored);
 }
 
 core::trust::Request::Answer remote::posix::Stub::send(
         const core::trust::Agent::RequestParameters& parameters)
 {
-    // We consider the process start time to prevent from spoofing.
-    auto start_time_before_query = start_time_resolver(parameters.application.pid);
+    core::trust::Request::Answer published;
 
-    // This call will throw if there is no session known for the uid.
-    Session::Ptr session = session_registry->resolve_session_for_uid(parameters.application.uid);
+    // Decisions published by skeletons spare us the round trip and pinning down the process.
+    if (lookup_published_decision(parameters.application.uid, parameters.application.id, parameters.feature, published))
+        return published;
+
+    // We pin down the requesting process to prevent from spoofing.
+    auto identity = process_identity_resolver(parameters.application.pid);
 
     remote::posix::Request request
     {
         parameters.application.uid,
         parameters.application.pid,
         parameters.feature,
-        start_time_before_query
+        identity->start_time(),
+        1,
+        0
     };
 
-    boost::system::error_code ec;
-
-    boost::asio::write(
-                session->socket,
-                boost::asio::buffer(&request, sizeof(request)),
-                ec);
-
-    if (ec)
-        handle_error_from_socket_operation_for_uid(ec, parameters.application.uid);
-
     core::trust::Request::Answer answer
     {
         core::trust::Request::Answer::denied
     };
 
-    boost::asio::read(
-                session->socket,
-                boost::asio::buffer(&answer, sizeof(answer)),
-                ec);
+    DecisionCache::Key key
+    {
+        parameters.application.uid,
+        parameters.application.pid,
+        identity->start_time(),
+        parameters.feature
+    };
 
-    if (ec)
-        handle_error_from_socket_operation_for_uid(ec, parameters.application.uid);
+    if (decision_cache && decision_cache->lookup(key, answer))
+        return answer;
 
-    // And finally, we check on the process start time.
-    auto start_time_after_query = start_time_resolver(parameters.application.pid);
+    // Revocations arriving while the request is in flight might render the answer stale.
+    auto generation = decision_cache ? decision_cache->generation() : 0;
+    bool cacheable{false};
 
-    // We consider the process start time to prevent from spoofing. That is,
-    // if the process start times differ here, we would authenticate a different process and
-    // with that potentially a different app.
-    if (start_time_before_query != start_time_after_query) throw std::runtime_error
+    // This call will throw if there is no session known for the uid.
+    transact_with_session_for_uid(
+                parameters.application.uid,
+                [&request, &answer, &cacheable](Session& session, boost::system::error_code& ec)
+                {
+                    // We only cache answers of skeletons that keep us posted about revocations.
+                    cacheable = session.revocations.is_open();
+
+                    if (session.requests)
+                        exchange_via_shared_memory(session, request, answer, ec);
+#if defined(CORE_TRUST_HAVE_IO_URING)
+                    else if (session.ring)
+                        exchange_via_io_uring(session, request, answer, ec);
+#endif
+                    else
+                        exchange_via_socket(
+                                session,
+                                {boost::asio::buffer(&request, sizeof(request))},
+                                boost::asio::buffer(&answer, sizeof(answer)),
+                                ec);
+                });
+
+    // And finally, we check that the process is still around. That is, if the
+    // pid refers to a different process now, we would authenticate a different
+    // process and with that potentially a different app.
+    if (not identity->is_alive()) throw std::runtime_error
     {
-        "Detected a spoofing attempt, process start times before"
-        "and after authentication do not match."
+        "Detected a spoofing attempt, the requesting process did "
+        "not survive authentication."
     };
 
+    if (decision_cache && cacheable)
+        decision_cache->remember(key, answer, generation);
+
     // We will only ever return if we encountered no errors during communication
     // with the other side.
     return answer;
 }
 
-// Called in case of an incoming connection.
-void remote::posix::Stub::on_new_session(
-        const boost::system::error_code& ec,
-        const remote::posix::Stub::Session::Ptr& session)
+core::trust::Agent::BatchAnswer remote::posix::Stub::send_batch(
+        const core::trust::Agent::BatchRequestParameters& parameters)
 {
-    if (ec == boost::asio::error::operation_aborted)
-        return;
+    core::trust::Agent::BatchAnswer result;
 
-    if (ec) { start_accept(); return; }
+    if (parameters.features.empty())
+        return result;
 
-    auto pc = peer_credentials_resolver(session->socket.native_handle());
+    if (parameters.features.size() > max_features_per_request) throw std::runtime_error
+    {
+        "Too many features in a single request."
+    };
 
-    session_registry->add_session_for_uid(std::get<0>(pc), session);
+    // We only spare the round trip if decisions have been published for all features.
+    for (const auto& feature : parameters.features)
+    {
+        core::trust::Request::Answer published;
 
-    start_accept();
-}
+        if (not lookup_published_decision(parameters.application.uid, parameters.application.id, feature, published))
+        {
+            result.clear();
+            break;
+        }
 
-void remote::posix::Stub::handle_error_from_socket_operation_for_uid(const boost::system::error_code& ec, trust::Uid uid)
-{
-    switch (ec.value())
-    {
-    // We treat all the following errors as indications for the peer having
-    // gone away. For that, we update the Session::Registry
-    case boost::asio::error::basic_errors::access_denied:
-    case boost::asio::error::basic_errors::broken_pipe:
-    case boost::asio::error::basic_errors::connection_aborted:
-    case boost::asio::error::basic_errors::connection_refused:
-    case boost::asio::error::basic_errors::connection_reset:
-        session_registry->remove_session_for_uid(uid);
-        break;
-    default:
-        break;
+        result[feature] = published;
     }
 
-    // By default, we just rethrow.
-    throw std::system_error{ec.value(), std::system_category()};
-}
+    if (not result.empty())
+        return result;
 
-bool remote::posix::Stub::has_session_for_uid(trust::Uid uid) const
-{
-    return session_registry->has_session_for_uid(uid);
-}
+    // We pin down the requesting process to prevent from spoofing.
+    auto identity = process_identity_resolver(parameters.application.pid);
 
-remote::posix::Skeleton::Ptr remote::posix::Skeleton::create_skeleton_for_configuration(
-    const remote::posix::Skeleton::Configuration& configuration)
-{
-    remote::posix::Skeleton::Ptr skeleton
+    std::vector<core::trust::Feature> features
     {
-        new remote::posix::Skeleton
-        {
-            configuration
-        }
+        parameters.features.begin(),
+        parameters.features.end()
     };
 
-    skeleton->start_read();
-    return skeleton;
-}
-
-remote::posix::Skeleton::Skeleton(const Configuration& configuration)
-    : core::trust::remote::Agent::Skeleton{configuration.impl},
-      start_time_resolver{configuration.start_time_resolver},
-      app_id_resolver{configuration.app_id_resolver},
-      description_pattern{configuration.description_format},
-      verify_process_start_time{configuration.verify_process_start_time},
-      endpoint{configuration.endpoint},
-      socket{configuration.io_service}
-{
-    try
-    {
-        socket.connect(configuration.endpoint);
-    } catch(const boost::exception& e)
+    remote::posix::Request request
     {
-        throw std::runtime_error
-        {
-            "Could not connect to endpoint: " + endpoint.path()
-        };
-    }
-}
-
-remote::posix::Skeleton::~Skeleton()
-{
-    socket.cancel();
-}
+        parameters.application.uid,
+        parameters.application.pid,
+        features.front(),
+        identity->start_time(),
+        static_cast<std::uint32_t>(features.size()),
+        0
+    };
 
-void remote::posix::Skeleton::start_read()
-{
-    Ptr sp{shared_from_this()};
+    std::vector<core::trust::Request::Answer> answers
+    {
+        features.size(),
+        core::trust::Request::Answer::denied
+    };
 
-    boost::asio::async_read(
-                socket,
-                boost::asio::buffer(&request, sizeof(request)),
-                [sp](const boost::system::error_code& ec, std::size_t size)
+    // The request is followed by all but the first feature.
+    // This call will throw if there is no session known for the uid.
+    // Batch requests are always sent over the socket.
+    transact_with_session_for_uid(
+                parameters.application.uid,
+                [&request, &features, &answers](Session& session, boost::system::error_code& ec)
                 {
-                    sp->on_read_finished(ec, size);
+                    exchange_via_socket(
+                            session,
+                            {
+                                boost::asio::buffer(&request, sizeof(request)),
+                                boost::asio::buffer(features.data() + 1, sizeof(core::trust::Feature) * (features.size() - 1))
+                            },
+                            boost::asio::buffer(answers.data(), sizeof(core::trust::Request::Answer) * answers.size()),
+                            ec);
                 });
+
+    // And finally, we check that the process is still around.
+    if (not identity->is_alive()) throw std::runtime_error
+    {
+        "Detected a spoofing attempt, the requesting process did "
+        "not survive authentication."
+    };
+
+    for (std::size_t i = 0; i < features.size(); i++)
+        result[features[i]] = answers[i];
+
+    return result;
 }
 
-void remote::posix::Skeleton::on_read_finished(const boost::system::error_code& ec, std::size_t size)
+// Called in case of an incoming connection.
+void remote::posix::Stub::on_new_session(
+        const boost::system::error_code& ec,
+        const remote::posix::Stub::Session::Ptr& session)
 {
     if (ec == boost::asio::error::operation_aborted)
         return;
 
-    if (ec) { start_read(); return; }
-
-    if (size != sizeof(request))
-        return;
+    if (ec) { start_accept(); return; }
 
-    auto answer = process_incoming_request(request);
+    await_hello(session);
 
-    // We send back our answer, we might throw here and just let the
-    // exception propagate through the stack.
-    boost::asio::write(socket, boost::asio::buffer(&answer, sizeof(answer)));
-    // And restart reading.
-    start_read();
+    start_accept();
 }
 
-core::trust::Request::Answer remote::posix::Skeleton::process_incoming_request(const core::trust::remote::posix::Request& request)
+void remote::posix::Stub::await_hello(const remote::posix::Stub::Session::Ptr& session)
 {
-    if (verify_process_start_time)
+    auto hello = std::make_shared<Hello>();
+    auto timer = std::make_shared<boost::asio::steady_timer>(io_service);
+    // Whoever of the read and the timer completes first decides on the session.
+    auto decided = std::make_shared<std::atomic<bool>>(false);
+
+    timer->expires_from_now(hello_timeout);
+    timer->async_wait([session, decided](const boost::system::error_code& ec)
     {
-        // We first validate the process start time again.
-        if (start_time_resolver(request.app_pid) != request.app_start_time) throw std::runtime_error
-        {
-            "Potential spoofing detected on incoming request."
-        };
-    }
+        if (ec == boost::asio::error::operation_aborted || decided->exchange(true))
+            return;
 
-    auto app_id = app_id_resolver(request.app_pid);
+        // The peer does not speak our protocol.
+        boost::system::error_code ignored;
+        session->socket.close(ignored);
+    });
 
-    // And reach out to the user.
-    // TODO(tvoss): How to handle exceptions here?
+    Ptr sp{shared_from_this()};
 
-    return authenticate_request_with_parameters(core::trust::Agent::RequestParameters
-    {
-        request.app_uid,
-        request.app_pid,
-        app_id,
-        request.feature,
-        description_pattern
+    boost::asio::async_read(
+                session->socket,
+                boost::asio::buffer(hello.get(), sizeof(*hello)),
+                [sp, session, hello, timer, decided](const boost::system::error_code& ec, std::size_t)
+                {
+                    if (decided->exchange(true))
+                        return;
+
+                    boost::system::error_code ignored;
+                    timer->cancel(ignored);
+
+                    if (ec)
+                        return;
+
+                    if (not is_compatible(*hello))
+                    {
+                        session->socket.close(ignored);
+                        return;
+                    }
+
+                    sp->register_session(session);
+                });
+}
+
+void remote::posix::Stub::register_session(const remote::posix::Stub::Session::Ptr& session)
+{
+#if defined(CORE_TRUST_HAVE_IO_URING)
+    if (accept_ring)
+    {
+        // We keep on using the socket if we cannot set up an io_uring instance.
+        try
+        {
+            auto ring = IoUring::create(4);
+            ring->register_buffers(
+            {
+                {&session->request_frame, sizeof(session->request_frame)},
+                {&session->answer_frame, sizeof(session->answer_frame)}
+            });
+            session->ring = ring;
+        } catch(const std::exception&)
+        {
+        }
+    }
+#endif
+
+    auto pc = peer_credentials_resolver(session->socket.native_handle());
+
+    // Our Hello has to precede any request sent via the session.
+    std::lock_guard<std::mutex> sl(session->lock);
+
+    {
+        // Requests might be waiting for a skeleton to (re-)connect.
+        std::lock_guard<std::mutex> lg(registration_guard);
+        session_registry->add_session_for_uid(std::get<0>(pc), session);
+        session_registered.notify_all();
+    }
+
+    Hello hello{protocol_magic, protocol_version};
+
+    // The first request on a broken session fails over to the next one.
+    boost::system::error_code ignored;
+    boost::asio::write(session->socket, boost::asio::buffer(&hello, sizeof(hello)), ignored);
+}
+
+void remote::posix::Stub::transact_with_session_for_uid(
+        trust::Uid uid,
+        const std::function<void(Session&, boost::system::error_code&)>& exchange)
+{
+    // Skeletons might be about to (re-)connect, and we hold back requests for the grace period.
+    auto deadline = std::chrono::steady_clock::now() + reconnect_grace_period;
+
+    bool known{false};
+    boost::system::error_code ec;
+
+    do
+    {
+        for (const auto& session : session_registry->resolve_sessions_for_uid_by_load(uid))
+        {
+            known = true;
+
+            // We account for queued requests, too.
+            struct InFlight
+            {
+                InFlight(std::atomic<std::size_t>& counter) : counter(counter) { ++counter; }
+                ~InFlight() { --counter; }
+                std::atomic<std::size_t>& counter;
+            } in_flight{session->in_flight};
+
+            // Requests on a single session have to be serialized.
+            std::lock_guard<std::mutex> lg(session->lock);
+
+            // Another request might have found the session to be broken while we were waiting.
+            if (not session->healthy)
+                continue;
+
+            ec.clear();
+
+            if (decision_cache && not session->revocations_negotiated)
+                negotiate_revocation_channel(uid, session, ec);
+
+            if (not ec && consult_decision_tables && not session->decision_table_negotiated)
+                negotiate_decision_table(uid, *session, ec);
+
+            if (not ec && shared_memory_ring_capacity > 0 && not session->shared_memory_negotiated)
+                negotiate_shared_memory_rings(*session, ec);
+
+            if (not ec)
+                exchange(*session, ec);
+
+            if (not ec)
+                return;
+
+            // Anything else but the peer having gone away is reported to the caller.
+            if (not is_peer_gone(ec))
+                throw std::system_error{ec.value(), std::system_category()};
+
+            // We retire the session and fail over to the next one.
+            session->healthy = false;
+            session_registry->remove_session_for_uid(uid, session);
+
+            // Decisions published by the peer are not maintained anymore.
+            if (session->decision_table)
+            {
+                auto table = session->decision_table;
+                decision_tables.update([uid, table](CopyOnWriteMap<Uid, DecisionTable::Ptr>::Map& tables)
+                {
+                    auto it = tables.find(uid);
+                    if (it != tables.end() && it->second == table)
+                        tables.erase(it);
+                });
+            }
+        }
+        // We replay the request on sessions established by reconnecting skeletons.
+    } while (wait_for_session_for_uid(uid, deadline));
+
+    if (not known) throw std::out_of_range
+    {
+        "No session known for uid " + std::to_string(uid.value)
+    };
+
+    // All sessions have been retired by concurrent requests.
+    if (not ec) throw std::out_of_range
+    {
+        "No healthy session known for uid " + std::to_string(uid.value)
+    };
+
+    throw std::system_error{ec.value(), std::system_category()};
+}
+
+bool remote::posix::Stub::wait_for_session_for_uid(
+        trust::Uid uid,
+        const std::chrono::steady_clock::time_point& deadline)
+{
+    std::unique_lock<std::mutex> ul(registration_guard);
+
+    return session_registered.wait_until(ul, deadline, [this, uid]()
+    {
+        return not session_registry->resolve_sessions_for_uid_by_load(uid).empty();
+    });
+}
+
+void remote::posix::Stub::exchange_via_socket(
+        Session& session,
+        const std::vector<boost::asio::const_buffer>& request,
+        const boost::asio::mutable_buffer& reply,
+        boost::system::error_code& ec)
+{
+    boost::asio::write(session.socket, request, ec);
+
+    if (not ec)
+        boost::asio::read(session.socket, reply, ec);
+}
+
+void remote::posix::Stub::exchange_via_shared_memory(
+        Session& session,
+        const remote::posix::Request& request,
+        core::trust::Request::Answer& answer,
+        boost::system::error_code& ec)
+{
+    // Requests are serialized per session, and the ring never fills up.
+    if (not session.requests->try_push(&request))
+    {
+        ec = boost::asio::error::no_buffer_space;
+        return;
+    }
+
+    while (true)
+    {
+        // The skeleton usually answers quickly, and we avoid sleeping if possible.
+        for (std::size_t i = 0; i < spins_before_blocking; i++)
+            if (session.replies->try_pop(&answer))
+                return;
+
+        if (not session.replies->prepare_to_wait())
+            continue;
+
+        // The socket stays silent while rings are in use, readability
+        // indicates that the peer has gone away.
+        ::pollfd fds[2]
+        {
+            {session.replies->doorbell(), POLLIN, 0},
+            {session.socket.native_handle(), POLLIN, 0}
+        };
+
+        auto rc = ::poll(fds, 2, -1);
+
+        session.replies->finish_wait();
+
+        if (rc == -1 && errno != EINTR)
+        {
+            ec = boost::system::error_code{errno, boost::system::system_category()};
+            return;
+        }
+
+        if (rc > 0 && fds[1].revents != 0 && not session.replies->try_pop(&answer))
+        {
+            ec = boost::asio::error::eof;
+            return;
+        }
+    }
+}
+
+#if defined(CORE_TRUST_HAVE_IO_URING)
+void remote::posix::Stub::exchange_via_io_uring(
+        Session& session,
+        const remote::posix::Request& request,
+        core::trust::Request::Answer& answer,
+        boost::system::error_code& ec)
+{
+    auto fd = session.socket.native_handle();
+
+    session.request_frame = request;
+
+    session.ring->prepare_write_fixed(fd, &session.request_frame, sizeof(session.request_frame), 0, io_uring_write, true);
+    session.ring->prepare_read_fixed(fd, &session.answer_frame, sizeof(session.answer_frame), 1, io_uring_read, false);
+    session.ring->submit_and_wait(2);
+
+    // A failing write cancels the linked read.
+    std::int32_t written{-ECANCELED}, read{-ECANCELED};
+
+    session.ring->drain([&written, &read](std::uint64_t user_data, std::int32_t res, std::uint32_t)
+    {
+        if (user_data == io_uring_write)
+            written = res;
+        else if (user_data == io_uring_read)
+            read = res;
     });
+
+    auto frame = reinterpret_cast<char*>(&session.request_frame);
+    auto answer_frame = reinterpret_cast<char*>(&session.answer_frame);
+
+    if (written < 0)
+    {
+        ec = boost::system::error_code{-written, boost::system::system_category()};
+    } else if (static_cast<std::size_t>(written) < sizeof(session.request_frame))
+    {
+        // Short writes break the link, and we finish up synchronously.
+        boost::asio::write(session.socket, boost::asio::buffer(frame + written, sizeof(session.request_frame) - written), ec);
+
+        if (not ec)
+            boost::asio::read(session.socket, boost::asio::buffer(answer_frame, sizeof(session.answer_frame)), ec);
+    } else if (read < 0)
+    {
+        ec = boost::system::error_code{-read, boost::system::system_category()};
+    } else if (read == 0)
+    {
+        ec = boost::asio::error::eof;
+    } else if (static_cast<std::size_t>(read) < sizeof(session.answer_frame))
+    {
+        boost::asio::read(session.socket, boost::asio::buffer(answer_frame + read, sizeof(session.answer_frame) - read), ec);
+    }
+
+    if (not ec)
+        answer = session.answer_frame;
+}
+#endif
+
+void remote::posix::Stub::negotiate_shared_memory_rings(Session& session, boost::system::error_code& ec)
+{
+    session.shared_memory_negotiated = true;
+
+    auto requests = SharedMemoryRing::create(shared_memory_ring_capacity, sizeof(remote::posix::Request));
+    auto replies = SharedMemoryRing::create(shared_memory_ring_capacity, sizeof(core::trust::Request::Answer));
+
+    remote::posix::Request handshake
+    {
+        core::trust::Uid{0},
+        core::trust::Pid{0},
+        core::trust::Feature{0},
+        0,
+        shared_memory_handshake,
+        0
+    };
+
+    boost::asio::write(session.socket, boost::asio::buffer(&handshake, sizeof(handshake)), ec);
+
+    if (not ec)
+        send_fds(session.socket.native_handle(), {requests->memfd(), requests->doorbell(), replies->memfd(), replies->doorbell()}, ec);
+
+    core::trust::Request::Answer ack
+    {
+        core::trust::Request::Answer::denied
+    };
+
+    if (not ec)
+        boost::asio::read(session.socket, boost::asio::buffer(&ack, sizeof(ack)), ec);
+
+    // We keep on using the socket if the skeleton declined.
+    if (not ec && ack == core::trust::Request::Answer::granted)
+    {
+        session.requests = requests;
+        session.replies = replies;
+    }
+}
+
+void remote::posix::Stub::negotiate_revocation_channel(
+        trust::Uid uid,
+        const Session::Ptr& session,
+        boost::system::error_code& ec)
+{
+    session->revocations_negotiated = true;
+
+    boost::asio::local::stream_protocol::socket remote_end{io_service};
+    boost::asio::local::connect_pair(session->revocations, remote_end);
+
+    remote::posix::Request handshake
+    {
+        core::trust::Uid{0},
+        core::trust::Pid{0},
+        core::trust::Feature{0},
+        0,
+        revocation_handshake,
+        0
+    };
+
+    boost::asio::write(session->socket, boost::asio::buffer(&handshake, sizeof(handshake)), ec);
+
+    if (not ec)
+        send_fds(session->socket.native_handle(), {remote_end.native_handle()}, ec);
+
+    core::trust::Request::Answer ack
+    {
+        core::trust::Request::Answer::denied
+    };
+
+    if (not ec)
+        boost::asio::read(session->socket, boost::asio::buffer(&ack, sizeof(ack)), ec);
+
+    // We do not cache answers if the skeleton declined.
+    if (ec || ack != core::trust::Request::Answer::granted)
+    {
+        boost::system::error_code ignored;
+        session->revocations.close(ignored);
+        return;
+    }
+
+    start_read_revocations(decision_cache, uid, session);
+}
+
+void remote::posix::Stub::negotiate_decision_table(
+        trust::Uid uid,
+        Session& session,
+        boost::system::error_code& ec)
+{
+    session.decision_table_negotiated = true;
+
+    remote::posix::Request handshake
+    {
+        core::trust::Uid{0},
+        core::trust::Pid{0},
+        core::trust::Feature{0},
+        0,
+        decision_table_handshake,
+        0
+    };
+
+    boost::asio::write(session.socket, boost::asio::buffer(&handshake, sizeof(handshake)), ec);
+
+    core::trust::Request::Answer ack
+    {
+        core::trust::Request::Answer::denied
+    };
+
+    if (not ec)
+        boost::asio::read(session.socket, boost::asio::buffer(&ack, sizeof(ack)), ec);
+
+    // Skeletons not publishing decisions are asked for every request.
+    if (ec || ack != core::trust::Request::Answer::granted)
+        return;
+
+    try
+    {
+        auto fds = receive_fds(session.socket.native_handle(), 1);
+        session.decision_table = DecisionTable::attach(fds[0]);
+    } catch(const std::system_error& e)
+    {
+        ec = boost::system::error_code{e.code().value(), boost::system::system_category()};
+        return;
+    } catch(const std::exception&)
+    {
+        // We keep on asking the skeleton for every request.
+        return;
+    }
+
+    decision_tables.insert_or_assign(uid, session.decision_table);
+}
+
+bool remote::posix::Stub::lookup_published_decision(
+        trust::Uid uid,
+        const std::string& app_id,
+        trust::Feature feature,
+        core::trust::Request::Answer& answer) const
+{
+    if (not consult_decision_tables || app_id.empty())
+        return false;
+
+    auto table = decision_tables.try_resolve(uid);
+
+    if (not table)
+        return false;
+
+    return (*table)->lookup(app_id.data(), size_of_versionless_app_id(app_id), feature, answer);
+}
+
+void remote::posix::Stub::start_read_revocations(
+        const DecisionCache::Ptr& cache,
+        trust::Uid uid,
+        const Session::Ptr& session)
+{
+    boost::asio::async_read(
+                session->revocations,
+                boost::asio::buffer(&session->revocation, sizeof(session->revocation)),
+                [cache, uid, session](const boost::system::error_code& ec, std::size_t)
+                {
+                    if (ec)
+                    {
+                        // We cannot learn about revocations anymore and stop relying on the cache.
+                        cache->revoke(Revocation{uid, true, core::trust::Feature{}});
+                        return;
+                    }
+
+                    // Skeletons can only ever revoke decisions for the user they are running under.
+                    auto revocation = session->revocation;
+                    revocation.uid = uid;
+                    cache->revoke(revocation);
+
+                    start_read_revocations(cache, uid, session);
+                });
+}
+
+bool remote::posix::Stub::is_peer_gone(const boost::system::error_code& ec)
+{
+    switch (ec.value())
+    {
+    // We treat all the following errors as indications for the peer having gone away.
+    case boost::asio::error::basic_errors::access_denied:
+    case boost::asio::error::basic_errors::broken_pipe:
+    case boost::asio::error::basic_errors::connection_aborted:
+    case boost::asio::error::basic_errors::connection_refused:
+    case boost::asio::error::basic_errors::connection_reset:
+        return true;
+    default:
+        break;
+    }
+
+    // A peer closing its end of the socket surfaces as eof on reads.
+    return ec == boost::asio::error::eof;
+}
+
+bool remote::posix::Stub::has_session_for_uid(trust::Uid uid) const
+{
+    return session_registry->has_session_for_uid(uid);
+}
+
+remote::posix::Skeleton::Ptr remote::posix::Skeleton::create_skeleton_for_configuration(
+    const remote::posix::Skeleton::Configuration& configuration)
+{
+    remote::posix::Skeleton::Ptr skeleton
+    {
+        new remote::posix::Skeleton
+        {
+            configuration
+        }
+    };
+
+    skeleton->greet();
+    return skeleton;
+}
+
+remote::posix::Skeleton::Skeleton(const Configuration& configuration)
+    : core::trust::remote::Agent::Skeleton{configuration.impl},
+      process_identity_resolver{configuration.process_identity_resolver ?
+                                    configuration.process_identity_resolver :
+                                    helpers::pidfd_process_identity_resolver(configuration.start_time_resolver)},
+      app_id_resolver{configuration.app_id_resolver},
+      description_pattern{configuration.description_format},
+      verify_process_start_time{configuration.verify_process_start_time},
+      endpoint{configuration.endpoint},
+      socket{configuration.io_service},
+      doorbell{configuration.io_service},
+      revocations{configuration.io_service},
+      decision_table{configuration.decision_table},
+      ring_completions{configuration.io_service},
+      ring_completion_count{0},
+      reconnect_backoff(configuration.reconnect_backoff),
+      next_reconnect_backoff{configuration.reconnect_backoff.initial},
+      reconnect_timer{configuration.io_service},
+      jitter{std::random_device{}()}
+{
+    try
+    {
+        socket.connect(configuration.endpoint);
+    } catch(const boost::exception& e)
+    {
+        throw std::runtime_error
+        {
+            "Could not connect to endpoint: " + endpoint.path()
+        };
+    }
+
+#if defined(CORE_TRUST_HAVE_IO_URING)
+    if (configuration.io_backend == IoBackend::io_uring && IoUring::is_supported())
+    {
+        ring = IoUring::create(4);
+        ring->register_buffers(
+        {
+            {&request, sizeof(request)},
+            {&answer_frame, sizeof(answer_frame)}
+        });
+        notify_completions_via(ring, ring_completions);
+    }
+#endif
+}
+
+remote::posix::Skeleton::~Skeleton()
+{
+    // Stubs must not rely on the decisions we published anymore.
+    if (decision_table)
+        decision_table->retire();
+
+    boost::system::error_code ignored;
+    socket.cancel(ignored);
+    doorbell.cancel(ignored);
+    ring_completions.cancel(ignored);
+    reconnect_timer.cancel(ignored);
+}
+
+void remote::posix::Skeleton::revoke(const remote::Revocation& revocation)
+{
+    std::lock_guard<std::mutex> lg(revocation_guard);
+
+    if (not revocations.is_open())
+        return;
+
+    // Revocations carry padding, and we make sure to not leak uninitialized bytes.
+    remote::Revocation frame;
+    std::memset(static_cast<void*>(&frame), 0, sizeof(frame));
+    frame.uid = revocation.uid;
+    frame.all_features = revocation.all_features;
+    frame.feature = revocation.feature;
+
+    boost::system::error_code ec;
+    boost::asio::write(revocations, boost::asio::buffer(&frame, sizeof(frame)), ec);
+
+    // The stub drops all cached decisions once the channel breaks.
+    if (ec)
+        revocations.close(ec);
+}
+
+void remote::posix::Skeleton::greet()
+{
+    Hello ours{protocol_magic, protocol_version};
+
+    boost::system::error_code ec;
+    boost::asio::write(socket, boost::asio::buffer(&ours, sizeof(ours)), ec);
+
+    if (ec) { on_disconnected(); return; }
+
+    Ptr sp{shared_from_this()};
+
+    boost::asio::async_read(
+                socket,
+                boost::asio::buffer(&hello, sizeof(hello)),
+                [sp](const boost::system::error_code& ec, std::size_t)
+                {
+                    sp->on_greeted(ec);
+                });
+}
+
+void remote::posix::Skeleton::on_greeted(const boost::system::error_code& ec)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+
+    // The stub has gone away or the socket broke.
+    if (ec) { on_disconnected(); return; }
+
+    if (not is_compatible(hello))
+    {
+        // The stub does not speak our protocol, and we try again later in case it gets replaced.
+        boost::system::error_code ignored;
+        socket.close(ignored);
+
+        if (reconnect_backoff.initial.count() > 0)
+            schedule_reconnect();
+
+        return;
+    }
+
+    next_reconnect_backoff = reconnect_backoff.initial;
+    start_read();
+}
+
+void remote::posix::Skeleton::start_read()
+{
+#if defined(CORE_TRUST_HAVE_IO_URING)
+    if (ring)
+    {
+        ring->prepare_read_fixed(socket.native_handle(), &request, sizeof(request), 0, io_uring_read, false);
+        ring->submit_and_wait(0);
+
+        start_wait_for_io_uring_completions();
+        return;
+    }
+#endif
+
+    Ptr sp{shared_from_this()};
+
+    boost::asio::async_read(
+                socket,
+                boost::asio::buffer(&request, sizeof(request)),
+                [sp](const boost::system::error_code& ec, std::size_t size)
+                {
+                    sp->on_read_finished(ec, size);
+                });
+}
+
+void remote::posix::Skeleton::on_read_finished(const boost::system::error_code& ec, std::size_t size)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+
+    // The stub has gone away or the socket broke.
+    if (ec) { on_disconnected(); return; }
+
+    if (size != sizeof(request))
+        return;
+
+    try
+    {
+        // We drop the connection on malformed requests, failing the stub's request.
+        if (not dispatch_request()) { on_disconnected(); return; }
+    } catch(const boost::system::system_error&)
+    {
+        // Writing back the answer failed.
+        on_disconnected();
+        return;
+    }
+
+    // And restart reading.
+    start_read();
+}
+
+void remote::posix::Skeleton::on_disconnected()
+{
+    boost::system::error_code ignored;
+    socket.close(ignored);
+
+    // Shared-memory rings and revocation channels are bound to the connection
+    // they have been handed over on.
+    doorbell.close(ignored);
+    requests.reset();
+    replies.reset();
+
+    {
+        std::lock_guard<std::mutex> lg(revocation_guard);
+        revocations.close(ignored);
+    }
+
+    if (reconnect_backoff.initial.count() == 0)
+        return;
+
+    // The stub might be back already, and we try right away.
+    next_reconnect_backoff = reconnect_backoff.initial;
+    reconnect();
+}
+
+void remote::posix::Skeleton::reconnect()
+{
+    Ptr sp{shared_from_this()};
+
+    boost::system::error_code ignored;
+    socket.close(ignored);
+
+    socket.async_connect(
+                endpoint,
+                [sp](const boost::system::error_code& ec)
+                {
+                    sp->on_reconnect_finished(ec);
+                });
+}
+
+void remote::posix::Skeleton::schedule_reconnect()
+{
+    // We pick a delay in [backoff/2, backoff] to keep skeletons of multiple
+    // users from hitting a restarted stub all at once.
+    auto backoff = next_reconnect_backoff.count();
+    std::chrono::milliseconds delay
+    {
+        std::uniform_int_distribution<std::chrono::milliseconds::rep>{backoff / 2, backoff}(jitter)
+    };
+
+    next_reconnect_backoff = std::min(2 * next_reconnect_backoff, reconnect_backoff.maximum);
+
+    Ptr sp{shared_from_this()};
+
+    reconnect_timer.expires_from_now(delay);
+    reconnect_timer.async_wait([sp](const boost::system::error_code& ec)
+    {
+        if (ec == boost::asio::error::operation_aborted)
+            return;
+
+        sp->reconnect();
+    });
+}
+
+void remote::posix::Skeleton::on_reconnect_finished(const boost::system::error_code& ec)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+
+    if (ec) { schedule_reconnect(); return; }
+
+    greet();
+}
+
+bool remote::posix::Skeleton::dispatch_request()
+{
+    if (request.feature_count == shared_memory_handshake)
+    {
+        attach_to_shared_memory_rings();
+        return true;
+    }
+
+    if (request.feature_count == revocation_handshake)
+    {
+        attach_to_revocation_channel();
+        return true;
+    }
+
+    if (request.feature_count == decision_table_handshake)
+    {
+        hand_out_decision_table();
+        return true;
+    }
+
+    // We bail out on malformed requests.
+    if (request.feature_count == 0 || request.feature_count > max_features_per_request)
+        return false;
+
+    if (request.feature_count == 1)
+    {
+        auto answer = process_incoming_request(request);
+
+        // We send back our answer, we might throw here and just let the
+        // exception propagate through the stack.
+        boost::asio::write(socket, boost::asio::buffer(&answer, sizeof(answer)));
+    } else
+    {
+        std::vector<core::trust::Feature> features(request.feature_count);
+        features.front() = request.feature;
+
+        // The remaining features directly follow the request.
+        boost::asio::read(socket, boost::asio::buffer(features.data() + 1, sizeof(core::trust::Feature) * (features.size() - 1)));
+
+        auto answers = process_incoming_batch_request(request, features);
+
+        boost::asio::write(socket, boost::asio::buffer(answers.data(), sizeof(core::trust::Request::Answer) * answers.size()));
+    }
+
+    return true;
+}
+
+#if defined(CORE_TRUST_HAVE_IO_URING)
+void remote::posix::Skeleton::start_wait_for_io_uring_completions()
+{
+    Ptr sp{shared_from_this()};
+
+    ring_completions.async_read_some(
+                boost::asio::buffer(&ring_completion_count, sizeof(ring_completion_count)),
+                [sp](const boost::system::error_code& ec, std::size_t)
+                {
+                    sp->on_io_uring_completions(ec);
+                });
+}
+
+void remote::posix::Skeleton::on_io_uring_completions(const boost::system::error_code& ec)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+
+    bool read_completed{false};
+    std::int32_t read{0};
+
+    // A failing write of an answer cancels the linked read, and we
+    // learn about any issues from the read.
+    ring->drain([&read_completed, &read](std::uint64_t user_data, std::int32_t res, std::uint32_t)
+    {
+        if (user_data != io_uring_read)
+            return;
+
+        read_completed = true;
+        read = res;
+    });
+
+    if (not read_completed)
+    {
+        start_wait_for_io_uring_completions();
+        return;
+    }
+
+    // The peer has gone away or the socket broke.
+    if (read <= 0)
+    {
+        on_disconnected();
+        return;
+    }
+
+    try
+    {
+        // Short reads are completed synchronously.
+        if (static_cast<std::size_t>(read) < sizeof(request))
+            boost::asio::read(socket, boost::asio::buffer(reinterpret_cast<char*>(&request) + read, sizeof(request) - read));
+
+        if (request.feature_count == 1)
+        {
+            answer_frame = process_incoming_request(request);
+
+            // We link writing the answer with reading the next request, entering the kernel only once.
+            ring->prepare_write_fixed(socket.native_handle(), &answer_frame, sizeof(answer_frame), 1, io_uring_write, true);
+        } else if (not dispatch_request())
+        {
+            // We drop the connection on malformed requests, failing the stub's request.
+            on_disconnected();
+            return;
+        }
+    } catch(const boost::system::system_error&)
+    {
+        on_disconnected();
+        return;
+    }
+
+    start_read();
+}
+#endif
+
+std::string remote::posix::Skeleton::resolve_app_id_for_request(const core::trust::remote::posix::Request& request)
+{
+    if (not verify_process_start_time)
+        return app_id_resolver(request.app_pid);
+
+    // We first validate the process start time again.
+    auto identity = process_identity_resolver(request.app_pid);
+
+    if (identity->start_time() != request.app_start_time) throw std::runtime_error
+    {
+        "Potential spoofing detected on incoming request."
+    };
+
+    auto app_id = app_id_resolver(request.app_pid);
+
+    // The app id has to belong to the very process we validated.
+    if (not identity->is_alive()) throw std::runtime_error
+    {
+        "Potential spoofing detected on incoming request."
+    };
+
+    return app_id;
+}
+
+core::trust::Request::Answer remote::posix::Skeleton::process_incoming_request(const core::trust::remote::posix::Request& request)
+{
+    // We are called from io_service handlers, and failing to resolve the app id or to
+    // obtain an answer from the user must neither escape nor leave the stub waiting.
+    try
+    {
+        auto app_id = resolve_app_id_for_request(request);
+
+        // And reach out to the user.
+        return authenticate_request_with_parameters(core::trust::Agent::RequestParameters
+        {
+            request.app_uid,
+            request.app_pid,
+            app_id,
+            request.feature,
+            description_pattern
+        });
+    } catch(const std::exception&)
+    {
+        return core::trust::Request::Answer::denied;
+    }
+}
+
+std::vector<core::trust::Request::Answer> remote::posix::Skeleton::process_incoming_batch_request(
+        const core::trust::remote::posix::Request& request,
+        const std::vector<core::trust::Feature>& features)
+{
+    core::trust::Agent::BatchAnswer answers;
+
+    // Just like for single requests, failures deny all features.
+    try
+    {
+        auto app_id = resolve_app_id_for_request(request);
+
+        // And reach out to the user, once for all features.
+        answers = authenticate_batch_request_with_parameters(core::trust::Agent::BatchRequestParameters
+        {
+            {
+                request.app_uid,
+                request.app_pid,
+                app_id
+            },
+            {
+                features.begin(),
+                features.end()
+            },
+            description_pattern
+        });
+    } catch(const std::exception&)
+    {
+        answers.clear();
+    }
+
+    std::vector<core::trust::Request::Answer> result;
+    for (const auto& feature : features)
+    {
+        // Features that the agent did not answer for are denied.
+        auto it = answers.find(feature);
+        result.push_back(it != answers.end() ? it->second : core::trust::Request::Answer::denied);
+    }
+
+    return result;
+}
+
+void remote::posix::Skeleton::attach_to_shared_memory_rings()
+{
+    core::trust::Request::Answer ack
+    {
+        core::trust::Request::Answer::denied
+    };
+
+    // We need the fds to stay in sync with the stream, and always try to receive them.
+    // A stub is only expected to hand over rings once, though.
+    try
+    {
+        auto fds = receive_fds(socket.native_handle(), fds_per_shared_memory_handshake);
+
+        auto request_ring = SharedMemoryRing::attach(fds[0], fds[1], sizeof(posix::Request));
+        auto reply_ring = SharedMemoryRing::attach(fds[2], fds[3], sizeof(core::trust::Request::Answer));
+
+        if (not requests)
+        {
+            requests = request_ring;
+            replies = reply_ring;
+            doorbell.assign(::dup(requests->doorbell()));
+
+            ack = core::trust::Request::Answer::granted;
+        }
+    } catch(const std::exception&)
+    {
+        // We decline and the stub keeps on using the socket.
+    }
+
+    boost::asio::write(socket, boost::asio::buffer(&ack, sizeof(ack)));
+
+    if (ack == core::trust::Request::Answer::granted)
+        serve_shared_memory_requests();
+}
+
+void remote::posix::Skeleton::attach_to_revocation_channel()
+{
+    core::trust::Request::Answer ack
+    {
+        core::trust::Request::Answer::denied
+    };
+
+    // We need the fds to stay in sync with the stream, and always try to receive them.
+    try
+    {
+        auto fds = receive_fds(socket.native_handle(), 1);
+
+        std::lock_guard<std::mutex> lg(revocation_guard);
+
+        if (revocations.is_open())
+        {
+            ::close(fds[0]);
+        } else
+        {
+            revocations.assign(boost::asio::local::stream_protocol{}, fds[0]);
+            ack = core::trust::Request::Answer::granted;
+        }
+    } catch(const std::exception&)
+    {
+        // We decline and the stub does not cache our answers.
+    }
+
+    boost::asio::write(socket, boost::asio::buffer(&ack, sizeof(ack)));
+}
+
+void remote::posix::Skeleton::hand_out_decision_table()
+{
+    core::trust::Request::Answer ack
+    {
+        decision_table ? core::trust::Request::Answer::granted : core::trust::Request::Answer::denied
+    };
+
+    boost::asio::write(socket, boost::asio::buffer(&ack, sizeof(ack)));
+
+    if (ack != core::trust::Request::Answer::granted)
+        return;
+
+    boost::system::error_code ec;
+    send_fds(socket.native_handle(), {decision_table->memfd()}, ec);
+
+    if (ec) throw boost::system::system_error{ec};
+}
+
+void remote::posix::Skeleton::serve_shared_memory_requests()
+{
+    posix::Request request{};
+
+    do
+    {
+        while (requests->try_pop(&request))
+        {
+            // Malformed requests are denied, we have to answer every request in order.
+            auto answer = request.feature_count == 1 ?
+                        process_incoming_request(request) :
+                        core::trust::Request::Answer::denied;
+
+            // The stub only ever has one request in flight, and the reply ring cannot be full.
+            replies->try_push(&answer);
+        }
+    } while (not requests->prepare_to_wait());
+
+    Ptr sp{shared_from_this()};
+
+    doorbell.async_read_some(
+                boost::asio::null_buffers(),
+                [sp](const boost::system::error_code& ec, std::size_t)
+                {
+                    sp->on_shared_memory_doorbell(ec);
+                });
+}
+
+void remote::posix::Skeleton::on_shared_memory_doorbell(const boost::system::error_code& ec)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+
+    requests->finish_wait();
+
+    serve_shared_memory_requests();
 }
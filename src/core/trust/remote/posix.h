@@ -19,8 +19,13 @@
 #ifndef CORE_TRUST_REMOTE_POSIX_H_
 #define CORE_TRUST_REMOTE_POSIX_H_
 
+#include <core/trust/copy_on_write_map.h>
 #include <core/trust/remote/agent.h>
+#include <core/trust/remote/decision_cache.h>
+#include <core/trust/remote/decision_table.h>
 #include <core/trust/remote/helpers.h>
+#include <core/trust/remote/io_uring.h>
+#include <core/trust/remote/shared_memory_ring.h>
 
 #include <core/posix/process.h>
 #include <core/posix/linux/proc/process/stat.h>
@@ -31,9 +36,14 @@
 #include <boost/bind.hpp>
 #include <boost/format.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
 #include <functional>
 #include <mutex>
+#include <random>
+#include <vector>
 
 namespace core
 {
@@ -59,6 +69,76 @@ struct CORE_TRUST_DLL_PUBLIC Request
     // We want to prevent from spoofing and send over the process start time.
     // In seconds since the epoch.
     std::int64_t app_start_time;
+    // The number of features covered by the request. For batch requests, feature
+    // carries the first feature and the remaining feature_count - 1 features follow
+    // the request on the wire. The answers are sent back in the same order.
+    std::uint32_t feature_count;
+    // Spells out the padding of the frame, always zero.
+    std::uint32_t reserved;
+};
+
+// Greets the peer of a freshly established connection. The skeleton sends its Hello right
+// after connecting, and the stub answers with its own Hello once it accepted the skeleton's.
+// Either side closes the connection if magic or version do not match. Peers speaking an
+// older protocol do not greet, and the stub closes their connection after a timeout.
+struct CORE_TRUST_DLL_PUBLIC Hello
+{
+    // Tells our protocol from others, always protocol_magic.
+    std::uint32_t magic;
+    // The version of the protocol spoken by the sender, always protocol_version.
+    std::uint32_t version;
+};
+
+// Identifies the protocol, "TRST" in little-endian order. It is chosen to not read as
+// Answer::granted, for older stubs that mistake the Hello for an answer.
+constexpr const std::uint32_t protocol_magic{0x54535254};
+
+// The version of the protocol described here. Bumped whenever the layout of a frame
+// or the meaning of a control request changes.
+constexpr const std::uint32_t protocol_version{2};
+
+// The maximum number of features that a single request might cover.
+constexpr const std::uint32_t max_features_per_request{1024};
+
+// A request with this feature count is a control request handing over a pair of
+// shared-memory rings. It is followed by a single byte carrying the memfd and the
+// doorbell of the request ring and of the reply ring as SCM_RIGHTS, in that order.
+// The skeleton acknowledges with Answer::granted if it attached to the rings, and
+// single-feature requests are exchanged via the rings from then on.
+constexpr const std::uint32_t shared_memory_handshake{0xffffffff};
+
+// A request with this feature count is a control request handing over one end of a
+// socket pair. It is followed by a single byte carrying the socket as SCM_RIGHTS. The
+// skeleton acknowledges with Answer::granted and sends Revocation frames over the socket
+// from then on, whenever decisions change on its side.
+constexpr const std::uint32_t revocation_handshake{0xfffffffe};
+
+// A request with this feature count is a control request asking for the decisions
+// published by the skeleton. The skeleton replies with Answer::granted followed by a
+// single byte carrying the memfd of its DecisionTable as SCM_RIGHTS, or with
+// Answer::denied if it does not publish decisions.
+constexpr const std::uint32_t decision_table_handshake{0xfffffffd};
+
+// The backend driving socket io for stubs and skeletons.
+enum class IoBackend
+{
+    // boost::asio's reactor, issuing one syscall per accept, read and write.
+    asio,
+    // io_uring, accepting connections with a multishot accept and exchanging requests
+    // with linked writes and reads on registered buffers. Falls back to asio if the
+    // kernel lacks support, or if the kernel headers lacked it at build time.
+    io_uring
+};
+
+// Bounds the jittered, exponential backoff between attempts of a skeleton to
+// reconnect to its stub after the connection broke.
+struct CORE_TRUST_DLL_PUBLIC ReconnectBackoff
+{
+    // The delay before the second attempt, doubled for every subsequent attempt.
+    // A zero delay disables reconnecting.
+    std::chrono::milliseconds initial;
+    // The upper bound of the delay between two attempts.
+    std::chrono::milliseconds maximum;
 };
 
 // Models the sending end of a remote agent, meant to be used by trusted helpers.
@@ -88,7 +168,10 @@ public:
         // Just for convenience
         typedef std::shared_ptr<Session> Ptr;
 
-        // A fancy map implementing the monitor pattern.
+        // A fancy map optimized for lookups: Readers access an immutable snapshot
+        // without locking, modifications are serialized and copy the map.
+        // A user id maps to all sessions established by skeletons running under
+        // that user id, and requests are balanced across them.
         // All functions in this class are thread-safe, but _not_ reentrant.
         class Registry
         {
@@ -101,19 +184,28 @@ public:
             // Returns true iff the registry instance contains a session for the given user id.
             virtual bool has_session_for_uid(Uid uid) const;
 
-            // Adds the given session for the given uid to the registry.
+            // Adds the given session to the sessions known for the given uid.
             virtual void add_session_for_uid(Uid uid, Session::Ptr session);
 
-            // Removes the session instance for the given user id.
+            // Removes all session instances for the given user id.
             virtual void remove_session_for_uid(Uid uid);
 
-            // Queries the session for the given user id.
+            // Removes the given session instance for the given user id.
+            virtual void remove_session_for_uid(Uid uid, const Session::Ptr& session);
+
+            // Queries the least-loaded, healthy session for the given user id.
             // Throws std::out_of_range if no session is known for the user id.
             virtual Session::Ptr resolve_session_for_uid(Uid uid);
 
+            // Queries the least-loaded, healthy session for the given user id, returning
+            // an empty optional if no session is known for the user id.
+            virtual boost::optional<Session::Ptr> try_resolve_session_for_uid(Uid uid);
+
+            // Returns all healthy sessions for the given user id, ordered by ascending load.
+            virtual std::vector<Session::Ptr> resolve_sessions_for_uid_by_load(Uid uid);
+
         private:
-            mutable std::mutex guard;
-            std::map<core::trust::Uid, Session::Ptr> sessions;
+            CopyOnWriteMap<core::trust::Uid, std::vector<Session::Ptr>> sessions;
         };
 
         // Creates a new session.
@@ -123,6 +215,31 @@ public:
         boost::asio::local::stream_protocol::socket socket;
         // We have to synchronize requests per session.
         std::mutex lock;
+        // The number of requests currently assigned to the session, including queued ones.
+        std::atomic<std::size_t> in_flight{0};
+        // Set to false once a socket operation indicated that the peer has gone away.
+        std::atomic<bool> healthy{true};
+        // Set to true once we tried to hand over shared-memory rings.
+        bool shared_memory_negotiated{false};
+        // Rings carrying requests to and replies from the skeleton, if negotiated successfully.
+        SharedMemoryRing::Ptr requests;
+        SharedMemoryRing::Ptr replies;
+        // The io_uring instance handling the socket if the io_uring backend is enabled,
+        // with request_frame and answer_frame registered as buffers 0 and 1.
+        IoUring::Ptr ring;
+        posix::Request request_frame;
+        core::trust::Request::Answer answer_frame;
+        // Set to true once we tried to set up a channel for revocations.
+        bool revocations_negotiated{false};
+        // Carries revocations from the skeleton if set up successfully, answers
+        // obtained via the session are only cached in that case.
+        boost::asio::local::stream_protocol::socket revocations;
+        // The revocation that we read into.
+        Revocation revocation;
+        // Set to true once we asked for the decisions published by the skeleton.
+        bool decision_table_negotiated{false};
+        // The decisions published by the skeleton, if any.
+        DecisionTable::Ptr decision_table;
     };
 
     // All creation time arguments go here.
@@ -138,6 +255,24 @@ public:
         PeerCredentialsResolver peer_credentials_resolver;
         // A synchronized registry of all known sessions.
         Session::Registry::Ptr session_registry;
+        // If non-zero, single-feature requests are exchanged via shared-memory rings with
+        // the given number of slots, falling back to the socket if a skeleton declines.
+        std::uint32_t shared_memory_ring_capacity;
+        // Helper to pin down requesting processes during authentication. If empty,
+        // helpers::pidfd_process_identity_resolver(start_time_resolver) is used.
+        helpers::ProcessIdentityResolver process_identity_resolver;
+        // The backend for accepting connections and exchanging requests.
+        IoBackend io_backend;
+        // Requests for a user id without a healthy session wait up to the given
+        // period for a skeleton to (re-)connect before failing.
+        std::chrono::milliseconds reconnect_grace_period;
+        // If set, answers are cached and repeated requests of a process are answered
+        // locally until the answer expires or a skeleton revokes it.
+        DecisionCache::Ptr decision_cache;
+        // If true, requests carrying an application id are answered from the decisions
+        // published by skeletons if possible, without a round trip. Callers vouch for the
+        // application id in that case, instead of the skeleton resolving it.
+        bool consult_decision_tables;
     };
 
     // Creates a stub instance for the given configuration.
@@ -151,6 +286,11 @@ public:
     // From core::trust::remote::Agent::Stub.
     core::trust::Request::Answer send(const core::trust::Agent::RequestParameters& parameters) override;
 
+    // From core::trust::remote::Agent::Stub.
+    // Sends out all features in a single request, throws std::runtime_error if
+    // the request covers more than max_features_per_request features.
+    BatchAnswer send_batch(const core::trust::Agent::BatchRequestParameters& parameters) override;
+
     // For testing purposes
     bool has_session_for_uid(Uid uid) const;
 
@@ -166,9 +306,76 @@ private:
     // Called in case of an incoming connection.
     void on_new_session(const boost::system::error_code& ec, const Session::Ptr& session);
 
-    // Interprets the given error code, carrying out maintenance on the Session::Registry
-    // before rethrowing as a std::system_error.
-    void handle_error_from_socket_operation_for_uid(const boost::system::error_code& ec, Uid uid);
+    // Waits for the Hello of the skeleton on a freshly accepted session, and
+    // registers the session if the skeleton speaks our protocol.
+    void await_hello(const Session::Ptr& session);
+
+    // Sets up and registers a freshly accepted session, answering with our Hello.
+    void register_session(const Session::Ptr& session);
+
+    // Queues up an accept on the io_uring instance and waits for completions.
+    void start_accept_via_io_uring(bool rearm);
+
+    // Called whenever accepts submitted to the io_uring instance completed.
+    void on_io_uring_accept_completions(const boost::system::error_code& ec);
+
+    // Invokes exchange for the least-loaded session for uid, with the session locked.
+    // Fails over to the next session if the peer has gone away, and replays the request
+    // on sessions registered within the reconnect grace period. Throws std::out_of_range
+    // if no session is known for uid and std::system_error if communication failed on
+    // all sessions.
+    void transact_with_session_for_uid(
+            Uid uid,
+            const std::function<void(Session&, boost::system::error_code&)>& exchange);
+
+    // Waits until a healthy session is known for uid or until deadline passed,
+    // returning true in the former case.
+    bool wait_for_session_for_uid(Uid uid, const std::chrono::steady_clock::time_point& deadline);
+
+    // Writes out request and reads the reply via the session's socket.
+    static void exchange_via_socket(
+            Session& session,
+            const std::vector<boost::asio::const_buffer>& request,
+            const boost::asio::mutable_buffer& reply,
+            boost::system::error_code& ec);
+
+    // Pushes request to the session's request ring and waits for the answer on the
+    // reply ring, watching the socket for the peer going away.
+    static void exchange_via_shared_memory(
+            Session& session,
+            const posix::Request& request,
+            core::trust::Request::Answer& answer,
+            boost::system::error_code& ec);
+
+    // Writes out request and reads the answer via the session's io_uring instance,
+    // linking the read to the write and entering the kernel only once.
+    static void exchange_via_io_uring(
+            Session& session,
+            const posix::Request& request,
+            core::trust::Request::Answer& answer,
+            boost::system::error_code& ec);
+
+    // Hands over a pair of freshly created shared-memory rings to the session's peer.
+    void negotiate_shared_memory_rings(Session& session, boost::system::error_code& ec);
+
+    // Hands over one end of a socket pair to the session's peer for sending
+    // revocations concerning uid, and starts reading from the other end.
+    void negotiate_revocation_channel(Uid uid, const Session::Ptr& session, boost::system::error_code& ec);
+
+    // Asks the session's peer for the decisions it publishes, and makes them
+    // available to requests for uid.
+    void negotiate_decision_table(Uid uid, Session& session, boost::system::error_code& ec);
+
+    // Returns true and the answer published for app_id and feature by a skeleton running
+    // under uid in answer. Does not enter the kernel.
+    bool lookup_published_decision(Uid uid, const std::string& app_id, Feature feature, core::trust::Request::Answer& answer) const;
+
+    // Reads the next revocation concerning uid from session's revocation channel,
+    // applying it to cache. Revokes all decisions for uid if the channel broke.
+    static void start_read_revocations(const DecisionCache::Ptr& cache, Uid uid, const Session::Ptr& session);
+
+    // Returns true if the given error code indicates that the peer has gone away.
+    static bool is_peer_gone(const boost::system::error_code& ec);
 
     // The io dispatcher that this instance is associated with.
     boost::asio::io_service& io_service;
@@ -177,12 +384,33 @@ private:
     // The acceptor object for handling incoming connection requests.
     boost::asio::local::stream_protocol::acceptor acceptor;
 
-    // Helper to map pid -> process start time.
-    helpers::ProcessStartTimeResolver start_time_resolver;
+    // Helper to pin down requesting processes.
+    helpers::ProcessIdentityResolver process_identity_resolver;
     // Helper for resolving a socket's peer's credentials.
     PeerCredentialsResolver peer_credentials_resolver;
     // A synchronized registry of all known sessions.
     Session::Registry::Ptr session_registry;
+    // The number of slots of shared-memory rings, 0 if disabled.
+    std::uint32_t shared_memory_ring_capacity;
+    // The io_uring instance accepting connections if the io_uring backend is enabled.
+    IoUring::Ptr accept_ring;
+    // Signaled for completions of accept_ring.
+    boost::asio::posix::stream_descriptor accept_completions;
+    // The counter of accept_completions that we read into.
+    std::uint64_t accept_completion_count;
+    // Whether the kernel supports multishot accepts.
+    bool multishot_accept;
+    // The period that requests wait for skeletons to (re-)connect.
+    std::chrono::milliseconds reconnect_grace_period;
+    // Caches answers if set.
+    DecisionCache::Ptr decision_cache;
+    // Whether we consult the decisions published by skeletons.
+    bool consult_decision_tables;
+    // The decisions published by skeletons, by the user id they are running under.
+    CopyOnWriteMap<Uid, DecisionTable::Ptr> decision_tables;
+    // Guards session registration, signaling session_registered.
+    std::mutex registration_guard;
+    std::condition_variable session_registered;
 };
 
 // Models the receiving end of a remote agent, meant to be used by the trust store daemon.
@@ -214,30 +442,103 @@ public:
         // process start times. This causes issues for the case of crossing the
         // Android/Ubuntu boundary and we have to make it configurable.
         bool verify_process_start_time;
+        // Helper to pin down requesting processes when verifying process start times. If
+        // empty, helpers::pidfd_process_identity_resolver(start_time_resolver) is used.
+        helpers::ProcessIdentityResolver process_identity_resolver;
+        // The backend for reading requests and writing answers.
+        IoBackend io_backend;
+        // Backoff applied when reconnecting to the stub after the connection broke.
+        ReconnectBackoff reconnect_backoff;
+        // If set, handed out to stubs asking for the decisions that we publish.
+        DecisionTable::Ptr decision_table;
     };
 
     static Ptr create_skeleton_for_configuration(const Configuration& configuration);
 
     virtual ~Skeleton();
 
+    // From core::trust::remote::Agent::Skeleton.
+    // Sends revocation to the stub if it handed over a revocation channel.
+    // The uid is filled in by the stub from the credentials of our connection.
+    void revoke(const Revocation& revocation) override;
+
 private:
     // Constructs a new Skeleton instance, installing impl for handling actual requests.
     Skeleton(const Configuration& configuration);
 
+    // Sends our Hello to the stub and waits for the stub's Hello before reading requests.
+    void greet();
+
+    // Called whenever the stub's Hello has been read.
+    void on_greeted(const boost::system::error_code& ec);
+
     // Called to initiate an async read operation.
     void start_read();
 
+    // Tears down the broken connection and schedules reconnecting
+    // to the stub, if configured to do so.
+    void on_disconnected();
+
+    // Attempts to reconnect to the stub asynchronously.
+    void reconnect();
+
+    // Schedules the next attempt to reconnect, applying jittered backoff.
+    void schedule_reconnect();
+
+    // Called whenever an attempt to reconnect to the stub finished.
+    void on_reconnect_finished(const boost::system::error_code& ec);
+
     // Called whenever a read operation from the socket finishes.
     void on_read_finished(const boost::system::error_code& ec, std::size_t size);
 
+    // Handles the request that has just been read, writing back the answer.
+    // Returns false if the request was malformed and we should drop the connection.
+    bool dispatch_request();
+
+    // Waits for completions of the io_uring instance.
+    void start_wait_for_io_uring_completions();
+
+    // Called whenever submissions to the io_uring instance completed.
+    void on_io_uring_completions(const boost::system::error_code& ec);
+
+    // Resolves the app id of the process issuing request, validating the
+    // process start time if configured to do so.
+    std::string resolve_app_id_for_request(const posix::Request& request);
+
     // Handles an incoming request, reaching out to the super class implementation
-    // to obtain an answer to the trust request.
+    // to obtain an answer to the trust request. Never throws, but denies requests
+    // that the app id cannot be resolved or no answer can be obtained for.
     core::trust::Request::Answer process_incoming_request(const posix::Request& request);
 
+    // Handles an incoming batch request covering the given features, returning
+    // the answers in the order of features. Never throws, just like process_incoming_request.
+    std::vector<core::trust::Request::Answer> process_incoming_batch_request(
+            const posix::Request& request,
+            const std::vector<core::trust::Feature>& features);
+
+    // Receives and attaches to the shared-memory rings following a handshake request,
+    // replying with whether we attached successfully.
+    void attach_to_shared_memory_rings();
+
+    // Receives the revocation channel following a handshake request,
+    // replying with whether we accepted it.
+    void attach_to_revocation_channel();
+
+    // Hands out our decision table following a handshake request, if any.
+    void hand_out_decision_table();
+
+    // Handles all requests pending in the request ring and waits for the doorbell.
+    void serve_shared_memory_requests();
+
+    // Called whenever the doorbell of the request ring has been rung.
+    void on_shared_memory_doorbell(const boost::system::error_code& ec);
+
     // Request object that we read into.
     posix::Request request;
-    // Helper for resolving pid -> start time.
-    helpers::ProcessStartTimeResolver start_time_resolver;
+    // The Hello of the stub that we read into.
+    Hello hello;
+    // Helper for pinning down requesting processes.
+    helpers::ProcessIdentityResolver process_identity_resolver;
     // Helper for resolving pid -> application id.
     helpers::AppIdResolver app_id_resolver;
     // Pattern for assembling the prompt dialog's description given
@@ -251,6 +552,34 @@ private:
     boost::asio::local::stream_protocol::endpoint endpoint;
     // The actual socket for communication with the service.
     boost::asio::local::stream_protocol::socket socket;
+    // Rings carrying requests from and replies to the stub, if handed over by the stub.
+    SharedMemoryRing::Ptr requests;
+    SharedMemoryRing::Ptr replies;
+    // Watches the doorbell of the request ring.
+    boost::asio::posix::stream_descriptor doorbell;
+    // Guards revocations, revoke might be called from arbitrary threads.
+    std::mutex revocation_guard;
+    // Carries revocations to the stub, if handed over by the stub.
+    boost::asio::local::stream_protocol::socket revocations;
+    // The decisions we publish to the stub, if any.
+    DecisionTable::Ptr decision_table;
+    // The io_uring instance handling the socket if the io_uring backend is enabled,
+    // with request and answer_frame registered as buffers 0 and 1.
+    IoUring::Ptr ring;
+    // The answer we write back via ring.
+    core::trust::Request::Answer answer_frame;
+    // Signaled for completions of ring.
+    boost::asio::posix::stream_descriptor ring_completions;
+    // The counter of ring_completions that we read into.
+    std::uint64_t ring_completion_count;
+    // Bounds of the delay between attempts to reconnect.
+    ReconnectBackoff reconnect_backoff;
+    // The delay before the next attempt to reconnect.
+    std::chrono::milliseconds next_reconnect_backoff;
+    // Fires for delayed attempts to reconnect.
+    boost::asio::steady_timer reconnect_timer;
+    // Source of randomness for jittering the backoff.
+    std::minstd_rand jitter;
 };
 }
 }
@@ -0,0 +1,258 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/remote/shared_memory_ring.h>
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MFD_CLOEXEC
+#include <linux/memfd.h>
+#endif
+
+namespace remote = core::trust::remote;
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "Shared-memory rings require lock-free atomics.");
+
+struct remote::posix::SharedMemoryRing::Header
+{
+    // Marks the memory as a trust-store ring.
+    static constexpr const std::uint32_t expected_magic{0x74727374};
+
+    std::uint32_t magic;
+    std::uint32_t slot_count;
+    std::uint32_t slot_size;
+    // The next slot to write to, only modified by the producer.
+    alignas(64) std::atomic<std::uint32_t> head;
+    // The next slot to read from, only modified by the consumer.
+    alignas(64) std::atomic<std::uint32_t> tail;
+    // Set to 1 by the consumer before blocking on the doorbell.
+    alignas(64) std::atomic<std::uint32_t> consumer_waiting;
+};
+
+namespace
+{
+std::system_error last_system_error()
+{
+    return std::system_error{errno, std::system_category()};
+}
+
+std::uint32_t round_up_to_power_of_two(std::uint32_t value)
+{
+    std::uint32_t result{1};
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+}
+
+remote::posix::SharedMemoryRing::Ptr remote::posix::SharedMemoryRing::create(std::uint32_t slot_count, std::uint32_t slot_size)
+{
+    if (slot_count == 0 || slot_count > max_slot_count || slot_size == 0) throw std::runtime_error
+    {
+        "Invalid geometry for shared-memory ring."
+    };
+
+    slot_count = round_up_to_power_of_two(slot_count);
+    auto size = sizeof(Header) + std::size_t{slot_count} * slot_size;
+
+    int memfd = ::syscall(SYS_memfd_create, "trust-store-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd == -1)
+        throw last_system_error();
+
+    // Sealing the size prevents the peer from truncating the memory under our feet.
+    if (::ftruncate(memfd, size) == -1 || ::fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == -1)
+    {
+        auto error = last_system_error();
+        ::close(memfd);
+        throw error;
+    }
+
+    int doorbell = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (doorbell == -1)
+    {
+        auto error = last_system_error();
+        ::close(memfd);
+        throw error;
+    }
+
+    auto base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    if (base == MAP_FAILED)
+    {
+        auto error = last_system_error();
+        ::close(memfd); ::close(doorbell);
+        throw error;
+    }
+
+    auto header = new (base) Header;
+    header->magic = Header::expected_magic;
+    header->slot_count = slot_count;
+    header->slot_size = slot_size;
+    header->head = 0;
+    header->tail = 0;
+    header->consumer_waiting = 0;
+
+    return Ptr{new SharedMemoryRing{memfd, doorbell, base, size, slot_count, slot_size}};
+}
+
+remote::posix::SharedMemoryRing::Ptr remote::posix::SharedMemoryRing::attach(int memfd, int doorbell, std::uint32_t slot_size)
+{
+    auto fail = [memfd, doorbell](const std::string& what) -> std::runtime_error
+    {
+        ::close(memfd); ::close(doorbell);
+        return std::runtime_error{"Cannot attach to shared-memory ring: " + what};
+    };
+
+    // We only ever map memory that cannot shrink anymore.
+    auto seals = ::fcntl(memfd, F_GET_SEALS);
+    if (seals == -1 || (seals & F_SEAL_SHRINK) == 0)
+        throw fail("memory is not sealed against shrinking");
+
+    struct stat st;
+    if (::fstat(memfd, &st) == -1 || st.st_size < static_cast<off_t>(sizeof(Header)))
+        throw fail("memory too small");
+
+    std::size_t size = st.st_size;
+
+    auto base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    if (base == MAP_FAILED)
+        throw fail(std::strerror(errno));
+
+    auto header = static_cast<Header*>(base);
+    auto slot_count = header->slot_count;
+
+    bool valid = header->magic == Header::expected_magic
+            && header->slot_size == slot_size
+            && slot_count > 0 && slot_count <= max_slot_count
+            && (slot_count & (slot_count - 1)) == 0
+            && size >= sizeof(Header) + std::size_t{slot_count} * slot_size;
+
+    if (not valid)
+    {
+        ::munmap(base, size);
+        throw fail("invalid header");
+    }
+
+    // The doorbell has to be non-blocking for finish_wait to work.
+    ::fcntl(doorbell, F_SETFL, ::fcntl(doorbell, F_GETFL) | O_NONBLOCK);
+
+    return Ptr{new SharedMemoryRing{memfd, doorbell, base, size, slot_count, slot_size}};
+}
+
+remote::posix::SharedMemoryRing::SharedMemoryRing(int memfd, int doorbell, void* base, std::size_t size, std::uint32_t slot_count, std::uint32_t slot_size)
+    : memfd_{memfd},
+      doorbell_{doorbell},
+      base{base},
+      size{size},
+      slot_count_{slot_count},
+      slot_size{slot_size},
+      header{static_cast<Header*>(base)}
+{
+}
+
+remote::posix::SharedMemoryRing::~SharedMemoryRing()
+{
+    ::munmap(base, size);
+    ::close(memfd_);
+    ::close(doorbell_);
+}
+
+bool remote::posix::SharedMemoryRing::try_push(const void* data)
+{
+    auto head = header->head.load(std::memory_order_relaxed);
+    auto tail = header->tail.load(std::memory_order_acquire);
+
+    if (head - tail >= slot_count_)
+        return false;
+
+    std::memcpy(slot(head), data, slot_size);
+
+    // Publishing the slot and checking for a waiting consumer has to be
+    // sequentially consistent, pairing up with prepare_to_wait.
+    header->head.store(head + 1, std::memory_order_seq_cst);
+
+    if (header->consumer_waiting.load(std::memory_order_seq_cst))
+    {
+        static const std::uint64_t ring{1};
+        // The counter cannot realistically overflow, and we ignore the result.
+        if (::write(doorbell_, &ring, sizeof(ring)) != sizeof(ring)) {}
+    }
+
+    return true;
+}
+
+bool remote::posix::SharedMemoryRing::try_pop(void* data)
+{
+    auto tail = header->tail.load(std::memory_order_relaxed);
+    auto head = header->head.load(std::memory_order_acquire);
+
+    if (tail == head)
+        return false;
+
+    std::memcpy(data, slot(tail), slot_size);
+    header->tail.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool remote::posix::SharedMemoryRing::prepare_to_wait()
+{
+    header->consumer_waiting.store(1, std::memory_order_seq_cst);
+
+    if (header->head.load(std::memory_order_seq_cst) == header->tail.load(std::memory_order_relaxed))
+        return true;
+
+    header->consumer_waiting.store(0, std::memory_order_relaxed);
+    return false;
+}
+
+void remote::posix::SharedMemoryRing::finish_wait()
+{
+    header->consumer_waiting.store(0, std::memory_order_relaxed);
+
+    std::uint64_t rings{0};
+    // The doorbell is non-blocking, and we do not care whether it has been rung or not.
+    if (::read(doorbell_, &rings, sizeof(rings)) != sizeof(rings)) {}
+}
+
+int remote::posix::SharedMemoryRing::memfd() const
+{
+    return memfd_;
+}
+
+int remote::posix::SharedMemoryRing::doorbell() const
+{
+    return doorbell_;
+}
+
+std::uint32_t remote::posix::SharedMemoryRing::slot_count() const
+{
+    return slot_count_;
+}
+
+unsigned char* remote::posix::SharedMemoryRing::slot(std::uint32_t index)
+{
+    return static_cast<unsigned char*>(base) + sizeof(Header) + std::size_t{index & (slot_count_ - 1)} * slot_size;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_TRUST_REMOTE_SHARED_MEMORY_RING_H_
+#define CORE_TRUST_REMOTE_SHARED_MEMORY_RING_H_
+
+#include <core/trust/visibility.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace core
+{
+namespace trust
+{
+namespace remote
+{
+namespace posix
+{
+// A SharedMemoryRing is a lock-free, single-producer/single-consumer queue of
+// fixed-size slots living in a sealed memfd. An eventfd serves as doorbell and is
+// only rung if the consumer announced that it is about to block. Both fds can be
+// handed over to another process that then attaches to the very same ring.
+class CORE_TRUST_DLL_PUBLIC SharedMemoryRing
+{
+public:
+    // Just for convenience
+    typedef std::shared_ptr<SharedMemoryRing> Ptr;
+
+    // The maximum number of slots that a ring might hold.
+    static constexpr const std::uint32_t max_slot_count{1 << 16};
+
+    // Creates a new ring with slot_count slots of slot_size bytes each. slot_count is
+    // rounded up to the next power of two. Throws std::system_error in case of issues.
+    static Ptr create(std::uint32_t slot_count, std::uint32_t slot_size);
+
+    // Attaches to the ring described by memfd and doorbell, taking ownership of both fds.
+    // Throws std::runtime_error if memfd does not describe a valid ring with slots of
+    // slot_size bytes.
+    static Ptr attach(int memfd, int doorbell, std::uint32_t slot_size);
+
+    SharedMemoryRing(const SharedMemoryRing&) = delete;
+    SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+    // Unmaps the ring and closes all fds.
+    ~SharedMemoryRing();
+
+    // Copies a slot's worth of bytes from data to the next free slot, ringing the
+    // doorbell if the consumer is waiting. Returns false if the ring is full.
+    bool try_push(const void* data);
+
+    // Copies the oldest slot to data, returning false if the ring is empty.
+    bool try_pop(void* data);
+
+    // Announces that the consumer is about to block on the doorbell. Returns false
+    // if the ring is not empty, in which case the consumer must not block.
+    bool prepare_to_wait();
+
+    // Announces that the consumer stopped waiting, consuming pending doorbell rings.
+    void finish_wait();
+
+    // Returns the fd referring to the shared memory backing the ring.
+    int memfd() const;
+
+    // Returns the fd of the doorbell, becoming readable if the ring has been rung.
+    int doorbell() const;
+
+    // Returns the number of slots in the ring.
+    std::uint32_t slot_count() const;
+
+private:
+    // The layout of the shared memory region preceding the slots.
+    struct Header;
+
+    SharedMemoryRing(int memfd, int doorbell, void* base, std::size_t size, std::uint32_t slot_count, std::uint32_t slot_size);
+
+    // Returns a pointer to the slot at the given, unmasked index.
+    unsigned char* slot(std::uint32_t index);
+
+    int memfd_;
+    int doorbell_;
+    void* base;
+    std::size_t size;
+    // We keep private copies of the geometry, the peer might modify
+    // the shared header at any time.
+    std::uint32_t slot_count_;
+    std::uint32_t slot_size;
+    Header* header;
+};
+}
+}
+}
+}
+
+#endif // CORE_TRUST_REMOTE_SHARED_MEMORY_RING_H_
@@ -40,6 +40,8 @@ core::trust::Request::Answer core::trust::process_trust_request(const core::trus
     // Narrow it down to the specific app and the specific feature
     query->for_application_id(params.application_id);
     query->for_feature(params.feature);
+    // Only the most recent answer is of interest.
+    query->limit(1);
 
     query->execute();
 
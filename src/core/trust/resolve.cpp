@@ -18,55 +18,443 @@
 
 #include <core/trust/resolve.h>
 
+#include <core/trust/async_store.h>
 #include <core/trust/request.h>
 #include <core/trust/store.h>
+#include <core/trust/impl/archive/stream.h>
 
+#include "dbus/bus_pool.h"
 #include "dbus/codec.h"
 #include "dbus/interface.h"
 
-#include <core/dbus/asio/executor.h>
-
 #include <core/dbus/service.h>
 #include <core/dbus/stub.h>
 
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
 namespace dbus = core::dbus;
 
 namespace
 {
 namespace detail
 {
-std::shared_ptr<dbus::Bus> session_bus()
+// Turns a failed invocation into an error suitable for handing to AsyncStore handlers.
+std::exception_ptr error_from(const core::dbus::Error& error)
+{
+    return std::make_exception_ptr(std::runtime_error(error.print()));
+}
+
+// Invokes Method on object without blocking, reporting the outcome to handler.
+template<typename Method, typename... Args>
+void invoke_async(const std::shared_ptr<dbus::Object>& object, const core::trust::AsyncStore::Handler& handler, const Args&... args)
 {
-    std::shared_ptr<dbus::Bus> bus
+    object->invoke_method_asynchronously_with_callback<Method, void>([handler](const core::dbus::Result<void>& result)
     {
-        new dbus::Bus(dbus::WellKnownBus::session)
-    };
+        handler(result.is_error() ? error_from(result.error()) : nullptr);
+    }, args...);
+}
 
-    bus->install_executor(dbus::asio::make_executor(bus));
+// Invokes Method on the query object without blocking, and reports the outcome
+// together with the subsequent status of the query to handler.
+template<typename Method>
+void invoke_async_and_report_status(const std::shared_ptr<dbus::Object>& object, const core::trust::AsyncStore::Query::StatusHandler& handler)
+{
+    invoke_async<Method>(object, [object, handler](const std::exception_ptr& error)
+    {
+        if (error)
+        {
+            handler(error, core::trust::Store::Query::Status::error);
+            return;
+        }
 
-    return bus;
+        object->invoke_method_asynchronously_with_callback<
+                core::trust::dbus::Store::Query::Status,
+                core::trust::Store::Query::Status
+        >([handler](const core::dbus::Result<core::trust::Store::Query::Status>& result)
+        {
+            if (result.is_error())
+                handler(error_from(result.error()), core::trust::Store::Query::Status::error);
+            else
+                handler(nullptr, result.value());
+        });
+    });
 }
 
-struct Store : public core::trust::Store
+// A Filter captures the limits applied to a query.
+struct Filter
+{
+    // A limit is only applied if its first member is true.
+    std::pair<bool, std::string> application_id;
+    std::pair<bool, std::uint64_t> feature;
+    std::pair<bool, std::pair<std::int64_t, std::int64_t>> interval;
+    std::pair<bool, core::trust::Request::Answer> answer;
+    // The maximum number of most recent results.
+    std::pair<bool, std::size_t> count;
+
+    // Returns true if request satisfies all limits, apart from count.
+    bool matches(const core::trust::Request& request) const
+    {
+        auto when = request.when.time_since_epoch().count();
+
+        return (not application_id.first || application_id.second == request.from) &&
+               (not feature.first || feature.second == request.feature.value) &&
+               (not interval.first || (interval.second.first <= when && when <= interval.second.second)) &&
+               (not answer.first || answer.second == request.answer);
+    }
+
+    bool operator<(const Filter& rhs) const
+    {
+        return std::tie(application_id, feature, interval, answer, count) <
+               std::tie(rhs.application_id, rhs.feature, rhs.interval, rhs.answer, rhs.count);
+    }
+};
+
+// A Cache remembers the results of queries executed against a remote store,
+// and drops them as soon as a change announced by the store might affect them.
+// All functions are thread-safe.
+class Cache
+{
+public:
+    Cache(std::size_t capacity) : capacity(capacity)
+    {
+    }
+
+    // Returns true and the results known for filter in results, iff known.
+    bool lookup(const Filter& filter, std::vector<core::trust::Request>& results)
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        auto it = entries.find(filter);
+        if (it == entries.end())
+            return false;
+
+        results = it->second.second;
+        return true;
+    }
+
+    // Returns the current version of the cache, which changes whenever an
+    // announced change is processed.
+    std::uint64_t version() const
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        return changes;
+    }
+
+    // Remembers results for filter, iff no change has been announced
+    // since the cache had been at version.
+    void remember(const Filter& filter, const std::vector<core::trust::Request>& results, std::uint64_t version)
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        if (version != changes)
+            return;
+
+        if (entries.count(filter) == 0 && entries.size() >= capacity)
+        {
+            // We evict the entry remembered first.
+            auto oldest = entries.begin();
+            for (auto it = entries.begin(); it != entries.end(); ++it)
+                if (it->second.first < oldest->second.first)
+                    oldest = it;
+            entries.erase(oldest);
+        }
+
+        entries[filter] = std::make_pair(insertions++, results);
+    }
+
+    // Drops all results that might be affected by the change described in notification.
+    void on_changed(const core::trust::dbus::Store::Changed::Notification& notification)
+    {
+        typedef core::trust::dbus::Store::Changed::Kind Kind;
+
+        std::lock_guard<std::mutex> lg(guard);
+
+        changes++;
+
+        // We missed a change, the store restarted, the store has been reset, or we
+        // do not know which requests have been erased or imported.
+        if (notification.generation != generation + 1 ||
+                notification.kind == Kind::reset ||
+                notification.kind == Kind::results_erased ||
+                notification.kind == Kind::imported)
+        {
+            generation = notification.generation;
+            entries.clear();
+            return;
+        }
+
+        generation = notification.generation;
+
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            const auto& filter = it->first;
+
+            bool affected{false};
+            switch (notification.kind)
+            {
+            case Kind::application_removed:
+                affected = not filter.application_id.first || filter.application_id.second == notification.request.from;
+                break;
+            case Kind::feature_removed:
+                affected = not filter.feature.first || filter.feature.second == notification.request.feature.value;
+                break;
+            case Kind::older_removed:
+                affected = not filter.interval.first ||
+                        filter.interval.second.first < notification.request.when.time_since_epoch().count();
+                break;
+            default:
+                affected = filter.matches(notification.request);
+                break;
+            }
+
+            if (affected)
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+    }
+
+private:
+    std::size_t capacity;
+
+    mutable std::mutex guard;
+    // The number of announced changes processed so far.
+    std::uint64_t changes{0};
+    // The generation of the store as announced with the last change.
+    std::uint64_t generation{0};
+    // Counts insertions, used for eviction.
+    std::uint64_t insertions{0};
+    std::map<Filter, std::pair<std::uint64_t, std::vector<core::trust::Request>>> entries;
+};
+
+// A CachingQuery serves results from a Cache, only reaching out to
+// the remote store for results not known to the cache and for erasing requests.
+class CachingQuery : public core::trust::Store::Query
 {
+public:
+    // Creates a remote query.
+    typedef std::function<std::shared_ptr<core::trust::Store::Query>()> RemoteQueryFactory;
+
+    CachingQuery(const std::shared_ptr<Cache>& cache, const RemoteQueryFactory& remote_query_factory)
+        : cache(cache),
+          remote_query_factory(remote_query_factory)
+    {
+    }
+
+    Status status() const
+    {
+        return current_status;
+    }
+
+    void for_application_id(const std::string& id)
+    {
+        filter.application_id = std::make_pair(true, id);
+    }
+
+    void for_feature(core::trust::Feature feature)
+    {
+        filter.feature = std::make_pair(true, feature.value);
+    }
+
+    void for_interval(const core::trust::Request::Timestamp& begin, const core::trust::Request::Timestamp& end)
+    {
+        filter.interval = std::make_pair(true, std::make_pair(begin.time_since_epoch().count(), end.time_since_epoch().count()));
+    }
+
+    void for_answer(core::trust::Request::Answer answer)
+    {
+        filter.answer = std::make_pair(true, answer);
+    }
+
+    void limit(std::size_t count)
+    {
+        filter.count = std::make_pair(true, count);
+    }
+
+    void all()
+    {
+        filter = Filter{};
+    }
+
+    void execute()
+    {
+        remote.reset();
+        results.clear();
+        position = 0;
+
+        if (not cache->lookup(filter, results))
+        {
+            auto version = cache->version();
+
+            auto query = prepare_remote_query();
+            while (query->status() == Status::has_more_results)
+            {
+                results.push_back(query->current());
+                query->next();
+            }
+
+            cache->remember(filter, results, version);
+        }
+
+        update_status();
+    }
+
+    void next()
+    {
+        if (remote)
+            remote->next();
+
+        position++;
+        update_status();
+    }
+
+    void erase()
+    {
+        if (current_status != Status::has_more_results)
+            throw std::runtime_error("Cannot delete request as query points beyond the result set.");
+
+        // We bring up a remote query pointing to the same request, and keep on
+        // using it for subsequent erasures.
+        if (not remote)
+        {
+            remote = prepare_remote_query();
+            for (std::size_t i = 0; i < position; i++)
+                remote->next();
+        }
+
+        remote->erase();
+
+        results.erase(results.begin() + position);
+        update_status();
+    }
+
+    std::size_t count()
+    {
+        std::vector<core::trust::Request> known;
+        if (cache->lookup(filter, known))
+            return known.size();
+
+        return limited_remote_query()->count();
+    }
+
+    bool exists()
+    {
+        std::vector<core::trust::Request> known;
+        if (cache->lookup(filter, known))
+            return not known.empty();
+
+        return limited_remote_query()->exists();
+    }
+
+    void erase_all()
+    {
+        // The remote query erases all requests matching the filter with a single call.
+        remote.reset();
+        limited_remote_query()->erase_all();
+
+        results.clear();
+        position = 0;
+        update_status();
+    }
+
+    core::trust::Request current()
+    {
+        if (current_status != Status::has_more_results)
+            throw Errors::NoCurrentResult{};
+
+        return results.at(position);
+    }
+
+private:
+    // Creates and executes a remote query limited by filter.
+    std::shared_ptr<core::trust::Store::Query> prepare_remote_query()
+    {
+        auto query = limited_remote_query();
+        query->execute();
+        return query;
+    }
+
+    // Creates a remote query limited by filter.
+    std::shared_ptr<core::trust::Store::Query> limited_remote_query()
+    {
+        auto query = remote_query_factory();
+
+        if (filter.application_id.first)
+            query->for_application_id(filter.application_id.second);
+        if (filter.feature.first)
+            query->for_feature(core::trust::Feature{filter.feature.second});
+        if (filter.interval.first)
+            query->for_interval(
+                        core::trust::Request::Timestamp{core::trust::Request::Duration{filter.interval.second.first}},
+                        core::trust::Request::Timestamp{core::trust::Request::Duration{filter.interval.second.second}});
+        if (filter.answer.first)
+            query->for_answer(filter.answer.second);
+        if (filter.count.first)
+            query->limit(filter.count.second);
+
+        return query;
+    }
+
+    void update_status()
+    {
+        current_status = position < results.size() ? Status::has_more_results : Status::eor;
+    }
+
+    std::shared_ptr<Cache> cache;
+    RemoteQueryFactory remote_query_factory;
+
+    Filter filter;
+    Status current_status{Status::armed};
+    std::vector<core::trust::Request> results;
+    std::size_t position{0};
+    // Only present after erasing requests.
+    std::shared_ptr<core::trust::Store::Query> remote;
+};
+
+struct Store : public core::trust::Store, public core::trust::AsyncStore
+{
+    // If drive_bus is true, the store runs bus on a dedicated thread.
+    // Buses handed out by the pool are driven by the pool. Query results
+    // are cached if cache_capacity is larger than 0.
     Store(const std::shared_ptr<dbus::Service>& service,
-          const std::shared_ptr<core::dbus::Bus>& bus)
+          const std::shared_ptr<core::dbus::Bus>& bus,
+          bool drive_bus,
+          std::size_t cache_capacity)
         : bus(bus),
-          worker{[this]() { Store::bus->run(); }},
           service(service),
           proxy(service->object_for_path(dbus::types::ObjectPath::root()))
     {
+        if (cache_capacity > 0)
+        {
+            // We subscribe prior to caching any results, thus seeing all changes.
+            auto cache = std::make_shared<Cache>(cache_capacity);
+            auto signal = proxy->get_signal<core::trust::dbus::Store::Changed>();
+            signal->connect([cache](const core::trust::dbus::Store::Changed::Notification& notification)
+            {
+                cache->on_changed(notification);
+            });
+
+            Store::cache = cache;
+            changed = signal;
+        }
+
+        if (drive_bus)
+            worker = std::move(std::thread([this]() { Store::bus->run(); }));
     }
 
     ~Store()
     {
-        bus->stop();
-
         if (worker.joinable())
+        {
+            bus->stop();
             worker.join();
+        }
     }
 
-    struct Query : public core::trust::Store::Query
+    struct Query : public core::trust::Store::Query, public core::trust::AsyncStore::Query
     {
         core::dbus::types::ObjectPath path;
         std::shared_ptr<dbus::Object> parent;
@@ -83,9 +471,12 @@ struct Store : public core::trust::Store
 
         ~Query()
         {
+            // Queries might be released from within AsyncStore handlers, on the very
+            // thread dispatching replies. We thus must not wait for the removal to finish.
             try
             {
-                parent->invoke_method_synchronously<core::trust::dbus::Store::RemoveQuery, void>(path);
+                parent->invoke_method_asynchronously_with_callback<core::trust::dbus::Store::RemoveQuery, void>(
+                            [](const core::dbus::Result<void>&) {}, path);
             } catch(...)
             {
             }
@@ -118,6 +509,14 @@ struct Store : public core::trust::Store
                 throw std::runtime_error(result.error().print());
         }
 
+        void erase_all()
+        {
+            auto result = object->invoke_method_synchronously<core::trust::dbus::Store::Query::EraseAll, void>();
+
+            if (result.is_error())
+                throw std::runtime_error(result.error().print());
+        }
+
         void execute()
         {
             auto result = object->invoke_method_synchronously<core::trust::dbus::Store::Query::Execute, void>();
@@ -134,6 +533,34 @@ struct Store : public core::trust::Store
                 throw std::runtime_error(result.error().print());
         }
 
+        void limit(std::size_t count)
+        {
+            auto result = object->invoke_method_synchronously<core::trust::dbus::Store::Query::Limit, void>(static_cast<std::uint64_t>(count));
+
+            if (result.is_error())
+                throw std::runtime_error(result.error().print());
+        }
+
+        std::size_t count()
+        {
+            auto result = object->invoke_method_synchronously<core::trust::dbus::Store::Query::Count, std::uint64_t>();
+
+            if (result.is_error())
+                throw std::runtime_error(result.error().print());
+
+            return result.value();
+        }
+
+        bool exists()
+        {
+            auto result = object->invoke_method_synchronously<core::trust::dbus::Store::Query::Exists, bool>();
+
+            if (result.is_error())
+                throw std::runtime_error(result.error().print());
+
+            return result.value();
+        }
+
         void for_application_id(const std::string &id)
         {
             auto result = object->invoke_method_synchronously<core::trust::dbus::Store::Query::ForApplicationId, void>(id);
@@ -182,6 +609,79 @@ struct Store : public core::trust::Store
 
             return result.value();
         }
+
+        void status_async(const StatusHandler& handler)
+        {
+            object->invoke_method_asynchronously_with_callback<
+                    core::trust::dbus::Store::Query::Status,
+                    core::trust::Store::Query::Status
+            >([handler](const core::dbus::Result<core::trust::Store::Query::Status>& result)
+            {
+                if (result.is_error())
+                    handler(error_from(result.error()), core::trust::Store::Query::Status::error);
+                else
+                    handler(nullptr, result.value());
+            });
+        }
+
+        void for_application_id_async(const std::string& id, const Handler& handler)
+        {
+            invoke_async<core::trust::dbus::Store::Query::ForApplicationId>(object, handler, id);
+        }
+
+        void for_feature_async(core::trust::Feature feature, const Handler& handler)
+        {
+            invoke_async<core::trust::dbus::Store::Query::ForFeature>(object, handler, feature);
+        }
+
+        void for_interval_async(const core::trust::Request::Timestamp& begin, const core::trust::Request::Timestamp& end, const Handler& handler)
+        {
+            invoke_async<core::trust::dbus::Store::Query::ForInterval>(
+                        object,
+                        handler,
+                        std::make_tuple(
+                            begin.time_since_epoch().count(),
+                            end.time_since_epoch().count()));
+        }
+
+        void for_answer_async(core::trust::Request::Answer answer, const Handler& handler)
+        {
+            invoke_async<core::trust::dbus::Store::Query::ForAnswer>(object, handler, answer);
+        }
+
+        void all_async(const Handler& handler)
+        {
+            invoke_async<core::trust::dbus::Store::Query::All>(object, handler);
+        }
+
+        void execute_async(const StatusHandler& handler)
+        {
+            invoke_async_and_report_status<core::trust::dbus::Store::Query::Execute>(object, handler);
+        }
+
+        void next_async(const StatusHandler& handler)
+        {
+            invoke_async_and_report_status<core::trust::dbus::Store::Query::Next>(object, handler);
+        }
+
+        void erase_async(const StatusHandler& handler)
+        {
+            invoke_async_and_report_status<core::trust::dbus::Store::Query::Erase>(object, handler);
+        }
+
+        void current_async(const RequestHandler& handler)
+        {
+            object->invoke_method_asynchronously_with_callback<
+                    core::trust::dbus::Store::Query::Current,
+                    core::trust::Request
+            >([handler](const core::dbus::Result<core::trust::Request>& result)
+            {
+                if (result.is_error())
+                    handler(std::make_exception_ptr(core::trust::Store::Query::Errors::NoCurrentResult{}), core::trust::Request{});
+                else
+                    handler(nullptr, result.value());
+            });
+        }
     };
 
     void add(const core::trust::Request& r)
@@ -206,6 +706,28 @@ struct Store : public core::trust::Store
             throw std::runtime_error(response.error().print());
     }
 
+    void remove_feature(core::trust::Feature feature)
+    {
+        auto response =
+                proxy->invoke_method_synchronously<
+                    core::trust::dbus::Store::RemoveFeature,
+                    void>(feature.value);
+
+        if (response.is_error())
+            throw std::runtime_error(response.error().print());
+    }
+
+    void remove_older_than(const core::trust::Request::Timestamp& timestamp)
+    {
+        auto response =
+                proxy->invoke_method_synchronously<
+                    core::trust::dbus::Store::RemoveOlderThan,
+                    void>(static_cast<std::int64_t>(timestamp.time_since_epoch().count()));
+
+        if (response.is_error())
+            throw std::runtime_error(response.error().print());
+    }
+
     void reset()
     {
         try
@@ -226,6 +748,78 @@ struct Store : public core::trust::Store
     }
 
     std::shared_ptr<core::trust::Store::Query> query()
+    {
+        if (cache)
+        {
+            auto service = Store::service;
+            auto proxy = Store::proxy;
+
+            return std::make_shared<CachingQuery>(cache, [service, proxy]()
+            {
+                return remote_query(service, proxy);
+            });
+        }
+
+        return remote_query(service, proxy);
+    }
+
+    std::vector<Statistics> statistics()
+    {
+        auto result = proxy->invoke_method_synchronously<
+                core::trust::dbus::Store::Statistics,
+                std::vector<Statistics>>();
+
+        if (result.is_error())
+            throw std::runtime_error(result.error().print());
+
+        return result.value();
+    }
+
+    std::size_t export_to(int fd)
+    {
+        auto result = proxy->invoke_method_synchronously<
+                core::trust::dbus::Store::Export,
+                core::dbus::types::UnixFd>();
+
+        if (result.is_error())
+            throw Errors::ErrorExportingStore{result.error().print().c_str()};
+
+        auto source = result.value();
+
+        // We pass the stream on while decoding it, telling complete exports from failed ones.
+        try
+        {
+            core::trust::impl::archive::Reader reader{source.to_raw()};
+            core::trust::impl::archive::Writer writer{fd};
+
+            core::trust::Request request;
+            while (reader.read(request))
+                writer.write(request);
+
+            return writer.finish();
+        } catch(const std::runtime_error& e)
+        {
+            throw Errors::ErrorExportingStore{e.what()};
+        }
+    }
+
+    std::size_t import_from(int fd, bool defer_indices)
+    {
+        // The store reads from fd directly.
+        auto result = proxy->invoke_method_synchronously<
+                core::trust::dbus::Store::Import,
+                std::uint64_t>(core::dbus::types::UnixFd{fd}, defer_indices);
+
+        if (result.is_error())
+            throw Errors::ErrorImportingStore{result.error().print().c_str()};
+
+        return result.value();
+    }
+
+    // Creates a query on the remote store.
+    static std::shared_ptr<core::trust::Store::Query> remote_query(
+            const std::shared_ptr<dbus::Service>& service,
+            const std::shared_ptr<dbus::Object>& proxy)
     {
         auto result = proxy->invoke_method_synchronously<
                 core::trust::dbus::Store::AddQuery,
@@ -246,33 +840,134 @@ struct Store : public core::trust::Store
         return query;
     }
 
+    void add_async(const core::trust::Request& r, const Handler& handler)
+    {
+        invoke_async<core::trust::dbus::Store::Add>(proxy, handler, r);
+    }
+
+    void query_async(const QueryHandler& handler)
+    {
+        // We do not refer to this store in the callback, as the
+        // store might have been destroyed by the time the reply arrives.
+        auto service = Store::service;
+        auto proxy = Store::proxy;
+
+        proxy->invoke_method_asynchronously_with_callback<
+                core::trust::dbus::Store::AddQuery,
+                core::dbus::types::ObjectPath
+        >([service, proxy, handler](const core::dbus::Result<core::dbus::types::ObjectPath>& result)
+        {
+            if (result.is_error())
+            {
+                handler(error_from(result.error()), std::shared_ptr<core::trust::AsyncStore::Query>{});
+                return;
+            }
+
+            auto path = result.value();
+
+            handler(nullptr, std::shared_ptr<core::trust::AsyncStore::Query>
+            {
+                new detail::Store::Query
+                {
+                    path,
+                    proxy,
+                    service->object_for_path(path)
+                }
+            });
+        });
+    }
+
     std::shared_ptr<core::dbus::Bus> bus;
     std::thread worker;
     std::shared_ptr<dbus::Service> service;
     std::shared_ptr<dbus::Object> proxy;
+    // Only present if query results are cached.
+    std::shared_ptr<Cache> cache;
+    // Keeps the subscription to change notifications alive.
+    std::shared_ptr<void> changed;
 };
-}
-}
 
-std::shared_ptr<core::trust::Store> core::trust::resolve_store_on_bus_with_name(
+// Resolves the store exposed on bus under the given name.
+std::shared_ptr<detail::Store> resolve(
         const std::shared_ptr<core::dbus::Bus>& bus,
-        const std::string& name)
+        const std::string& name,
+        bool drive_bus,
+        std::size_t cache_capacity = 0)
 {
     if (name.empty())
-        throw Errors::ServiceNameMustNotBeEmpty{};
+        throw core::trust::Errors::ServiceNameMustNotBeEmpty{};
 
-    return std::shared_ptr<core::trust::Store>
+    return std::shared_ptr<detail::Store>
     {
         new detail::Store
         {
             core::dbus::Service::use_service(bus, "com.ubuntu.trust.store." + name),
-            bus
+            bus,
+            drive_bus,
+            cache_capacity
         }
     };
 }
+}
+}
+
+std::shared_ptr<core::trust::Store> core::trust::resolve_store_on_bus_with_name(
+        const std::shared_ptr<core::dbus::Bus>& bus,
+        const std::string& name)
+{
+    return detail::resolve(bus, name, true);
+}
 
 std::shared_ptr<core::trust::Store> core::trust::resolve_store_in_session_with_name(
         const std::string& name)
 {
-    return core::trust::resolve_store_on_bus_with_name(detail::session_bus(), name);
+    return detail::resolve(
+            core::trust::dbus::BusPool::instance().bus_for_well_known_bus(core::dbus::WellKnownBus::session),
+            name,
+            false);
+}
+
+std::shared_ptr<core::trust::AsyncStore> core::trust::resolve_async_store_on_bus_with_name(
+        const std::shared_ptr<core::dbus::Bus>& bus,
+        const std::string& name)
+{
+    return detail::resolve(bus, name, true);
+}
+
+std::shared_ptr<core::trust::AsyncStore> core::trust::resolve_async_store_in_session_with_name(
+        const std::string& name)
+{
+    return detail::resolve(
+            core::trust::dbus::BusPool::instance().bus_for_well_known_bus(core::dbus::WellKnownBus::session),
+            name,
+            false);
+}
+
+std::shared_ptr<core::trust::Store> core::trust::resolve_caching_store_on_bus_with_name(
+        const std::shared_ptr<core::dbus::Bus>& bus,
+        const std::string& name,
+        std::size_t capacity)
+{
+    if (capacity == 0) throw std::invalid_argument
+    {
+        "Cache capacity must not be 0."
+    };
+
+    return detail::resolve(bus, name, true, capacity);
+}
+
+std::shared_ptr<core::trust::Store> core::trust::resolve_caching_store_in_session_with_name(
+        const std::string& name,
+        std::size_t capacity)
+{
+    if (capacity == 0) throw std::invalid_argument
+    {
+        "Cache capacity must not be 0."
+    };
+
+    return detail::resolve(
+            core::trust::dbus::BusPool::instance().bus_for_well_known_bus(core::dbus::WellKnownBus::session),
+            name,
+            false,
+            capacity);
 }
@@ -0,0 +1,113 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <core/trust/revoking_store.h>
+
+#include <functional>
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace
+{
+// Decorates queries, revoking decisions whenever results are erased.
+class Query : public core::trust::ForwardingStore::Query
+{
+public:
+    Query(const std::shared_ptr<core::trust::Store::Query>& impl, const std::function<void()>& revoke_all)
+        : core::trust::ForwardingStore::Query{impl}, revoke_all{revoke_all}
+    {
+    }
+
+    void erase() override { impl->erase(); revoke_all(); }
+    void erase_all() override { impl->erase_all(); revoke_all(); }
+
+private:
+    std::function<void()> revoke_all;
+};
+}
+
+core::trust::RevokingStore::RevokingStore(const std::shared_ptr<core::trust::Store>& impl,
+                                          const std::shared_ptr<core::trust::remote::Agent::Skeleton>& skeleton)
+    : core::trust::ForwardingStore{impl},
+      skeleton{skeleton}
+{
+    if (not skeleton) throw std::runtime_error
+    {
+        "Missing skeleton for revoking decisions."
+    };
+}
+
+void core::trust::RevokingStore::reset()
+{
+    impl->reset();
+    revoke(true, core::trust::Feature{});
+}
+
+void core::trust::RevokingStore::add(const core::trust::Request& request)
+{
+    impl->add(request);
+    revoke(false, request.feature);
+}
+
+void core::trust::RevokingStore::add_all(const std::vector<core::trust::Request>& requests)
+{
+    impl->add_all(requests);
+    for (const auto& request : requests)
+        revoke(false, request.feature);
+}
+
+std::size_t core::trust::RevokingStore::load(const core::trust::Store::RequestSource& source, bool defer_indices)
+{
+    auto result = impl->load(source, defer_indices);
+    // Loads might cover any number of features, and we do not track them.
+    revoke(true, core::trust::Feature{});
+    return result;
+}
+
+void core::trust::RevokingStore::remove_application(const std::string& id)
+{
+    impl->remove_application(id);
+    revoke(true, core::trust::Feature{});
+}
+
+void core::trust::RevokingStore::remove_feature(core::trust::Feature feature)
+{
+    impl->remove_feature(feature);
+    revoke(false, feature);
+}
+
+void core::trust::RevokingStore::remove_older_than(const core::trust::Request::Timestamp& timestamp)
+{
+    impl->remove_older_than(timestamp);
+    revoke(true, core::trust::Feature{});
+}
+
+std::shared_ptr<core::trust::Store::Query> core::trust::RevokingStore::query()
+{
+    auto skeleton = this->skeleton;
+
+    return std::make_shared<::Query>(impl->query(), [skeleton]()
+    {
+        skeleton->revoke(core::trust::remote::Revocation{core::trust::Uid{::getuid()}, true, core::trust::Feature{}});
+    });
+}
+
+void core::trust::RevokingStore::revoke(bool all_features, core::trust::Feature feature)
+{
+    skeleton->revoke(core::trust::remote::Revocation{core::trust::Uid{::getuid()}, all_features, feature});
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/store.h>
+
+#include <core/trust/impl/archive/stream.h>
+#include <core/trust/impl/log_structured/store.h>
+#include <core/trust/impl/sqlite3/store.h>
+
+#include <core/posix/this_process.h>
+
+#include <xdg.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <stdexcept>
+
+namespace
+{
+// The environment variable selecting the backend of the default store.
+constexpr const char* backend_env_var{"CORE_TRUST_STORE_BACKEND"};
+
+typedef std::function<std::shared_ptr<core::trust::Store>(const std::string&)> StoreFactory;
+
+// Returns a map for resolving backend names to store factories.
+const std::map<std::string, StoreFactory>& known_backends()
+{
+    static const std::map<std::string, StoreFactory> lut
+    {
+        {
+            "sqlite",
+            [](const std::string& service_name)
+            {
+                return core::trust::impl::sqlite::create_for_service(service_name, *xdg::BaseDirSpecification::create());
+            }
+        },
+        {
+            "log_structured",
+            [](const std::string& service_name)
+            {
+                return core::trust::impl::log_structured::create_for_service(service_name, *xdg::BaseDirSpecification::create());
+            }
+        }
+    };
+    return lut;
+}
+}
+
+void core::trust::Store::add_all(const std::vector<core::trust::Request>& requests)
+{
+    for (const auto& request : requests)
+        add(request);
+}
+
+void core::trust::Store::Query::limit(std::size_t)
+{
+}
+
+void core::trust::Store::Query::erase_all()
+{
+    execute();
+
+    while (status() == core::trust::Store::Query::Status::has_more_results)
+        erase();
+}
+
+std::size_t core::trust::Store::load(const RequestSource& source, bool)
+{
+    static constexpr const std::size_t group_size{256};
+
+    std::size_t count{0};
+    std::vector<core::trust::Request> group;
+
+    core::trust::Request request;
+    while (source(request))
+    {
+        group.push_back(request);
+
+        if (group.size() == group_size)
+        {
+            add_all(group);
+            count += group.size();
+            group.clear();
+        }
+    }
+
+    if (not group.empty())
+        add_all(group);
+
+    return count + group.size();
+}
+
+std::size_t core::trust::Store::Query::count()
+{
+    std::size_t result{0};
+
+    execute();
+
+    while (status() == core::trust::Store::Query::Status::has_more_results)
+    {
+        result++;
+        next();
+    }
+
+    return result;
+}
+
+bool core::trust::Store::Query::exists()
+{
+    execute();
+    return status() == core::trust::Store::Query::Status::has_more_results;
+}
+
+void core::trust::Store::remove_feature(core::trust::Feature feature)
+{
+    auto query = this->query();
+    query->for_feature(feature);
+    query->erase_all();
+}
+
+void core::trust::Store::remove_older_than(const core::trust::Request::Timestamp& timestamp)
+{
+    // Nothing precedes the earliest point in time.
+    if (timestamp == core::trust::Request::Timestamp::min())
+        return;
+
+    // Intervals are closed, and we thus stop right before timestamp.
+    auto query = this->query();
+    query->for_interval(
+                core::trust::Request::Timestamp::min(),
+                timestamp - core::trust::Request::Duration{1});
+    query->erase_all();
+}
+
+std::vector<core::trust::Store::Statistics> core::trust::Store::statistics()
+{
+    std::map<std::pair<std::string, core::trust::Feature::IntegerType>, Statistics> lut;
+
+    auto query = this->query();
+    query->all();
+    query->execute();
+
+    while (query->status() == core::trust::Store::Query::Status::has_more_results)
+    {
+        auto request = query->current();
+
+        auto it = lut.find(std::make_pair(request.from, request.feature.value));
+        if (it == lut.end())
+        {
+            it = lut.insert(std::make_pair(
+                                std::make_pair(request.from, request.feature.value),
+                                Statistics{request.from, request.feature, 0, 0, request.when, request.when})).first;
+        }
+
+        auto& statistics = it->second;
+        if (request.answer == core::trust::Request::Answer::granted)
+            statistics.granted++;
+        else
+            statistics.denied++;
+        statistics.first = std::min(statistics.first, request.when);
+        statistics.last = std::max(statistics.last, request.when);
+
+        query->next();
+    }
+
+    std::vector<Statistics> result;
+    for (const auto& pair : lut)
+        result.push_back(pair.second);
+
+    return result;
+}
+
+std::size_t core::trust::Store::export_to(int fd)
+{
+    try
+    {
+        core::trust::impl::archive::Writer writer{fd};
+
+        // Results are streamed, and we only keep the dictionary of app ids around.
+        auto query = this->query();
+        query->all();
+        query->execute();
+
+        while (query->status() == core::trust::Store::Query::Status::has_more_results)
+        {
+            writer.write(query->current());
+            query->next();
+        }
+
+        return writer.finish();
+    } catch(const std::runtime_error& e)
+    {
+        throw Errors::ErrorExportingStore{e.what()};
+    }
+}
+
+std::size_t core::trust::Store::import_from(int fd, bool defer_indices)
+{
+    try
+    {
+        core::trust::impl::archive::Reader reader{fd};
+
+        // Stores loading requests within a single transaction do not keep
+        // any of them if the stream turns out to be corrupted.
+        return load([&reader](core::trust::Request& request)
+        {
+            return reader.read(request);
+        }, defer_indices);
+    } catch(const Errors::StoreIsReadOnly&)
+    {
+        throw;
+    } catch(const std::runtime_error& e)
+    {
+        throw Errors::ErrorImportingStore{e.what()};
+    }
+}
+
+std::shared_ptr<core::trust::Store> core::trust::create_default_store(const std::string& service_name)
+{
+    return core::trust::create_store_for_backend(
+                core::posix::this_process::env::get(backend_env_var, "sqlite"),
+                service_name);
+}
+
+std::shared_ptr<core::trust::Store> core::trust::create_store_for_backend(const std::string& backend, const std::string& service_name)
+{
+    auto it = known_backends().find(backend);
+
+    if (it == known_backends().end()) throw std::invalid_argument
+    {
+        "Unknown store backend: " + backend
+    };
+
+    return it->second(service_name);
+}
@@ -45,3 +45,38 @@ core::trust::Request::Answer core::trust::WhiteListingAgent::authenticate_reques
 
     return impl->authenticate_request_with_parameters(parameters);
 }
+
+core::trust::Agent::BatchAnswer core::trust::WhiteListingAgent::authenticate_batch_request_with_parameters(const core::trust::Agent::BatchRequestParameters& parameters)
+{
+    core::trust::Agent::BatchAnswer answers;
+
+    // The predicate operates on individual requests, and we only pass on
+    // the features that have not been whitelisted.
+    auto remaining = parameters;
+    remaining.features.clear();
+
+    for (const auto& feature : parameters.features)
+    {
+        core::trust::Agent::RequestParameters params
+        {
+            parameters.application.uid,
+            parameters.application.pid,
+            parameters.application.id,
+            feature,
+            parameters.description
+        };
+
+        if (white_listing_predicate(params))
+            answers[feature] = core::trust::Request::Answer::granted;
+        else
+            remaining.features.insert(feature);
+    }
+
+    if (not remaining.features.empty())
+    {
+        auto delegated = impl->authenticate_batch_request_with_parameters(remaining);
+        answers.insert(delegated.begin(), delegated.end());
+    }
+
+    return answers;
+}
@@ -16,6 +16,8 @@
  * Authored by: Thomas Voß <thomas.voss@canonical.com>
  */
 
+#include <condition_variable>
+#include <mutex>
 #include <random>
 
 #include <core/trust/cached_agent.h>
@@ -92,7 +94,8 @@ TEST(CachedAgent, ctor_throws_for_missing_agent_implementation)
     {
         a_null_agent(),
         a_mocked_store(),
-        a_mocked_reporter()
+        a_mocked_reporter(),
+        core::trust::CachedAgent::Persistence::synchronous()
     };
 
     EXPECT_THROW(core::trust::CachedAgent agent{configuration},
@@ -105,7 +108,8 @@ TEST(RequestProcessing, ctor_throws_for_missing_store_implementation)
     {
         a_mocked_agent(),
         a_null_store(),
-        a_mocked_reporter()
+        a_mocked_reporter(),
+        core::trust::CachedAgent::Persistence::synchronous()
     };
 
     EXPECT_THROW(core::trust::CachedAgent agent{configuration},
@@ -153,6 +157,7 @@ TEST(CachedAgent, queries_store_for_cached_results_and_returns_cached_value)
     // and to the respective feature.
     EXPECT_CALL(*mocked_query, for_application_id(params.application.id)).Times(1);
     EXPECT_CALL(*mocked_query, for_feature(params.feature)).Times(1);
+    EXPECT_CALL(*mocked_query, limit(1)).Times(1);
     // The setup ensures that a previously stored answer is available in the store.
     // For that, the agent should not be queried.
     EXPECT_CALL(*mocked_agent, authenticate_request_with_parameters(_)).Times(0);
@@ -165,7 +170,8 @@ TEST(CachedAgent, queries_store_for_cached_results_and_returns_cached_value)
     {
         mocked_agent,
         mocked_store,
-        mocked_reporter
+        mocked_reporter,
+        core::trust::CachedAgent::Persistence::synchronous()
     };
 
     core::trust::CachedAgent agent
@@ -230,6 +236,7 @@ TEST(CachedAgent, queries_agent_if_no_cached_results_and_returns_users_answer)
     // and to the respective feature.
     EXPECT_CALL(*mocked_query, for_application_id(params.application.id)).Times(1);
     EXPECT_CALL(*mocked_query, for_feature(params.feature)).Times(1);
+    EXPECT_CALL(*mocked_query, limit(1)).Times(1);
     // The setup ensures that a previously stored answer is available in the store.
     // For that, the agent should not be queried.
     EXPECT_CALL(*mocked_agent, authenticate_request_with_parameters(agent_params)).Times(1);
@@ -242,7 +249,8 @@ TEST(CachedAgent, queries_agent_if_no_cached_results_and_returns_users_answer)
     {
         mocked_agent,
         mocked_store,
-        mocked_reporter
+        mocked_reporter,
+        core::trust::CachedAgent::Persistence::synchronous()
     };
 
     core::trust::CachedAgent agent
@@ -252,3 +260,314 @@ TEST(CachedAgent, queries_agent_if_no_cached_results_and_returns_users_answer)
 
     EXPECT_EQ(answer, agent.authenticate_request_with_parameters(params));
 }
+
+TEST(CachedAgent, batch_request_runs_single_query_and_prompts_once_for_missing_features)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+
+    const core::trust::Feature cached_feature{1};
+    const core::trust::Feature stale_duplicate_feature{1};
+    const core::trust::Feature missing_feature_1{2};
+    const core::trust::Feature missing_feature_2{3};
+    const core::trust::Feature unrelated_feature{4};
+
+    core::trust::Agent::BatchRequestParameters batch_params
+    {
+        {
+            params.application.uid,
+            params.application.pid,
+            params.application.id
+        },
+        {
+            cached_feature,
+            missing_feature_1,
+            missing_feature_2
+        },
+        params.description
+    };
+
+    core::trust::Agent::BatchRequestParameters expected_agent_params
+    {
+        {
+            params.application.uid,
+            params.application.pid,
+            params.application.id
+        },
+        {
+            missing_feature_1,
+            missing_feature_2
+        },
+        params.description
+    };
+
+    auto now = std::chrono::system_clock::now();
+
+    // The store hands out results ordered by descending timestamp.
+    core::trust::Request cached{params.application.id, cached_feature, now, core::trust::Request::Answer::granted};
+    core::trust::Request unrelated{params.application.id, unrelated_feature, now, core::trust::Request::Answer::granted};
+    core::trust::Request stale{params.application.id, stale_duplicate_feature, now - std::chrono::seconds{10}, core::trust::Request::Answer::denied};
+
+    auto mocked_agent = a_mocked_agent();
+    auto mocked_query = a_mocked_query();
+    auto mocked_store = a_mocked_store();
+    auto mocked_reporter = a_mocked_reporter();
+
+    ON_CALL(*mocked_store, query())
+            .WillByDefault(
+                Return(
+                    mocked_query));
+
+    EXPECT_CALL(*mocked_query, status())
+            .WillOnce(Return(core::trust::Store::Query::Status::has_more_results))
+            .WillOnce(Return(core::trust::Store::Query::Status::has_more_results))
+            .WillOnce(Return(core::trust::Store::Query::Status::has_more_results))
+            .WillRepeatedly(Return(core::trust::Store::Query::Status::eor));
+    EXPECT_CALL(*mocked_query, current())
+            .WillOnce(Return(unrelated))
+            .WillOnce(Return(cached))
+            .WillOnce(Return(stale));
+
+    // A single query, narrowed down to the app id only.
+    EXPECT_CALL(*mocked_store, query()).Times(1);
+    EXPECT_CALL(*mocked_query, for_application_id(params.application.id)).Times(1);
+    EXPECT_CALL(*mocked_query, for_feature(_)).Times(0);
+
+    // A single prompt for both missing features.
+    EXPECT_CALL(*mocked_agent, authenticate_request_with_parameters(_)).Times(0);
+    EXPECT_CALL(*mocked_agent, authenticate_batch_request_with_parameters(expected_agent_params))
+            .Times(1)
+            .WillOnce(Return(core::trust::Agent::BatchAnswer
+            {
+                {missing_feature_1, core::trust::Request::Answer::denied},
+                {missing_feature_2, core::trust::Request::Answer::denied}
+            }));
+
+    EXPECT_CALL(*mocked_store, add(_)).Times(2);
+    EXPECT_CALL(*mocked_reporter, report_cached_answer_found(_, cached)).Times(1);
+    EXPECT_CALL(*mocked_reporter, report_user_prompted_for_trust(_, core::trust::Request::Answer::denied)).Times(2);
+
+    core::trust::CachedAgent::Configuration configuration
+    {
+        mocked_agent,
+        mocked_store,
+        mocked_reporter,
+        core::trust::CachedAgent::Persistence::synchronous()
+    };
+
+    core::trust::CachedAgent agent
+    {
+        configuration
+    };
+
+    auto answers = agent.authenticate_batch_request_with_parameters(batch_params);
+
+    EXPECT_EQ(3u, answers.size());
+    EXPECT_EQ(core::trust::Request::Answer::granted, answers.at(cached_feature));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answers.at(missing_feature_1));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answers.at(missing_feature_2));
+}
+
+namespace
+{
+// Records groups of requests handed to the store.
+struct MockGroupingStore : public MockStore
+{
+    MOCK_METHOD1(add_all, void(const std::vector<core::trust::Request>&));
+};
+}
+
+TEST(CachedAgent, write_behind_answers_pending_requests_from_memory_and_persists_them_in_groups)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+    auto other_params = params;
+    other_params.feature = core::trust::Feature{params.feature.value + 1};
+
+    auto mocked_agent = a_mocked_agent();
+    auto mocked_store = std::make_shared<NiceMock<MockGroupingStore>>();
+    auto mocked_reporter = a_mocked_reporter();
+
+    ON_CALL(*mocked_store, query()).WillByDefault(Return(a_mocked_query()));
+
+    // The repeated request is answered from memory.
+    EXPECT_CALL(*mocked_agent, authenticate_request_with_parameters(_))
+            .Times(2)
+            .WillRepeatedly(Return(core::trust::Request::Answer::granted));
+    EXPECT_CALL(*mocked_reporter, report_cached_answer_found(params, _)).Times(1);
+
+    // Both answers are persisted together, as soon as the batch is complete.
+    EXPECT_CALL(*mocked_store, add(_)).Times(0);
+    EXPECT_CALL(*mocked_store, add_all(SizeIs(2))).Times(1);
+
+    core::trust::CachedAgent::Configuration configuration
+    {
+        mocked_agent,
+        mocked_store,
+        mocked_reporter,
+        core::trust::CachedAgent::Persistence::write_behind(std::chrono::minutes{1}, 2)
+    };
+
+    core::trust::CachedAgent agent
+    {
+        configuration
+    };
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, agent.authenticate_request_with_parameters(params));
+    EXPECT_EQ(core::trust::Request::Answer::granted, agent.authenticate_request_with_parameters(params));
+    EXPECT_EQ(core::trust::Request::Answer::granted, agent.authenticate_request_with_parameters(other_params));
+
+    agent.flush();
+}
+
+TEST(CachedAgent, write_behind_persists_pending_requests_on_shutdown_if_configured)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+
+    for (bool flush_on_shutdown : {true, false})
+    {
+        auto mocked_agent = a_mocked_agent();
+        auto mocked_store = std::make_shared<NiceMock<MockGroupingStore>>();
+
+        ON_CALL(*mocked_store, query()).WillByDefault(Return(a_mocked_query()));
+        ON_CALL(*mocked_agent, authenticate_request_with_parameters(_))
+                .WillByDefault(Return(core::trust::Request::Answer::denied));
+
+        EXPECT_CALL(*mocked_store, add_all(SizeIs(1))).Times(flush_on_shutdown ? 1 : 0);
+
+        auto persistence = core::trust::CachedAgent::Persistence::write_behind(std::chrono::minutes{1}, 64);
+        persistence.flush_on_shutdown = flush_on_shutdown;
+
+        core::trust::CachedAgent agent
+        {
+            core::trust::CachedAgent::Configuration
+            {
+                mocked_agent,
+                mocked_store,
+                a_mocked_reporter(),
+                persistence
+            }
+        };
+
+        EXPECT_EQ(core::trust::Request::Answer::denied, agent.authenticate_request_with_parameters(params));
+    }
+}
+
+TEST(CachedAgent, write_behind_drops_discarded_requests_from_memory_and_never_persists_them)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+    auto other_params = params;
+    other_params.feature = core::trust::Feature{params.feature.value + 1};
+
+    auto mocked_agent = a_mocked_agent();
+    auto mocked_store = std::make_shared<NiceMock<MockGroupingStore>>();
+
+    ON_CALL(*mocked_store, query()).WillByDefault(Return(a_mocked_query()));
+
+    // The discarded answer is neither served from memory nor persisted, and the user is prompted again.
+    EXPECT_CALL(*mocked_agent, authenticate_request_with_parameters(params))
+            .Times(2)
+            .WillOnce(Return(core::trust::Request::Answer::granted))
+            .WillOnce(Return(core::trust::Request::Answer::denied));
+    EXPECT_CALL(*mocked_agent, authenticate_request_with_parameters(other_params))
+            .Times(1)
+            .WillOnce(Return(core::trust::Request::Answer::granted));
+
+    EXPECT_CALL(*mocked_store, add_all(ElementsAre(
+                                           AllOf(Field(&core::trust::Request::feature, other_params.feature),
+                                                 Field(&core::trust::Request::answer, core::trust::Request::Answer::granted)),
+                                           AllOf(Field(&core::trust::Request::feature, params.feature),
+                                                 Field(&core::trust::Request::answer, core::trust::Request::Answer::denied))))).Times(1);
+
+    core::trust::CachedAgent agent
+    {
+        core::trust::CachedAgent::Configuration
+        {
+            mocked_agent,
+            mocked_store,
+            a_mocked_reporter(),
+            core::trust::CachedAgent::Persistence::write_behind(std::chrono::minutes{1}, 64)
+        }
+    };
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, agent.authenticate_request_with_parameters(params));
+    EXPECT_EQ(core::trust::Request::Answer::granted, agent.authenticate_request_with_parameters(other_params));
+
+    agent.discard([&params](const core::trust::Request& request) { return request.feature == params.feature; });
+
+    EXPECT_EQ(core::trust::Request::Answer::denied, agent.authenticate_request_with_parameters(params));
+    EXPECT_EQ(core::trust::Request::Answer::granted, agent.authenticate_request_with_parameters(other_params));
+
+    agent.flush();
+}
+
+TEST(CachedAgent, discarding_blocks_until_the_group_being_persisted_reached_the_store)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+
+    auto mocked_agent = a_mocked_agent();
+    auto mocked_store = std::make_shared<NiceMock<MockGroupingStore>>();
+
+    ON_CALL(*mocked_store, query()).WillByDefault(Return(a_mocked_query()));
+    ON_CALL(*mocked_agent, authenticate_request_with_parameters(_))
+            .WillByDefault(Return(core::trust::Request::Answer::granted));
+
+    std::mutex guard;
+    std::condition_variable cv;
+    bool writing{false}, persisted{false};
+
+    // The writer is held within the store until we discarded.
+    EXPECT_CALL(*mocked_store, add_all(SizeIs(1))).Times(1).WillOnce(Invoke([&](const std::vector<core::trust::Request>&)
+    {
+        std::unique_lock<std::mutex> ul(guard);
+        writing = true;
+        cv.notify_all();
+        cv.wait_for(ul, std::chrono::milliseconds{100});
+        persisted = true;
+    }));
+
+    core::trust::CachedAgent agent
+    {
+        core::trust::CachedAgent::Configuration
+        {
+            mocked_agent,
+            mocked_store,
+            a_mocked_reporter(),
+            core::trust::CachedAgent::Persistence::write_behind(std::chrono::milliseconds{0}, 1)
+        }
+    };
+
+    agent.authenticate_request_with_parameters(params);
+
+    {
+        std::unique_lock<std::mutex> ul(guard);
+        cv.wait(ul, [&writing]() { return writing; });
+    }
+
+    agent.discard_all();
+
+    std::lock_guard<std::mutex> lg(guard);
+    EXPECT_TRUE(persisted);
+}
+
+TEST(CachedAgent, ctor_throws_for_write_behind_with_empty_batches)
+{
+    core::trust::CachedAgent::Configuration configuration
+    {
+        a_mocked_agent(),
+        a_mocked_store(),
+        a_mocked_reporter(),
+        core::trust::CachedAgent::Persistence::write_behind(std::chrono::milliseconds{5}, 0)
+    };
+
+    EXPECT_THROW(core::trust::CachedAgent agent{configuration},
+                 std::logic_error);
+}
@@ -21,6 +21,7 @@
 
 #include <core/trust/dbus/agent.h>
 #include <core/trust/dbus/agent_registry.h>
+#include <core/trust/dbus/bus_pool.h>
 
 #include "mock_agent.h"
 #include "process_exited_successfully.h"
@@ -78,6 +79,10 @@ struct DBusAgentRegistry : public core::dbus::testing::Fixture
     };
 };
 
+struct DBusBusPool : public core::dbus::testing::Fixture
+{
+};
+
 struct MockAgentRegistry : public core::trust::Agent::Registry
 {
     // Registers an agent for the given uid.
@@ -118,6 +123,35 @@ INSTANTIATE_TEST_CASE_P(BusFactoryType, BusFactoryType, testing::Values(
                             std::make_pair(core::trust::dbus::BusFactory::Type::session_with_address_from_env, "session_with_address_from_env"),
                             std::make_pair(core::trust::dbus::BusFactory::Type::system_with_address_from_env, "system_with_address_from_env")));
 
+TEST_F(DBusBusPool, hands_out_the_same_connection_while_in_use)
+{
+    auto& pool = core::trust::dbus::BusPool::instance();
+
+    auto b1 = pool.bus_for_well_known_bus(core::dbus::WellKnownBus::session);
+    auto b2 = pool.bus_for_well_known_bus(core::dbus::WellKnownBus::session);
+
+    EXPECT_EQ(b1, b2);
+}
+
+TEST_F(DBusBusPool, releases_a_connection_with_its_last_user)
+{
+    auto& pool = core::trust::dbus::BusPool::instance();
+    auto size = pool.size();
+
+    {
+        auto b1 = pool.bus_for_well_known_bus(core::dbus::WellKnownBus::session);
+        auto b2 = pool.bus_for_well_known_bus(core::dbus::WellKnownBus::session);
+        EXPECT_EQ(size + 1, pool.size());
+    }
+
+    EXPECT_EQ(size, pool.size());
+}
+
+TEST_F(DBusBusPool, throws_for_empty_address)
+{
+    EXPECT_THROW(core::trust::dbus::BusPool::instance().bus_for_address(""), std::invalid_argument);
+}
+
 TEST_F(DBusAgent, public_api_with_daemon_works)
 {
     using namespace ::testing;
@@ -201,6 +235,10 @@ TEST_F(DBusAgent, remote_invocation_works_correctly)
                 [agent](const core::trust::Agent::RequestParameters& params)
                 {
                     return agent->authenticate_request_with_parameters(params);
+                },
+                [agent](const core::trust::Agent::BatchRequestParameters& params)
+                {
+                    return agent->authenticate_batch_request_with_parameters(params);
                 }
             }
         };
@@ -286,6 +324,10 @@ TEST_F(DBusAgent, remote_invocation_throws_if_answer_non_conclusive)
                 [agent](const core::trust::Agent::RequestParameters& params)
                 {
                     return agent->authenticate_request_with_parameters(params);
+                },
+                [agent](const core::trust::Agent::BatchRequestParameters& params)
+                {
+                    return agent->authenticate_batch_request_with_parameters(params);
                 }
             }
         };
@@ -384,7 +426,9 @@ TEST_F(DBusAgentRegistry, remote_invocation_works_correctly)
             {
                 object,
                 bus,
-                agent_registry
+                agent_registry,
+                // No decisions are cached.
+                {}
             }
         };
 
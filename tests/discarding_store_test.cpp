@@ -0,0 +1,197 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <core/trust/discarding_store.h>
+
+#include "mock_agent.h"
+#include "mock_store.h"
+#include "the.h"
+
+#include <gmock/gmock.h>
+
+namespace
+{
+// Records groups of requests handed to the store.
+struct MockGroupingStore : public MockStore
+{
+    MOCK_METHOD1(add_all, void(const std::vector<core::trust::Request>&));
+};
+
+std::shared_ptr<testing::NiceMock<MockAgent>> a_mocked_agent()
+{
+    return std::make_shared<testing::NiceMock<MockAgent>>();
+}
+
+std::shared_ptr<testing::NiceMock<MockGroupingStore>> a_mocked_store()
+{
+    using namespace ::testing;
+
+    auto store = std::make_shared<NiceMock<MockGroupingStore>>();
+    ON_CALL(*store, query()).WillByDefault(Return(std::make_shared<NiceMock<MockStore::MockQuery>>()));
+    return store;
+}
+
+// Returns a cached agent keeping all answers obtained from agent pending, until flushed.
+core::trust::CachedAgent::Ptr a_write_behind_agent_for(const std::shared_ptr<core::trust::Agent>& agent, const std::shared_ptr<core::trust::Store>& store)
+{
+    return std::make_shared<core::trust::CachedAgent>(
+        core::trust::CachedAgent::Configuration
+        {
+            agent,
+            store,
+            std::make_shared<core::trust::CachedAgent::Reporter>(),
+            core::trust::CachedAgent::Persistence::write_behind(std::chrono::minutes{1}, 64)
+        });
+}
+}
+
+TEST(DiscardingStore, ctor_throws_for_null_agent)
+{
+    EXPECT_ANY_THROW(core::trust::DiscardingStore(a_mocked_store(), core::trust::CachedAgent::Ptr{}));
+}
+
+TEST(DiscardingStore, persists_pending_answers_before_adding_a_request)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+
+    auto mocked_agent = a_mocked_agent();
+    auto mocked_store = a_mocked_store();
+
+    ON_CALL(*mocked_agent, authenticate_request_with_parameters(_))
+            .WillByDefault(Return(core::trust::Request::Answer::granted));
+
+    core::trust::Request request
+    {
+        params.application.id,
+        params.feature,
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::denied
+    };
+
+    {
+        InSequence seq;
+        EXPECT_CALL(*mocked_store, add_all(SizeIs(1))).Times(1);
+        EXPECT_CALL(*mocked_store, add(request)).Times(1);
+    }
+
+    auto cached_agent = a_write_behind_agent_for(mocked_agent, mocked_store);
+    core::trust::DiscardingStore store{mocked_store, cached_agent};
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, cached_agent->authenticate_request_with_parameters(params));
+    store.add(request);
+}
+
+TEST(DiscardingStore, discards_pending_answers_of_a_removed_application)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+
+    auto mocked_agent = a_mocked_agent();
+    auto mocked_store = a_mocked_store();
+
+    ON_CALL(*mocked_agent, authenticate_request_with_parameters(_))
+            .WillByDefault(Return(core::trust::Request::Answer::granted));
+
+    EXPECT_CALL(*mocked_store, remove_application(params.application.id)).Times(1);
+    EXPECT_CALL(*mocked_store, add_all(_)).Times(0);
+
+    auto cached_agent = a_write_behind_agent_for(mocked_agent, mocked_store);
+    core::trust::DiscardingStore store{mocked_store, cached_agent};
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, cached_agent->authenticate_request_with_parameters(params));
+    store.remove_application(params.application.id);
+    cached_agent->flush();
+}
+
+TEST(DiscardingStore, keeps_pending_answers_of_other_applications)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+
+    auto mocked_agent = a_mocked_agent();
+    auto mocked_store = a_mocked_store();
+
+    ON_CALL(*mocked_agent, authenticate_request_with_parameters(_))
+            .WillByDefault(Return(core::trust::Request::Answer::granted));
+
+    EXPECT_CALL(*mocked_store, remove_application("com.ubuntu.other")).Times(1);
+    EXPECT_CALL(*mocked_store, add_all(SizeIs(1))).Times(1);
+
+    auto cached_agent = a_write_behind_agent_for(mocked_agent, mocked_store);
+    core::trust::DiscardingStore store{mocked_store, cached_agent};
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, cached_agent->authenticate_request_with_parameters(params));
+    store.remove_application("com.ubuntu.other");
+    cached_agent->flush();
+}
+
+TEST(DiscardingStore, discards_pending_answers_matching_a_query_whose_results_are_erased)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+    auto other_params = params;
+    other_params.feature = core::trust::Feature{params.feature.value + 1};
+
+    auto mocked_agent = a_mocked_agent();
+    auto mocked_store = a_mocked_store();
+
+    ON_CALL(*mocked_agent, authenticate_request_with_parameters(_))
+            .WillByDefault(Return(core::trust::Request::Answer::granted));
+
+    // Only the answer for the other feature survives.
+    EXPECT_CALL(*mocked_store, add_all(ElementsAre(Field(&core::trust::Request::feature, other_params.feature)))).Times(1);
+
+    auto cached_agent = a_write_behind_agent_for(mocked_agent, mocked_store);
+    core::trust::DiscardingStore store{mocked_store, cached_agent};
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, cached_agent->authenticate_request_with_parameters(params));
+    EXPECT_EQ(core::trust::Request::Answer::granted, cached_agent->authenticate_request_with_parameters(other_params));
+
+    auto query = store.query();
+    query->for_feature(params.feature);
+    query->erase_all();
+
+    cached_agent->flush();
+}
+
+TEST(DiscardingStore, discards_all_pending_answers_on_reset)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+
+    auto mocked_agent = a_mocked_agent();
+    auto mocked_store = a_mocked_store();
+
+    ON_CALL(*mocked_agent, authenticate_request_with_parameters(_))
+            .WillByDefault(Return(core::trust::Request::Answer::granted));
+
+    EXPECT_CALL(*mocked_store, reset()).Times(1);
+    EXPECT_CALL(*mocked_store, add_all(_)).Times(0);
+
+    auto cached_agent = a_write_behind_agent_for(mocked_agent, mocked_store);
+    core::trust::DiscardingStore store{mocked_store, cached_agent};
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, cached_agent->authenticate_request_with_parameters(params));
+    store.reset();
+    cached_agent->flush();
+}
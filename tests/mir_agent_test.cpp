@@ -21,6 +21,7 @@
 #include <core/trust/mir/config.h>
 
 #include <core/trust/agent.h>
+#include <core/trust/i18n.h>
 #include <core/trust/request.h>
 #include <core/trust/store.h>
 
@@ -31,6 +32,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <future>
 #include <random>
 #include <thread>
 
@@ -77,20 +79,20 @@ struct MockPromptProviderHelper : public core::trust::mir::PromptProviderHelper
         : core::trust::mir::PromptProviderHelper{args}
     {
         using namespace ::testing;
-        ON_CALL(*this, exec_prompt_provider_with_arguments(_))
+        ON_CALL(*this, exec_prompt_provider_with_translated_arguments(_))
                 .WillByDefault(
-                    Invoke(this, &MockPromptProviderHelper::super_exec_prompt_provider_with_arguments));
+                    Invoke(this, &MockPromptProviderHelper::super_exec_prompt_provider_with_translated_arguments));
     }
 
     // Execs the executable provided at construction time for the arguments and
-    // returns the corresponding child process.
-    MOCK_METHOD1(exec_prompt_provider_with_arguments,
+    // returns the corresponding child process, the description has been translated already.
+    MOCK_METHOD1(exec_prompt_provider_with_translated_arguments,
                  core::posix::ChildProcess(
                      const core::trust::mir::PromptProviderHelper::InvocationArguments&));
 
-    core::posix::ChildProcess super_exec_prompt_provider_with_arguments(const core::trust::mir::PromptProviderHelper::InvocationArguments& args)
+    core::posix::ChildProcess super_exec_prompt_provider_with_translated_arguments(const core::trust::mir::PromptProviderHelper::InvocationArguments& args)
     {
-        return core::trust::mir::PromptProviderHelper::exec_prompt_provider_with_arguments(args);
+        return core::trust::mir::PromptProviderHelper::exec_prompt_provider_with_translated_arguments(args);
     }
 };
 
@@ -230,6 +232,31 @@ TEST(DefaultPromptProviderHelper, correctly_passes_arguments_to_prompt_executabl
     core::posix::this_process::env::unset_or_throw("CORE_TRUST_MIR_PROMPT_TESTING");
 }
 
+TEST(DefaultPromptProviderHelper, translates_the_description_prior_to_exec_ing_the_prompt_executable)
+{
+    using namespace ::testing;
+
+    core::trust::mir::PromptProviderHelper::InvocationArguments iargs
+    {
+        42,
+        {
+            "/tmp",
+            "Does not exist",
+            "does.not.exist.application"
+        },
+        "Just an extended description for %1%"
+    };
+
+    auto translated = iargs;
+    translated.description = core::trust::i18n::tr(iargs.description, core::trust::i18n::service_text_domain());
+
+    MockPromptProviderHelper helper{core::trust::mir::PromptProviderHelper::CreationArguments{"/bin/false"}};
+
+    EXPECT_CALL(helper, exec_prompt_provider_with_translated_arguments(translated)).Times(1);
+
+    helper.exec_prompt_provider_with_arguments(iargs);
+}
+
 TEST(MirAgent, creates_prompt_session_and_execs_helper_with_preauthenticated_fd)
 {
     using namespace ::testing;
@@ -279,7 +306,7 @@ TEST(MirAgent, creates_prompt_session_and_execs_helper_with_preauthenticated_fd)
     EXPECT_CALL(*prompt_session_vtable, new_fd_for_prompt_provider()).Times(1);
 
     EXPECT_CALL(*prompt_provider_exec_helper,
-                exec_prompt_provider_with_arguments(
+                exec_prompt_provider_with_translated_arguments(
                     reference_invocation_args)).Times(1);
 
     core::trust::mir::Agent agent
@@ -291,6 +318,10 @@ TEST(MirAgent, creates_prompt_session_and_execs_helper_with_preauthenticated_fd)
             core::trust::mir::Agent::translator_only_accepting_exit_status_success(),
             app_info_resolver,
             parent_pid_resolver->GetStdFunction(),
+            // No caching of process ancestry.
+            {},
+            // No latency reporting.
+            {}
         }
     };
 
@@ -306,6 +337,77 @@ TEST(MirAgent, creates_prompt_session_and_execs_helper_with_preauthenticated_fd)
                   }));
 }
 
+TEST(MirAgent, prompts_once_per_feature_of_a_batch_request)
+{
+    using namespace ::testing;
+
+    const core::trust::Pid app_pid {21};
+    const std::string app_id {"does.not.exist.application"};
+    const std::string app_description {"This is just an extended description %1%"};
+    const int pre_authenticated_fd {42};
+
+    auto connection_vtable = a_mocked_connection_vtable();
+    auto prompt_session_vtable = a_mocked_prompt_session_vtable();
+
+    auto prompt_provider_exec_helper = a_mocked_prompt_provider_calling_bin_false();
+    auto app_info_resolver = a_mocked_app_info_resolver();
+    auto parent_pid_resolver = a_mocked_parent_pid_resolver();
+
+    ON_CALL(*connection_vtable, create_prompt_session_sync(_, _, _))
+            .WillByDefault(Return(prompt_session_vtable));
+
+    ON_CALL(*prompt_session_vtable, error_message())
+            .WillByDefault(Return(std::string()));
+
+    ON_CALL(*prompt_session_vtable, new_fd_for_prompt_provider())
+            .WillByDefault(Return(pre_authenticated_fd));
+
+    ON_CALL(*prompt_session_vtable, add_prompt_provider_sync(_))
+            .WillByDefault(Return(true));
+
+    ON_CALL(*app_info_resolver, resolve(_))
+            .WillByDefault(Return(core::trust::mir::AppInfo{"/tmp", "Does not exist", app_id}));
+
+    // The prompt does not present the feature, and we cannot apply a single answer to all of them.
+    EXPECT_CALL(*connection_vtable, create_prompt_session_sync(app_pid, _, _)).Times(2);
+    EXPECT_CALL(*prompt_provider_exec_helper, exec_prompt_provider_with_translated_arguments(_)).Times(2);
+
+    core::trust::mir::Agent agent
+    {
+        core::trust::mir::Agent::Configuration
+        {
+            connection_vtable,
+            prompt_provider_exec_helper,
+            core::trust::mir::Agent::translator_only_accepting_exit_status_success(),
+            app_info_resolver,
+            parent_pid_resolver->GetStdFunction(),
+            // No caching of process ancestry.
+            {},
+            // No latency reporting.
+            {}
+        }
+    };
+
+    auto answers = agent.authenticate_batch_request_with_parameters(
+                core::trust::Agent::BatchRequestParameters
+                {
+                    {
+                        core::trust::Uid{::getuid()},
+                        app_pid,
+                        app_id
+                    },
+                    {
+                        core::trust::Feature{1},
+                        core::trust::Feature{2}
+                    },
+                    app_description
+                });
+
+    // /bin/false exits with failure.
+    EXPECT_EQ(core::trust::Request::Answer::denied, answers.at(core::trust::Feature{1}));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answers.at(core::trust::Feature{2}));
+}
+
 TEST(MirAgent, calls_into_app_info_resolver_with_app_id)
 {
     using namespace ::testing;
@@ -352,7 +454,7 @@ TEST(MirAgent, calls_into_app_info_resolver_with_app_id)
             .WillRepeatedly(
                 Return(core::trust::mir::AppInfo{app_icon, app_name, app_id}));
     EXPECT_CALL(*prompt_provider_exec_helper,
-                exec_prompt_provider_with_arguments(
+                exec_prompt_provider_with_translated_arguments(
                     reference_invocation_args)).Times(1);
 
     core::trust::mir::Agent agent
@@ -364,6 +466,10 @@ TEST(MirAgent, calls_into_app_info_resolver_with_app_id)
             core::trust::mir::Agent::translator_only_accepting_exit_status_success(),
             app_info_resolver,
             parent_pid_resolver->GetStdFunction(),
+            // No caching of process ancestry.
+            {},
+            // No latency reporting.
+            {}
         }
     };
 
@@ -412,7 +518,7 @@ TEST(MirAgent, sig_kills_prompt_provider_process_on_status_change)
 
     void* prompt_session_state_callback_context{nullptr};
 
-    ON_CALL(*prompt_provider_helper, exec_prompt_provider_with_arguments(_))
+    ON_CALL(*prompt_provider_helper, exec_prompt_provider_with_translated_arguments(_))
             .WillByDefault(
                 Return(
                     core::posix::fork(
@@ -453,6 +559,10 @@ TEST(MirAgent, sig_kills_prompt_provider_process_on_status_change)
             core::trust::mir::Agent::translator_only_accepting_exit_status_success(),
             app_info_resolver,
             parent_pid_resolver->GetStdFunction(),
+            // No caching of process ancestry.
+            {},
+            // No latency reporting.
+            {}
         }
     };
 
@@ -525,7 +635,7 @@ TEST(MirAgent, dont_exec_provider_when_unable_to_create_a_prompt_session)
     EXPECT_CALL(*parent_pid_resolver, Call(_)).Times(0);
     EXPECT_CALL(*prompt_session_vtable, new_fd_for_prompt_provider()).Times(0);
     EXPECT_CALL(*prompt_provider_exec_helper,
-                exec_prompt_provider_with_arguments(_)).Times(0);
+                exec_prompt_provider_with_translated_arguments(_)).Times(0);
 
     core::trust::mir::Agent agent
     {
@@ -536,6 +646,10 @@ TEST(MirAgent, dont_exec_provider_when_unable_to_create_a_prompt_session)
             core::trust::mir::Agent::translator_only_accepting_exit_status_success(),
             app_info_resolver,
             parent_pid_resolver->GetStdFunction(),
+            // No caching of process ancestry.
+            {},
+            // No latency reporting.
+            {}
         }
     };
 
@@ -615,7 +729,7 @@ TEST(MirAgent, creates_prompt_session_for_parent_pid)
     EXPECT_CALL(*prompt_session_vtable, new_fd_for_prompt_provider()).Times(1);
 
     EXPECT_CALL(*prompt_provider_exec_helper,
-                exec_prompt_provider_with_arguments(
+                exec_prompt_provider_with_translated_arguments(
                     reference_invocation_args)).Times(1);
 
     core::trust::mir::Agent agent
@@ -627,6 +741,180 @@ TEST(MirAgent, creates_prompt_session_for_parent_pid)
             core::trust::mir::Agent::translator_only_accepting_exit_status_success(),
             app_info_resolver,
             parent_pid_resolver->GetStdFunction(),
+            // No caching of process ancestry.
+            {},
+            // No latency reporting.
+            {}
+        }
+    };
+
+    EXPECT_EQ(core::trust::Request::Answer::denied, // /bin/false exits with failure.
+              agent.authenticate_request_with_parameters(
+                  core::trust::Agent::RequestParameters
+                  {
+                     core::trust::Uid{::getuid()},
+                     app_pid,
+                     app_id,
+                     feature,
+                     app_description
+                  }));
+}
+
+TEST(MirAgent, caches_parent_pid_with_prompt_session_across_requests)
+{
+    using namespace ::testing;
+
+    const core::trust::Pid app_pid {21};
+    const core::trust::Pid app_parent_pid {7};
+    const std::string app_icon{"/tmp"};
+    const std::string app_name {"Does not exist"};
+    const std::string app_id {"does.not.exist.application"};
+    const core::trust::Feature feature{42};
+    const std::string app_description {"This is just an extended description %1%"};
+    const int pre_authenticated_fd {42};
+
+    auto connection_vtable = a_mocked_connection_vtable();
+    auto prompt_session_vtable_error = a_mocked_prompt_session_vtable();
+    auto prompt_session_vtable = a_mocked_prompt_session_vtable();
+
+    auto prompt_provider_exec_helper = a_mocked_prompt_provider_calling_bin_false();
+    auto app_info_resolver = a_mocked_app_info_resolver();
+    auto parent_pid_resolver = a_mocked_parent_pid_resolver();
+
+    ON_CALL(*prompt_session_vtable, error_message())
+            .WillByDefault(Return(std::string()));
+
+    ON_CALL(*prompt_session_vtable, new_fd_for_prompt_provider())
+            .WillByDefault(Return(pre_authenticated_fd));
+
+    ON_CALL(*prompt_session_vtable, add_prompt_provider_sync(_))
+            .WillByDefault(Return(true));
+
+    ON_CALL(*app_info_resolver, resolve(_))
+            .WillByDefault(Return(core::trust::mir::AppInfo{app_icon, app_name, app_id}));
+
+    // Only the first request has to walk up the process tree.
+    EXPECT_CALL(*connection_vtable, create_prompt_session_sync(app_pid, _, _))
+        .Times(1)
+        .WillOnce(Return(prompt_session_vtable_error));
+    EXPECT_CALL(*prompt_session_vtable_error, error_message())
+        .Times(1)
+        .WillOnce(Return(
+            std::string("Error processing request: Could not identify application session\n")
+        ));
+
+    EXPECT_CALL(*parent_pid_resolver, Call(app_pid))
+        .Times(1)
+        .WillOnce(Return(app_parent_pid));
+    EXPECT_CALL(*connection_vtable, create_prompt_session_sync(app_parent_pid, _, _))
+        .Times(2)
+        .WillRepeatedly(Return(prompt_session_vtable));
+
+    EXPECT_CALL(*prompt_provider_exec_helper,
+                exec_prompt_provider_with_translated_arguments(_)).Times(2);
+
+    core::trust::mir::Agent agent
+    {
+        core::trust::mir::Agent::Configuration
+        {
+            connection_vtable,
+            prompt_provider_exec_helper,
+            core::trust::mir::Agent::translator_only_accepting_exit_status_success(),
+            app_info_resolver,
+            parent_pid_resolver->GetStdFunction(),
+            [](core::trust::Pid pid) { return std::int64_t(pid.value * 100); },
+            // No latency reporting.
+            {}
+        }
+    };
+
+    core::trust::Agent::RequestParameters params
+    {
+        core::trust::Uid{::getuid()},
+        app_pid,
+        app_id,
+        feature,
+        app_description
+    };
+
+    EXPECT_EQ(core::trust::Request::Answer::denied, // /bin/false exits with failure.
+              agent.authenticate_request_with_parameters(params));
+    EXPECT_EQ(core::trust::Request::Answer::denied,
+              agent.authenticate_request_with_parameters(params));
+}
+
+TEST(MirAgent, reports_stage_latencies_and_resolves_app_info_concurrently)
+{
+    using namespace ::testing;
+
+    const core::trust::Pid app_pid {21};
+    const std::string app_icon{"/tmp"};
+    const std::string app_name {"Does not exist"};
+    const std::string app_id {"does.not.exist.application"};
+    const core::trust::Feature feature{42};
+    const std::string app_description {"This is just an extended description %1%"};
+    const int pre_authenticated_fd {42};
+
+    auto connection_vtable = a_mocked_connection_vtable();
+    auto prompt_session_vtable = a_mocked_prompt_session_vtable();
+
+    auto prompt_provider_exec_helper = a_mocked_prompt_provider_calling_bin_false();
+    auto app_info_resolver = a_mocked_app_info_resolver();
+    auto parent_pid_resolver = a_mocked_parent_pid_resolver();
+
+    ON_CALL(*prompt_session_vtable, error_message())
+            .WillByDefault(Return(std::string()));
+
+    ON_CALL(*prompt_session_vtable, new_fd_for_prompt_provider())
+            .WillByDefault(Return(pre_authenticated_fd));
+
+    // Resolving the app info must not be serialized after the compositor calls: We
+    // only hand out the prompt session once the app info resolver has been invoked.
+    std::promise<void> app_info_resolved;
+    auto app_info_resolved_future = app_info_resolved.get_future();
+    bool resolved_concurrently{false};
+
+    EXPECT_CALL(*app_info_resolver, resolve(app_id))
+            .Times(1)
+            .WillOnce(DoAll(
+                InvokeWithoutArgs([&app_info_resolved]() { app_info_resolved.set_value(); }),
+                Return(core::trust::mir::AppInfo{app_icon, app_name, app_id})));
+
+    EXPECT_CALL(*connection_vtable, create_prompt_session_sync(app_pid, _, _))
+            .Times(1)
+            .WillOnce(DoAll(
+                InvokeWithoutArgs([&app_info_resolved_future, &resolved_concurrently]()
+                {
+                    resolved_concurrently =
+                            app_info_resolved_future.wait_for(std::chrono::seconds{5}) == std::future_status::ready;
+                }),
+                Return(prompt_session_vtable)));
+    EXPECT_CALL(*prompt_session_vtable, new_fd_for_prompt_provider())
+            .Times(1)
+            .WillOnce(Return(pre_authenticated_fd));
+
+    EXPECT_CALL(*prompt_provider_exec_helper,
+                exec_prompt_provider_with_translated_arguments(_)).Times(1);
+
+    unsigned int reports{0};
+    core::trust::mir::Agent::StageLatencies reported{};
+
+    core::trust::mir::Agent agent
+    {
+        core::trust::mir::Agent::Configuration
+        {
+            connection_vtable,
+            prompt_provider_exec_helper,
+            core::trust::mir::Agent::translator_only_accepting_exit_status_success(),
+            app_info_resolver,
+            parent_pid_resolver->GetStdFunction(),
+            // No caching of process ancestry.
+            {},
+            [&reports, &reported](const core::trust::mir::Agent::StageLatencies& latencies)
+            {
+                reports++;
+                reported = latencies;
+            }
         }
     };
 
@@ -640,6 +928,59 @@ TEST(MirAgent, creates_prompt_session_for_parent_pid)
                      feature,
                      app_description
                   }));
+
+    EXPECT_TRUE(resolved_concurrently);
+    EXPECT_EQ(1u, reports);
+    EXPECT_LE(reported.prompt_session_setup + reported.fd_acquisition + reported.pipeline_stall,
+              reported.time_to_prompt);
+}
+
+TEST(PromptSessionAncestryCache, drops_entry_if_ancestor_start_time_changed)
+{
+    std::int64_t ancestor_start_time{1000};
+
+    core::trust::mir::PromptSessionAncestryCache cache
+    {
+        [&ancestor_start_time](core::trust::Pid pid)
+        {
+            return pid.value == 7 ? ancestor_start_time : std::int64_t(pid.value);
+        }
+    };
+
+    cache.remember(core::trust::Pid{21}, 21, core::trust::Pid{7});
+
+    core::trust::Pid ancestor{0};
+    EXPECT_TRUE(cache.lookup(core::trust::Pid{21}, 21, ancestor));
+    EXPECT_EQ(core::trust::Pid{7}, ancestor);
+
+    // A different process instance reusing the same pid misses.
+    EXPECT_FALSE(cache.lookup(core::trust::Pid{21}, 42, ancestor));
+
+    // The ancestor pid got recycled.
+    ancestor_start_time = 2000;
+    EXPECT_FALSE(cache.lookup(core::trust::Pid{21}, 21, ancestor));
+    EXPECT_EQ(0u, cache.size());
+}
+
+TEST(PromptSessionAncestryCache, evicts_least_recently_used_entry_when_full)
+{
+    core::trust::mir::PromptSessionAncestryCache cache
+    {
+        [](core::trust::Pid pid) { return std::int64_t(pid.value); },
+        2
+    };
+
+    core::trust::Pid ancestor{0};
+
+    cache.remember(core::trust::Pid{10}, 10, core::trust::Pid{1});
+    cache.remember(core::trust::Pid{11}, 11, core::trust::Pid{1});
+    EXPECT_TRUE(cache.lookup(core::trust::Pid{10}, 10, ancestor));
+    cache.remember(core::trust::Pid{12}, 12, core::trust::Pid{1});
+
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_TRUE(cache.lookup(core::trust::Pid{10}, 10, ancestor));
+    EXPECT_FALSE(cache.lookup(core::trust::Pid{11}, 11, ancestor));
+    EXPECT_TRUE(cache.lookup(core::trust::Pid{12}, 12, ancestor));
 }
 
 TEST(TrustPrompt, aborts_for_missing_title)
@@ -31,6 +31,12 @@ struct MockAgent : public core::trust::Agent
      * @param description Extended description of the trust request.
      */
     MOCK_METHOD1(authenticate_request_with_parameters, core::trust::Request::Answer(const core::trust::Agent::RequestParameters&));
+
+    /**
+     * @brief Presents the given batch request to the user, returning the user-provided answers.
+     * @param parameters The trust request covering multiple features that a user has to answer.
+     */
+    MOCK_METHOD1(authenticate_batch_request_with_parameters, core::trust::Agent::BatchAnswer(const core::trust::Agent::BatchRequestParameters&));
 };
 
 #endif // MOCK_AGENT_H_
@@ -43,6 +43,9 @@ struct MockStore : public core::trust::Store
         /** @brief Limit the query for a specific answer. */
         MOCK_METHOD1(for_answer, void(core::trust::Request::Answer));
 
+        /** @brief Limit the query to the given number of most recent results. */
+        MOCK_METHOD1(limit, void(std::size_t));
+
         /** @brief Query all stored requests. */
         MOCK_METHOD0(all, void());
 
@@ -57,6 +60,12 @@ struct MockStore : public core::trust::Store
 
         /** @brief Access the request the query currently points to. */
         MOCK_METHOD0(current, core::trust::Request());
+
+        /** @brief Returns the number of results of the query, without visiting them. */
+        MOCK_METHOD0(count, std::size_t());
+
+        /** @brief Returns true if the query has at least one result. */
+        MOCK_METHOD0(exists, bool());
     };
 
     /** @brief Resets the state of the store, implementations should discard
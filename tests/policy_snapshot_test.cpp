@@ -0,0 +1,287 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/trust/policy_snapshot.h>
+
+#include "mock_agent.h"
+#include "the.h"
+
+#include <gmock/gmock.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+static constexpr const char* snapshot_path_for_testing
+{
+    "/tmp/policy_snapshot_test.snapshot"
+};
+
+std::shared_ptr<testing::NiceMock<MockAgent>> a_mocked_agent()
+{
+    return std::make_shared<testing::NiceMock<MockAgent>>();
+}
+
+core::trust::PolicySnapshot::Ptr a_snapshot_for(const std::vector<core::trust::PolicySnapshot::Rule>& rules)
+{
+    core::trust::PolicySnapshot::compile(rules, snapshot_path_for_testing);
+    return core::trust::PolicySnapshot::open(snapshot_path_for_testing);
+}
+
+core::trust::PolicySnapshot::Rule a_rule(const std::string& pattern, std::uint64_t feature, core::trust::Request::Answer answer)
+{
+    return core::trust::PolicySnapshot::Rule{pattern, core::trust::Feature{feature}, answer};
+}
+}
+
+TEST(PolicySnapshot, parsing_rules_skips_comments_and_empty_lines)
+{
+    std::stringstream ss
+    {
+        "# A comment\n"
+        "\n"
+        "com.ubuntu.camera_camera 0 granted\n"
+        "   com.ubuntu.* 1 denied\n"
+    };
+
+    auto rules = core::trust::PolicySnapshot::parse_rules(ss);
+
+    ASSERT_EQ(2u, rules.size());
+    EXPECT_EQ("com.ubuntu.camera_camera", rules[0].pattern);
+    EXPECT_EQ(core::trust::Feature{0}, rules[0].feature);
+    EXPECT_EQ(core::trust::Request::Answer::granted, rules[0].answer);
+    EXPECT_EQ("com.ubuntu.*", rules[1].pattern);
+    EXPECT_EQ(core::trust::Feature{1}, rules[1].feature);
+    EXPECT_EQ(core::trust::Request::Answer::denied, rules[1].answer);
+}
+
+TEST(PolicySnapshot, parsing_malformed_rules_throws)
+{
+    std::stringstream missing_answer{"com.ubuntu.camera_camera 0\n"};
+    EXPECT_THROW(core::trust::PolicySnapshot::parse_rules(missing_answer), std::runtime_error);
+
+    std::stringstream unknown_answer{"com.ubuntu.camera_camera 0 maybe\n"};
+    EXPECT_THROW(core::trust::PolicySnapshot::parse_rules(unknown_answer), std::runtime_error);
+
+    std::stringstream trailing_garbage{"com.ubuntu.camera_camera 0 granted 42\n"};
+    EXPECT_THROW(core::trust::PolicySnapshot::parse_rules(trailing_garbage), std::runtime_error);
+}
+
+TEST(PolicySnapshot, compiling_patterns_with_inner_wildcards_throws)
+{
+    EXPECT_THROW(core::trust::PolicySnapshot::compile(
+                     {a_rule("com.*.camera", 0, core::trust::Request::Answer::granted)},
+                     snapshot_path_for_testing),
+                 std::runtime_error);
+}
+
+TEST(PolicySnapshot, lookup_finds_exact_matches_only_for_the_given_feature)
+{
+    auto snapshot = a_snapshot_for(
+    {
+        a_rule("com.ubuntu.camera_camera", 0, core::trust::Request::Answer::granted),
+        a_rule("com.ubuntu.camera_camera", 1, core::trust::Request::Answer::denied)
+    });
+
+    core::trust::Request::Answer answer;
+
+    EXPECT_TRUE(snapshot->lookup("com.ubuntu.camera_camera", core::trust::Feature{0}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::granted, answer);
+    EXPECT_TRUE(snapshot->lookup("com.ubuntu.camera_camera", core::trust::Feature{1}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answer);
+
+    EXPECT_FALSE(snapshot->lookup("com.ubuntu.camera_camera", core::trust::Feature{2}, answer));
+    EXPECT_FALSE(snapshot->lookup("com.ubuntu.camera", core::trust::Feature{0}, answer));
+    EXPECT_FALSE(snapshot->lookup("com.ubuntu.camera_camera_1.2.3", core::trust::Feature{0}, answer));
+}
+
+TEST(PolicySnapshot, exact_matches_take_precedence_over_the_longest_matching_prefix)
+{
+    auto snapshot = a_snapshot_for(
+    {
+        a_rule("*", 0, core::trust::Request::Answer::denied),
+        a_rule("com.ubuntu.*", 0, core::trust::Request::Answer::granted),
+        a_rule("com.ubuntu.evil*", 0, core::trust::Request::Answer::denied),
+        a_rule("com.ubuntu.evil_trusted", 0, core::trust::Request::Answer::granted)
+    });
+
+    core::trust::Request::Answer answer;
+
+    EXPECT_TRUE(snapshot->lookup("com.ubuntu.camera_camera", core::trust::Feature{0}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::granted, answer);
+    EXPECT_TRUE(snapshot->lookup("com.ubuntu.evil_app", core::trust::Feature{0}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answer);
+    EXPECT_TRUE(snapshot->lookup("com.ubuntu.evil_trusted", core::trust::Feature{0}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::granted, answer);
+    EXPECT_TRUE(snapshot->lookup("org.example.app", core::trust::Feature{0}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answer);
+}
+
+TEST(PolicySnapshot, later_rules_override_earlier_rules)
+{
+    auto snapshot = a_snapshot_for(
+    {
+        a_rule("com.ubuntu.camera_camera", 0, core::trust::Request::Answer::granted),
+        a_rule("com.ubuntu.camera_camera", 0, core::trust::Request::Answer::denied)
+    });
+
+    core::trust::Request::Answer answer;
+
+    EXPECT_EQ(1u, snapshot->size());
+    EXPECT_TRUE(snapshot->lookup("com.ubuntu.camera_camera", core::trust::Feature{0}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answer);
+}
+
+TEST(PolicySnapshot, lookup_finds_all_rules_of_a_large_policy)
+{
+    static constexpr const unsigned int rule_count{10000};
+
+    std::vector<core::trust::PolicySnapshot::Rule> rules;
+    for (unsigned int i = 0; i < rule_count; i++)
+        rules.push_back(a_rule("does.not.exist.app" + std::to_string(i / 10), i % 10,
+                               i % 3 == 0 ? core::trust::Request::Answer::granted : core::trust::Request::Answer::denied));
+
+    auto snapshot = a_snapshot_for(rules);
+    EXPECT_EQ(rule_count, snapshot->size());
+
+    for (const auto& rule : rules)
+    {
+        core::trust::Request::Answer answer;
+        EXPECT_TRUE(snapshot->lookup(rule.pattern, rule.feature, answer));
+        EXPECT_EQ(rule.answer, answer);
+    }
+
+    core::trust::Request::Answer answer;
+    EXPECT_FALSE(snapshot->lookup("does.not.exist.app", core::trust::Feature{0}, answer));
+}
+
+TEST(PolicySnapshot, an_empty_policy_compiles_to_an_empty_snapshot)
+{
+    auto snapshot = a_snapshot_for({});
+
+    core::trust::Request::Answer answer;
+
+    EXPECT_EQ(0u, snapshot->size());
+    EXPECT_FALSE(snapshot->lookup("com.ubuntu.camera_camera", core::trust::Feature{0}, answer));
+}
+
+TEST(PolicySnapshot, opening_a_truncated_snapshot_throws)
+{
+    core::trust::PolicySnapshot::compile(
+        {a_rule("com.ubuntu.camera_camera", 0, core::trust::Request::Answer::granted)},
+        snapshot_path_for_testing);
+
+    std::string content;
+    {
+        std::ifstream in{snapshot_path_for_testing, std::ios::binary};
+        content.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+    }
+
+    {
+        std::ofstream out{snapshot_path_for_testing, std::ios::binary | std::ios::trunc};
+        out.write(content.data(), content.size() - 1);
+    }
+
+    EXPECT_THROW(core::trust::PolicySnapshot::open(snapshot_path_for_testing), std::runtime_error);
+    EXPECT_THROW(core::trust::PolicySnapshot::open("/tmp/this.snapshot.does.not.exist"), std::runtime_error);
+}
+
+TEST(PolicySnapshotAgent, ctor_throws_for_null_snapshot_or_agent)
+{
+    EXPECT_ANY_THROW(core::trust::PolicySnapshotAgent(core::trust::PolicySnapshot::Ptr{}, a_mocked_agent()));
+    EXPECT_ANY_THROW(core::trust::PolicySnapshotAgent(a_snapshot_for({}), std::shared_ptr<core::trust::Agent>{}));
+}
+
+TEST(PolicySnapshotAgent, answers_covered_requests_without_consulting_impl)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+
+    auto mock_agent = a_mocked_agent();
+    EXPECT_CALL(*mock_agent, authenticate_request_with_parameters(_))
+            .Times(0);
+
+    core::trust::PolicySnapshotAgent agent
+    {
+        a_snapshot_for({a_rule(params.application.id, params.feature.value, core::trust::Request::Answer::granted)}),
+        mock_agent
+    };
+
+    EXPECT_EQ(core::trust::Request::Answer::granted,
+              agent.authenticate_request_with_parameters(params));
+}
+
+TEST(PolicySnapshotAgent, dispatches_to_impl_for_uncovered_requests)
+{
+    using namespace ::testing;
+
+    auto params = the::default_request_parameters_for_testing();
+
+    auto mock_agent = a_mocked_agent();
+    EXPECT_CALL(*mock_agent, authenticate_request_with_parameters(params))
+            .Times(1)
+            .WillRepeatedly(Return(core::trust::Request::Answer::denied));
+
+    core::trust::PolicySnapshotAgent agent
+    {
+        a_snapshot_for({a_rule(params.application.id, params.feature.value + 1, core::trust::Request::Answer::granted)}),
+        mock_agent
+    };
+
+    EXPECT_EQ(core::trust::Request::Answer::denied,
+              agent.authenticate_request_with_parameters(params));
+}
+
+TEST(PolicySnapshotAgent, only_dispatches_uncovered_features_of_batch_requests_to_impl)
+{
+    using namespace ::testing;
+
+    core::trust::Agent::BatchRequestParameters params
+    {
+        {
+            the::default_uid_for_testing(),
+            the::default_pid_for_testing(),
+            "com.ubuntu.camera_camera"
+        },
+        {core::trust::Feature{0}, core::trust::Feature{1}},
+        "Someone wants to access your camera and microphone."
+    };
+
+    auto remaining = params;
+    remaining.features = {core::trust::Feature{1}};
+
+    auto mock_agent = a_mocked_agent();
+    EXPECT_CALL(*mock_agent, authenticate_batch_request_with_parameters(_))
+            .Times(1)
+            .WillRepeatedly(Invoke([remaining](const core::trust::Agent::BatchRequestParameters& p)
+            {
+                EXPECT_EQ(remaining.features, p.features);
+                return core::trust::Agent::BatchAnswer{{core::trust::Feature{1}, core::trust::Request::Answer::denied}};
+            }));
+
+    core::trust::PolicySnapshotAgent agent
+    {
+        a_snapshot_for({a_rule("com.ubuntu.*", 0, core::trust::Request::Answer::granted)}),
+        mock_agent
+    };
+
+    auto answers = agent.authenticate_batch_request_with_parameters(params);
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, answers.at(core::trust::Feature{0}));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answers.at(core::trust::Feature{1}));
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Compares the asio and io_uring backends of the unix socket remote agent. For every
+// backend, a stub and a skeleton answering immediately are set up in a child process.
+// We measure per-request latencies and count the syscalls issued by the requesting
+// thread by tracing it from the parent process.
+//
+// Usage: posix_remote_agent_benchmark [requests]
+
+#include <core/trust/remote/helpers.h>
+#include <core/trust/remote/posix.h>
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+static constexpr const char* endpoint_for_benchmark
+{
+    "/tmp/posix.remote.agent.benchmark"
+};
+
+// The number of requests issued before measuring.
+static constexpr const unsigned int warm_up_requests{1000};
+
+// Answers all requests immediately, such that we measure the transport only.
+struct GrantingAgent : public core::trust::Agent
+{
+    core::trust::Request::Answer authenticate_request_with_parameters(const RequestParameters&) override
+    {
+        return core::trust::Request::Answer::granted;
+    }
+};
+
+// A ProcessIdentity that does not issue any syscalls.
+struct StaticProcessIdentity : public core::trust::remote::helpers::ProcessIdentity
+{
+    core::trust::Pid pid() const override { return core::trust::Pid{::getpid()}; }
+    std::int64_t start_time() const override { return 42; }
+    bool is_alive() const override { return true; }
+};
+
+// The results of a single benchmark run, latencies in nanoseconds.
+struct Results
+{
+    std::int64_t p50;
+    std::int64_t p99;
+    double syscalls_per_request;
+};
+
+void read_exactly(int fd, void* data, std::size_t size)
+{
+    if (::read(fd, data, size) != static_cast<ssize_t>(size)) throw std::runtime_error
+    {
+        "Could not read from pipe."
+    };
+}
+
+void write_exactly(int fd, const void* data, std::size_t size)
+{
+    if (::write(fd, data, size) != static_cast<ssize_t>(size)) throw std::runtime_error
+    {
+        "Could not write to pipe."
+    };
+}
+
+// Sets up stub and skeleton for backend and drives requests as instructed by the parent:
+// It first reports p50 and p99 latencies, and then issues the number of requests announced
+// by the parent per traced window, stopping itself at the end of every window.
+void run_child(core::trust::remote::posix::IoBackend backend, unsigned int requests, int to_parent, int from_parent)
+{
+    boost::asio::io_service io_service;
+    boost::asio::io_service::work keep_alive{io_service};
+    std::thread worker{[&io_service]() { io_service.run(); }};
+
+    std::remove(endpoint_for_benchmark);
+
+    auto start_time_resolver = [](core::trust::Pid) { return std::int64_t{42}; };
+    auto process_identity_resolver = [](core::trust::Pid)
+    {
+        return std::make_shared<StaticProcessIdentity>();
+    };
+
+    core::trust::remote::posix::Stub::Configuration stub_config
+    {
+        io_service,
+        boost::asio::local::stream_protocol::endpoint{endpoint_for_benchmark},
+        start_time_resolver,
+        core::trust::remote::posix::Stub::get_sock_opt_credentials_resolver(),
+        std::make_shared<core::trust::remote::posix::Stub::Session::Registry>(),
+        0,
+        process_identity_resolver,
+        backend,
+        std::chrono::milliseconds{0},
+        nullptr,
+        false
+    };
+
+    auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(stub_config);
+
+    auto skeleton = core::trust::remote::posix::Skeleton::create_skeleton_for_configuration(
+                core::trust::remote::posix::Skeleton::Configuration
+                {
+                    std::make_shared<GrantingAgent>(),
+                    io_service,
+                    boost::asio::local::stream_protocol::endpoint{endpoint_for_benchmark},
+                    start_time_resolver,
+                    [](core::trust::Pid) { return "benchmark"; },
+                    "Benchmarking %1%.",
+                    false,
+                    process_identity_resolver,
+                    backend,
+                    {},
+                    {}
+                });
+
+    core::trust::Uid uid{::getuid()};
+
+    while (not stub->has_session_for_uid(uid))
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    core::trust::Agent::RequestParameters parameters
+    {
+        uid,
+        core::trust::Pid{::getpid()},
+        "benchmark",
+        core::trust::Feature{0},
+        ""
+    };
+
+    for (unsigned int i = 0; i < warm_up_requests; i++)
+        stub->authenticate_request_with_parameters(parameters);
+
+    std::vector<std::int64_t> latencies;
+    latencies.reserve(requests);
+
+    for (unsigned int i = 0; i < requests; i++)
+    {
+        auto before = std::chrono::steady_clock::now();
+        stub->authenticate_request_with_parameters(parameters);
+        auto after = std::chrono::steady_clock::now();
+
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    std::int64_t percentiles[2]
+    {
+        latencies[latencies.size() / 2],
+        latencies[latencies.size() * 99 / 100]
+    };
+
+    write_exactly(to_parent, percentiles, sizeof(percentiles));
+
+    // Traced windows, the parent announces the number of requests.
+    unsigned int count{0};
+    while (::read(from_parent, &count, sizeof(count)) == sizeof(count))
+    {
+        for (unsigned int i = 0; i < count; i++)
+            stub->authenticate_request_with_parameters(parameters);
+
+        ::raise(SIGSTOP);
+    }
+
+    io_service.stop();
+    worker.join();
+}
+
+// Traces the child while it issues count requests, returning the number of syscall stops.
+std::uint64_t count_syscall_stops_for_window(pid_t child, unsigned int count, int to_child)
+{
+    if (::ptrace(PTRACE_SEIZE, child, nullptr, PTRACE_O_TRACESYSGOOD) == -1) throw std::system_error
+    {
+        errno, std::system_category()
+    };
+
+    int status{0};
+
+    ::ptrace(PTRACE_INTERRUPT, child, nullptr, nullptr);
+    ::waitpid(child, &status, 0);
+    ::ptrace(PTRACE_SYSCALL, child, nullptr, nullptr);
+
+    write_exactly(to_child, &count, sizeof(count));
+
+    std::uint64_t stops{0};
+
+    while (::waitpid(child, &status, 0) == child)
+    {
+        if (not WIFSTOPPED(status)) throw std::runtime_error
+        {
+            "Child exited while being traced."
+        };
+
+        auto signal = WSTOPSIG(status);
+
+        if (signal == (SIGTRAP | 0x80))
+        {
+            stops++;
+            ::ptrace(PTRACE_SYSCALL, child, nullptr, nullptr);
+        } else if (signal == SIGSTOP)
+        {
+            // The child reached the end of the window, and we suppress the signal.
+            ::ptrace(PTRACE_DETACH, child, nullptr, nullptr);
+            break;
+        } else
+        {
+            ::ptrace(PTRACE_SYSCALL, child, nullptr, signal);
+        }
+    }
+
+    return stops;
+}
+
+Results run(core::trust::remote::posix::IoBackend backend, unsigned int requests)
+{
+    int to_parent[2], to_child[2];
+
+    if (::pipe(to_parent) == -1 || ::pipe(to_child) == -1) throw std::system_error
+    {
+        errno, std::system_category()
+    };
+
+    auto child = ::fork();
+
+    if (child == 0)
+    {
+        ::close(to_parent[0]); ::close(to_child[1]);
+        run_child(backend, requests, to_parent[1], to_child[0]);
+        ::_exit(EXIT_SUCCESS);
+    }
+
+    ::close(to_parent[1]); ::close(to_child[0]);
+
+    std::int64_t percentiles[2];
+    read_exactly(to_parent[0], percentiles, sizeof(percentiles));
+
+    // Syscalls issued at the boundaries of a window cancel out.
+    auto baseline = count_syscall_stops_for_window(child, 0, to_child[1]);
+    auto loaded = count_syscall_stops_for_window(child, requests, to_child[1]);
+
+    ::close(to_child[1]);
+    ::waitpid(child, nullptr, 0);
+    ::close(to_parent[0]);
+
+    // Every syscall results in an entry and an exit stop.
+    return Results
+    {
+        percentiles[0],
+        percentiles[1],
+        (loaded - baseline) / 2.0 / requests
+    };
+}
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int requests = argc > 1 ? std::stoul(argv[1]) : 10000;
+
+    std::printf("%-10s %20s %12s %12s\n", "backend", "syscalls/request", "p50 [us]", "p99 [us]");
+
+    auto report = [](const char* name, const Results& results)
+    {
+        std::printf("%-10s %20.2f %12.2f %12.2f\n", name, results.syscalls_per_request, results.p50 / 1000., results.p99 / 1000.);
+    };
+
+    report("asio", run(core::trust::remote::posix::IoBackend::asio, requests));
+
+#if defined(CORE_TRUST_HAVE_IO_URING)
+    if (core::trust::remote::posix::IoUring::is_supported())
+        report("io_uring", run(core::trust::remote::posix::IoBackend::io_uring, requests));
+    else
+        std::printf("%-10s %s\n", "io_uring", "not supported by the kernel");
+#else
+    std::printf("%-10s %s\n", "io_uring", "not supported by the build");
+#endif
+
+    return EXIT_SUCCESS;
+}
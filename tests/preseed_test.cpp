@@ -25,6 +25,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
 #include <map>
 
 namespace
@@ -93,3 +95,70 @@ TEST(Preseed, correctly_populates_per_service_trust_store)
         query->next(); counter++;
     }
 }
+
+TEST(Preseed, parses_requests_and_skips_blank_lines_and_comments)
+{
+    core::trust::Request r;
+
+    EXPECT_TRUE(core::trust::Preseed::parse_request("  does.not.exist.app \t 42   denied\r", r));
+    EXPECT_EQ("does.not.exist.app", r.from);
+    EXPECT_EQ(core::trust::Feature{42}, r.feature);
+    EXPECT_EQ(core::trust::Request::Answer::denied, r.answer);
+
+    EXPECT_FALSE(core::trust::Preseed::parse_request("", r));
+    EXPECT_FALSE(core::trust::Preseed::parse_request("   ", r));
+    EXPECT_FALSE(core::trust::Preseed::parse_request("# does.not.exist.app 0 granted", r));
+
+    EXPECT_THROW(core::trust::Preseed::parse_request("does.not.exist.app 0", r), std::runtime_error);
+    EXPECT_THROW(core::trust::Preseed::parse_request("does.not.exist.app 0 granted 1", r), std::runtime_error);
+    EXPECT_THROW(core::trust::Preseed::parse_request("does.not.exist.app -1 granted", r), std::runtime_error);
+    EXPECT_THROW(core::trust::Preseed::parse_request("does.not.exist.app 1x granted", r), std::runtime_error);
+    EXPECT_THROW(core::trust::Preseed::parse_request("does.not.exist.app 0 maybe", r), std::runtime_error);
+}
+
+TEST(Preseed, streams_requests_from_input_file_into_per_service_trust_store)
+{
+    const std::string service_name{"JustANameForTesting"};
+    const std::string input{"preseed_test_input.txt"};
+
+    {
+        std::ofstream out{input};
+        out << "# app id               feature     answer" << std::endl;
+        for (unsigned int i = 0; i < 1000; i++)
+            out << "does.not.exist.app" << i % 10 << " " << i % 7 << " " << (i % 2 == 0 ? "granted" : "denied") << std::endl;
+    }
+
+    const std::vector<std::string> argv
+    {
+        "--for-service", service_name,
+        "--request", "does.not.exist.app 7 granted",
+        "--input", input,
+        "--bulk-load"
+    };
+
+    auto store = core::trust::create_default_store(service_name);
+    store->reset();
+
+    auto child = core::posix::exec(
+                core::trust::testing::trust_store_preseed_executable_in_build_dir,
+                argv,
+                a_copy_of_the_current_env(),
+                core::posix::StandardStream::empty);
+
+    auto result = child.wait_for(core::posix::wait::Flags::untraced);
+
+    EXPECT_EQ(core::posix::wait::Result::Status::exited, result.status);
+    EXPECT_EQ(core::posix::exit::Status::success, result.detail.if_exited.status);
+
+    EXPECT_EQ(1001u, store->query()->count());
+
+    auto query = store->query();
+    query->for_application_id("does.not.exist.app3");
+    EXPECT_EQ(100u, query->count());
+
+    query->all();
+    query->for_feature(core::trust::Feature{7});
+    EXPECT_EQ(1u, query->count());
+
+    std::remove(input.c_str());
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <core/trust/publishing_store.h>
+
+#include "mock_store.h"
+
+#include <gmock/gmock.h>
+
+namespace
+{
+std::shared_ptr<testing::NiceMock<MockStore>> a_mocked_store()
+{
+    return std::make_shared<testing::NiceMock<MockStore>>();
+}
+
+std::shared_ptr<testing::NiceMock<MockStore::MockQuery>> a_mocked_query()
+{
+    return std::make_shared<testing::NiceMock<MockStore::MockQuery>>();
+}
+
+// Returns a query yielding request as its only result.
+std::shared_ptr<testing::NiceMock<MockStore::MockQuery>> a_mocked_query_yielding(const core::trust::Request& request)
+{
+    using namespace ::testing;
+
+    auto visited = std::make_shared<bool>(false);
+
+    auto query = a_mocked_query();
+    ON_CALL(*query, status()).WillByDefault(Invoke([visited]()
+    {
+        return *visited ? core::trust::Store::Query::Status::eor : core::trust::Store::Query::Status::has_more_results;
+    }));
+    ON_CALL(*query, current()).WillByDefault(Return(request));
+    ON_CALL(*query, next()).WillByDefault(Invoke([visited]() { *visited = true; }));
+    return query;
+}
+
+// Returns a query without results.
+std::shared_ptr<testing::NiceMock<MockStore::MockQuery>> an_empty_mocked_query()
+{
+    using namespace ::testing;
+
+    auto query = a_mocked_query();
+    ON_CALL(*query, status()).WillByDefault(Return(core::trust::Store::Query::Status::eor));
+    return query;
+}
+
+core::trust::PublishingStore::IsAuthoritative always_authoritative()
+{
+    return [](const std::string&, core::trust::Feature) { return true; };
+}
+
+core::trust::Request a_request_for(const std::string& app_id, core::trust::Feature feature, core::trust::Request::Answer answer)
+{
+    return core::trust::Request
+    {
+        app_id,
+        feature,
+        std::chrono::system_clock::now(),
+        answer
+    };
+}
+}
+
+TEST(PublishingStore, ctor_throws_for_null_table)
+{
+    EXPECT_ANY_THROW(core::trust::PublishingStore(a_mocked_store(), core::trust::remote::posix::DecisionTable::Ptr{}, always_authoritative()));
+}
+
+TEST(PublishingStore, publishes_the_most_recent_answer_after_adding_a_request)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto table = core::trust::remote::posix::DecisionTable::create(16);
+
+    // The store still knows about a more recent answer than the one added.
+    auto added = a_request_for("com.ubuntu.app", core::trust::Feature{1}, core::trust::Request::Answer::granted);
+    auto most_recent = a_request_for("com.ubuntu.app", core::trust::Feature{1}, core::trust::Request::Answer::denied);
+
+    auto query = a_mocked_query_yielding(most_recent);
+    ON_CALL(*store, query()).WillByDefault(Return(query));
+
+    EXPECT_CALL(*store, add(added)).Times(1);
+    EXPECT_CALL(*query, for_application_id("com.ubuntu.app")).Times(1);
+    EXPECT_CALL(*query, for_feature(core::trust::Feature{1})).Times(1);
+    EXPECT_CALL(*query, limit(1)).Times(1);
+
+    core::trust::PublishingStore publishing_store{store, table, always_authoritative()};
+    publishing_store.add(added);
+
+    core::trust::Request::Answer answer;
+    EXPECT_TRUE(table->lookup("com.ubuntu.app", core::trust::Feature{1}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answer);
+}
+
+TEST(PublishingStore, does_not_publish_answers_that_are_not_authoritative)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto table = core::trust::remote::posix::DecisionTable::create(16);
+
+    EXPECT_CALL(*store, add(_)).Times(1);
+    EXPECT_CALL(*store, query()).Times(0);
+
+    core::trust::PublishingStore publishing_store
+    {
+        store,
+        table,
+        [](const std::string& app_id, core::trust::Feature) { return app_id != "com.ubuntu.app"; }
+    };
+    publishing_store.add(a_request_for("com.ubuntu.app", core::trust::Feature{1}, core::trust::Request::Answer::granted));
+
+    core::trust::Request::Answer answer;
+    EXPECT_FALSE(table->lookup("com.ubuntu.app", core::trust::Feature{1}, answer));
+}
+
+TEST(PublishingStore, withdraws_decisions_after_removing_an_application)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto table = core::trust::remote::posix::DecisionTable::create(16);
+    table->publish("com.ubuntu.app", core::trust::Feature{1}, core::trust::Request::Answer::granted);
+    table->publish("com.ubuntu.other", core::trust::Feature{1}, core::trust::Request::Answer::granted);
+
+    EXPECT_CALL(*store, remove_application("com.ubuntu.app")).Times(1);
+
+    core::trust::PublishingStore publishing_store{store, table, always_authoritative()};
+    publishing_store.remove_application("com.ubuntu.app");
+
+    core::trust::Request::Answer answer;
+    EXPECT_FALSE(table->lookup("com.ubuntu.app", core::trust::Feature{1}, answer));
+    EXPECT_TRUE(table->lookup("com.ubuntu.other", core::trust::Feature{1}, answer));
+}
+
+TEST(PublishingStore, clears_decisions_after_a_reset)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto table = core::trust::remote::posix::DecisionTable::create(16);
+    table->publish("com.ubuntu.app", core::trust::Feature{1}, core::trust::Request::Answer::granted);
+
+    EXPECT_CALL(*store, reset()).Times(1);
+
+    core::trust::PublishingStore publishing_store{store, table, always_authoritative()};
+    publishing_store.reset();
+
+    core::trust::Request::Answer answer;
+    EXPECT_FALSE(table->lookup("com.ubuntu.app", core::trust::Feature{1}, answer));
+}
+
+TEST(PublishingStore, withdraws_decisions_without_remaining_answers_after_erasing_query_results)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto table = core::trust::remote::posix::DecisionTable::create(16);
+    table->publish("com.ubuntu.app", core::trust::Feature{1}, core::trust::Request::Answer::granted);
+
+    auto erased = a_request_for("com.ubuntu.app", core::trust::Feature{1}, core::trust::Request::Answer::granted);
+
+    // The first query is the one erasing results, the second one looks for remaining answers.
+    auto query = a_mocked_query_yielding(erased);
+    EXPECT_CALL(*store, query())
+            .WillOnce(Return(query))
+            .WillOnce(Return(an_empty_mocked_query()));
+    EXPECT_CALL(*query, erase()).Times(1);
+
+    core::trust::PublishingStore publishing_store{store, table, always_authoritative()};
+
+    auto q = publishing_store.query();
+    q->execute();
+    q->erase();
+
+    core::trust::Request::Answer answer;
+    EXPECT_FALSE(table->lookup("com.ubuntu.app", core::trust::Feature{1}, answer));
+}
+
+TEST(PublishingStore, republishes_the_keys_of_loaded_requests)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto table = core::trust::remote::posix::DecisionTable::create(16);
+
+    auto loaded = a_request_for("com.ubuntu.app", core::trust::Feature{1}, core::trust::Request::Answer::denied);
+
+    ON_CALL(*store, query()).WillByDefault(Return(a_mocked_query_yielding(loaded)));
+    // The default implementation of load adds requests in groups.
+    EXPECT_CALL(*store, add(loaded)).Times(2);
+
+    std::vector<core::trust::Request> requests{loaded, loaded};
+
+    core::trust::PublishingStore publishing_store{store, table, always_authoritative()};
+    EXPECT_EQ(2u, publishing_store.load([&requests](core::trust::Request& request)
+    {
+        if (requests.empty())
+            return false;
+
+        request = requests.back();
+        requests.pop_back();
+        return true;
+    }, false));
+
+    core::trust::Request::Answer answer;
+    EXPECT_TRUE(table->lookup("com.ubuntu.app", core::trust::Feature{1}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answer);
+}
@@ -18,6 +18,8 @@
 
 // Implementation-specific header
 #include <core/trust/remote/agent.h>
+#include <core/trust/remote/decision_cache.h>
+#include <core/trust/remote/decision_table.h>
 #include <core/trust/remote/dbus.h>
 #include <core/trust/remote/posix.h>
 
@@ -33,8 +35,17 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <cstring>
 #include <thread>
 
+#if defined(CORE_TRUST_HAVE_IO_URING)
+#include <linux/io_uring.h>
+#endif
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+
 namespace
 {
 struct MockRemoteAgentStub : public core::trust::remote::Agent::Stub
@@ -69,6 +80,35 @@ TEST(RemoteAgentStub, calls_send_for_handling_requests_and_returns_answer)
               stub.authenticate_request_with_parameters(parameters));
 }
 
+TEST(RemoteAgentStub, calls_send_per_feature_for_batch_requests_by_default)
+{
+    using namespace ::testing;
+
+    core::trust::Agent::BatchRequestParameters parameters
+    {
+        {
+            core::trust::Uid{21},
+            core::trust::Pid{42},
+            std::string{"does.not.exist"}
+        },
+        {
+            core::trust::Feature{1},
+            core::trust::Feature{2}
+        },
+        std::string{"some meaningless description"}
+    };
+
+    MockRemoteAgentStub stub;
+    EXPECT_CALL(stub, send(_))
+            .Times(2)
+            .WillRepeatedly(Return(core::trust::Request::Answer::granted));
+
+    auto answers = stub.authenticate_batch_request_with_parameters(parameters);
+    EXPECT_EQ(2u, answers.size());
+    EXPECT_EQ(core::trust::Request::Answer::granted, answers.at(core::trust::Feature{1}));
+    EXPECT_EQ(core::trust::Request::Answer::granted, answers.at(core::trust::Feature{2}));
+}
+
 TEST(RemoteAgentSkeleton, calls_out_to_implementation)
 {
     using namespace ::testing;
@@ -177,6 +217,373 @@ TEST(RemoteAgentStubSessionRegistry, removing_a_non_existing_session_does_not_th
 }
 
 
+TEST(RemoteAgentStubSessionRegistry, try_resolve_returns_session_iff_known)
+{
+    using Session = core::trust::remote::posix::Stub::Session;
+
+    boost::asio::io_service io_service;
+
+    Session::Ptr session
+    {
+        new Session
+        {
+            io_service
+        }
+    };
+
+    Session::Registry::Ptr registry
+    {
+        new Session::Registry{}
+    };
+
+    core::trust::Uid uid{::getuid()};
+
+    EXPECT_FALSE(registry->try_resolve_session_for_uid(uid));
+    registry->add_session_for_uid(uid, session);
+    EXPECT_EQ(session, *registry->try_resolve_session_for_uid(uid));
+    registry->remove_session_for_uid(uid);
+    EXPECT_FALSE(registry->try_resolve_session_for_uid(uid));
+}
+
+TEST(LockingAgentRegistry, lookups_are_consistent_under_concurrent_registrations)
+{
+    core::trust::LockingAgentRegistry registry;
+
+    auto agent = std::make_shared<::testing::NiceMock<MockAgent>>();
+    const core::trust::Uid uid{42};
+
+    std::atomic<bool> done{false};
+
+    std::thread writer{[&]()
+    {
+        for (unsigned int i = 0; i < 1000; i++)
+        {
+            registry.register_agent_for_user(uid, agent);
+            registry.unregister_agent_for_user(uid);
+        }
+
+        done = true;
+    }};
+
+    while (not done)
+    {
+        // Either the agent is known or it is not, but we never observe a torn state.
+        auto resolved = registry.try_resolve_agent_for_user(uid);
+        if (resolved)
+        {
+            EXPECT_EQ(agent, *resolved);
+        }
+    }
+
+    writer.join();
+
+    EXPECT_FALSE(registry.try_resolve_agent_for_user(uid));
+}
+
+TEST(RemoteAgentStubSessionRegistry, keeps_all_sessions_for_a_uid_and_resolves_least_loaded_healthy_one)
+{
+    using Session = core::trust::remote::posix::Stub::Session;
+
+    boost::asio::io_service io_service;
+
+    auto busy = std::make_shared<Session>(io_service);
+    auto idle = std::make_shared<Session>(io_service);
+    auto broken = std::make_shared<Session>(io_service);
+
+    busy->in_flight = 2;
+    broken->healthy = false;
+
+    Session::Registry registry;
+
+    core::trust::Uid uid{::getuid()};
+
+    registry.add_session_for_uid(uid, busy);
+    registry.add_session_for_uid(uid, broken);
+    registry.add_session_for_uid(uid, idle);
+
+    EXPECT_EQ(idle, registry.resolve_session_for_uid(uid));
+    EXPECT_EQ((std::vector<Session::Ptr>{idle, busy}), registry.resolve_sessions_for_uid_by_load(uid));
+
+    registry.remove_session_for_uid(uid, idle);
+    EXPECT_EQ(busy, registry.resolve_session_for_uid(uid));
+
+    registry.remove_session_for_uid(uid);
+    EXPECT_FALSE(registry.has_session_for_uid(uid));
+}
+
+TEST(ProcessIdentity, start_time_identity_detects_recycled_pid)
+{
+    std::int64_t start_time{42};
+
+    auto identity = core::trust::remote::helpers::start_time_process_identity_resolver([&start_time](core::trust::Pid)
+    {
+        return start_time;
+    })(core::trust::Pid{::getpid()});
+
+    EXPECT_EQ(42, identity->start_time());
+    EXPECT_TRUE(identity->is_alive());
+
+    // A different process now runs under the same pid.
+    start_time = 43;
+    EXPECT_FALSE(identity->is_alive());
+}
+
+TEST(ProcessIdentity, pidfd_identity_detects_process_exit)
+{
+    auto app = core::posix::fork([]()
+    {
+        while(true) std::this_thread::sleep_for(std::chrono::milliseconds{500});
+        return core::posix::exit::Status::success;
+    }, core::posix::StandardStream::empty);
+
+    auto start_time_resolver = core::trust::remote::helpers::proc_stat_start_time_resolver();
+
+    auto identity = core::trust::remote::helpers::pidfd_process_identity_resolver(start_time_resolver)(
+                core::trust::Pid{app.pid()});
+
+    EXPECT_EQ(start_time_resolver(core::trust::Pid{app.pid()}), identity->start_time());
+    EXPECT_TRUE(identity->is_alive());
+
+    app.send_signal_or_throw(core::posix::Signal::sig_kill);
+    app.wait_for(core::posix::wait::Flags::untraced);
+
+    EXPECT_FALSE(identity->is_alive());
+}
+
+TEST(SharedMemoryRing, preserves_order_and_respects_capacity)
+{
+    auto ring = core::trust::remote::posix::SharedMemoryRing::create(3, sizeof(int));
+
+    // The slot count is rounded up to the next power of two.
+    EXPECT_EQ(4u, ring->slot_count());
+
+    for (int i = 0; i < 4; i++)
+        EXPECT_TRUE(ring->try_push(&i));
+
+    int value{42};
+    EXPECT_FALSE(ring->try_push(&value));
+
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(ring->try_pop(&value));
+        EXPECT_EQ(i, value);
+    }
+
+    EXPECT_FALSE(ring->try_pop(&value));
+}
+
+TEST(SharedMemoryRing, attached_ring_shares_slots_and_rings_doorbell_only_for_waiting_consumer)
+{
+    using core::trust::remote::posix::SharedMemoryRing;
+
+    auto producer = SharedMemoryRing::create(16, sizeof(int));
+    auto consumer = SharedMemoryRing::attach(::dup(producer->memfd()), ::dup(producer->doorbell()), sizeof(int));
+
+    auto doorbell_rung = [&consumer]()
+    {
+        ::pollfd pfd{consumer->doorbell(), POLLIN, 0};
+        return ::poll(&pfd, 1, 0) == 1;
+    };
+
+    int value{42};
+    EXPECT_TRUE(producer->try_push(&value));
+    EXPECT_FALSE(doorbell_rung());
+
+    // The ring is not empty, and the consumer must not block.
+    EXPECT_FALSE(consumer->prepare_to_wait());
+    EXPECT_TRUE(consumer->try_pop(&value));
+    EXPECT_EQ(42, value);
+
+    EXPECT_TRUE(consumer->prepare_to_wait());
+    value = 43;
+    EXPECT_TRUE(producer->try_push(&value));
+    EXPECT_TRUE(doorbell_rung());
+
+    consumer->finish_wait();
+    EXPECT_FALSE(doorbell_rung());
+    EXPECT_TRUE(consumer->try_pop(&value));
+    EXPECT_EQ(43, value);
+}
+
+TEST(SharedMemoryRing, attaching_to_invalid_memory_throws)
+{
+    using core::trust::remote::posix::SharedMemoryRing;
+
+    auto ring = SharedMemoryRing::create(16, sizeof(int));
+
+    // Slot sizes have to match.
+    EXPECT_THROW(SharedMemoryRing::attach(::dup(ring->memfd()), ::dup(ring->doorbell()), sizeof(std::int64_t)),
+                 std::runtime_error);
+    // Memory has to be sealed.
+    EXPECT_THROW(SharedMemoryRing::attach(::eventfd(0, 0), ::dup(ring->doorbell()), sizeof(int)),
+                 std::runtime_error);
+}
+
+TEST(DecisionCache, answers_lookups_until_entries_expire)
+{
+    core::trust::remote::DecisionCache cache
+    {
+        core::trust::remote::DecisionCache::Configuration{std::chrono::milliseconds{50}, 16}
+    };
+
+    core::trust::remote::DecisionCache::Key key
+    {
+        core::trust::Uid{1}, core::trust::Pid{2}, 3, core::trust::Feature{4}
+    };
+
+    auto answer = core::trust::Request::Answer::denied;
+    EXPECT_FALSE(cache.lookup(key, answer));
+
+    cache.remember(key, core::trust::Request::Answer::granted, cache.generation());
+    EXPECT_TRUE(cache.lookup(key, answer));
+    EXPECT_EQ(core::trust::Request::Answer::granted, answer);
+
+    // A different incarnation of the process does not match.
+    core::trust::remote::DecisionCache::Key other_incarnation{key.uid, key.pid, 4, key.feature};
+    EXPECT_FALSE(cache.lookup(other_incarnation, answer));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    EXPECT_FALSE(cache.lookup(key, answer));
+    EXPECT_EQ(0u, cache.size());
+}
+
+TEST(DecisionCache, revocations_drop_entries_and_discard_answers_obtained_before)
+{
+    core::trust::remote::DecisionCache cache
+    {
+        core::trust::remote::DecisionCache::Configuration{std::chrono::minutes{1}, 16}
+    };
+
+    core::trust::remote::DecisionCache::Key first{core::trust::Uid{1}, core::trust::Pid{2}, 3, core::trust::Feature{4}};
+    core::trust::remote::DecisionCache::Key second{core::trust::Uid{1}, core::trust::Pid{2}, 3, core::trust::Feature{5}};
+    core::trust::remote::DecisionCache::Key other_user{core::trust::Uid{6}, core::trust::Pid{7}, 3, core::trust::Feature{4}};
+
+    for (const auto& key : {first, second, other_user})
+        cache.remember(key, core::trust::Request::Answer::granted, cache.generation());
+
+    cache.revoke(core::trust::remote::Revocation{core::trust::Uid{1}, false, core::trust::Feature{4}});
+
+    auto answer = core::trust::Request::Answer::denied;
+    EXPECT_FALSE(cache.lookup(first, answer));
+    EXPECT_TRUE(cache.lookup(second, answer));
+    EXPECT_TRUE(cache.lookup(other_user, answer));
+
+    // An answer obtained prior to a revocation is not remembered.
+    auto generation = cache.generation();
+    cache.revoke(core::trust::remote::Revocation{core::trust::Uid{1}, true, core::trust::Feature{}});
+    cache.remember(first, core::trust::Request::Answer::granted, generation);
+
+    EXPECT_FALSE(cache.lookup(first, answer));
+    EXPECT_FALSE(cache.lookup(second, answer));
+    EXPECT_TRUE(cache.lookup(other_user, answer));
+}
+
+TEST(DecisionCache, evicts_the_oldest_entry_if_full)
+{
+    core::trust::remote::DecisionCache cache
+    {
+        core::trust::remote::DecisionCache::Configuration{std::chrono::minutes{1}, 2}
+    };
+
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        cache.remember(
+                    core::trust::remote::DecisionCache::Key{core::trust::Uid{1}, core::trust::Pid{2}, 3, core::trust::Feature{i}},
+                    core::trust::Request::Answer::granted,
+                    cache.generation());
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    auto answer = core::trust::Request::Answer::denied;
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_FALSE(cache.lookup(core::trust::remote::DecisionCache::Key{core::trust::Uid{1}, core::trust::Pid{2}, 3, core::trust::Feature{0}}, answer));
+    EXPECT_TRUE(cache.lookup(core::trust::remote::DecisionCache::Key{core::trust::Uid{1}, core::trust::Pid{2}, 3, core::trust::Feature{2}}, answer));
+}
+
+TEST(DecisionTable, attached_table_sees_published_and_withdrawn_decisions)
+{
+    using core::trust::remote::posix::DecisionTable;
+
+    auto owner = DecisionTable::create(16);
+    auto reader = DecisionTable::attach(::dup(owner->memfd()));
+
+    EXPECT_EQ(16u, reader->slot_count());
+
+    auto answer = core::trust::Request::Answer::denied;
+    EXPECT_FALSE(reader->lookup("com.ubuntu.app", core::trust::Feature{1}, answer));
+
+    owner->publish("com.ubuntu.app", core::trust::Feature{1}, core::trust::Request::Answer::granted);
+    owner->publish("com.ubuntu.app", core::trust::Feature{2}, core::trust::Request::Answer::denied);
+    owner->publish("com.ubuntu.other", core::trust::Feature{1}, core::trust::Request::Answer::granted);
+    EXPECT_EQ(3u, reader->size());
+
+    EXPECT_TRUE(reader->lookup("com.ubuntu.app", core::trust::Feature{1}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::granted, answer);
+    EXPECT_TRUE(reader->lookup("com.ubuntu.app", core::trust::Feature{2}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answer);
+
+    // Only the given prefix of the app id is considered.
+    std::string versioned{"com.ubuntu.app_1.2.3"};
+    EXPECT_TRUE(reader->lookup(versioned.c_str(), versioned.find('_'), core::trust::Feature{1}, answer));
+
+    owner->publish("com.ubuntu.app", core::trust::Feature{1}, core::trust::Request::Answer::denied);
+    EXPECT_TRUE(reader->lookup("com.ubuntu.app", core::trust::Feature{1}, answer));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answer);
+
+    owner->withdraw("com.ubuntu.app", core::trust::Feature{2});
+    EXPECT_FALSE(reader->lookup("com.ubuntu.app", core::trust::Feature{2}, answer));
+
+    owner->withdraw_application("com.ubuntu.app");
+    EXPECT_FALSE(reader->lookup("com.ubuntu.app", core::trust::Feature{1}, answer));
+    EXPECT_TRUE(reader->lookup("com.ubuntu.other", core::trust::Feature{1}, answer));
+
+    owner->retire();
+    EXPECT_FALSE(reader->lookup("com.ubuntu.other", core::trust::Feature{1}, answer));
+    EXPECT_EQ(0u, reader->size());
+}
+
+TEST(DecisionTable, drops_decisions_if_full_and_reuses_withdrawn_slots)
+{
+    using core::trust::remote::posix::DecisionTable;
+
+    auto table = DecisionTable::create(4);
+
+    // At most three quarters of the slots are used.
+    for (unsigned int i = 0; i < 4; i++)
+        table->publish("com.ubuntu.app", core::trust::Feature{i}, core::trust::Request::Answer::granted);
+
+    auto answer = core::trust::Request::Answer::denied;
+    EXPECT_EQ(3u, table->size());
+    EXPECT_FALSE(table->lookup("com.ubuntu.app", core::trust::Feature{3}, answer));
+
+    table->withdraw("com.ubuntu.app", core::trust::Feature{0});
+    table->publish("com.ubuntu.app", core::trust::Feature{3}, core::trust::Request::Answer::granted);
+    EXPECT_TRUE(table->lookup("com.ubuntu.app", core::trust::Feature{3}, answer));
+    EXPECT_TRUE(table->lookup("com.ubuntu.app", core::trust::Feature{1}, answer));
+    EXPECT_EQ(3u, table->size());
+
+    table->clear();
+    EXPECT_EQ(0u, table->size());
+}
+
+TEST(DecisionTable, attached_tables_are_read_only_and_invalid_memory_throws)
+{
+    using core::trust::remote::posix::DecisionTable;
+
+    auto owner = DecisionTable::create(16);
+    auto reader = DecisionTable::attach(::dup(owner->memfd()));
+
+    EXPECT_THROW(reader->publish("com.ubuntu.app", core::trust::Feature{1}, core::trust::Request::Answer::granted),
+                 std::logic_error);
+    EXPECT_THROW(reader->clear(), std::logic_error);
+
+    // Memory has to be sealed.
+    EXPECT_THROW(DecisionTable::attach(::eventfd(0, 0)), std::runtime_error);
+    // Shared memory rings are not decision tables.
+    auto ring = core::trust::remote::posix::SharedMemoryRing::create(16, sizeof(int));
+    EXPECT_THROW(DecisionTable::attach(::dup(ring->memfd())), std::runtime_error);
+}
+
 namespace
 {
 struct UnixDomainSocketRemoteAgent : public ::testing::Test
@@ -210,12 +617,23 @@ struct UnixDomainSocketRemoteAgent : public ::testing::Test
             boost::asio::local::stream_protocol::endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing},
             core::trust::remote::helpers::proc_stat_start_time_resolver(),
             core::trust::remote::posix::Stub::get_sock_opt_credentials_resolver(),
-            std::make_shared<core::trust::remote::posix::Stub::Session::Registry>()
+            std::make_shared<core::trust::remote::posix::Stub::Session::Registry>(),
+            // Requests go over the socket.
+            0,
+            // Pins down processes via pidfd if supported.
+            {},
+            core::trust::remote::posix::IoBackend::asio,
+            // Fail requests right away if no session is known for a uid.
+            std::chrono::milliseconds{0},
+            // Decisions are not cached.
+            {},
+            // Published decisions are not consulted.
+            false
         };
     }
 
-    // Returns a peer ready to be forked that connects to the endpoint_for_testing
-    // and immediately exits, checking for any sort of testing failures that might have
+    // Returns a peer ready to be forked that connects to the endpoint_for_testing,
+    // exchanges greetings with the stub and immediately exits, checking for any sort of testing failures that might have
     // occured in between.
     static std::function<core::posix::exit::Status()> a_raw_peer_immediately_exiting()
     {
@@ -230,6 +648,18 @@ struct UnixDomainSocketRemoteAgent : public ::testing::Test
 
             EXPECT_NO_THROW(socket.connect(boost::asio::local::stream_protocol::endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing}));
 
+            core::trust::remote::posix::Hello hello
+            {
+                core::trust::remote::posix::protocol_magic,
+                core::trust::remote::posix::protocol_version
+            };
+
+            EXPECT_NO_THROW(boost::asio::write(socket, boost::asio::buffer(&hello, sizeof(hello))));
+            EXPECT_NO_THROW(boost::asio::read(socket, boost::asio::buffer(&hello, sizeof(hello))));
+
+            EXPECT_EQ(core::trust::remote::posix::protocol_magic, hello.magic);
+            EXPECT_EQ(core::trust::remote::posix::protocol_version, hello.version);
+
             io_service.stop();
             if(worker.joinable())
                 worker.join();
@@ -306,6 +736,651 @@ TEST_F(UnixDomainSocketRemoteAgent, queries_peer_credentials_for_incoming_connec
     EXPECT_TRUE(stub->has_session_for_uid(uid));
 }
 
+TEST_F(UnixDomainSocketRemoteAgent, stub_closes_connections_of_peers_speaking_another_protocol_version)
+{
+    auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(
+                the_default_stub_configuration());
+
+    boost::asio::local::stream_protocol::socket socket{io_service};
+    socket.connect(boost::asio::local::stream_protocol::endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing});
+
+    core::trust::remote::posix::Hello hello
+    {
+        core::trust::remote::posix::protocol_magic,
+        core::trust::remote::posix::protocol_version + 1
+    };
+
+    boost::asio::write(socket, boost::asio::buffer(&hello, sizeof(hello)));
+
+    // The stub does not greet back, but closes the connection.
+    boost::system::error_code ec;
+    boost::asio::read(socket, boost::asio::buffer(&hello, sizeof(hello)), ec);
+
+    EXPECT_EQ(boost::asio::error::eof, ec);
+    EXPECT_FALSE(stub->has_session_for_uid(core::trust::Uid{::getuid()}));
+}
+
+TEST_F(UnixDomainSocketRemoteAgent, stub_fails_over_to_next_session_if_peer_has_gone_away)
+{
+    using Session = core::trust::remote::posix::Stub::Session;
+
+    auto config = the_default_stub_configuration();
+    config.start_time_resolver = [](core::trust::Pid) { return 42; };
+
+    auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(config);
+
+    core::trust::Uid uid{::getuid()};
+
+    // The first session's peer is gone already.
+    auto dead = std::make_shared<Session>(io_service);
+    boost::asio::local::stream_protocol::socket dead_peer{io_service};
+    boost::asio::local::connect_pair(dead->socket, dead_peer);
+    dead_peer.close();
+
+    // The second session's peer replies with granted.
+    auto alive = std::make_shared<Session>(io_service);
+    boost::asio::local::stream_protocol::socket alive_peer{io_service};
+    boost::asio::local::connect_pair(alive->socket, alive_peer);
+
+    config.session_registry->add_session_for_uid(uid, dead);
+    config.session_registry->add_session_for_uid(uid, alive);
+
+    std::thread peer{[&alive_peer]()
+    {
+        core::trust::remote::posix::Request request;
+        boost::asio::read(alive_peer, boost::asio::buffer(&request, sizeof(request)));
+
+        auto answer = core::trust::Request::Answer::granted;
+        boost::asio::write(alive_peer, boost::asio::buffer(&answer, sizeof(answer)));
+    }};
+
+    EXPECT_EQ(core::trust::Request::Answer::granted,
+              stub->authenticate_request_with_parameters(
+                  core::trust::Agent::RequestParameters
+                  {
+                      uid,
+                      core::trust::Pid{::getpid()},
+                      "",
+                      core::trust::Feature{},
+                      ""
+                  }));
+
+    peer.join();
+
+    // The dead session has been retired.
+    EXPECT_EQ(std::vector<Session::Ptr>{alive}, config.session_registry->resolve_sessions_for_uid_by_load(uid));
+}
+
+TEST_F(UnixDomainSocketRemoteAgent, skeleton_denies_features_missing_from_the_batch_answer_of_its_agent)
+{
+    using namespace ::testing;
+
+    core::trust::Uid uid{::getuid()};
+
+    auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(
+                the_default_stub_configuration());
+
+    auto mock_agent = std::make_shared<NiceMock<MockAgent>>();
+
+    // The agent leaves out the second feature.
+    EXPECT_CALL(*mock_agent, authenticate_batch_request_with_parameters(_))
+            .Times(1)
+            .WillRepeatedly(Return(core::trust::Agent::BatchAnswer
+            {
+                {core::trust::Feature{1}, core::trust::Request::Answer::granted}
+            }));
+
+    auto skeleton = core::trust::remote::posix::Skeleton::create_skeleton_for_configuration(
+                core::trust::remote::posix::Skeleton::Configuration
+                {
+                    mock_agent,
+                    io_service,
+                    boost::asio::local::stream_protocol::endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing},
+                    core::trust::remote::helpers::proc_stat_start_time_resolver(),
+                    [](core::trust::Pid) { return "does.not.exist.application"; },
+                    "Just a test for %1%.",
+                    false,
+                    // Pins down processes via pidfd if supported.
+                    {},
+                    core::trust::remote::posix::IoBackend::asio,
+                    // Do not reconnect to the stub.
+                    {},
+                    // Decisions are not published.
+                    {}
+                });
+
+    // The session is registered asynchronously.
+    while (not stub->has_session_for_uid(uid))
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    auto answers = stub->authenticate_batch_request_with_parameters(
+                core::trust::Agent::BatchRequestParameters
+                {
+                    {
+                        uid,
+                        core::trust::Pid{::getpid()},
+                        ""
+                    },
+                    {
+                        core::trust::Feature{1},
+                        core::trust::Feature{2}
+                    },
+                    ""
+                });
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, answers.at(core::trust::Feature{1}));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answers.at(core::trust::Feature{2}));
+}
+
+TEST_F(UnixDomainSocketRemoteAgent, skeleton_drops_the_connection_on_requests_with_out_of_range_feature_count)
+{
+    using namespace ::testing;
+
+    for (auto io_backend : {core::trust::remote::posix::IoBackend::asio, core::trust::remote::posix::IoBackend::io_uring})
+    {
+        std::remove(UnixDomainSocketRemoteAgent::endpoint_for_testing);
+
+        // We act as the stub.
+        boost::asio::local::stream_protocol::endpoint endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing};
+        boost::asio::local::stream_protocol::acceptor acceptor{io_service, endpoint};
+
+        auto mock_agent = std::make_shared<NiceMock<MockAgent>>();
+
+        EXPECT_CALL(*mock_agent, authenticate_request_with_parameters(_)).Times(0);
+        EXPECT_CALL(*mock_agent, authenticate_batch_request_with_parameters(_)).Times(0);
+
+        auto skeleton = core::trust::remote::posix::Skeleton::create_skeleton_for_configuration(
+                    core::trust::remote::posix::Skeleton::Configuration
+                    {
+                        mock_agent,
+                        io_service,
+                        endpoint,
+                        core::trust::remote::helpers::proc_stat_start_time_resolver(),
+                        [](core::trust::Pid) { return "does.not.exist.application"; },
+                        "Just a test for %1%.",
+                        false,
+                        // Pins down processes via pidfd if supported.
+                        {},
+                        io_backend,
+                        // Do not reconnect to the stub.
+                        {},
+                        // Decisions are not published.
+                        {}
+                    });
+
+        boost::asio::local::stream_protocol::socket socket{io_service};
+        acceptor.accept(socket);
+
+        core::trust::remote::posix::Hello hello;
+        boost::asio::read(socket, boost::asio::buffer(&hello, sizeof(hello)));
+        boost::asio::write(socket, boost::asio::buffer(&hello, sizeof(hello)));
+
+        core::trust::remote::posix::Request request
+        {
+            core::trust::Uid{::getuid()},
+            core::trust::Pid{::getpid()},
+            core::trust::Feature{1},
+            0,
+            core::trust::remote::posix::max_features_per_request + 1,
+            0
+        };
+
+        boost::asio::write(socket, boost::asio::buffer(&request, sizeof(request)));
+
+        // Instead of leaving us waiting for an answer, the skeleton closes the connection.
+        core::trust::Request::Answer answer;
+        boost::system::error_code ec;
+        boost::asio::read(socket, boost::asio::buffer(&answer, sizeof(answer)), ec);
+
+        EXPECT_EQ(boost::asio::error::eof, ec);
+    }
+}
+
+TEST_F(UnixDomainSocketRemoteAgent, stub_and_skeleton_exchange_requests_via_shared_memory_rings)
+{
+    using namespace ::testing;
+
+    static constexpr const unsigned int request_count{100};
+
+    core::trust::Uid uid{::getuid()};
+
+    auto config = the_default_stub_configuration();
+    config.shared_memory_ring_capacity = 4;
+
+    auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(config);
+
+    auto mock_agent = std::make_shared<NiceMock<MockAgent>>();
+
+    EXPECT_CALL(*mock_agent, authenticate_request_with_parameters(_))
+            .Times(request_count)
+            .WillRepeatedly(Return(core::trust::Request::Answer::granted));
+
+    auto skeleton = core::trust::remote::posix::Skeleton::create_skeleton_for_configuration(
+                core::trust::remote::posix::Skeleton::Configuration
+                {
+                    mock_agent,
+                    io_service,
+                    boost::asio::local::stream_protocol::endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing},
+                    core::trust::remote::helpers::proc_stat_start_time_resolver(),
+                    [](core::trust::Pid) { return "does.not.exist.application"; },
+                    "Just a test for %1%.",
+                    false,
+                    // Pins down processes via pidfd if supported.
+                    {},
+                    core::trust::remote::posix::IoBackend::asio,
+                    // Do not reconnect to the stub.
+                    {},
+                    // Decisions are not published.
+                    {}
+                });
+
+    // The session is registered asynchronously.
+    while (not stub->has_session_for_uid(uid))
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    for (unsigned int i = 0; i < request_count; i++)
+    {
+        EXPECT_EQ(core::trust::Request::Answer::granted,
+                  stub->authenticate_request_with_parameters(
+                      core::trust::Agent::RequestParameters
+                      {
+                          uid,
+                          core::trust::Pid{::getpid()},
+                          "",
+                          core::trust::Feature{i},
+                          ""
+                      }));
+    }
+
+    auto session = config.session_registry->resolve_session_for_uid(uid);
+    EXPECT_TRUE(session->shared_memory_negotiated);
+    EXPECT_NE(nullptr, session->requests);
+    EXPECT_NE(nullptr, session->replies);
+}
+
+TEST_F(UnixDomainSocketRemoteAgent, skeleton_denies_requests_failing_on_its_side_and_keeps_serving_shared_memory_rings)
+{
+    using namespace ::testing;
+
+    core::trust::Uid uid{::getuid()};
+
+    auto config = the_default_stub_configuration();
+    config.shared_memory_ring_capacity = 4;
+
+    auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(config);
+
+    auto mock_agent = std::make_shared<NiceMock<MockAgent>>();
+
+    EXPECT_CALL(*mock_agent, authenticate_request_with_parameters(_))
+            .Times(2)
+            .WillOnce(Throw(std::runtime_error{"Could not reach out to the user."}))
+            .WillOnce(Return(core::trust::Request::Answer::granted));
+
+    auto skeleton = core::trust::remote::posix::Skeleton::create_skeleton_for_configuration(
+                core::trust::remote::posix::Skeleton::Configuration
+                {
+                    mock_agent,
+                    io_service,
+                    boost::asio::local::stream_protocol::endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing},
+                    core::trust::remote::helpers::proc_stat_start_time_resolver(),
+                    [](core::trust::Pid) { return "does.not.exist.application"; },
+                    "Just a test for %1%.",
+                    false,
+                    // Pins down processes via pidfd if supported.
+                    {},
+                    core::trust::remote::posix::IoBackend::asio,
+                    // Do not reconnect to the stub.
+                    {},
+                    // Decisions are not published.
+                    {}
+                });
+
+    // The session is registered asynchronously.
+    while (not stub->has_session_for_uid(uid))
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    core::trust::Agent::RequestParameters parameters
+    {
+        uid,
+        core::trust::Pid{::getpid()},
+        "",
+        core::trust::Feature{},
+        ""
+    };
+
+    EXPECT_EQ(core::trust::Request::Answer::denied, stub->authenticate_request_with_parameters(parameters));
+    EXPECT_EQ(core::trust::Request::Answer::granted, stub->authenticate_request_with_parameters(parameters));
+
+    EXPECT_NE(nullptr, config.session_registry->resolve_session_for_uid(uid)->requests);
+}
+
+#if defined(CORE_TRUST_HAVE_IO_URING)
+TEST(IoUring, links_write_and_read_on_registered_buffers_in_a_single_enter)
+{
+    using core::trust::remote::posix::IoUring;
+
+    // Nothing to test if the kernel lacks support.
+    if (not IoUring::is_supported())
+        return;
+
+    int fds[2];
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+    char ping[4] = {'p', 'i', 'n', 'g'};
+    char pong[4] = {0, 0, 0, 0};
+
+    // The peer's reply is available already.
+    ASSERT_EQ(4, ::write(fds[1], "pong", 4));
+
+    auto ring = IoUring::create(4);
+    ring->register_buffers({{ping, sizeof(ping)}, {pong, sizeof(pong)}});
+
+    ring->prepare_write_fixed(fds[0], ping, sizeof(ping), 0, 1, true);
+    ring->prepare_read_fixed(fds[0], pong, sizeof(pong), 1, 2, false);
+    ring->submit_and_wait(2);
+
+    std::map<std::uint64_t, std::int32_t> results;
+    EXPECT_EQ(2u, ring->drain([&results](std::uint64_t user_data, std::int32_t res, std::uint32_t)
+    {
+        results[user_data] = res;
+    }));
+
+    EXPECT_EQ(4, results[1]);
+    EXPECT_EQ(4, results[2]);
+    EXPECT_EQ(0, std::memcmp(pong, "pong", 4));
+    EXPECT_EQ(1u, ring->enter_count());
+
+    char received[4];
+    EXPECT_EQ(4, ::read(fds[1], received, sizeof(received)));
+    EXPECT_EQ(0, std::memcmp(received, "ping", 4));
+
+    ::close(fds[0]); ::close(fds[1]);
+}
+
+TEST(IoUring, multishot_accept_completes_for_every_incoming_connection)
+{
+    using core::trust::remote::posix::IoUring;
+
+    // Nothing to test if the kernel lacks support.
+    if (not IoUring::is_supported())
+        return;
+
+    boost::asio::io_service io_service;
+
+    std::remove(UnixDomainSocketRemoteAgent::endpoint_for_testing);
+    boost::asio::local::stream_protocol::endpoint endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing};
+    boost::asio::local::stream_protocol::acceptor acceptor{io_service, endpoint};
+
+    auto ring = IoUring::create(4);
+    ring->prepare_accept(acceptor.native_handle(), true, 42);
+    ring->submit_and_wait(0);
+
+    boost::asio::local::stream_protocol::socket first{io_service}, second{io_service};
+    first.connect(endpoint);
+    second.connect(endpoint);
+
+    std::vector<int> accepted;
+    while (accepted.size() < 2)
+    {
+        ring->submit_and_wait(1);
+        ring->drain([&accepted](std::uint64_t user_data, std::int32_t res, std::uint32_t flags)
+        {
+            EXPECT_EQ(42u, user_data);
+            EXPECT_TRUE(flags & IORING_CQE_F_MORE);
+            ASSERT_GE(res, 0);
+            accepted.push_back(res);
+        });
+    }
+
+    for (auto fd : accepted)
+        ::close(fd);
+}
+#endif
+
+TEST_F(UnixDomainSocketRemoteAgent, stub_and_skeleton_exchange_requests_via_io_uring)
+{
+    using namespace ::testing;
+
+    static constexpr const unsigned int request_count{100};
+
+    core::trust::Uid uid{::getuid()};
+
+    auto config = the_default_stub_configuration();
+    config.io_backend = core::trust::remote::posix::IoBackend::io_uring;
+
+    auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(config);
+
+    auto mock_agent = std::make_shared<NiceMock<MockAgent>>();
+
+    EXPECT_CALL(*mock_agent, authenticate_request_with_parameters(_))
+            .Times(request_count)
+            .WillRepeatedly(Return(core::trust::Request::Answer::granted));
+    EXPECT_CALL(*mock_agent, authenticate_batch_request_with_parameters(_))
+            .Times(1)
+            .WillRepeatedly(Return(core::trust::Agent::BatchAnswer
+            {
+                {core::trust::Feature{1}, core::trust::Request::Answer::denied},
+                {core::trust::Feature{2}, core::trust::Request::Answer::granted}
+            }));
+
+    auto skeleton = core::trust::remote::posix::Skeleton::create_skeleton_for_configuration(
+                core::trust::remote::posix::Skeleton::Configuration
+                {
+                    mock_agent,
+                    io_service,
+                    boost::asio::local::stream_protocol::endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing},
+                    core::trust::remote::helpers::proc_stat_start_time_resolver(),
+                    [](core::trust::Pid) { return "does.not.exist.application"; },
+                    "Just a test for %1%.",
+                    false,
+                    // Pins down processes via pidfd if supported.
+                    {},
+                    core::trust::remote::posix::IoBackend::io_uring,
+                    // Do not reconnect to the stub.
+                    {},
+                    // Decisions are not published.
+                    {}
+                });
+
+    // The session is registered asynchronously.
+    while (not stub->has_session_for_uid(uid))
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    for (unsigned int i = 0; i < request_count; i++)
+    {
+        EXPECT_EQ(core::trust::Request::Answer::granted,
+                  stub->authenticate_request_with_parameters(
+                      core::trust::Agent::RequestParameters
+                      {
+                          uid,
+                          core::trust::Pid{::getpid()},
+                          "",
+                          core::trust::Feature{i},
+                          ""
+                      }));
+    }
+
+    // Batch requests are interleaved with requests handled via io_uring.
+    auto answers = stub->authenticate_batch_request_with_parameters(
+                core::trust::Agent::BatchRequestParameters
+                {
+                    {
+                        uid,
+                        core::trust::Pid{::getpid()},
+                        ""
+                    },
+                    {core::trust::Feature{1}, core::trust::Feature{2}},
+                    ""
+                });
+
+    EXPECT_EQ(core::trust::Request::Answer::denied, answers.at(core::trust::Feature{1}));
+    EXPECT_EQ(core::trust::Request::Answer::granted, answers.at(core::trust::Feature{2}));
+
+    auto session = config.session_registry->resolve_session_for_uid(uid);
+#if defined(CORE_TRUST_HAVE_IO_URING)
+    EXPECT_EQ(core::trust::remote::posix::IoUring::is_supported(), session->ring != nullptr);
+#else
+    // Builds lacking io_uring support stick to asio.
+    EXPECT_EQ(nullptr, session->ring);
+#endif
+}
+
+TEST_F(UnixDomainSocketRemoteAgent, stub_answers_repeated_requests_from_cache_until_skeleton_revokes)
+{
+    using namespace ::testing;
+
+    core::trust::Uid uid{::getuid()};
+
+    auto config = the_default_stub_configuration();
+    config.decision_cache = std::make_shared<core::trust::remote::DecisionCache>(
+                core::trust::remote::DecisionCache::Configuration{std::chrono::minutes{1}, 16});
+
+    auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(config);
+
+    auto mock_agent = std::make_shared<NiceMock<MockAgent>>();
+
+    // The second request is answered from the cache, the third one after the revocation is not.
+    EXPECT_CALL(*mock_agent, authenticate_request_with_parameters(_))
+            .Times(2)
+            .WillRepeatedly(Return(core::trust::Request::Answer::granted));
+
+    auto skeleton = core::trust::remote::posix::Skeleton::create_skeleton_for_configuration(
+                core::trust::remote::posix::Skeleton::Configuration
+                {
+                    mock_agent,
+                    io_service,
+                    boost::asio::local::stream_protocol::endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing},
+                    core::trust::remote::helpers::proc_stat_start_time_resolver(),
+                    [](core::trust::Pid) { return "does.not.exist.application"; },
+                    "Just a test for %1%.",
+                    false,
+                    // Pins down processes via pidfd if supported.
+                    {},
+                    core::trust::remote::posix::IoBackend::asio,
+                    // Do not reconnect to the stub.
+                    {},
+                    // Decisions are not published.
+                    {}
+                });
+
+    while (not stub->has_session_for_uid(uid))
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    core::trust::Agent::RequestParameters parameters
+    {
+        uid,
+        core::trust::Pid{::getpid()},
+        "",
+        core::trust::Feature{42},
+        ""
+    };
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, stub->authenticate_request_with_parameters(parameters));
+    EXPECT_EQ(core::trust::Request::Answer::granted, stub->authenticate_request_with_parameters(parameters));
+    EXPECT_EQ(1u, config.decision_cache->size());
+
+    skeleton->revoke(core::trust::remote::Revocation{uid, false, core::trust::Feature{42}});
+
+    // Revocations are delivered asynchronously.
+    while (config.decision_cache->size() > 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, stub->authenticate_request_with_parameters(parameters));
+}
+
+TEST_F(UnixDomainSocketRemoteAgent, skeleton_reconnects_to_a_restarted_stub_and_requests_wait_for_it)
+{
+    using namespace ::testing;
+
+    core::trust::Uid uid{::getuid()};
+
+    auto mock_agent = std::make_shared<NiceMock<MockAgent>>();
+
+    EXPECT_CALL(*mock_agent, authenticate_request_with_parameters(_))
+            .Times(1)
+            .WillRepeatedly(Return(core::trust::Request::Answer::granted));
+
+    // The first stub lives in a helper with its own runtime.
+    std::unique_ptr<boost::asio::io_service> helper_service{new boost::asio::io_service};
+    std::unique_ptr<boost::asio::io_service::work> helper_keep_alive{new boost::asio::io_service::work{*helper_service}};
+    std::thread helper_worker{[&helper_service]() { helper_service->run(); }};
+
+    auto first_registry = std::make_shared<core::trust::remote::posix::Stub::Session::Registry>();
+    auto first_stub = core::trust::remote::posix::Stub::create_stub_for_configuration(
+                core::trust::remote::posix::Stub::Configuration
+                {
+                    *helper_service,
+                    boost::asio::local::stream_protocol::endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing},
+                    core::trust::remote::helpers::proc_stat_start_time_resolver(),
+                    core::trust::remote::posix::Stub::get_sock_opt_credentials_resolver(),
+                    first_registry,
+                    // Requests go over the socket.
+                    0,
+                    // Pins down processes via pidfd if supported.
+                    {},
+                    core::trust::remote::posix::IoBackend::asio,
+                    // Fail requests right away if no session is known for a uid.
+                    std::chrono::milliseconds{0},
+                    // Decisions are not cached.
+                    {},
+                    // Published decisions are not consulted.
+                    false
+                });
+
+    auto skeleton = core::trust::remote::posix::Skeleton::create_skeleton_for_configuration(
+                core::trust::remote::posix::Skeleton::Configuration
+                {
+                    mock_agent,
+                    io_service,
+                    boost::asio::local::stream_protocol::endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing},
+                    core::trust::remote::helpers::proc_stat_start_time_resolver(),
+                    [](core::trust::Pid) { return "does.not.exist.application"; },
+                    "Just a test for %1%.",
+                    false,
+                    // Pins down processes via pidfd if supported.
+                    {},
+                    core::trust::remote::posix::IoBackend::asio,
+                    core::trust::remote::posix::ReconnectBackoff
+                    {
+                        std::chrono::milliseconds{10},
+                        std::chrono::milliseconds{100}
+                    },
+                    // Decisions are not published.
+                    {}
+                });
+
+    while (not first_stub->has_session_for_uid(uid))
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    // The helper goes away, leaving its socket behind in the filesystem.
+    helper_keep_alive.reset();
+    helper_service->stop();
+    helper_worker.join();
+    first_stub.reset();
+    first_registry.reset();
+    helper_service.reset();
+
+    // And comes back, immediately receiving a request for the reconnecting skeleton.
+    auto config = the_default_stub_configuration();
+    config.reconnect_grace_period = std::chrono::milliseconds{1000};
+    auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(config);
+
+    auto before = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(core::trust::Request::Answer::granted,
+              stub->authenticate_request_with_parameters(
+                  core::trust::Agent::RequestParameters
+                  {
+                      uid,
+                      core::trust::Pid{::getpid()},
+                      "",
+                      core::trust::Feature{},
+                      ""
+                  }));
+
+    EXPECT_LT(std::chrono::steady_clock::now() - before, std::chrono::milliseconds{1000});
+}
+
 TEST_F(UnixDomainSocketRemoteAgent, stub_and_skeleton_query_process_start_time_for_request)
 {
     using namespace ::testing;
@@ -324,6 +1399,8 @@ TEST_F(UnixDomainSocketRemoteAgent, stub_and_skeleton_query_process_start_time_f
 
     auto config = the_default_stub_configuration();
     config.start_time_resolver = process_start_time_resolver.to_functional();
+    config.process_identity_resolver = core::trust::remote::helpers::start_time_process_identity_resolver(
+                process_start_time_resolver.to_functional());
 
     auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(config);
 
@@ -342,8 +1419,9 @@ TEST_F(UnixDomainSocketRemoteAgent, stub_and_skeleton_query_process_start_time_f
 
         NiceMock<MockProcessStartTimeResolver> process_start_time_resolver;
 
+        // Once for validating the request, and once more after resolving the app id.
         EXPECT_CALL(process_start_time_resolver, resolve_process_start_time(_))
-                .Times(1)
+                .Times(2)
                 .WillRepeatedly(Return(42));
 
         auto mock_agent = std::make_shared<::testing::NiceMock<MockAgent>>();
@@ -360,7 +1438,14 @@ TEST_F(UnixDomainSocketRemoteAgent, stub_and_skeleton_query_process_start_time_f
             process_start_time_resolver.to_functional(),
             core::trust::remote::helpers::aa_get_task_con_app_id_resolver(),
             "Just a test for %1%.",
-            true
+            true,
+            core::trust::remote::helpers::start_time_process_identity_resolver(
+                    process_start_time_resolver.to_functional()),
+            core::trust::remote::posix::IoBackend::asio,
+            // Do not reconnect to the stub.
+            {},
+            // Decisions are not published.
+            {}
         };
 
         auto skeleton = core::trust::remote::posix::Skeleton::create_skeleton_for_configuration(config);
@@ -404,6 +1489,119 @@ TEST_F(UnixDomainSocketRemoteAgent, stub_and_skeleton_query_process_start_time_f
     EXPECT_TRUE(ProcessExitedSuccessfully(child.wait_for(core::posix::wait::Flags::untraced)));
 }
 
+TEST_F(UnixDomainSocketRemoteAgent, stub_and_skeleton_handle_batch_requests_in_a_single_round_trip)
+{
+    using namespace ::testing;
+
+    static const std::set<core::trust::Feature> features
+    {
+        core::trust::Feature{1},
+        core::trust::Feature{2},
+        core::trust::Feature{3}
+    };
+
+    // We need to make sure that we have a valid pid.
+    auto app = core::posix::fork([]()
+    {
+        while(true) std::this_thread::sleep_for(std::chrono::milliseconds{500});
+        return core::posix::exit::Status::success;
+    }, core::posix::StandardStream::empty);
+
+    // skeleton --| good to go |--> stub
+    core::testing::CrossProcessSync cps;
+
+    auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(
+                the_default_stub_configuration());
+
+    core::posix::ChildProcess child = core::posix::fork([&cps]()
+    {
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        boost::asio::io_service io_service;
+        boost::asio::io_service::work work{io_service};
+        std::thread worker{[&io_service] { io_service.run(); }};
+
+        auto mock_agent = std::make_shared<::testing::NiceMock<MockAgent>>();
+
+        // A single request carrying all features reaches the agent.
+        EXPECT_CALL(*mock_agent, authenticate_request_with_parameters(_))
+                .Times(0);
+        EXPECT_CALL(*mock_agent, authenticate_batch_request_with_parameters(Field(&core::trust::Agent::BatchRequestParameters::features, Eq(features))))
+                .Times(1)
+                .WillRepeatedly(Return(core::trust::Agent::BatchAnswer
+                {
+                    {core::trust::Feature{1}, core::trust::Request::Answer::granted},
+                    {core::trust::Feature{2}, core::trust::Request::Answer::denied},
+                    {core::trust::Feature{3}, core::trust::Request::Answer::granted}
+                }));
+
+        core::trust::remote::posix::Skeleton::Configuration config
+        {
+            mock_agent,
+            io_service,
+            boost::asio::local::stream_protocol::endpoint{UnixDomainSocketRemoteAgent::endpoint_for_testing},
+            core::trust::remote::helpers::proc_stat_start_time_resolver(),
+            core::trust::remote::helpers::aa_get_task_con_app_id_resolver(),
+            "Just a test for %1%.",
+            false,
+            // Pins down processes via pidfd if supported.
+            {},
+            core::trust::remote::posix::IoBackend::asio,
+            // Do not reconnect to the stub.
+            {},
+            // Decisions are not published.
+            {}
+        };
+
+        auto skeleton = core::trust::remote::posix::Skeleton::create_skeleton_for_configuration(config);
+
+        cps.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        trap->run();
+
+        io_service.stop();
+
+        if (worker.joinable())
+            worker.join();
+
+        return ::testing::Test::HasFailure() ?
+                    core::posix::exit::Status::failure :
+                    core::posix::exit::Status::success;
+    }, core::posix::StandardStream::empty);
+
+    cps.wait_for_signal_ready_for(std::chrono::milliseconds{500});
+
+    // We have to provide some grace to the service, such that it can spin up threads
+    // and handle incoming connections. This is specifically required to satisfy slow builders.
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+
+    auto answers = stub->authenticate_batch_request_with_parameters(
+                core::trust::Agent::BatchRequestParameters
+                {
+                    {
+                        core::trust::Uid{::getuid()},
+                        core::trust::Pid{app.pid()},
+                        ""
+                    },
+                    features,
+                    ""
+                });
+
+    EXPECT_EQ(core::trust::Request::Answer::granted, answers.at(core::trust::Feature{1}));
+    EXPECT_EQ(core::trust::Request::Answer::denied, answers.at(core::trust::Feature{2}));
+    EXPECT_EQ(core::trust::Request::Answer::granted, answers.at(core::trust::Feature{3}));
+
+    child.send_signal_or_throw(core::posix::Signal::sig_term);
+    EXPECT_TRUE(ProcessExitedSuccessfully(child.wait_for(core::posix::wait::Flags::untraced)));
+
+    app.send_signal_or_throw(core::posix::Signal::sig_kill);
+}
+
 /**************************************
   Full blown acceptance tests go here.
 **************************************/
@@ -469,7 +1667,18 @@ TEST(UnixDomainSocket, a_service_can_query_a_remote_agent)
             boost::asio::local::stream_protocol::endpoint{endpoint_for_acceptance_testing},
             core::trust::remote::helpers::proc_stat_start_time_resolver(),
             core::trust::remote::posix::Stub::get_sock_opt_credentials_resolver(),
-            std::make_shared<core::trust::remote::posix::Stub::Session::Registry>()
+            std::make_shared<core::trust::remote::posix::Stub::Session::Registry>(),
+            // Requests go over the socket.
+            0,
+            // Pins down processes via pidfd if supported.
+            {},
+            core::trust::remote::posix::IoBackend::asio,
+            // Fail requests right away if no session is known for a uid.
+            std::chrono::milliseconds{0},
+            // Decisions are not cached.
+            {},
+            // Published decisions are not consulted.
+            false
         };
 
         auto stub = core::trust::remote::posix::Stub::create_stub_for_configuration(config);
@@ -530,7 +1739,14 @@ TEST(UnixDomainSocket, a_service_can_query_a_remote_agent)
             core::trust::remote::helpers::proc_stat_start_time_resolver(),
             core::trust::remote::helpers::aa_get_task_con_app_id_resolver(),
             "Just a test for %1%.",
-            true
+            true,
+            // Pins down processes via pidfd if supported.
+            {},
+            core::trust::remote::posix::IoBackend::asio,
+            // Do not reconnect to the stub.
+            {},
+            // Decisions are not published.
+            {}
         };
 
         stub_ready.wait_for_signal_ready_for(std::chrono::milliseconds{1000});
@@ -769,7 +1985,14 @@ TEST(UnixDomainSocket, a_standalone_service_can_query_a_remote_agent)
             core::trust::remote::helpers::proc_stat_start_time_resolver(),
             core::trust::remote::helpers::aa_get_task_con_app_id_resolver(),
             "Just a test for %1%.",
-            true
+            true,
+            // Pins down processes via pidfd if supported.
+            {},
+            core::trust::remote::posix::IoBackend::asio,
+            // Do not reconnect to the stub.
+            {},
+            // Decisions are not published.
+            {}
         };
 
         stub_ready.wait_for_signal_ready_for(std::chrono::milliseconds{1000});
@@ -857,7 +2080,10 @@ TEST_F(DBus, a_service_can_query_a_remote_agent)
         core::trust::remote::dbus::Agent::Stub::Configuration config
         {
             object,
-            bus
+            bus,
+            core::trust::remote::helpers::proc_stat_start_time_resolver(),
+            // Decisions are not cached.
+            {}
         };
 
         auto stub = std::make_shared<core::trust::remote::dbus::Agent::Stub>(config);
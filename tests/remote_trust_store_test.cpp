@@ -19,7 +19,9 @@
 #include <core/dbus/fixture.h>
 #include <core/dbus/asio/executor.h>
 
+#include <core/trust/async_store.h>
 #include <core/trust/expose.h>
+#include <core/trust/notifying_store.h>
 #include <core/trust/resolve.h>
 
 #include <core/trust/store.h>
@@ -31,7 +33,14 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
 #include <thread>
+#include <vector>
+
+#include <unistd.h>
 
 namespace
 {
@@ -695,3 +704,492 @@ TEST_F(RemoteTrustStore, erasing_requests_empties_store)
 
     EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(service, client));
 }
+
+TEST_F(RemoteTrustStore, exposing_a_store_without_workers_throws)
+{
+    auto store = core::trust::create_default_store(service_name);
+
+    EXPECT_THROW(core::trust::expose_store_to_bus_with_name(store, session_bus(), service_name, 0),
+                 std::invalid_argument);
+}
+
+TEST_F(RemoteTrustStore, concurrent_queries_are_handled_in_parallel_and_in_order)
+{
+    core::testing::CrossProcessSync cps;
+
+    auto service = [this, &cps]()
+    {
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto bus = session_bus();
+        bus->install_executor(core::dbus::asio::make_executor(bus));
+
+        auto store = core::trust::create_default_store(service_name);
+        auto mapping = core::trust::expose_store_to_bus_with_name(store, bus, service_name, 2);
+
+        cps.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        trap->run();
+
+        return core::posix::exit::Status::success;
+    };
+
+    auto client = [this, &cps]()
+    {
+        auto bus = session_bus();
+        bus->install_executor(core::dbus::asio::make_executor(bus));
+
+        cps.wait_for_signal_ready_for(std::chrono::milliseconds{500});
+        auto store = core::trust::resolve_store_on_bus_with_name(bus, service_name);
+
+        store->reset();
+
+        static const unsigned int request_count = 50;
+        static const unsigned int app_count = 4;
+
+        core::trust::Request r
+        {
+            "",
+            core::trust::Feature{0},
+            std::chrono::system_clock::now(),
+            core::trust::Request::Answer::granted
+        };
+
+        for (unsigned int app = 0; app < app_count; app++)
+        {
+            r.from = "this.does.not.exist.app." + std::to_string(app);
+            for (unsigned int i = 0; i < request_count; i++)
+            {
+                r.feature.value = i;
+                r.when = r.when + std::chrono::seconds{1};
+                store->add(r);
+            }
+        }
+
+        // Every thread walks its own query, expecting the results in insertion order.
+        auto reader = [store](unsigned int app, unsigned int& count)
+        {
+            auto query = store->query();
+            query->for_application_id("this.does.not.exist.app." + std::to_string(app));
+            query->execute();
+
+            std::uint64_t expected_feature = 0;
+            while(core::trust::Store::Query::Status::eor != query->status())
+            {
+                auto current = query->current();
+                if (current.feature.value == expected_feature++)
+                    count++;
+                query->next();
+            }
+        };
+
+        std::vector<unsigned int> counts(app_count, 0);
+        std::vector<std::thread> readers;
+
+        for (unsigned int app = 0; app < app_count; app++)
+            readers.emplace_back(reader, app, std::ref(counts[app]));
+
+        for (auto& reader : readers)
+            reader.join();
+
+        for (auto count : counts)
+            EXPECT_EQ(request_count, count);
+
+        return ::testing::Test::HasFatalFailure() || ::testing::Test::HasFailure() ?
+                    core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(service, client));
+}
+
+TEST_F(RemoteTrustStore, a_store_exposed_to_the_session_can_be_resolved_in_the_same_process)
+{
+    auto store = core::trust::create_default_store(service_name);
+    // Both the exposed and the resolved store share the pooled session bus connection.
+    auto mapping = core::trust::expose_store_to_session_with_name(store, service_name);
+    auto remote = core::trust::resolve_store_in_session_with_name(service_name);
+
+    remote->reset();
+
+    core::trust::Request r
+    {
+        "this.does.not.exist.app",
+        core::trust::Feature{0},
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+
+    remote->add(r);
+
+    auto query = remote->query();
+    query->all();
+    query->execute();
+
+    ASSERT_EQ(core::trust::Store::Query::Status::has_more_results, query->status());
+    EXPECT_EQ(r.from, query->current().from);
+}
+
+TEST_F(RemoteTrustStore, a_caching_store_sees_changes_applied_within_the_exposing_process)
+{
+    core::testing::CrossProcessSync service_ready, cache_populated, request_added;
+
+    core::trust::Request r
+    {
+        "this.does.not.exist.app",
+        core::trust::Feature{0},
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+
+    auto service = [this, r, &service_ready, &cache_populated, &request_added]()
+    {
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto bus = session_bus();
+        bus->install_executor(core::dbus::asio::make_executor(bus));
+
+        auto store = core::trust::create_default_store(service_name); store->reset();
+        auto notifications = std::make_shared<core::trust::NotifyingStore>(store);
+        auto mapping = core::trust::expose_store_to_bus_with_name(notifications, notifications, bus, service_name);
+
+        service_ready.try_signal_ready_for(std::chrono::milliseconds{500});
+        cache_populated.wait_for_signal_ready_for(std::chrono::milliseconds{500});
+
+        // Just like a cached agent persisting answers, we bypass the bus.
+        notifications->add(r);
+
+        request_added.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        trap->run();
+
+        return core::posix::exit::Status::success;
+    };
+
+    auto client = [this, r, &service_ready, &cache_populated, &request_added]()
+    {
+        auto bus = session_bus();
+        bus->install_executor(core::dbus::asio::make_executor(bus));
+
+        service_ready.wait_for_signal_ready_for(std::chrono::milliseconds{500});
+        auto store = core::trust::resolve_caching_store_on_bus_with_name(bus, service_name);
+
+        auto count_requests_for_app = [store](const std::string& app)
+        {
+            auto query = store->query();
+            query->for_application_id(app);
+            return query->count();
+        };
+
+        EXPECT_EQ(0u, count_requests_for_app(r.from));
+        cache_populated.try_signal_ready_for(std::chrono::milliseconds{500});
+        request_added.wait_for_signal_ready_for(std::chrono::milliseconds{500});
+
+        // Changes are announced asynchronously, and we give the announcement some time to arrive.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+        while (count_requests_for_app(r.from) == 0 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+        EXPECT_EQ(1u, count_requests_for_app(r.from));
+
+        return ::testing::Test::HasFatalFailure() || ::testing::Test::HasFailure() ?
+                    core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(service, client));
+}
+
+TEST_F(RemoteTrustStore, a_store_exposed_to_the_session_can_be_exported_and_imported)
+{
+    auto store = core::trust::create_default_store(service_name);
+    auto mapping = core::trust::expose_store_to_session_with_name(store, service_name);
+    auto remote = core::trust::resolve_caching_store_in_session_with_name(service_name);
+
+    remote->reset();
+
+    std::vector<core::trust::Request> requests;
+    for (unsigned int i = 0; i < 1000; i++)
+    {
+        requests.push_back(core::trust::Request
+        {
+            "this.does.not.exist.app" + std::to_string(i % 10),
+            core::trust::Feature{i % 3},
+            core::trust::Request::Timestamp{core::trust::Request::Duration{i}},
+            core::trust::Request::Answer::granted
+        });
+    }
+    store->add_all(requests);
+
+    // Exports are streamed through a socket handed out by the store.
+    std::shared_ptr<std::FILE> file{std::tmpfile(), [](std::FILE* f) { if (f) std::fclose(f); }};
+    EXPECT_EQ(1000u, remote->export_to(::fileno(file.get())));
+
+    // Populates the cache, which imports invalidate.
+    EXPECT_EQ(1000u, remote->query()->count());
+
+    remote->reset();
+    EXPECT_EQ(0u, remote->query()->count());
+
+    // Imports hand over the file descriptor to the store.
+    ::lseek(::fileno(file.get()), 0, SEEK_SET);
+    EXPECT_EQ(1000u, remote->import_from(::fileno(file.get()), true));
+    EXPECT_EQ(1000u, remote->query()->count());
+
+    // Corrupted streams are rejected.
+    std::shared_ptr<std::FILE> garbage{std::tmpfile(), [](std::FILE* f) { if (f) std::fclose(f); }};
+    std::fputs("This is not an exported trust store.", garbage.get()); std::fflush(garbage.get());
+    ::lseek(::fileno(garbage.get()), 0, SEEK_SET);
+    EXPECT_THROW(remote->import_from(::fileno(garbage.get()), false), core::trust::Store::Errors::ErrorImportingStore);
+}
+
+TEST_F(RemoteTrustStore, a_pending_import_does_not_hold_back_modifications)
+{
+    auto store = core::trust::create_default_store(service_name);
+    auto mapping = core::trust::expose_store_to_session_with_name(store, service_name);
+    auto remote = core::trust::resolve_store_in_session_with_name(service_name);
+
+    remote->reset();
+
+    core::trust::Request r
+    {
+        "this.does.not.exist.app",
+        core::trust::Feature{0},
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+
+    remote->add(r);
+
+    std::shared_ptr<std::FILE> file{std::tmpfile(), [](std::FILE* f) { if (f) std::fclose(f); }};
+    EXPECT_EQ(1u, remote->export_to(::fileno(file.get())));
+
+    remote->reset();
+
+    // The client hands over the stream only after modifying the store.
+    int fds[2];
+    ASSERT_EQ(0, ::pipe(fds));
+
+    std::size_t imported{0};
+    std::thread importer{[remote, &fds, &imported]()
+    {
+        imported = remote->import_from(fds[0], false);
+    }};
+
+    r.feature = core::trust::Feature{1};
+    remote->add(r);
+
+    ::lseek(::fileno(file.get()), 0, SEEK_SET);
+
+    char buffer[4096];
+    ssize_t n{0};
+    while ((n = ::read(::fileno(file.get()), buffer, sizeof(buffer))) > 0)
+        EXPECT_EQ(n, ::write(fds[1], buffer, n));
+
+    ::close(fds[1]);
+
+    importer.join();
+    ::close(fds[0]);
+
+    EXPECT_EQ(1u, imported);
+    EXPECT_EQ(2u, remote->query()->count());
+}
+
+TEST_F(RemoteTrustStore, an_async_store_keeps_many_requests_in_flight)
+{
+    core::testing::CrossProcessSync cps;
+
+    auto service = [this, &cps]()
+    {
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto bus = session_bus();
+        bus->install_executor(core::dbus::asio::make_executor(bus));
+
+        auto store = core::trust::create_default_store(service_name); store->reset();
+        auto mapping = core::trust::expose_store_to_bus_with_name(store, bus, service_name);
+
+        cps.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        trap->run();
+
+        return core::posix::exit::Status::success;
+    };
+
+    auto client = [this, &cps]()
+    {
+        auto bus = session_bus();
+        bus->install_executor(core::dbus::asio::make_executor(bus));
+
+        cps.wait_for_signal_ready_for(std::chrono::milliseconds{500});
+        auto store = core::trust::resolve_async_store_on_bus_with_name(bus, service_name);
+
+        static const unsigned int request_count = 100;
+
+        std::mutex guard;
+        std::condition_variable cv;
+        unsigned int added = 0, failed = 0;
+
+        core::trust::Request r
+        {
+            "this.does.not.exist.app",
+            core::trust::Feature{0},
+            std::chrono::system_clock::now(),
+            core::trust::Request::Answer::granted
+        };
+
+        // All requests are in flight before the first reply arrives.
+        for (unsigned int i = 0; i < request_count; i++)
+        {
+            r.feature.value = i;
+            store->add_async(r, [&](const std::exception_ptr& error)
+            {
+                std::lock_guard<std::mutex> lg(guard);
+                if (error) failed++; else added++;
+                cv.notify_all();
+            });
+        }
+
+        {
+            std::unique_lock<std::mutex> ul(guard);
+            EXPECT_TRUE(cv.wait_for(ul, std::chrono::seconds{10}, [&]() { return added + failed == request_count; }));
+            EXPECT_EQ(0u, failed);
+        }
+
+        bool done = false;
+        core::trust::Request current;
+        std::shared_ptr<core::trust::AsyncStore::Query> query;
+
+        store->query_async([&](const std::exception_ptr& error, const std::shared_ptr<core::trust::AsyncStore::Query>& q)
+        {
+            EXPECT_FALSE(error);
+            query = q;
+            query->for_feature_async(core::trust::Feature{42}, [&](const std::exception_ptr& error)
+            {
+                EXPECT_FALSE(error);
+                query->execute_async([&](const std::exception_ptr& error, core::trust::Store::Query::Status status)
+                {
+                    EXPECT_FALSE(error);
+                    EXPECT_EQ(core::trust::Store::Query::Status::has_more_results, status);
+                    query->current_async([&](const std::exception_ptr& error, const core::trust::Request& request)
+                    {
+                        EXPECT_FALSE(error);
+                        std::lock_guard<std::mutex> lg(guard);
+                        current = request;
+                        done = true;
+                        cv.notify_all();
+                    });
+                });
+            });
+        });
+
+        {
+            std::unique_lock<std::mutex> ul(guard);
+            EXPECT_TRUE(cv.wait_for(ul, std::chrono::seconds{10}, [&]() { return done; }));
+        }
+
+        EXPECT_EQ(r.from, current.from);
+        EXPECT_EQ(42u, current.feature.value);
+
+        return ::testing::Test::HasFatalFailure() || ::testing::Test::HasFailure() ?
+                    core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(service, client));
+}
+
+TEST_F(RemoteTrustStore, a_caching_store_sees_changes_announced_by_the_store)
+{
+    core::testing::CrossProcessSync cps;
+
+    auto service = [this, &cps]()
+    {
+        auto trap = core::posix::trap_signals_for_all_subsequent_threads({core::posix::Signal::sig_term});
+        trap->signal_raised().connect([trap](core::posix::Signal)
+        {
+            trap->stop();
+        });
+
+        auto bus = session_bus();
+        bus->install_executor(core::dbus::asio::make_executor(bus));
+
+        auto store = core::trust::create_default_store(service_name); store->reset();
+        auto mapping = core::trust::expose_store_to_bus_with_name(store, bus, service_name);
+
+        cps.try_signal_ready_for(std::chrono::milliseconds{500});
+
+        trap->run();
+
+        return core::posix::exit::Status::success;
+    };
+
+    auto client = [this, &cps]()
+    {
+        auto bus = session_bus();
+        bus->install_executor(core::dbus::asio::make_executor(bus));
+
+        cps.wait_for_signal_ready_for(std::chrono::milliseconds{500});
+        auto store = core::trust::resolve_caching_store_on_bus_with_name(bus, service_name);
+
+        auto count_requests_for_app = [store](const std::string& app)
+        {
+            auto query = store->query();
+            query->for_application_id(app);
+            query->execute();
+
+            unsigned int count = 0;
+            while (core::trust::Store::Query::Status::eor != query->status())
+            {
+                count++;
+                query->next();
+            }
+            return count;
+        };
+
+        core::trust::Request r
+        {
+            "this.does.not.exist.app",
+            core::trust::Feature{0},
+            std::chrono::system_clock::now(),
+            core::trust::Request::Answer::granted
+        };
+
+        store->add(r);
+
+        // The first query populates the cache, the second one is answered from it.
+        EXPECT_EQ(1u, count_requests_for_app(r.from));
+        EXPECT_EQ(1u, count_requests_for_app(r.from));
+        EXPECT_EQ(0u, count_requests_for_app("another.app"));
+
+        r.feature.value = 1;
+        store->add(r);
+        EXPECT_EQ(2u, count_requests_for_app(r.from));
+
+        // Erasing through a cached query reaches the remote store.
+        {
+            auto query = store->query();
+            query->for_application_id(r.from);
+            query->execute();
+            query->erase();
+        }
+        EXPECT_EQ(1u, count_requests_for_app(r.from));
+
+        store->remove_application(r.from);
+        EXPECT_EQ(0u, count_requests_for_app(r.from));
+
+        return ::testing::Test::HasFatalFailure() || ::testing::Test::HasFailure() ?
+                    core::posix::exit::Status::failure : core::posix::exit::Status::success;
+    };
+
+    EXPECT_EQ(core::testing::ForkAndRunResult::empty, core::testing::fork_and_run(service, client));
+}
@@ -163,6 +163,7 @@ TEST(RequestProcessing, queries_store_for_cached_results_and_returns_cached_valu
     // and to the respective feature.
     EXPECT_CALL(*mocked_query, for_application_id(params.application_id)).Times(1);
     EXPECT_CALL(*mocked_query, for_feature(params.feature)).Times(1);
+    EXPECT_CALL(*mocked_query, limit(1)).Times(1);
     // The setup ensures that a previously stored answer is available in the store.
     // For that, the agent should not be queried.
     EXPECT_CALL(*mocked_agent, authenticate_request_with_parameters(_)).Times(0);
@@ -225,6 +226,7 @@ TEST(RequestProcessing, queries_agent_if_no_cached_results_and_returns_users_ans
     // and to the respective feature.
     EXPECT_CALL(*mocked_query, for_application_id(params.application_id)).Times(1);
     EXPECT_CALL(*mocked_query, for_feature(params.feature)).Times(1);
+    EXPECT_CALL(*mocked_query, limit(1)).Times(1);
     // The setup ensures that a previously stored answer is available in the store.
     // For that, the agent should not be queried.
     EXPECT_CALL(*mocked_agent, authenticate_request_with_parameters(agent_params)).Times(1);
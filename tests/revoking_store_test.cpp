@@ -0,0 +1,200 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <core/trust/revoking_store.h>
+
+#include "mock_agent.h"
+#include "mock_store.h"
+
+#include <gmock/gmock.h>
+
+#include <unistd.h>
+
+namespace
+{
+struct MockSkeleton : public core::trust::remote::Agent::Skeleton
+{
+    MockSkeleton() : core::trust::remote::Agent::Skeleton{std::make_shared<testing::NiceMock<MockAgent>>()}
+    {
+    }
+
+    // Tells the sending end to drop cached decisions covered by revocation.
+    MOCK_METHOD1(revoke, void(const core::trust::remote::Revocation&));
+};
+
+std::shared_ptr<testing::NiceMock<MockStore>> a_mocked_store()
+{
+    return std::make_shared<testing::NiceMock<MockStore>>();
+}
+
+std::shared_ptr<testing::NiceMock<MockStore::MockQuery>> a_mocked_query()
+{
+    return std::make_shared<testing::NiceMock<MockStore::MockQuery>>();
+}
+
+std::shared_ptr<testing::NiceMock<MockSkeleton>> a_mocked_skeleton()
+{
+    return std::make_shared<testing::NiceMock<MockSkeleton>>();
+}
+
+core::trust::Request a_request_for(const std::string& app_id, core::trust::Feature feature)
+{
+    return core::trust::Request
+    {
+        app_id,
+        feature,
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+}
+
+// Matches revocations of the decisions for feature, for the user running the test.
+testing::Matcher<const core::trust::remote::Revocation&> revokes(core::trust::Feature feature)
+{
+    using namespace ::testing;
+    return AllOf(Field(&core::trust::remote::Revocation::uid, core::trust::Uid{::getuid()}),
+                 Field(&core::trust::remote::Revocation::all_features, false),
+                 Field(&core::trust::remote::Revocation::feature, feature));
+}
+
+// Matches revocations of all decisions for the user running the test.
+testing::Matcher<const core::trust::remote::Revocation&> revokes_all_features()
+{
+    using namespace ::testing;
+    return AllOf(Field(&core::trust::remote::Revocation::uid, core::trust::Uid{::getuid()}),
+                 Field(&core::trust::remote::Revocation::all_features, true));
+}
+}
+
+TEST(RevokingStore, ctor_throws_for_null_skeleton)
+{
+    EXPECT_ANY_THROW(core::trust::RevokingStore(a_mocked_store(), std::shared_ptr<core::trust::remote::Agent::Skeleton>{}));
+}
+
+TEST(RevokingStore, revokes_decisions_for_the_feature_after_adding_a_request)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto skeleton = a_mocked_skeleton();
+
+    auto request = a_request_for("com.ubuntu.app", core::trust::Feature{1});
+
+    {
+        InSequence seq;
+        EXPECT_CALL(*store, add(request)).Times(1);
+        EXPECT_CALL(*skeleton, revoke(revokes(core::trust::Feature{1}))).Times(1);
+    }
+
+    core::trust::RevokingStore revoking_store{store, skeleton};
+    revoking_store.add(request);
+}
+
+TEST(RevokingStore, revokes_decisions_for_every_feature_of_added_requests)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto skeleton = a_mocked_skeleton();
+
+    EXPECT_CALL(*store, add(_)).Times(2);
+    EXPECT_CALL(*skeleton, revoke(revokes(core::trust::Feature{1}))).Times(1);
+    EXPECT_CALL(*skeleton, revoke(revokes(core::trust::Feature{2}))).Times(1);
+
+    core::trust::RevokingStore revoking_store{store, skeleton};
+    revoking_store.add_all(
+    {
+        a_request_for("com.ubuntu.app", core::trust::Feature{1}),
+        a_request_for("com.ubuntu.app", core::trust::Feature{2})
+    });
+}
+
+TEST(RevokingStore, revokes_all_decisions_after_removing_an_application)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto skeleton = a_mocked_skeleton();
+
+    {
+        InSequence seq;
+        EXPECT_CALL(*store, remove_application("com.ubuntu.app")).Times(1);
+        EXPECT_CALL(*skeleton, revoke(revokes_all_features())).Times(1);
+    }
+
+    core::trust::RevokingStore revoking_store{store, skeleton};
+    revoking_store.remove_application("com.ubuntu.app");
+}
+
+TEST(RevokingStore, revokes_all_decisions_after_a_reset)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto skeleton = a_mocked_skeleton();
+
+    {
+        InSequence seq;
+        EXPECT_CALL(*store, reset()).Times(1);
+        EXPECT_CALL(*skeleton, revoke(revokes_all_features())).Times(1);
+    }
+
+    core::trust::RevokingStore revoking_store{store, skeleton};
+    revoking_store.reset();
+}
+
+TEST(RevokingStore, revokes_all_decisions_after_erasing_query_results)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto query = a_mocked_query();
+    auto skeleton = a_mocked_skeleton();
+
+    ON_CALL(*store, query()).WillByDefault(Return(query));
+
+    {
+        InSequence seq;
+        EXPECT_CALL(*query, erase()).Times(1);
+        EXPECT_CALL(*skeleton, revoke(revokes_all_features())).Times(1);
+    }
+
+    core::trust::RevokingStore revoking_store{store, skeleton};
+    revoking_store.query()->erase();
+}
+
+TEST(RevokingStore, does_not_revoke_decisions_for_queries_leaving_the_store_untouched)
+{
+    using namespace ::testing;
+
+    auto store = a_mocked_store();
+    auto query = a_mocked_query();
+    auto skeleton = a_mocked_skeleton();
+
+    ON_CALL(*store, query()).WillByDefault(Return(query));
+    ON_CALL(*query, status()).WillByDefault(Return(core::trust::Store::Query::Status::eor));
+
+    EXPECT_CALL(*query, execute()).Times(1);
+    EXPECT_CALL(*skeleton, revoke(_)).Times(0);
+
+    core::trust::RevokingStore revoking_store{store, skeleton};
+
+    auto q = revoking_store.query();
+    q->for_application_id("com.ubuntu.app");
+    q->execute();
+    EXPECT_EQ(core::trust::Store::Query::Status::eor, q->status());
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Compares the sqlite and the log-structured store backends. For every backend,
+// we measure the latency of adding requests and of looking up the latest answer
+// for an (application, feature) pair, as well as the time to open a populated store.
+//
+// Usage: store_benchmark [requests]
+
+#include <core/trust/store.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+// The directory hosting the stores while benchmarking.
+static constexpr const char* data_home_for_benchmark
+{
+    "/tmp/store.benchmark"
+};
+
+static constexpr const char* service_name_for_benchmark
+{
+    "store.benchmark"
+};
+
+// The number of distinct applications requests are spread across.
+static constexpr const unsigned int application_count{100};
+
+// The results of a single benchmark run, latencies in nanoseconds.
+struct Results
+{
+    std::int64_t add_p50;
+    std::int64_t add_p99;
+    std::int64_t lookup_p50;
+    std::int64_t lookup_p99;
+    std::int64_t cold_open;
+};
+
+// Returns the p-th percentile of samples, reordering samples.
+std::int64_t percentile(std::vector<std::int64_t>& samples, double p)
+{
+    auto it = samples.begin() + static_cast<std::size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), it, samples.end());
+    return *it;
+}
+
+template<typename F>
+std::int64_t measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+core::trust::Request request_for(unsigned int i)
+{
+    return core::trust::Request
+    {
+        "com.does.not.exist.app" + std::to_string(i % application_count),
+        core::trust::Feature{i / application_count},
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+}
+
+Results run(const std::string& backend, unsigned int requests)
+{
+    Results results;
+    std::vector<std::int64_t> samples;
+
+    {
+        auto store = core::trust::create_store_for_backend(backend, service_name_for_benchmark);
+        store->reset();
+
+        for (unsigned int i = 0; i < requests; i++)
+        {
+            auto r = request_for(i);
+            samples.push_back(measure([&]() { store->add(r); }));
+        }
+
+        results.add_p50 = percentile(samples, 0.5);
+        results.add_p99 = percentile(samples, 0.99);
+    }
+
+    std::shared_ptr<core::trust::Store> store;
+    results.cold_open = measure([&]() { store = core::trust::create_store_for_backend(backend, service_name_for_benchmark); });
+
+    samples.clear();
+    for (unsigned int i = 0; i < requests; i++)
+    {
+        auto r = request_for(i);
+        samples.push_back(measure([&]()
+        {
+            auto query = store->query();
+            query->for_application_id(r.from);
+            query->for_feature(r.feature);
+            query->execute();
+            if (query->status() != core::trust::Store::Query::Status::has_more_results)
+                std::abort();
+            query->current();
+        }));
+    }
+
+    results.lookup_p50 = percentile(samples, 0.5);
+    results.lookup_p99 = percentile(samples, 0.99);
+
+    return results;
+}
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int requests = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+
+    // Keeps the benchmark from touching the stores of the user.
+    ::setenv("XDG_DATA_HOME", data_home_for_benchmark, 1);
+    boost::filesystem::create_directories(data_home_for_benchmark);
+
+    std::printf("%-16s %12s %12s %12s %12s %14s\n", "backend", "add p50", "add p99", "lookup p50", "lookup p99", "cold open");
+
+    for (const std::string backend : {"sqlite", "log_structured"})
+    {
+        auto results = run(backend, requests);
+        std::printf("%-16s %10.1fus %10.1fus %10.1fus %10.1fus %12.1fus\n",
+                    backend.c_str(),
+                    results.add_p50 / 1000., results.add_p99 / 1000.,
+                    results.lookup_p50 / 1000., results.lookup_p99 / 1000.,
+                    results.cold_open / 1000.);
+    }
+
+    boost::filesystem::remove_all(data_home_for_benchmark);
+
+    return EXIT_SUCCESS;
+}
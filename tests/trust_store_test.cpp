@@ -20,12 +20,20 @@
 
 #include <xdg.h>
 
+#include <sqlite3.h>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <csignal>
+#include <cstdio>
+#include <fstream>
 #include <thread>
 #include <unordered_set>
 
+#include <sys/resource.h>
+#include <unistd.h>
+
 namespace
 {
 static const std::string service_name{"52EB2494-76F2-4ABB-A188-20B2D5B3CC94"};
@@ -365,6 +373,49 @@ TEST(TrustStore, added_requests_are_found_by_query_multi_threaded)
     EXPECT_EQ(500u, counter);
 }
 
+TEST(TrustStore, queries_never_observe_groups_of_requests_being_added_concurrently)
+{
+    auto store = core::trust::create_default_store(service_name);
+
+    store->reset();
+
+    // Large enough to span several statements within a single transaction.
+    static const std::size_t group_size = 500;
+    static const std::size_t group_count = 20;
+
+    std::thread writer{[store]()
+    {
+        for (std::size_t g = 0; g < group_count; g++)
+        {
+            std::vector<core::trust::Request> group;
+
+            for (std::size_t i = 0; i < group_size; i++)
+            {
+                group.push_back(core::trust::Request
+                {
+                    "this.does.not.exist.app",
+                    core::trust::Feature{g * group_size + i},
+                    std::chrono::system_clock::now(),
+                    core::trust::Request::Answer::granted
+                });
+            }
+
+            store->add_all(group);
+        }
+    }};
+
+    auto query = store->query();
+
+    // We stop at the first partial group that we observe.
+    std::size_t count{0};
+    while (count < group_size * group_count && count % group_size == 0)
+        count = query->count();
+
+    writer.join();
+
+    EXPECT_EQ(0u, count % group_size);
+}
+
 TEST(TrustStore, erasing_requests_empties_store)
 {
     auto store = core::trust::create_default_store(service_name);
@@ -444,6 +495,484 @@ TEST(TrustStore, removing_application)
     EXPECT_EQ(remaining_apps.find("this.does.not.exist.app4"), remaining_apps.end());
 }
 
+TEST(TrustStore, requests_added_as_a_group_are_found_by_query)
+{
+    auto store = core::trust::create_default_store(service_name);
+    store->reset();
+
+    std::vector<core::trust::Request> requests;
+
+    for (unsigned int i = 0; i < 10; i++)
+    {
+        requests.push_back(core::trust::Request
+        {
+            "this.does.not.exist.app",
+            core::trust::Feature{i},
+            std::chrono::system_clock::now(),
+            i % 2 == 0 ? core::trust::Request::Answer::granted : core::trust::Request::Answer::denied
+        });
+    }
+
+    store->add_all(requests);
+
+    auto query = store->query();
+    query->for_application_id("this.does.not.exist.app");
+    query->execute();
+
+    std::size_t count{0};
+    while (query->status() == core::trust::Store::Query::Status::has_more_results)
+    {
+        auto r = query->current();
+        EXPECT_EQ(requests.at(r.feature.value), r);
+        count++;
+        query->next();
+    }
+
+    EXPECT_EQ(requests.size(), count);
+
+    // An empty group does not modify the store.
+    EXPECT_NO_THROW(store->add_all(std::vector<core::trust::Request>{}));
+}
+
+namespace
+{
+// Returns all requests found by query, executing it before.
+std::vector<core::trust::Request> results_of(const std::shared_ptr<core::trust::Store::Query>& query)
+{
+    std::vector<core::trust::Request> results;
+
+    query->execute();
+    while (query->status() == core::trust::Store::Query::Status::has_more_results)
+    {
+        results.push_back(query->current());
+        query->next();
+    }
+
+    return results;
+}
+
+// Returns a temporary file holding content, positioned at its beginning.
+std::shared_ptr<std::FILE> temporary_file_with(const std::string& content)
+{
+    std::shared_ptr<std::FILE> file{std::tmpfile(), [](std::FILE* f) { if (f) std::fclose(f); }};
+
+    if (not content.empty())
+    {
+        EXPECT_EQ(static_cast<ssize_t>(content.size()), ::write(::fileno(file.get()), content.data(), content.size()));
+    }
+    ::lseek(::fileno(file.get()), 0, SEEK_SET);
+
+    return file;
+}
+
+// Returns the entire content of file.
+std::string content_of(const std::shared_ptr<std::FILE>& file)
+{
+    std::string content;
+    char buffer[4096];
+
+    ::lseek(::fileno(file.get()), 0, SEEK_SET);
+
+    ssize_t rc{0};
+    while ((rc = ::read(::fileno(file.get()), buffer, sizeof(buffer))) > 0)
+        content.append(buffer, rc);
+
+    return content;
+}
+
+// Adds n requests spread across several applications and features to store.
+void add_requests(const std::shared_ptr<core::trust::Store>& store, unsigned int n)
+{
+    std::vector<core::trust::Request> requests;
+
+    for (unsigned int i = 0; i < n; i++)
+    {
+        requests.push_back(core::trust::Request
+        {
+            "this.does.not.exist.app" + std::to_string(i % 5),
+            core::trust::Feature{i % 7},
+            core::trust::Request::Timestamp{core::trust::Request::Duration{i}},
+            i % 3 == 0 ? core::trust::Request::Answer::granted : core::trust::Request::Answer::denied
+        });
+    }
+
+    store->add_all(requests);
+}
+}
+
+TEST(TrustStore, erasing_all_results_of_a_query_leaves_other_requests_untouched)
+{
+    auto store = core::trust::create_default_store(service_name);
+    store->reset();
+
+    for (unsigned int i = 0; i < 40; i++)
+    {
+        store->add(core::trust::Request
+        {
+            "this.does.not.exist.app" + std::to_string(i % 4),
+            core::trust::Feature{i % 2},
+            core::trust::Request::Timestamp{core::trust::Request::Duration{i}},
+            i % 3 == 0 ? core::trust::Request::Answer::granted : core::trust::Request::Answer::denied
+        });
+    }
+
+    // The query does not need to be executed before.
+    auto query = store->query();
+    query->for_application_id("this.does.not.exist.app0");
+    query->for_answer(core::trust::Request::Answer::denied);
+    query->erase_all();
+    EXPECT_EQ(core::trust::Store::Query::Status::eor, query->status());
+
+    EXPECT_TRUE(results_of(query).empty());
+
+    query->all();
+    query->for_application_id("this.does.not.exist.app0");
+    for (const auto& r : results_of(query))
+        EXPECT_EQ(core::trust::Request::Answer::granted, r.answer);
+
+    // An executed query erases all results, not only the remaining ones.
+    query->all();
+    query->for_feature(core::trust::Feature{1});
+    query->execute();
+    query->next();
+    query->erase_all();
+
+    query->all();
+    auto remaining = results_of(query);
+    EXPECT_FALSE(remaining.empty());
+    for (const auto& r : remaining)
+    {
+        EXPECT_EQ(core::trust::Feature{0}, r.feature);
+        if (r.from == "this.does.not.exist.app0")
+        {
+            EXPECT_EQ(core::trust::Request::Answer::granted, r.answer);
+        }
+    }
+
+    // Erasing all requests empties the store.
+    query->all();
+    query->erase_all();
+    EXPECT_TRUE(results_of(query).empty());
+}
+
+TEST(TrustStore, removing_feature_and_older_requests)
+{
+    auto store = core::trust::create_default_store(service_name);
+    store->reset();
+
+    for (unsigned int i = 0; i < 30; i++)
+    {
+        store->add(core::trust::Request
+        {
+            "this.does.not.exist.app" + std::to_string(i % 3),
+            core::trust::Feature{i % 5},
+            core::trust::Request::Timestamp{core::trust::Request::Duration{100 + i}},
+            core::trust::Request::Answer::granted
+        });
+    }
+
+    // Revoking a feature affects all applications.
+    store->remove_feature(core::trust::Feature{2});
+
+    auto query = store->query();
+    auto remaining = results_of(query);
+    EXPECT_EQ(24u, remaining.size());
+    for (const auto& r : remaining)
+        EXPECT_NE(core::trust::Feature{2}, r.feature);
+
+    // Requests issued exactly at the given point in time are kept.
+    store->remove_older_than(core::trust::Request::Timestamp{core::trust::Request::Duration{120}});
+
+    remaining = results_of(query);
+    EXPECT_EQ(8u, remaining.size());
+    for (const auto& r : remaining)
+        EXPECT_LE(core::trust::Request::Timestamp{core::trust::Request::Duration{120}}, r.when);
+    EXPECT_EQ(core::trust::Request::Timestamp{core::trust::Request::Duration{120}}, remaining.back().when);
+
+    // Statistics only cover the remaining requests.
+    std::uint64_t granted{0};
+    for (const auto& s : store->statistics())
+    {
+        EXPECT_NE(core::trust::Feature{2}, s.feature);
+        EXPECT_LE(core::trust::Request::Timestamp{core::trust::Request::Duration{120}}, s.first);
+        granted += s.granted;
+    }
+    EXPECT_EQ(8u, granted);
+}
+
+TEST(TrustStore, counting_checking_and_limiting_query_results)
+{
+    auto store = core::trust::create_default_store(service_name);
+    store->reset();
+
+    auto query = store->query();
+    EXPECT_EQ(0u, query->count());
+    EXPECT_FALSE(query->exists());
+
+    for (unsigned int i = 0; i < 20; i++)
+    {
+        store->add(core::trust::Request
+        {
+            "this.does.not.exist.app" + std::to_string(i % 2),
+            core::trust::Feature{i % 4},
+            core::trust::Request::Timestamp{core::trust::Request::Duration{i}},
+            core::trust::Request::Answer::granted
+        });
+    }
+
+    // Counting does not require executing the query, and does not move its cursor.
+    query->for_application_id("this.does.not.exist.app1");
+    EXPECT_EQ(10u, query->count());
+    EXPECT_TRUE(query->exists());
+    query->execute();
+    EXPECT_EQ(core::trust::Request::Timestamp{core::trust::Request::Duration{19}}, query->current().when);
+    EXPECT_EQ(10u, query->count());
+    EXPECT_EQ(core::trust::Request::Timestamp{core::trust::Request::Duration{19}}, query->current().when);
+
+    query->for_feature(core::trust::Feature{0});
+    EXPECT_EQ(0u, query->count());
+    EXPECT_FALSE(query->exists());
+
+    // Limits select the most recent results.
+    query->all();
+    query->for_feature(core::trust::Feature{3});
+    query->limit(2);
+    EXPECT_EQ(2u, query->count());
+    EXPECT_TRUE(query->exists());
+
+    auto results = results_of(query);
+    ASSERT_EQ(2u, results.size());
+    EXPECT_EQ(core::trust::Request::Timestamp{core::trust::Request::Duration{19}}, results.at(0).when);
+    EXPECT_EQ(core::trust::Request::Timestamp{core::trust::Request::Duration{15}}, results.at(1).when);
+
+    // Erasing honors limits, too.
+    query->erase_all();
+    query->limit(10);
+    EXPECT_EQ(3u, query->count());
+
+    query->limit(0);
+    EXPECT_EQ(0u, query->count());
+    EXPECT_FALSE(query->exists());
+
+    // Resetting the query lifts all limits.
+    query->all();
+    EXPECT_EQ(18u, query->count());
+}
+
+TEST(TrustStore, loading_streams_requests_into_the_store_with_and_without_deferred_indices)
+{
+    auto store = core::trust::create_default_store(service_name);
+
+    for (bool defer_indices : {false, true})
+    {
+        store->reset();
+
+        // Not a multiple of any sensible chunk size.
+        const unsigned int n{203};
+        unsigned int i{0};
+
+        auto loaded = store->load([&i, n](core::trust::Request& request)
+        {
+            if (i == n)
+                return false;
+
+            request = core::trust::Request
+            {
+                "this.does.not.exist.app" + std::to_string(i % 3),
+                core::trust::Feature{i % 2},
+                core::trust::Request::Timestamp{core::trust::Request::Duration{i}},
+                core::trust::Request::Answer::granted
+            };
+
+            i++;
+            return true;
+        }, defer_indices);
+
+        EXPECT_EQ(n, loaded);
+        EXPECT_EQ(n, store->query()->count());
+
+        auto query = store->query();
+        query->for_application_id("this.does.not.exist.app1");
+        query->for_feature(core::trust::Feature{0});
+        EXPECT_EQ(34u, query->count());
+        query->execute();
+        EXPECT_EQ(core::trust::Request::Timestamp{core::trust::Request::Duration{202}}, query->current().when);
+
+        // Statistics cover loaded requests, and are maintained for requests added afterwards.
+        store->add(core::trust::Request
+        {
+            "this.does.not.exist.app0",
+            core::trust::Feature{0},
+            core::trust::Request::Timestamp{core::trust::Request::Duration{n}},
+            core::trust::Request::Answer::denied
+        });
+
+        std::uint64_t granted{0}, denied{0};
+        for (const auto& s : store->statistics())
+        {
+            granted += s.granted;
+            denied += s.denied;
+        }
+
+        EXPECT_EQ(n, granted);
+        EXPECT_EQ(1u, denied);
+    }
+}
+
+TEST(TrustStore, exported_requests_can_be_imported_into_another_store)
+{
+    auto store = core::trust::create_default_store(service_name);
+    store->reset();
+
+    // Spans several records of the stream format.
+    add_requests(store, 600);
+
+    auto file = temporary_file_with(std::string{});
+    EXPECT_EQ(600u, store->export_to(::fileno(file.get())));
+
+    auto clone = core::trust::create_default_store(service_name + "-clone");
+
+    for (bool defer_indices : {false, true})
+    {
+        clone->reset();
+
+        ::lseek(::fileno(file.get()), 0, SEEK_SET);
+        EXPECT_EQ(600u, clone->import_from(::fileno(file.get()), defer_indices));
+
+        EXPECT_EQ(results_of(store->query()), results_of(clone->query()));
+
+        auto query = clone->query();
+        query->for_application_id("this.does.not.exist.app3");
+        EXPECT_EQ(120u, query->count());
+
+        auto expected = store->statistics();
+        auto actual = clone->statistics();
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_EQ(expected.at(i).application_id, actual.at(i).application_id);
+            EXPECT_EQ(expected.at(i).granted, actual.at(i).granted);
+            EXPECT_EQ(expected.at(i).denied, actual.at(i).denied);
+        }
+    }
+
+    // App ids are dictionary encoded, and the stream is considerably smaller than its requests.
+    EXPECT_LT(content_of(file).size(), 600u * 48);
+}
+
+TEST(TrustStore, importing_rejects_corrupted_truncated_and_unknown_streams)
+{
+    auto store = core::trust::create_default_store(service_name);
+    store->reset();
+
+    // Fits into a single record of the stream format.
+    add_requests(store, 200);
+
+    auto file = temporary_file_with(std::string{});
+    store->export_to(::fileno(file.get()));
+    auto exported = content_of(file);
+
+    store->reset();
+
+    auto import = [store](const std::string& content)
+    {
+        auto file = temporary_file_with(content);
+        store->import_from(::fileno(file.get()), false);
+    };
+
+    // Flipping a single bit in the last byte of the requests record invalidates its checksum.
+    auto corrupted = exported;
+    corrupted.at(corrupted.size() - 18) ^= 0x01;
+    EXPECT_THROW(import(corrupted), core::trust::Store::Errors::ErrorImportingStore);
+    EXPECT_EQ(0u, store->query()->count());
+
+    // Streams lacking their end record are incomplete.
+    auto truncated = exported.substr(0, exported.size() - 17);
+    EXPECT_THROW(import(truncated), core::trust::Store::Errors::ErrorImportingStore);
+    EXPECT_EQ(0u, store->query()->count());
+
+    EXPECT_THROW(import(std::string{}), core::trust::Store::Errors::ErrorImportingStore);
+    EXPECT_THROW(import("This is not an exported trust store."), core::trust::Store::Errors::ErrorImportingStore);
+
+    EXPECT_NO_THROW(import(exported));
+    EXPECT_EQ(200u, store->query()->count());
+}
+
+TEST(TrustStore, statistics_aggregate_requests_per_application_and_feature)
+{
+    auto store = core::trust::create_default_store(service_name);
+    store->reset();
+
+    EXPECT_TRUE(store->statistics().empty());
+
+    auto at = [](std::int64_t ticks)
+    {
+        return core::trust::Request::Timestamp{core::trust::Request::Duration{ticks}};
+    };
+
+    // Requests are added out of order with respect to their timestamps.
+    for (unsigned int i = 0; i < 30; i++)
+    {
+        store->add(core::trust::Request
+        {
+            "this.does.not.exist.app" + std::to_string(i % 3),
+            core::trust::Feature{i % 2},
+            at(1000 - i),
+            i % 5 == 0 ? core::trust::Request::Answer::granted : core::trust::Request::Answer::denied
+        });
+    }
+
+    auto statistics = store->statistics();
+    ASSERT_EQ(6u, statistics.size());
+
+    std::uint64_t granted{0}, denied{0};
+    for (std::size_t i = 0; i < statistics.size(); i++)
+    {
+        const auto& s = statistics.at(i);
+        EXPECT_EQ("this.does.not.exist.app" + std::to_string(i / 2), s.application_id);
+        EXPECT_EQ(core::trust::Feature{i % 2}, s.feature);
+        EXPECT_EQ(5u, s.granted + s.denied);
+        EXPECT_LT(s.first, s.last);
+        granted += s.granted;
+        denied += s.denied;
+    }
+    EXPECT_EQ(6u, granted);
+    EXPECT_EQ(24u, denied);
+
+    // Requests 0, 6, ..., 24 have been issued by app0 for feature 0, with the last one being the oldest
+    // and only the first one being granted.
+    EXPECT_EQ(at(1000 - 24), statistics.at(0).first);
+    EXPECT_EQ(at(1000), statistics.at(0).last);
+    EXPECT_EQ(1u, statistics.at(0).granted);
+
+    // Erasing the most recent request of app0 and feature 0 updates the aggregate accordingly.
+    auto query = store->query();
+    query->for_application_id("this.does.not.exist.app0");
+    query->for_feature(core::trust::Feature{0});
+    query->execute();
+    ASSERT_EQ(core::trust::Store::Query::Status::has_more_results, query->status());
+    EXPECT_EQ(at(1000), query->current().when);
+    query->erase();
+
+    statistics = store->statistics();
+    ASSERT_EQ(6u, statistics.size());
+    EXPECT_EQ(0u, statistics.at(0).granted);
+    EXPECT_EQ(4u, statistics.at(0).denied);
+    EXPECT_EQ(at(1000 - 6), statistics.at(0).last);
+
+    // Removed applications do not show up anymore.
+    store->remove_application("this.does.not.exist.app1");
+
+    statistics = store->statistics();
+    ASSERT_EQ(4u, statistics.size());
+    for (const auto& s : statistics)
+        EXPECT_NE("this.does.not.exist.app1", s.application_id);
+
+    store->reset();
+    EXPECT_TRUE(store->statistics().empty());
+}
+
+#include <core/trust/impl/log_structured/store.h>
 #include <core/trust/impl/sqlite3/store.h>
 namespace
 {
@@ -490,3 +1019,351 @@ TEST(SqliteTrustStore, queries_xdg_data_home)
     EXPECT_CALL(spec.data_, home()).Times(1).WillRepeatedly(Return(boost::filesystem::path{"/tmp"}));
     core::trust::impl::sqlite::create_for_service(service_name, spec);
 }
+
+TEST(SqliteTrustStore, read_only_store_sees_requests_added_by_read_write_store)
+{
+    using namespace ::testing;
+
+    MockXdgBaseDirSpec spec;
+    EXPECT_CALL(spec.data_, home()).WillRepeatedly(Return(boost::filesystem::path{"/tmp"}));
+
+    auto store = core::trust::impl::sqlite::create_for_service(service_name, spec);
+    store->reset();
+
+    auto read_only_store = core::trust::impl::sqlite::create_read_only_for_service(service_name, spec);
+
+    core::trust::Request r
+    {
+        "this.does.not.exist.app",
+        core::trust::Feature{42},
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+
+    store->add(r);
+
+    auto query = read_only_store->query();
+    query->for_application_id(r.from);
+    query->for_feature(r.feature);
+    query->execute();
+
+    ASSERT_EQ(core::trust::Store::Query::Status::has_more_results, query->status());
+    EXPECT_EQ(r, query->current());
+}
+
+TEST(SqliteTrustStore, read_only_store_throws_on_modification)
+{
+    using namespace ::testing;
+
+    MockXdgBaseDirSpec spec;
+    EXPECT_CALL(spec.data_, home()).WillRepeatedly(Return(boost::filesystem::path{"/tmp"}));
+
+    auto store = core::trust::impl::sqlite::create_for_service(service_name, spec);
+    store->reset();
+
+    core::trust::Request r
+    {
+        "this.does.not.exist.app",
+        core::trust::Feature{42},
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+
+    store->add(r);
+
+    auto read_only_store = core::trust::impl::sqlite::create_read_only_for_service(service_name, spec);
+
+    EXPECT_THROW(read_only_store->add(r), core::trust::Store::Errors::StoreIsReadOnly);
+    EXPECT_THROW(read_only_store->remove_application(r.from), core::trust::Store::Errors::StoreIsReadOnly);
+    EXPECT_THROW(read_only_store->reset(), core::trust::Store::Errors::StoreIsReadOnly);
+
+    auto query = read_only_store->query();
+    query->execute();
+    EXPECT_THROW(query->erase(), core::trust::Store::Errors::StoreIsReadOnly);
+}
+
+TEST(SqliteTrustStore, migrates_database_with_schema_version_1)
+{
+    using namespace ::testing;
+
+    static const std::string legacy_service_name{"0C1B5E5A-7F53-4D5B-8E0E-2F9A4C3B1D77"};
+
+    MockXdgBaseDirSpec spec;
+    EXPECT_CALL(spec.data_, home()).WillRepeatedly(Return(boost::filesystem::path{"/tmp"}));
+
+    auto dir = boost::filesystem::path{"/tmp"} / legacy_service_name;
+    boost::filesystem::remove_all(dir);
+    boost::filesystem::create_directories(dir);
+
+    // Sets up a database as written by previous versions, storing app ids as text.
+    {
+        sqlite3* db = nullptr;
+        ASSERT_EQ(SQLITE_OK, sqlite3_open((dir / "trust.db").string().c_str(), &db));
+        ASSERT_EQ(SQLITE_OK, sqlite3_exec(
+                      db,
+                      "CREATE TABLE requests ('Id' INTEGER PRIMARY KEY ASC, 'ApplicationId' TEXT NOT NULL,"
+                      " 'Feature' BIGINT, 'Timestamp' BIGINT, 'Answer' INTEGER);"
+                      "INSERT INTO requests ('ApplicationId','Feature','Timestamp','Answer') VALUES"
+                      " ('com.ubuntu.camera_camera', 0, 100, 0), ('com.ubuntu.camera_camera', 1, 200, 1),"
+                      " ('com.ubuntu.music_music', 0, 300, 0);"
+                      "PRAGMA user_version=1;",
+                      nullptr, nullptr, nullptr));
+        sqlite3_close(db);
+    }
+
+    auto store = core::trust::impl::sqlite::create_for_service(legacy_service_name, spec);
+
+    auto query = store->query();
+    query->for_application_id("com.ubuntu.camera_camera");
+    query->execute();
+
+    ASSERT_EQ(core::trust::Store::Query::Status::has_more_results, query->status());
+    EXPECT_EQ(core::trust::Feature{1}, query->current().feature);
+    EXPECT_EQ(core::trust::Request::Answer::granted, query->current().answer);
+    query->next();
+    ASSERT_EQ(core::trust::Store::Query::Status::has_more_results, query->status());
+    EXPECT_EQ(core::trust::Feature{0}, query->current().feature);
+    EXPECT_EQ(core::trust::Request::Answer::denied, query->current().answer);
+    query->next();
+    EXPECT_EQ(core::trust::Store::Query::Status::eor, query->status());
+
+    // Features are stored with their full width from now on.
+    core::trust::Request r
+    {
+        "com.ubuntu.music_music",
+        core::trust::Feature{std::uint64_t{1} << 40},
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+    store->add(r);
+
+    store->remove_application("com.ubuntu.camera_camera");
+
+    query->all();
+    query->execute();
+
+    ASSERT_EQ(core::trust::Store::Query::Status::has_more_results, query->status());
+    EXPECT_EQ(r, query->current());
+    query->next();
+    ASSERT_EQ(core::trust::Store::Query::Status::has_more_results, query->status());
+    EXPECT_EQ("com.ubuntu.music_music", query->current().from);
+    query->next();
+    EXPECT_EQ(core::trust::Store::Query::Status::eor, query->status());
+
+    // Unknown applications do not match any request.
+    query->for_application_id("com.ubuntu.camera_camera");
+    query->execute();
+    EXPECT_EQ(core::trust::Store::Query::Status::eor, query->status());
+
+    // Statistics cover requests recorded before the migration, too.
+    auto statistics = store->statistics();
+    ASSERT_EQ(2u, statistics.size());
+    EXPECT_EQ("com.ubuntu.music_music", statistics.at(0).application_id);
+    EXPECT_EQ(core::trust::Feature{0}, statistics.at(0).feature);
+    EXPECT_EQ(0u, statistics.at(0).granted);
+    EXPECT_EQ(1u, statistics.at(0).denied);
+    EXPECT_EQ(core::trust::Request::Timestamp{core::trust::Request::Duration{300}}, statistics.at(0).first);
+    EXPECT_EQ(core::trust::Request::Timestamp{core::trust::Request::Duration{300}}, statistics.at(0).last);
+    EXPECT_EQ(r.feature, statistics.at(1).feature);
+    EXPECT_EQ(1u, statistics.at(1).granted);
+
+    // The index covers timestamps from schema version 4 on.
+    {
+        sqlite3* db = nullptr;
+        ASSERT_EQ(SQLITE_OK, sqlite3_open((dir / "trust.db").string().c_str(), &db));
+
+        sqlite3_stmt* stmt = nullptr;
+        ASSERT_EQ(SQLITE_OK, sqlite3_prepare_v2(db, "SELECT name FROM sqlite_master WHERE type = 'index' AND tbl_name = 'requests';", -1, &stmt, nullptr));
+
+        std::vector<std::string> indices;
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+            indices.push_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+
+        EXPECT_EQ(std::vector<std::string>{"requests_by_key"}, indices);
+    }
+}
+
+TEST(SqliteTrustStore, read_only_store_throws_for_missing_database)
+{
+    using namespace ::testing;
+
+    MockXdgBaseDirSpec spec;
+    EXPECT_CALL(spec.data_, home()).WillRepeatedly(Return(boost::filesystem::path{"/tmp"}));
+
+    EXPECT_THROW(core::trust::impl::sqlite::create_read_only_for_service("this.service.does.not.exist", spec),
+                 core::trust::Store::Errors::ErrorOpeningStore);
+}
+
+namespace
+{
+static const std::string log_structured_service_name{"8B7E3AD4-3F07-4A7C-9C4A-6B5D1F0E2A91"};
+
+// Sets up an empty log for log_structured_service_name in /tmp.
+struct LogStructuredTrustStore : public ::testing::Test
+{
+    LogStructuredTrustStore()
+    {
+        using namespace ::testing;
+        ON_CALL(spec.data_, home()).WillByDefault(Return(boost::filesystem::path{"/tmp"}));
+        boost::filesystem::remove(log());
+    }
+
+    boost::filesystem::path log() const
+    {
+        return boost::filesystem::path{"/tmp"} / log_structured_service_name / "trust.log";
+    }
+
+    std::shared_ptr<core::trust::Store> open(const core::trust::impl::log_structured::Configuration& configuration =
+            core::trust::impl::log_structured::default_configuration())
+    {
+        return core::trust::impl::log_structured::create_for_service(log_structured_service_name, spec, configuration);
+    }
+
+    static unsigned int count(const std::shared_ptr<core::trust::Store>& store)
+    {
+        auto query = store->query();
+        query->execute();
+
+        unsigned int result = 0;
+        while (core::trust::Store::Query::Status::eor != query->status())
+        {
+            result++;
+            query->next();
+        }
+        return result;
+    }
+
+    ::testing::NiceMock<MockXdgBaseDirSpec> spec;
+};
+}
+
+TEST_F(LogStructuredTrustStore, rebuilds_index_when_reopened)
+{
+    core::trust::Request r
+    {
+        "this.does.not.exist.app",
+        core::trust::Feature{0},
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+
+    {
+        auto store = open();
+        for (unsigned int i = 0; i < 10; i++)
+        {
+            r.feature.value = i;
+            store->add(r);
+        }
+
+        // Erase the latest request.
+        auto query = store->query();
+        query->execute();
+        query->erase();
+
+        store->remove_application("another.app");
+    }
+
+    auto store = open();
+    EXPECT_EQ(9u, count(store));
+
+    auto query = store->query();
+    query->for_application_id(r.from);
+    query->for_feature(core::trust::Feature{4});
+    query->execute();
+    ASSERT_EQ(core::trust::Store::Query::Status::has_more_results, query->status());
+    EXPECT_EQ(4u, query->current().feature.value);
+}
+
+TEST_F(LogStructuredTrustStore, drops_partially_written_records_when_reopened)
+{
+    core::trust::Request r
+    {
+        "this.does.not.exist.app",
+        core::trust::Feature{0},
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+
+    open()->add(r);
+
+    // Simulates a crash in the middle of appending a record.
+    {
+        std::ofstream out{log().string(), std::ios::app | std::ios::binary};
+        out << "garbage";
+    }
+
+    {
+        auto store = open();
+        EXPECT_EQ(1u, count(store));
+        store->add(r);
+    }
+
+    EXPECT_EQ(2u, count(open()));
+}
+
+TEST_F(LogStructuredTrustStore, failed_appends_leave_no_partially_written_record_behind)
+{
+    core::trust::Request r
+    {
+        "this.does.not.exist.app",
+        core::trust::Feature{0},
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+
+    {
+        auto store = open();
+        store->add(r);
+
+        // Writes beyond the file size limit fail midway, instead of raising SIGXFSZ.
+        auto handler = std::signal(SIGXFSZ, SIG_IGN);
+        struct rlimit limit; ::getrlimit(RLIMIT_FSIZE, &limit);
+        auto restricted = limit; restricted.rlim_cur = boost::filesystem::file_size(log()) + 4;
+        ::setrlimit(RLIMIT_FSIZE, &restricted);
+
+        EXPECT_ANY_THROW(store->add(r));
+
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+        std::signal(SIGXFSZ, handler);
+
+        store->add(r);
+        EXPECT_EQ(2u, count(store));
+    }
+
+    EXPECT_EQ(2u, count(open()));
+}
+
+TEST_F(LogStructuredTrustStore, compaction_preserves_content_and_shrinks_log)
+{
+    auto configuration = core::trust::impl::log_structured::default_configuration();
+    configuration.compaction_threshold = 10;
+    configuration.sync_on_append = false;
+
+    core::trust::Request r
+    {
+        "this.does.not.exist.app",
+        core::trust::Feature{0},
+        std::chrono::system_clock::now(),
+        core::trust::Request::Answer::granted
+    };
+
+    auto store = open(configuration);
+
+    for (unsigned int i = 0; i < 100; i++)
+    {
+        r.from = "app." + std::to_string(i);
+        store->add(r);
+    }
+
+    auto size_before_removal = boost::filesystem::file_size(log());
+
+    for (unsigned int i = 0; i < 90; i++)
+        store->remove_application("app." + std::to_string(i));
+
+    EXPECT_LT(boost::filesystem::file_size(log()), size_before_removal);
+    EXPECT_EQ(10u, count(store));
+    EXPECT_EQ(10u, count(open(configuration)));
+}